@@ -6,6 +6,9 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add aux_getPayloadString                                                 //
+//----------------------------------------------------------------------------//
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -508,6 +511,29 @@ bool aux_compareStringsN(char *str1, char *str2, int len)
     return ret;
 }
 
+/** Copy a received payload to a string buffer */
+bool aux_getPayloadString(const void *payload, int payloadlen, char *str, 
+        unsigned int size)
+{
+    bool ret;
+    if((str == NULL) || (size == 0))
+    {
+        return false;
+    }
+    ret = (payload != NULL) && (payloadlen >= 0) && 
+            ((unsigned int)payloadlen < size);
+    if(ret)
+    {
+        memcpy(str, payload, payloadlen);
+        str[payloadlen] = 0;
+    }
+    else
+    {
+        str[0] = 0;
+    }
+    return ret;
+}
+
 /**
  * Check if a received HAPCAN Frame matches the gateway filters
  */
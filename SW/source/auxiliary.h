@@ -6,6 +6,9 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add aux_getPayloadString                                                 //
+//----------------------------------------------------------------------------//
 
 #ifndef AUXILIARY_H
 #define AUXILIARY_H
@@ -203,6 +206,22 @@ bool aux_compareStrings(char *str1, char *str2);
  */
 bool aux_compareStringsN(char *str1, char *str2, int len);
 
+/**
+ * Copy a received payload (not null terminated) to a string buffer. When the 
+ * payload does not fit in the buffer, the string is set to empty (long 
+ * payloads are not text commands).
+ * 
+ * \param   payload     received payload
+ *          payloadlen  received payload length
+ *          str         string buffer to be filled
+ *          size        size of the string buffer
+ * 
+ * \return  true:   payload copied
+ *          false:  payload does not fit / parameter error (empty string)
+ */
+bool aux_getPayloadString(const void *payload, int payloadlen, char *str, 
+        unsigned int size);
+
 /**
  * Check if a received HAPCAN Frame matches the gateway filters
  * 
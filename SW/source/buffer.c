@@ -6,6 +6,36 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add buffer_pushNoCopy / buffer_popNoCopy: the element is handed over     //
+// (no copy). buffer_push copies the data before the buffer is locked.        //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Overflow policy per buffer (drop oldest, drop newest, block with         //
+// timeout, grow up to a maximum) and drop counter. An overflow is handled    //
+// in place and returns BUFFER_OVERFLOW                                       //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - buffer_resize: change the number of elements of a buffer at runtime      //
+// keeping the stored elements. Maximum elements raised to 65536. buffer_init //
+// no longer returns with the init lock taken                                 //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - buffer_dataCount returns 0 for a wrong ID (used by the metrics)          //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_BUFFER          //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - BUFFER_POLICY_BLOCK waits in the push, under the lock of the buffer.     //
+// buffer_waitNotFull waits under the lock of a pair of buffers. Elements     //
+// removed by buffer_pop are freed with the free function of the buffer       //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_BUFFER
 
 /*
  * Includes
@@ -14,6 +44,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
+#include <time.h>
+#include <errno.h>
 #include <linux/can.h>
 #include <linux/can/raw.h>
 #include "buffer.h"
@@ -23,7 +55,7 @@
 // INTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
 #define MAXIMUM_NUMBER_OF_BUFFERS   30
-#define MAXIMUM_NUMBER_OF_BUFFER_ELEMENTS   2000
+#define MAXIMUM_NUMBER_OF_BUFFER_ELEMENTS   65536
 
 //----------------------------------------------------------------------------//
 // INTERNAL TYPES
@@ -36,6 +68,11 @@ typedef struct
     unsigned int elements;  // Maximum number of elements in buffer
     unsigned int* dataLen;  // Size of the data stored in data field
     void **data;
+    bufferPolicy_t policy;  // Overflow policy
+    unsigned int timeout;   // BUFFER_POLICY_BLOCK: timeout in ms
+    unsigned int maxElements;   // BUFFER_POLICY_GROW: maximum elements
+    unsigned long drops;    // Number of elements dropped (overflow)
+    void (*freeData)(void *data);   // Free function of the elements
 } buffer_t;
 
 //----------------------------------------------------------------------------//
@@ -45,11 +82,16 @@ static int i_NumberOfBuffers = 0;
 static buffer_t buffers[MAXIMUM_NUMBER_OF_BUFFERS];
 static pthread_mutex_t buffer_initMutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t buffer_Mutex[MAXIMUM_NUMBER_OF_BUFFERS];
+static pthread_cond_t buffer_NotFull[MAXIMUM_NUMBER_OF_BUFFERS];
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
 static unsigned int buffer_NextIndex(int id, unsigned int index);
+static void buffer_FreeData(int id, void *data);
+static int buffer_WaitFreePosition(int id, pthread_mutex_t *lock);
+static int buffer_Realloc(int id, unsigned int elements);
+static int buffer_Grow(int id);
 
 /* Returns the next position based on the current position
  */
@@ -67,6 +109,121 @@ static unsigned int buffer_NextIndex(int id, unsigned int index)
     return lui_Next;
 }
 
+/* Free an element with the free function of the buffer
+ */
+static void buffer_FreeData(int id, void *data)
+{
+    if(data == NULL)
+    {
+        return;
+    }
+    if(buffers[id].freeData != NULL)
+    {
+        buffers[id].freeData(data);
+    }
+    else
+    {
+        free(data);
+    }
+}
+
+/* Wait (up to the timeout of the buffer) while the buffer is full. lock is 
+ * taken by the caller and released while waiting: it has to be the lock taken
+ * to pop from the buffer.
+ * Returns BUFFER_OK if there is a free position, BUFFER_ERROR if not.
+ */
+static int buffer_WaitFreePosition(int id, pthread_mutex_t *lock)
+{
+    int i_Check;
+    struct timespec ts_Timeout;
+    
+    if(buffer_IsFull(id) == BUFFER_OK)
+    {
+        return BUFFER_OK;
+    }
+    // Absolute timeout
+    clock_gettime(CLOCK_REALTIME, &ts_Timeout);
+    ts_Timeout.tv_sec += buffers[id].timeout / 1000;
+    ts_Timeout.tv_nsec += (long)(buffers[id].timeout % 1000) * 1000000L;
+    if(ts_Timeout.tv_nsec >= 1000000000L)
+    {
+        ts_Timeout.tv_sec++;
+        ts_Timeout.tv_nsec -= 1000000000L;
+    }
+    i_Check = 0;
+    while((buffer_IsFull(id) != BUFFER_OK) && (i_Check != ETIMEDOUT))
+    {
+        i_Check = pthread_cond_timedwait(&buffer_NotFull[id], lock, 
+                &ts_Timeout);
+    }
+    return buffer_IsFull(id);
+}
+
+/* Change the number of elements of the buffer. The elements are moved to the 
+ * start of the new arrays. elements cannot be lower than count. Buffer has to 
+ * be locked.
+ * Returns BUFFER_OK if the buffer was changed, BUFFER_ERROR if not.
+ */
+static int buffer_Realloc(int id, unsigned int elements)
+{
+    unsigned int lui_Elements;
+    unsigned int lui_Index;
+    unsigned int lui_Count;
+    unsigned int* lui_DataLen;
+    void **lvp_Data;
+    lui_Elements = elements;
+    if((lui_Elements == 0) || (lui_Elements < buffers[id].count))
+    {
+        return BUFFER_ERROR;
+    }
+    lui_DataLen = malloc(sizeof(unsigned int)*lui_Elements);
+    lvp_Data = malloc(sizeof(void *)*lui_Elements);
+    if((lui_DataLen == NULL) || (lvp_Data == NULL))
+    {
+        free(lui_DataLen);
+        free(lvp_Data);
+        return BUFFER_ERROR;
+    }
+    // Copy elements from tail to head
+    lui_Index = buffers[id].tail;
+    for(lui_Count = 0; lui_Count < buffers[id].count; lui_Count++)
+    {
+        lui_DataLen[lui_Count] = buffers[id].dataLen[lui_Index];
+        lvp_Data[lui_Count] = buffers[id].data[lui_Index];
+        lui_Index = buffer_NextIndex(id, lui_Index);
+    }
+    free(buffers[id].dataLen);
+    free(buffers[id].data);
+    buffers[id].dataLen = lui_DataLen;
+    buffers[id].data = lvp_Data;
+    buffers[id].elements = lui_Elements;
+    buffers[id].tail = 0;
+    buffers[id].head = buffers[id].count;
+    if(buffers[id].head >= buffers[id].elements)
+    {
+        buffers[id].head = 0;
+    }
+    return BUFFER_OK;
+}
+
+/* Grow the buffer (double it, up to maxElements). Buffer has to be locked.
+ * Returns BUFFER_OK if the buffer has grown, BUFFER_ERROR if not.
+ */
+static int buffer_Grow(int id)
+{
+    unsigned int lui_Elements;
+    lui_Elements = buffers[id].elements * 2;
+    if(lui_Elements > buffers[id].maxElements)
+    {
+        lui_Elements = buffers[id].maxElements;
+    }
+    if(lui_Elements <= buffers[id].elements)
+    {
+        return BUFFER_ERROR;
+    }
+    return buffer_Realloc(id, lui_Elements);
+}
+
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
@@ -80,17 +237,20 @@ int buffer_init(unsigned int elements)
     // Check buffer conditions
     if(i_NumberOfBuffers >= (MAXIMUM_NUMBER_OF_BUFFERS - 1))
     {
+        pthread_mutex_unlock(&buffer_initMutex);
         return BUFFER_ERROR_TOO_MANY_BUFFERS;
     }
-    if( elements >= (MAXIMUM_NUMBER_OF_BUFFER_ELEMENTS - 1))
+    if((elements == 0) || (elements > MAXIMUM_NUMBER_OF_BUFFER_ELEMENTS))
     {
+        pthread_mutex_unlock(&buffer_initMutex);
         return BUFFER_ERROR_TOO_MANY_ELEMENTS;
     }    
     // Define the Buffer ID as i_NumberOfBuffers
     i_BufferID = i_NumberOfBuffers;
     i_NumberOfBuffers++;    
-    // Init Buffer Mutex
+    // Init Buffer Mutex and condition (wait for a free position)
     pthread_mutex_init(&buffer_Mutex[i_BufferID], NULL);
+    pthread_cond_init(&buffer_NotFull[i_BufferID], NULL);
     // Fill Buffer
     buffers[i_BufferID].head = 0;
     buffers[i_BufferID].tail = 0;
@@ -98,6 +258,11 @@ int buffer_init(unsigned int elements)
     buffers[i_BufferID].elements = elements;
     buffers[i_BufferID].dataLen = malloc(sizeof(unsigned int*)*elements);
     buffers[i_BufferID].data = malloc(sizeof(void *)*elements);    
+    buffers[i_BufferID].policy = BUFFER_POLICY_DROP_OLDEST;
+    buffers[i_BufferID].timeout = 0;
+    buffers[i_BufferID].maxElements = elements;
+    buffers[i_BufferID].drops = 0;
+    buffers[i_BufferID].freeData = NULL;
     // UNLOCK - INIT
     pthread_mutex_unlock(&buffer_initMutex);    
     // return BufferID
@@ -128,6 +293,11 @@ int buffer_IsFull(int id)
  */
 unsigned int buffer_dataCount(int id)
 {
+    // Check ID
+    if((id < 0) || (id >= i_NumberOfBuffers))
+    {
+        return 0;
+    }
     // Return
     return buffers[id].count;
 }
@@ -135,6 +305,38 @@ unsigned int buffer_dataCount(int id)
 /* Add data to Buffer
  */
 int buffer_push(int id, void *data, unsigned int size)
+{
+    int i_Return;
+    void *p_Copy;
+    
+    // Check ID - See buffer_pushNoCopy
+    if(id >= i_NumberOfBuffers)
+    {
+        // Nothing is pushed/popped - wrong buffer ID
+        return BUFFER_WRONG_ID;
+    }
+    
+    // Data - Dynamic Allocation (keep a copy)
+    if(size > 0)
+    {
+        p_Copy = malloc(size);
+        memcpy(p_Copy, data, size);
+    }
+    else
+    {
+        p_Copy = NULL;
+    }
+    
+    // The copy is handed over to the buffer
+    i_Return = buffer_pushNoCopy(id, p_Copy, size);
+    
+    // Return
+    return i_Return;
+}
+
+/* Add data to Buffer - The data is handed over to the buffer (no copy)
+ */
+int buffer_pushNoCopy(int id, void *data, unsigned int size)
 {
     int i_Return;
     int i_BufferCount;
@@ -154,33 +356,58 @@ int buffer_push(int id, void *data, unsigned int size)
     // Protect in case push and pop take place at the same time
     pthread_mutex_lock(&buffer_Mutex[id]);
     
-    // Check if buffer is full
-    if(buffer_IsFull(id) == BUFFER_OK)
+    // BLOCK: wait for a free position - the check and the push are done under
+    // the same lock
+    if(buffers[id].policy == BUFFER_POLICY_BLOCK)
     {
-        // Return OK
-        i_Return = BUFFER_OK;
+        buffer_WaitFreePosition(id, &buffer_Mutex[id]);
     }
-    else
-    {        
-        // Return Overflow
-        i_Return = BUFFER_ERROR;
-        // fill buffer anyway, but first, eliminate last element
-        free(buffers[id].data[buffers[id].tail]);
-        buffers[id].data[buffers[id].tail] = NULL;
-        // Update Tail
-        buffers[id].tail = buffer_NextIndex(id, buffers[id].tail);
-        buffers[id].count--;
-        
+    
+    // Check if buffer is full
+    i_Return = BUFFER_OK;
+    if(buffer_IsFull(id) != BUFFER_OK)
+    {
+        // Overflow: apply the overflow policy of the buffer
+        switch(buffers[id].policy)
+        {
+            case BUFFER_POLICY_GROW:
+                if(buffer_Grow(id) == BUFFER_OK)
+                {
+                    break;
+                }
+                // Maximum reached - drop the oldest element
+                // fall through
+            case BUFFER_POLICY_DROP_OLDEST:
+            default:
+                // Return Overflow
+                i_Return = BUFFER_OVERFLOW;
+                buffers[id].drops++;
+                // fill buffer anyway, but first, eliminate last element
+                buffer_FreeData(id, buffers[id].data[buffers[id].tail]);
+                buffers[id].data[buffers[id].tail] = NULL;
+                // Update Tail
+                buffers[id].tail = buffer_NextIndex(id, buffers[id].tail);
+                buffers[id].count--;
+                break;
+            case BUFFER_POLICY_DROP_NEWEST:
+            case BUFFER_POLICY_BLOCK:
+                // Drop the new element (BLOCK: timeout)
+                buffers[id].drops++;
+                buffer_FreeData(id, data);
+                // Release MUTEX
+                pthread_mutex_unlock(&buffer_Mutex[id]);
+                return BUFFER_OVERFLOW;
+        }
     }
-    // Update Data - Dynamic Allocation (keep a copy)    
-    if(size > 0)
+    // Update Data - The buffer owns the data from now on
+    if((size > 0) && (data != NULL))
     {
         buffers[id].dataLen[buffers[id].head] = size;
-        buffers[id].data[buffers[id].head] = malloc(size);
-        memcpy(buffers[id].data[buffers[id].head], data, size);
+        buffers[id].data[buffers[id].head] = data;
     }
     else
     {
+        buffer_FreeData(id, data);
         buffers[id].dataLen[buffers[id].head] = 0;
         buffers[id].data[buffers[id].head] = NULL;
     }
@@ -276,18 +503,16 @@ int buffer_pop(int id, void *data, unsigned int size)
         {
             // Copy Data
             memcpy(data, buffers[id].data[buffers[id].tail], size);        
-            // Free data
-            free(buffers[id].data[buffers[id].tail]);
-            buffers[id].data[buffers[id].tail] = NULL;
-        }
-        else
-        {
-            data = NULL;                    
         }
+        // Free data (also if it is not copied)
+        buffer_FreeData(id, buffers[id].data[buffers[id].tail]);
+        buffers[id].data[buffers[id].tail] = NULL;
         
         // Update Index
         buffers[id].tail = buffer_NextIndex(id, buffers[id].tail);
         buffers[id].count--;
+        // Wake up producers waiting for a free position
+        pthread_cond_broadcast(&buffer_NotFull[id]);
     }
     /* See the function buffer_popSize.
      * MUTEX locked there is unlocked here
@@ -298,6 +523,199 @@ int buffer_pop(int id, void *data, unsigned int size)
     return i_Return;
 }
 
+/**
+ * Buffer Pop: Remove Element from buffer - The data is handed over to the 
+ * caller (no copy)
+ */
+int buffer_popNoCopy(int id, void **data, unsigned int *size)
+{
+    int i_Return;
+    int i_BufferCount;
+    
+    *data = NULL;
+    *size = 0;
+        
+    /* Get number of buffers: It is not protected because the initialization of
+     * buffer to be pushed/popped is done only once, before the first push/pop.
+     */
+    i_BufferCount = i_NumberOfBuffers;
+    
+    // Check ID
+    if(id >= i_BufferCount)
+    {
+        // Nothing is pushed/popped - wrong buffer ID
+        return BUFFER_WRONG_ID;
+    }
+    
+    // Protect in case push and pop take place at the same time
+    pthread_mutex_lock(&buffer_Mutex[id]);
+    
+    // Check if buffer is empty
+    if(buffers[id].count == 0)
+    {
+        // Return empty buffer
+        i_Return = BUFFER_ERROR;
+    }
+    else
+    {
+        // Return OK
+        i_Return = BUFFER_OK;
+        
+        // Hand over Data - The caller owns the data from now on
+        *data = buffers[id].data[buffers[id].tail];
+        *size = buffers[id].dataLen[buffers[id].tail];
+        buffers[id].data[buffers[id].tail] = NULL;
+        
+        // Update Index
+        buffers[id].tail = buffer_NextIndex(id, buffers[id].tail);
+        buffers[id].count--;
+        // Wake up producers waiting for a free position
+        pthread_cond_broadcast(&buffer_NotFull[id]);
+    }
+    
+    // Release MUTEX
+    pthread_mutex_unlock(&buffer_Mutex[id]);
+    
+    // Return
+    return i_Return;
+}
+
+/**
+ * Set the overflow policy of a buffer
+ */
+int buffer_setPolicy(int id, const bufferPolicySettings_t *settings)
+{
+    // Check ID
+    if((id < 0) || (id >= i_NumberOfBuffers))
+    {
+        return BUFFER_WRONG_ID;
+    }
+    // Protect in case push and pop take place at the same time
+    pthread_mutex_lock(&buffer_Mutex[id]);
+    buffers[id].policy = settings->policy;
+    buffers[id].timeout = settings->timeout;
+    buffers[id].maxElements = settings->maxElements;
+    if(buffers[id].maxElements < buffers[id].elements)
+    {
+        buffers[id].maxElements = buffers[id].elements;
+    }
+    if(buffers[id].maxElements > MAXIMUM_NUMBER_OF_BUFFER_ELEMENTS)
+    {
+        buffers[id].maxElements = MAXIMUM_NUMBER_OF_BUFFER_ELEMENTS;
+    }
+    // Release MUTEX
+    pthread_mutex_unlock(&buffer_Mutex[id]);
+    return BUFFER_OK;
+}
+
+/**
+ * Change the number of elements of a buffer, keeping the stored elements
+ */
+int buffer_resize(int id, unsigned int elements)
+{
+    int i_Return;
+    // Check ID
+    if((id < 0) || (id >= i_NumberOfBuffers))
+    {
+        return BUFFER_WRONG_ID;
+    }
+    if(elements > MAXIMUM_NUMBER_OF_BUFFER_ELEMENTS)
+    {
+        elements = MAXIMUM_NUMBER_OF_BUFFER_ELEMENTS;
+    }
+    // Protect in case push and pop take place at the same time
+    pthread_mutex_lock(&buffer_Mutex[id]);
+    // Do not drop elements: keep at least the elements already stored
+    if(elements < buffers[id].count)
+    {
+        elements = buffers[id].count;
+        #ifdef DEBUG_BUFFER
+        debug_verbose("buffer_resize: buffer %d kept with %u elements\n", id, 
+                elements);
+        #endif
+    }
+    if(elements == buffers[id].elements)
+    {
+        i_Return = BUFFER_OK;
+    }
+    else
+    {
+        i_Return = buffer_Realloc(id, elements);
+    }
+    if(buffers[id].maxElements < buffers[id].elements)
+    {
+        buffers[id].maxElements = buffers[id].elements;
+    }
+    // Release MUTEX and wake up the producers waiting for a free position
+    pthread_cond_broadcast(&buffer_NotFull[id]);
+    pthread_mutex_unlock(&buffer_Mutex[id]);
+    return i_Return;
+}
+
+/**
+ * Set the function used to free the elements dropped or cleaned
+ */
+void buffer_setFreeFunction(int id, void (*freeData)(void *data))
+{
+    if((id < 0) || (id >= i_NumberOfBuffers))
+    {
+        return;
+    }
+    pthread_mutex_lock(&buffer_Mutex[id]);
+    buffers[id].freeData = freeData;
+    pthread_mutex_unlock(&buffer_Mutex[id]);
+}
+
+/**
+ * Wait for a free position of a pair of buffers (BUFFER_POLICY_BLOCK only)
+ */
+int buffer_waitNotFull(int id, pthread_mutex_t *lock)
+{
+    int i_Return;
+    
+    if((id < 0) || (id >= i_NumberOfBuffers))
+    {
+        return BUFFER_WRONG_ID;
+    }
+    
+    // The push and the pop of the buffer are protected by lock (taken by the
+    // caller): the buffer lock is not taken while waiting
+    if(buffers[id].policy == BUFFER_POLICY_BLOCK)
+    {
+        i_Return = buffer_WaitFreePosition(id, lock);
+        if(i_Return != BUFFER_OK)
+        {
+            // Timeout: the element is dropped by the caller
+            pthread_mutex_lock(&buffer_Mutex[id]);
+            buffers[id].drops++;
+            pthread_mutex_unlock(&buffer_Mutex[id]);
+        }
+    }
+    else
+    {
+        i_Return = BUFFER_OK;
+    }
+    
+    // Return
+    return i_Return;
+}
+
+/**
+ * Returns the number of elements dropped
+ */
+unsigned long buffer_getDropCount(int id)
+{
+    unsigned long lul_Return;
+    if((id < 0) || (id >= i_NumberOfBuffers))
+    {
+        return 0;
+    }
+    pthread_mutex_lock(&buffer_Mutex[id]);
+    lul_Return = buffers[id].drops;
+    pthread_mutex_unlock(&buffer_Mutex[id]);
+    return lul_Return;
+}
+
 /**
  * Remove all elemnts from the buffer
  */
@@ -312,7 +730,7 @@ void buffer_clean(int id)
     li_count = buffers[id].count;
     while(li_count > 0)
     {
-        free(buffers[id].data[buffers[id].tail]);
+        buffer_FreeData(id, buffers[id].data[buffers[id].tail]);
         buffers[id].data[buffers[id].tail] = NULL;
         buffers[id].tail = buffer_NextIndex(id, buffers[id].tail);
         li_count--;
@@ -323,6 +741,9 @@ void buffer_clean(int id)
     buffers[id].tail = 0;
     buffers[id].count = 0;    
     
+    // Wake up producers waiting for a free position
+    pthread_cond_broadcast(&buffer_NotFull[id]);
+    
     // Release MUTEX
     pthread_mutex_unlock(&buffer_Mutex[id]);
 }
@@ -352,48 +773,48 @@ void buffer_print(int id)
 
     li_head = buffers[id].head;
     li_tail = buffers[id].tail;
-    debug_print("----------\n");
-    debug_print("Buffer: %d\n", id);
-    debug_print("- Count: %u\n", buffers[id].count);
-    debug_print("- Elements: %u\n", buffers[id].elements);
-    debug_print("- Head: %u\n", li_head);
-    debug_print("- Tail: %u\n", li_tail);
+    debug_verbose("----------\n");
+    debug_verbose("Buffer: %d\n", id);
+    debug_verbose("- Count: %u\n", buffers[id].count);
+    debug_verbose("- Elements: %u\n", buffers[id].elements);
+    debug_verbose("- Head: %u\n", li_head);
+    debug_verbose("- Tail: %u\n", li_tail);
     li_count = 0;
     while(li_count < buffers[id].count)
     {
-        debug_print("----------\n");
-        debug_print("- Data Index: %u\n", li_count);
+        debug_verbose("----------\n");
+        debug_verbose("- Data Index: %u\n", li_count);
         switch(buffers[id].dataLen[li_tail])
         {
             case sizeof(char):
             case sizeof(int):
                 li_Temp = 0;
                 memcpy(&li_Temp, buffers[id].data[li_tail], buffers[id].dataLen[li_tail]);                
-                debug_print("- Data: %d\n", li_Temp);
+                debug_verbose("- Data: %d\n", li_Temp);
                 break;
             case sizeof(unsigned long long):
                 memcpy(&lull_Temp, buffers[id].data[li_tail], sizeof(lull_Temp));                
-                debug_print("- Data: %llu\n", lull_Temp);
+                debug_verbose("- Data: %llu\n", lull_Temp);
                 break;
             case sizeof(struct can_frame):                
                 li_Temp = buffers[id].dataLen[li_tail];
                 lcp_Temp = malloc(li_Temp + 1);
                 memcpy(lcp_Temp, buffers[id].data[li_tail], li_Temp);
                 lcp_Temp[li_Temp] = '\0';
-                debug_print("- Data (String): %s\n", lcp_Temp);
+                debug_verbose("- Data (String): %s\n", lcp_Temp);
                 free(lcp_Temp);
                 memcpy(&cf_Frame, buffers[id].data[li_tail], li_Temp);
-                debug_print("- CAN ID: 0x%08x\n", cf_Frame.can_id);
+                debug_verbose("- CAN ID: 0x%08x\n", cf_Frame.can_id);
                 for(li_Temp = 0; li_Temp < 8; li_Temp++)
                 {
-                    debug_print("- CAN Data[%d] = 0x%02x\n", li_Temp, cf_Frame.data[li_Temp]);
+                    debug_verbose("- CAN Data[%d] = 0x%02x\n", li_Temp, cf_Frame.data[li_Temp]);
                 }
             default:                
                 li_Temp = buffers[id].dataLen[li_tail];
                 lcp_Temp = malloc(li_Temp + 1);
                 memcpy(lcp_Temp, buffers[id].data[li_tail], li_Temp);
                 lcp_Temp[li_Temp] = '\0';
-                debug_print("- Data: %s\n", lcp_Temp);
+                debug_verbose("- Data: %s\n", lcp_Temp);
                 free(lcp_Temp);
                 break;            
         }
@@ -407,6 +828,6 @@ void buffer_print(int id)
         } 
         li_count++;
     }    
-    debug_print("----------\n");
+    debug_verbose("----------\n");
     #endif     
 }
\ No newline at end of file
@@ -6,6 +6,19 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add buffer_pushNoCopy / buffer_popNoCopy (element is handed over)        //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Overflow policies (bufferPolicy_t), drop counter and BUFFER_OVERFLOW     //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add buffer_resize (number of elements changed at runtime)                //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - BUFFER_POLICY_BLOCK waits in the push. buffer_waitNotFull takes the      //
+// lock of a pair of buffers                                                  //
+//----------------------------------------------------------------------------//
 
 #ifndef BUFFER_H
 #define BUFFER_H
@@ -14,6 +27,8 @@
 extern "C" {
 #endif
 
+#include <pthread.h>
+
 //----------------------------------------------------------------------------//
 // EXTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
@@ -22,7 +37,26 @@ extern "C" {
 #define BUFFER_OK       1
 #define BUFFER_ERROR    -1
 #define BUFFER_WRONG_ID -2
+#define BUFFER_OVERFLOW -3  // Element dropped by the overflow policy
 
+//----------------------------------------------------------------------------//
+// EXTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Overflow policy: what is done when an element is pushed to a full buffer
+typedef enum
+{
+    BUFFER_POLICY_DROP_OLDEST = 0,  // Drop the oldest element (default)
+    BUFFER_POLICY_DROP_NEWEST,      // Drop the element being pushed
+    BUFFER_POLICY_BLOCK,            // Wait for a free position, up to timeout
+    BUFFER_POLICY_GROW              // Grow up to maxElements, then drop oldest
+} bufferPolicy_t;
+
+typedef struct
+{
+    bufferPolicy_t policy;
+    unsigned int timeout;       // BUFFER_POLICY_BLOCK: timeout in ms
+    unsigned int maxElements;   // BUFFER_POLICY_GROW: maximum elements
+} bufferPolicySettings_t;
 
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
@@ -49,20 +83,39 @@ int buffer_IsFull(int id);
  * Returns the positions filled for a given buffer ID.
  * 
  * \param   id    Buffer ID
- * \return  number of elements in the buffer
+ * \return  number of elements in the buffer (0 if the ID is not valid)
  */
 unsigned int buffer_dataCount(int id);
 
 /**
- * Buffer Push: Add Element to buffer.
+ * Buffer Push: Add Element to buffer. With BUFFER_POLICY_BLOCK, waits for a 
+ * free position (up to the timeout of the buffer) under the lock of the 
+ * buffer: the caller must not hold a lock the consumer needs to pop (see 
+ * buffer_waitNotFull).
  * 
  * \param   id    Buffer ID
- * \return  If buffer overflow: BUFFER_ERROR
+ * \return  If buffer overflow: BUFFER_OVERFLOW (oldest or new element dropped,
+ *          depending on the policy)
  *          If Wrong ID passed: BUFFER_WRONG_ID
  *          If OK: BUFFER_OK
  */
 int buffer_push(int id, void *data, unsigned int size);
 
+/**
+ * Buffer Push: Add Element to buffer without a copy. The buffer takes the 
+ * ownership of data (allocated with malloc), which is freed when the element 
+ * is dropped (overflow) or cleaned. If BUFFER_WRONG_ID is returned, data is 
+ * still owned by the caller.
+ * 
+ * \param   id      Buffer ID
+ * \param   data    Data allocated with malloc (handed over to the buffer)
+ * \param   size    Size of data
+ * \return  If buffer overflow: BUFFER_OVERFLOW (see buffer_push)
+ *          If Wrong ID passed: BUFFER_WRONG_ID
+ *          If OK: BUFFER_OK
+ */
+int buffer_pushNoCopy(int id, void *data, unsigned int size);
+
 /**
  * Returns the size of the next element to be removed. 
  * It has to be called before pop.
@@ -84,6 +137,77 @@ unsigned int buffer_popSize(int id);
  */
 int buffer_pop(int id, void *data, unsigned int size);
 
+/**
+ * Buffer Pop: Remove Element from buffer without a copy. The stored data is 
+ * handed over to the caller, and has to be freed after used: free(*data).
+ * It does not need buffer_popSize.
+ * 
+ * \param   id      Buffer ID
+ * \param   data    Stored data (NULL if error or empty)
+ * \param   size    Size of the stored data (0 if error or empty)
+ * \return  If buffer empty: BUFFER_ERROR
+ *          If Wrong ID passed: BUFFER_WRONG_ID
+ *          If OK: BUFFER_OK
+ */
+int buffer_popNoCopy(int id, void **data, unsigned int *size);
+
+/**
+ * Set the overflow policy of a buffer (default: BUFFER_POLICY_DROP_OLDEST).
+ * 
+ * \param   id          Buffer ID
+ * \param   settings    Policy, timeout (BLOCK) and maximum elements (GROW)
+ * \return  BUFFER_OK / BUFFER_WRONG_ID
+ */
+int buffer_setPolicy(int id, const bufferPolicySettings_t *settings);
+
+/**
+ * Change the number of elements of a buffer at runtime. The stored elements 
+ * are kept: if the buffer holds more elements than requested, it is resized 
+ * to the number of elements it holds. The limit of BUFFER_POLICY_GROW is 
+ * raised to the new size if needed.
+ * 
+ * \param   id          Buffer ID
+ * \param   elements    New number of elements
+ * \return  BUFFER_OK / BUFFER_ERROR (no memory, size kept) / BUFFER_WRONG_ID
+ */
+int buffer_resize(int id, unsigned int elements);
+
+/**
+ * Set the function used to free the elements dropped by the overflow policy,
+ * removed by buffer_clean or freed by buffer_pop (default: free).
+ * 
+ * \param   id          Buffer ID
+ * \param   freeData    Free function
+ * \return  nothing
+ */
+void buffer_setFreeFunction(int id, void (*freeData)(void *data));
+
+/**
+ * Wait for a free position of buffers written in pairs (data and timestamp),
+ * whose push and pop are protected by a lock of the caller. Only waits with 
+ * BUFFER_POLICY_BLOCK (up to the timeout of the buffer). The lock is taken by
+ * the caller and released while waiting: as the producers push under the 
+ * same lock, the position is still free when the pair is pushed. If the 
+ * buffer is still full, the element is counted as dropped and it has to be 
+ * dropped by the caller (not pushed). A buffer is waited either with this 
+ * function or in the push, not both.
+ * 
+ * \param   id      Buffer ID
+ * \param   lock    Lock of the pair of buffers (taken by the caller)
+ * \return  If buffer is not full: BUFFER_OK
+ *          If buffer is still full: BUFFER_ERROR
+ *          If Wrong ID passed: BUFFER_WRONG_ID
+ */
+int buffer_waitNotFull(int id, pthread_mutex_t *lock);
+
+/**
+ * Returns the number of elements dropped by the overflow policy.
+ * 
+ * \param   id    Buffer ID
+ * \return  number of elements dropped
+ */
+unsigned long buffer_getDropCount(int id);
+
 /**
  * Remove all elements from the buffer.
  * 
@@ -0,0 +1,243 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - The frame is pushed to the channels after the routes lock is released:   //
+// the matching channels are copied under the lock                            //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_CAN
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "auxiliary.h"
+#include "canbridge.h"
+#include "canbuf.h"
+#include "debug.h"
+#include "errorhandler.h"
+#include "hapcan.h"
+#include "jsonhandler.h"
+#include "metrics.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+#define CANBRIDGE_SECTION       "CANBridges"
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Route: frames received on "from" matching mask / check are sent to "to"
+typedef struct
+{
+    int from;
+    int to;
+    hapcanCANData mask;
+    hapcanCANData check;
+} canbridgeRoute_t;
+
+// Frame forwarded to a channel (loop prevention)
+typedef struct
+{
+    struct can_frame frame;
+    unsigned long long millisecondsSinceEpoch;
+} canbridgeEcho_t;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+static canbridgeRoute_t g_routes[CANBRIDGE_MAX_ROUTES];
+static int g_nRoutes = 0;
+static canbridgeEcho_t g_echo[SOCKETCAN_CHANNELS][CANBRIDGE_ECHO_FRAMES];
+static int g_echoIndex[SOCKETCAN_CHANNELS];
+static pthread_mutex_t g_bridge_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static void setFilter(int route, const char *field, uint8_t *mask,
+        uint8_t *check);
+static bool sameFrame(struct can_frame *a, struct can_frame *b);
+static bool isEcho(int channel, struct can_frame *pcf_Frame,
+        unsigned long long millisecondsSinceEpoch);
+
+// Optional filter of a route (byte of the HAPCAN frame)
+static void setFilter(int route, const char *field, uint8_t *mask,
+        uint8_t *check)
+{
+    int value;
+    int check_json;
+    check_json = jh_getJFieldInt(CANBRIDGE_SECTION, route, field, 0, NULL,
+            &value);
+    if((check_json == JSON_OK) && (value >= 0) && (value <= 255))
+    {
+        *mask = 0xFF;
+        *check = value;
+    }
+}
+
+// Same identifier, length and data
+static bool sameFrame(struct can_frame *a, struct can_frame *b)
+{
+    return (a->can_id == b->can_id) && (a->can_dlc == b->can_dlc) &&
+            (memcmp(a->data, b->data, a->can_dlc) == 0);
+}
+
+// Frame forwarded to this channel a moment ago - LOCKED BY THE CALLER
+static bool isEcho(int channel, struct can_frame *pcf_Frame,
+        unsigned long long millisecondsSinceEpoch)
+{
+    int i;
+    canbridgeEcho_t *echo;
+    for(i = 0; i < CANBRIDGE_ECHO_FRAMES; i++)
+    {
+        echo = &g_echo[channel][i];
+        if((echo->millisecondsSinceEpoch + CANBRIDGE_ECHO_TIME >=
+                millisecondsSinceEpoch) && sameFrame(&echo->frame, pcf_Frame))
+        {
+            // Only once: the next equal frame is a new one
+            echo->millisecondsSinceEpoch = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/* Build the routing table */
+void canbridge_init(void)
+{
+    int i;
+    int n_routes;
+    int check;
+    int from;
+    int to;
+    int frame;
+    canbridgeRoute_t *route;
+    check = jh_getJArrayElements(CANBRIDGE_SECTION, 0, NULL, JSON_DEPTH_LEVEL,
+            &n_routes);
+    if(check != JSON_OK)
+    {
+        n_routes = 0;
+    }
+    // LOCK ROUTES
+    pthread_mutex_lock(&g_bridge_mutex);
+    g_nRoutes = 0;
+    for(i = 0; (i < n_routes) && (g_nRoutes < CANBRIDGE_MAX_ROUTES); i++)
+    {
+        check = jh_getJFieldInt(CANBRIDGE_SECTION, i, "from", 0, NULL, &from);
+        if(check == JSON_OK)
+        {
+            check = jh_getJFieldInt(CANBRIDGE_SECTION, i, "to", 0, NULL, &to);
+        }
+        if((check != JSON_OK) || (from == to) || (from < 0) || (to < 0) ||
+                (from >= canbuf_getChannels()) || (to >= canbuf_getChannels()))
+        {
+            #ifdef DEBUG_CANROUTE_ERRORS
+            debug_error("canbridge_init: Route Error - Index %d\n", i);
+            #endif
+            continue;
+        }
+        route = &g_routes[g_nRoutes];
+        route->from = from;
+        route->to = to;
+        // Filters are optional: no filter forwards every frame
+        aux_clearHAPCANFrame(&route->mask);
+        aux_clearHAPCANFrame(&route->check);
+        check = jh_getJFieldInt(CANBRIDGE_SECTION, i, "frame", 0, NULL,
+                &frame);
+        if(check == JSON_OK)
+        {
+            route->mask.frametype = 0xFFFF;
+            route->check.frametype = frame;
+        }
+        setFilter(i, "node", &route->mask.module, &route->check.module);
+        setFilter(i, "group", &route->mask.group, &route->check.group);
+        setFilter(i, "destinationNode", &route->mask.data[2],
+                &route->check.data[2]);
+        setFilter(i, "destinationGroup", &route->mask.data[3],
+                &route->check.data[3]);
+        g_nRoutes++;
+    }
+    // UNLOCK ROUTES
+    pthread_mutex_unlock(&g_bridge_mutex);
+}
+
+/* Forward a frame to the channels of the matching routes */
+int canbridge_forward(int channel, struct can_frame *pcf_Frame,
+        unsigned long long millisecondsSinceEpoch)
+{
+    int i;
+    int check;
+    int forwarded;
+    int n_to;
+    int to[CANBRIDGE_MAX_ROUTES];
+    unsigned int sent;
+    canbridgeEcho_t *echo;
+    hapcanCANData hd_received;
+    // Nothing to do without routes
+    if(g_nRoutes == 0)
+    {
+        return 0;
+    }
+    n_to = 0;
+    sent = 0;
+    hapcan_getHAPCANDataFromCAN(pcf_Frame, &hd_received);
+    // LOCK ROUTES
+    pthread_mutex_lock(&g_bridge_mutex);
+    if(isEcho(channel, pcf_Frame, millisecondsSinceEpoch))
+    {
+        // UNLOCK ROUTES
+        pthread_mutex_unlock(&g_bridge_mutex);
+        metrics_add(METRICS_CAN_BRIDGE_LOOPS, channel, 1);
+        return 0;
+    }
+    for(i = 0; i < g_nRoutes; i++)
+    {
+        // Once for each channel, even if more than one route matches
+        if((g_routes[i].from != channel) || (sent & (1 << g_routes[i].to)) ||
+                !aux_checkCAN2MQTTMatch(&hd_received, &g_routes[i].mask,
+                &g_routes[i].check))
+        {
+            continue;
+        }
+        sent |= (1 << g_routes[i].to);
+        to[n_to] = g_routes[i].to;
+        n_to++;
+        // Remember it before it is sent: if it comes back, it is not 
+        // forwarded again
+        echo = &g_echo[g_routes[i].to][g_echoIndex[g_routes[i].to]];
+        echo->frame = *pcf_Frame;
+        echo->millisecondsSinceEpoch = millisecondsSinceEpoch;
+        g_echoIndex[g_routes[i].to] = (g_echoIndex[g_routes[i].to] + 1) %
+                CANBRIDGE_ECHO_FRAMES;
+    }
+    // UNLOCK ROUTES - the push may wait for a free position
+    pthread_mutex_unlock(&g_bridge_mutex);
+    forwarded = 0;
+    for(i = 0; i < n_to; i++)
+    {
+        check = canbuf_setWriteMsgToBuffer(to[i], pcf_Frame,
+                millisecondsSinceEpoch);
+        errorh_isCANError(to[i], ERROR_MODULE_CAN_SEND, check);
+        if(check == CAN_SEND_OK)
+        {
+            metrics_add(METRICS_CAN_BRIDGED_FRAMES, to[i], 1);
+            forwarded++;
+        }
+    }
+    return forwarded;
+}
@@ -0,0 +1,59 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef CANBRIDGE_H
+#define CANBRIDGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <linux/can.h>
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+/* Maximum number of routes of section "CANBridges" */
+#define CANBRIDGE_MAX_ROUTES        64
+/* Frames forwarded to each channel that are remembered for loop prevention */
+#define CANBRIDGE_ECHO_FRAMES       32
+/* A frame received up to this time after being forwarded to the same
+ * channel is an echo (ms) */
+#define CANBRIDGE_ECHO_TIME         500
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Build the routing table from the configuration (section "CANBridges":
+ * "from" and "to" channels, optional filters "frame", "node", "group",
+ * "destinationNode" and "destinationGroup"). Routes with the same or an
+ * invalid channel are ignored.
+ */
+void canbridge_init(void);
+
+/**
+ * Forward a frame received on a channel to the write queues of the channels
+ * of the matching routes (one hop: a forwarded frame is not forwarded again).
+ * A frame that was forwarded to this channel a moment ago (echo from another
+ * path between the buses) is not forwarded.
+ *
+ * \param   channel     (INPUT) CAN channel the frame was received from
+ * \param   pcf_Frame   (INPUT) frame received
+ * \param   millisecondsSinceEpoch  (INPUT) time the frame was received
+ * \return  number of channels the frame was forwarded to
+ */
+int canbridge_forward(int channel, struct can_frame *pcf_Frame,
+        unsigned long long millisecondsSinceEpoch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CANBRIDGE_H */
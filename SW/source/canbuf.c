@@ -6,16 +6,55 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Overflow policy of each buffer from the configuration. An overflow is    //
+// handled by the buffer (counted as a drop), not reported as an error        //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Number of elements of each buffer from the configuration. Add            //
+// canbuf_updateQueues: resize the buffers and set the policies again after   //
+// a configuration reload (stored frames are kept)                            //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Latency of each frame (monotonic stamp stored with the timestamp)        //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Add canbuf_getQueueDepth; frames received / sent are counted (metrics)   //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_CAN             //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Every frame received / sent is added to the bus trace (trace.h)          //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - Up to SOCKETCAN_CHANNELS channels; the socket of each channel is opened  //
+// on its interface of "canInterfaces" (reopened if changed on a reload)      //
+//----------------------------------------------------------------------------//
+//  1.08     | 18/Oct/2026 |                               | ALCP             //
+// - The wait for a free position ("block" policy) is done under the lock of  //
+// the buffers: the position cannot be taken by another producer              //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_CAN
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <net/if.h>
 #include "debug.h"
 #include "buffer.h"
 #include "auxiliary.h"
+#include "config.h"
+#include "latency.h"
+#include "metrics.h"
 #include "socketcan.h"
+#include "trace.h"
 #include "canbuf.h"
 
 //----------------------------------------------------------------------------//
@@ -25,26 +64,45 @@
 #define NUMBER_OF_CAN_WRITE_BUFFERS (CAN_WRITE_STAMP_BUFFER - CAN_WRITE_DATA_BUFFER + 1)
 #define NUMBER_OF_CAN_READ_BUFFERS  (CAN_READ_STAMP_BUFFER - CAN_READ_DATA_BUFFER + 1)
 
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+/* Element of the timestamp buffers */
+typedef struct
+{
+    unsigned long long millisecondsSinceEpoch;
+    latencyStamp_t latency;
+} canbufStamp_t;
+
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
-// State: For two CAN Channels: use {CAN_DISCONNECTED, CAN_DISCONNECTED};
-volatile stateCAN_t canbufState[SOCKETCAN_CHANNELS] = {CAN_DISCONNECTED};
-// ID: For two CAN channels
-   //{-1, -1, -1, -1} ,   /*  initializers for row indexed by 0 */
-   //{-1, -1, -1, -1}     /*  initializers for row indexed by 1 */
+// State: one for each CAN channel
+volatile stateCAN_t canbufState[SOCKETCAN_CHANNELS] = {CAN_DISCONNECTED, 
+    CAN_DISCONNECTED, CAN_DISCONNECTED, CAN_DISCONNECTED};
+// ID: one row for each CAN channel
 static int canbufID[SOCKETCAN_CHANNELS][CAN_NUMBER_OF_BUFFERS] = {
-   {-1, -1, -1, -1}   /*  initializers for row indexed by 0 */
+   {-1, -1, -1, -1},  /*  initializers for row indexed by 0 */
+   {-1, -1, -1, -1},  /*  initializers for row indexed by 1 */
+   {-1, -1, -1, -1},  /*  initializers for row indexed by 2 */
+   {-1, -1, -1, -1}   /*  initializers for row indexed by 3 */
 };
-// File descriptor: // For two CAN Channels: {-1, -1};
-static int fd[SOCKETCAN_CHANNELS] = {-1}; 
+// File descriptor: one for each CAN channel
+static int fd[SOCKETCAN_CHANNELS] = {-1, -1, -1, -1}; 
+// Interface of the open socket of each channel
+static char canbufInterface[SOCKETCAN_CHANNELS][IFNAMSIZ];
+// Number of channels (0: not read yet)
+static int canbufChannels = 0;
 
 static pthread_mutex_t cb_state_mutex[SOCKETCAN_CHANNELS] = {
-    PTHREAD_MUTEX_INITIALIZER};
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, 
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER};
 static pthread_mutex_t cb_read_mutex[SOCKETCAN_CHANNELS] = {
-    PTHREAD_MUTEX_INITIALIZER};
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, 
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER};
 static pthread_mutex_t cb_write_mutex[SOCKETCAN_CHANNELS] = {
-    PTHREAD_MUTEX_INITIALIZER};
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, 
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER};
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS
@@ -52,16 +110,17 @@ static pthread_mutex_t cb_write_mutex[SOCKETCAN_CHANNELS] = {
 static int canbuf_validateChannel(int channel);
 static stateCAN_t getCANBufState(int channel);
 static void setCANBufState(int channel, stateCAN_t cState);
+static void canbuf_configBuffers(int channel);
+static void canbuf_getInterface(int channel, char *name);
 
 /**
  * CAN Validate channel
- * \param   channel     Channel 0 (SOCKETCAN_CHANNEL_0): can0 
- *                      Channel 1 (SOCKETCAN_CHANNEL_1): can1
+ * \param   channel     CAN channel: 0 to canbuf_getChannels() - 1
  * \return  EXIT_SUCCESS / EXIT_FAILURE
  */
 static int canbuf_validateChannel(int channel)
 {
-    if( (channel < SOCKETCAN_CHANNEL_0) || (channel >= SOCKETCAN_CHANNELS) )
+    if( (channel < SOCKETCAN_CHANNEL_0) || (channel >= canbuf_getChannels()) )
     {
         return EXIT_FAILURE;
     }
@@ -96,10 +155,116 @@ static void setCANBufState(int channel, stateCAN_t cState)
     pthread_mutex_unlock(&cb_state_mutex[channel]);
 }
 
+/**
+ * Create the buffers (if not created yet) or resize them, and set the overflow
+ * policy, from the configuration. Data and timestamp buffers of one direction
+ * get the same size and policy, so they drop the same frames.
+ * \param   channel     CAN channel (already validated)
+ */
+static void canbuf_configBuffers(int channel)
+{
+    int count;
+    unsigned int size;
+    const char* queue;
+    bufferPolicySettings_t policy;
+    for(count = 0; count < CAN_NUMBER_OF_BUFFERS; count++)
+    {
+        if(count <= CAN_READ_STAMP_BUFFER)
+        {
+            queue = CONFIG_QUEUE_CAN_READ;
+        }
+        else
+        {
+            queue = CONFIG_QUEUE_CAN_WRITE;
+        }
+        size = config_getQueueSize(queue, CAN_BUFFER_SIZE);
+        if(canbufID[channel][count] < 0)
+        {
+            canbufID[channel][count] = buffer_init(size);
+        }
+        else
+        {
+            buffer_resize(canbufID[channel][count], size);
+        }
+        config_getQueuePolicy(queue, size, &policy);
+        buffer_setPolicy(canbufID[channel][count], &policy);
+    }
+}
+
+/**
+ * Interface of a channel from the configuration: element "channel" of
+ * "canInterfaces", CAN_DEFAULT_INTERFACE for channel 0 if not configured.
+ * \param   channel     CAN channel (already validated)
+ * \param   name        interface (IFNAMSIZ characters) (OUTPUT)
+ */
+static void canbuf_getInterface(int channel, char *name)
+{
+    int check;
+    int li_index;
+    int n_interfaces;
+    char **interfaces;
+    name[0] = 0;
+    check = config_getStringArray(CONFIG_GENERAL_SETTINGS_LEVEL, 
+            "canInterfaces", &n_interfaces, &interfaces);
+    if(check == EXIT_SUCCESS)
+    {
+        if(channel < n_interfaces)
+        {
+            snprintf(name, IFNAMSIZ, "%s", interfaces[channel]);
+        }
+        for(li_index = 0; li_index < n_interfaces; li_index++)
+        {
+            free(interfaces[li_index]);
+        }
+        free(interfaces);
+    }
+    else if(channel == SOCKETCAN_CHANNEL_0)
+    {
+        snprintf(name, IFNAMSIZ, "%s", CAN_DEFAULT_INTERFACE);
+    }
+}
 
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
+/* Number of CAN channels */
+int canbuf_getChannels(void)
+{
+    int check;
+    int li_index;
+    int n_interfaces;
+    char **interfaces;
+    // Read once: the threads of each channel are created at start-up
+    if(canbufChannels == 0)
+    {
+        n_interfaces = 1;
+        check = config_getStringArray(CONFIG_GENERAL_SETTINGS_LEVEL, 
+                "canInterfaces", &n_interfaces, &interfaces);
+        if(check == EXIT_SUCCESS)
+        {
+            for(li_index = 0; li_index < n_interfaces; li_index++)
+            {
+                free(interfaces[li_index]);
+            }
+            free(interfaces);
+        }
+        if(n_interfaces > SOCKETCAN_CHANNELS)
+        {
+            #ifdef DEBUG_CANBUF_ERRORS
+            debug_error("CAN: canInterfaces - Only %d channels are used!\n", 
+                    SOCKETCAN_CHANNELS);
+            #endif
+            n_interfaces = SOCKETCAN_CHANNELS;
+        }
+        else if(n_interfaces < 1)
+        {
+            n_interfaces = 1;
+        }
+        canbufChannels = n_interfaces;
+    }
+    return canbufChannels;
+}
+
 /* CAN Initialization - Buffer Initialization */
 int canbuf_init(int channel)
 {
@@ -113,20 +278,14 @@ int canbuf_init(int channel)
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("CAN: canbuf_init ERROR - Channel Error!\n");
-        debug_print("- Channel: %d\n", channel);
+        debug_error("CAN: canbuf_init ERROR - Channel Error!\n");
+        debug_error("- Channel: %d\n", channel);
         #endif
         return EXIT_FAILURE;
     }
     
     // Init buffers
-    for(count = 0; count < CAN_NUMBER_OF_BUFFERS; count++)
-    {
-        if(canbufID[channel][count] < 0)
-        {
-            canbufID[channel][count] = buffer_init(CAN_BUFFER_SIZE);
-        }
-    }
+    canbuf_configBuffers(channel);
     // Check buffers - All should have ID
     check = 0;
     for(count = 0; count < CAN_NUMBER_OF_BUFFERS; count++)
@@ -134,9 +293,9 @@ int canbuf_init(int channel)
         if(canbufID[channel][count] < 0)
         {
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("CAN: canbuf_init ERROR - Buffer Error!\n");
-            debug_print("- Channel: %d\n", channel);
-            debug_print("- Buffer: %d\n", count);
+            debug_error("CAN: canbuf_init ERROR - Buffer Error!\n");
+            debug_error("- Channel: %d\n", channel);
+            debug_error("- Buffer: %d\n", count);
             #endif
             check = 1;
         }
@@ -167,15 +326,16 @@ int canbuf_connect(int channel)
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("CAN: canbuf_init ERROR - Channel Error!\n");
-        debug_print("- Channel: %d\n", channel);
+        debug_error("CAN: canbuf_init ERROR - Channel Error!\n");
+        debug_error("- Channel: %d\n", channel);
         #endif
         return EXIT_FAILURE;
     }        
     
-    // Init Socket
+    // Init Socket on the configured interface
     i_Return = EXIT_SUCCESS;
-    i_Check = socketcan_open(channel);
+    canbuf_getInterface(channel, canbufInterface[channel]);
+    i_Check = socketcan_open(canbufInterface[channel]);
     if (i_Check < 0)
     {
         i_Return = EXIT_FAILURE;
@@ -228,8 +388,8 @@ int canbuf_close(int channel, int cleanBuffers)
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("CAN: canbuf_close ERROR - Channel Error!\n");
-        debug_print("- Channel: %d\n", channel);
+        debug_error("CAN: canbuf_close ERROR - Channel Error!\n");
+        debug_error("- Channel: %d\n", channel);
         #endif
         return EXIT_FAILURE;
     }
@@ -272,8 +432,8 @@ int canbuf_getState(int channel, stateCAN_t* scp_state)
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("CAN: canbuf_getState ERROR - Channel Error!\n");
-        debug_print("- Channel: %d\n", channel);
+        debug_error("CAN: canbuf_getState ERROR - Channel Error!\n");
+        debug_error("- Channel: %d\n", channel);
         #endif
         return EXIT_FAILURE;
     }
@@ -285,12 +445,72 @@ int canbuf_getState(int channel, stateCAN_t* scp_state)
     }        
 }
 
+/** Resize the buffers and set the policies from the configuration */
+int canbuf_updateQueues(int channel)
+{
+    char name[IFNAMSIZ];
+    // Validate channel
+    if( canbuf_validateChannel(channel) == EXIT_FAILURE )
+    {
+        return EXIT_FAILURE;
+    }
+    // New interface: connect again (the connection thread opens the socket)
+    canbuf_getInterface(channel, name);
+    if( (getCANBufState(channel) == CAN_CONNECTED) && 
+            (strcmp(name, canbufInterface[channel]) != 0) )
+    {
+        canbuf_close(channel, 0);
+    }
+    // LOCK READ and WRITE: data and timestamp buffers are changed together
+    pthread_mutex_lock(&cb_read_mutex[channel]);
+    pthread_mutex_lock(&cb_write_mutex[channel]);
+    canbuf_configBuffers(channel);
+    // UNLOCK WRITE and READ
+    pthread_mutex_unlock(&cb_write_mutex[channel]);
+    pthread_mutex_unlock(&cb_read_mutex[channel]);
+    return EXIT_SUCCESS;
+}
+
+/** Number of frames dropped by the buffers (overflow) */
+int canbuf_getDropCount(int channel, unsigned long *read, 
+        unsigned long *write)
+{
+    *read = 0;
+    *write = 0;
+    // Validate channel
+    if( canbuf_validateChannel(channel) == EXIT_FAILURE )
+    {
+        return EXIT_FAILURE;
+    }
+    // Data and timestamp buffers drop the same elements
+    *read = buffer_getDropCount(canbufID[channel][CAN_READ_DATA_BUFFER]);
+    *write = buffer_getDropCount(canbufID[channel][CAN_WRITE_DATA_BUFFER]);
+    return EXIT_SUCCESS;
+}
+
+/** Number of frames in the buffers */
+int canbuf_getQueueDepth(int channel, unsigned long *read, 
+        unsigned long *write)
+{
+    *read = 0;
+    *write = 0;
+    // Validate channel
+    if( canbuf_validateChannel(channel) == EXIT_FAILURE )
+    {
+        return EXIT_FAILURE;
+    }
+    *read = buffer_dataCount(canbufID[channel][CAN_READ_DATA_BUFFER]);
+    *write = buffer_dataCount(canbufID[channel][CAN_WRITE_DATA_BUFFER]);
+    return EXIT_SUCCESS;
+}
+
 /** Set Write buffer with data from parameters */
 int canbuf_setWriteMsgToBuffer(int channel, struct can_frame* pcf_Frame, 
         unsigned long long millisecondsSinceEpoch)
 {    
     int li_index;
     int check[NUMBER_OF_CAN_WRITE_BUFFERS];
+    canbufStamp_t stamp;
     
     // Validate channel
     if( canbuf_validateChannel(channel) == EXIT_FAILURE )
@@ -299,37 +519,55 @@ int canbuf_setWriteMsgToBuffer(int channel, struct can_frame* pcf_Frame,
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("CAN: canbuf_setWriteMsgToBuffer ERROR - Channel Error!\n");
-        debug_print("- Channel: %d\n", channel);
+        debug_error("CAN: canbuf_setWriteMsgToBuffer ERROR - Channel Error!\n");
+        debug_error("- Channel: %d\n", channel);
         #endif
         return CAN_SEND_PARAMETER_ERROR;
     }
     
     // Simply add data to Publish buffers
     li_index = 0;
+    stamp.millisecondsSinceEpoch = millisecondsSinceEpoch;
     // LOCK BUFFERS: Protect data and timestamp buffers from being 
     // read/written at different times
     pthread_mutex_lock(&cb_write_mutex[channel]);
-    check[li_index] = buffer_push(canbufID[channel][CAN_WRITE_DATA_BUFFER], 
-            pcf_Frame, sizeof(*pcf_Frame));
-    li_index++;
-    check[li_index] = buffer_push(canbufID[channel][CAN_WRITE_STAMP_BUFFER], 
-            &millisecondsSinceEpoch, sizeof(millisecondsSinceEpoch));
+    // Wait for a free position (only if the overflow policy is "block"). The 
+    // lock is released while waiting - it is also needed to send.
+    if(buffer_waitNotFull(canbufID[channel][CAN_WRITE_DATA_BUFFER], 
+            &cb_write_mutex[channel]) == BUFFER_ERROR)
+    {
+        // Still full: the frame is dropped
+        check[li_index] = BUFFER_OVERFLOW;
+        li_index++;
+        check[li_index] = BUFFER_OVERFLOW;
+    }
+    else
+    {
+        check[li_index] = buffer_push(canbufID[channel][CAN_WRITE_DATA_BUFFER], 
+                pcf_Frame, sizeof(*pcf_Frame));
+        li_index++;
+        latency_stampTx(&stamp.latency, LATENCY_OUTPUT_CAN);
+        check[li_index] = buffer_push(
+                canbufID[channel][CAN_WRITE_STAMP_BUFFER], &stamp, 
+                sizeof(stamp));
+    }
     // UNLOCK BUFFERS:
     pthread_mutex_unlock(&cb_write_mutex[channel]);
     /* Check for critical errors */
     for(li_index = 0; li_index < NUMBER_OF_CAN_WRITE_BUFFERS; li_index++)
     {
-        if( check[li_index] != BUFFER_OK )
+        // Overflow is handled by the buffer policy (frame dropped)
+        if( (check[li_index] != BUFFER_OK) && 
+                (check[li_index] != BUFFER_OVERFLOW) )
         {
             /***************/
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("CAN: canbuf_setWriteMsgToBuffer - Buffer Error!\n");
-            debug_print("- Channel: %d\n", channel);
-            debug_print("- CAN Write Buffer Index: %d\n", li_index);
-            debug_print("- CAN Write Buffer Error: %d\n", check[li_index]);
+            debug_error("CAN: canbuf_setWriteMsgToBuffer - Buffer Error!\n");
+            debug_error("- Channel: %d\n", channel);
+            debug_error("- CAN Write Buffer Index: %d\n", li_index);
+            debug_error("- CAN Write Buffer Error: %d\n", check[li_index]);
             #endif
             return CAN_SEND_BUFFER_ERROR;
         }
@@ -342,7 +580,8 @@ int canbuf_setWriteMsgToBuffer(int channel, struct can_frame* pcf_Frame,
 /* CAN Send Data from Write Buffer */
 int canbuf_send(int channel)
 {
-    unsigned long long millisecondsSinceEpoch;
+    canbufStamp_t stamp;
+    unsigned long long start;
     struct can_frame cf_Frame;
     int li_position;
     int li_index;
@@ -358,8 +597,8 @@ int canbuf_send(int channel)
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("CAN: canbuf_send ERROR - Channel Error!\n");
-        debug_print("- Channel: %d\n", channel);
+        debug_error("CAN: canbuf_send ERROR - Channel Error!\n");
+        debug_error("- Channel: %d\n", channel);
         #endif
         return CAN_SEND_PARAMETER_ERROR;
     }
@@ -402,8 +641,8 @@ int canbuf_send(int channel)
             /* BUFFERNS OUT OF SYNC */
             /************************/
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("canbuf_send: Write Buffer ERROR!\n (pre-check)");
-            debug_print("- Channel: %d\n", channel);
+            debug_error("canbuf_send: Write Buffer ERROR!\n (pre-check)");
+            debug_error("- Channel: %d\n", channel);
             #endif
             // Buffers out of sync - Unlock buffers and return now
             // UNLOCK BUFFERS
@@ -430,10 +669,10 @@ int canbuf_send(int channel)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("canbuf_send: Write Buffer ERROR! (data pop)\n");
-            debug_print("- Channel: %d\n", channel);
-            debug_print("- Buffer ID: %d\n", li_position);
-            debug_print("- Data Size: %d\n", lui_size);
+            debug_error("canbuf_send: Write Buffer ERROR! (data pop)\n");
+            debug_error("- Channel: %d\n", channel);
+            debug_error("- Buffer ID: %d\n", li_position);
+            debug_error("- Data Size: %d\n", lui_size);
             #endif
             li_return = CAN_SEND_BUFFER_ERROR;
         }
@@ -444,10 +683,10 @@ int canbuf_send(int channel)
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("canbuf_send: Write Buffer ERROR - Data Size is 0!\n");
-        debug_print("- Channel: %d\n", channel);
-        debug_print("- Buffer ID: %d\n", li_position);
-        debug_print("- Data Size: %d\n", lui_size);
+        debug_error("canbuf_send: Write Buffer ERROR - Data Size is 0!\n");
+        debug_error("- Channel: %d\n", channel);
+        debug_error("- Buffer ID: %d\n", li_position);
+        debug_error("- Data Size: %d\n", lui_size);
         #endif
         li_return = CAN_SEND_BUFFER_ERROR;
     }
@@ -456,16 +695,15 @@ int canbuf_send(int channel)
     lui_size = buffer_popSize(canbufID[channel][li_position]);
     if(lui_size > 0)
     {
-        li_temp = buffer_pop(canbufID[channel][li_position], 
-                &millisecondsSinceEpoch, sizeof(millisecondsSinceEpoch));
-        if( (li_temp != BUFFER_OK) || 
-                (lui_size != sizeof(millisecondsSinceEpoch)) )
+        li_temp = buffer_pop(canbufID[channel][li_position], &stamp, 
+                sizeof(stamp));
+        if( (li_temp != BUFFER_OK) || (lui_size != sizeof(stamp)) )
         {
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("canbuf_send: Write Buffer ERROR! (timestamp pop)\n");
-            debug_print("- Channel: %d\n", channel);
-            debug_print("- Buffer ID: %d\n", li_position);
-            debug_print("- Data Size: %d\n", lui_size);
+            debug_error("canbuf_send: Write Buffer ERROR! (timestamp pop)\n");
+            debug_error("- Channel: %d\n", channel);
+            debug_error("- Buffer ID: %d\n", li_position);
+            debug_error("- Data Size: %d\n", lui_size);
             #endif
             li_return = CAN_SEND_BUFFER_ERROR;
         }
@@ -476,10 +714,10 @@ int canbuf_send(int channel)
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("canbuf_send: Write Buffer ERROR - Data Size is 0!\n");
-        debug_print("- Channel: %d\n", channel);
-        debug_print("- Buffer ID: %d\n", li_position);
-        debug_print("- Data Size: %d\n", lui_size);
+        debug_error("canbuf_send: Write Buffer ERROR - Data Size is 0!\n");
+        debug_error("- Channel: %d\n", channel);
+        debug_error("- Buffer ID: %d\n", li_position);
+        debug_error("- Data Size: %d\n", lui_size);
         #endif
         li_return = CAN_SEND_BUFFER_ERROR;
     }
@@ -495,23 +733,27 @@ int canbuf_send(int channel)
     *******************************************************************/
     // Send Data - At this point all buffers and data sizes are validated
     #ifdef DEBUG_CANBUF_SEND
-    debug_printCAN("canbuf_send: There is data to be sent:\n", &cf_Frame);
+    debug_verboseCAN("canbuf_send: There is data to be sent:\n", &cf_Frame);
     #endif
+    start = latency_sendStart(&stamp.latency);
     li_temp = socketcan_write(fd[channel], &cf_Frame);
     if(li_temp < 0)
     {
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("canbuf_send: Socket Write ERROR!\n");
-        debug_print("- Channel: %d\n", channel);
-        debug_print("- Error: %d\n", li_temp);
+        debug_error("canbuf_send: Socket Write ERROR!\n");
+        debug_error("- Channel: %d\n", channel);
+        debug_error("- Error: %d\n", li_temp);
         #endif
         return CAN_SEND_SOCKET_ERROR;
     }
     else
     {
         #ifdef DEBUG_CANBUF_SEND
-        debug_print("canbuf_send: Data sent!\n");
+        debug_verbose("canbuf_send: Data sent!\n");
         #endif
+        latency_sent(&stamp.latency, start);
+        metrics_add(METRICS_CAN_TX_FRAMES, channel, 1);
+        trace_record(channel, TRACE_TX, &cf_Frame, aux_getmsSinceEpoch());
         return CAN_SEND_OK;
     }
 }
@@ -526,6 +768,7 @@ int canbuf_getReadMsgFromBuffer(int channel, struct can_frame* pcf_Frame,
     int li_temp;
     unsigned int lui_size;
     int li_return = CAN_RECEIVE_OK;
+    canbufStamp_t stamp;
     
     // Validate channel
     if( canbuf_validateChannel(channel) == EXIT_FAILURE )
@@ -534,8 +777,8 @@ int canbuf_getReadMsgFromBuffer(int channel, struct can_frame* pcf_Frame,
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("CAN: canbuf_getReadMsgFromBuffer - Channel Error!\n");
-        debug_print("- Channel: %d\n", channel);
+        debug_error("CAN: canbuf_getReadMsgFromBuffer - Channel Error!\n");
+        debug_error("- Channel: %d\n", channel);
         #endif
         return CAN_RECEIVE_PARAMETER_ERROR;
     }    
@@ -577,8 +820,8 @@ int canbuf_getReadMsgFromBuffer(int channel, struct can_frame* pcf_Frame,
             /* BUFFER OUT OF SYNC */
             /**********************/
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("CAN: Read Buffer ERROR!");
-            debug_print("- Channel: %d\n", channel);
+            debug_error("CAN: Read Buffer ERROR!");
+            debug_error("- Channel: %d\n", channel);
             #endif
             // Buffers out of sync: Unlock buffer and return now
             // UNLOCK BUFFER
@@ -605,10 +848,10 @@ int canbuf_getReadMsgFromBuffer(int channel, struct can_frame* pcf_Frame,
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("CAN: Read Buffer ERROR!\n");
-            debug_print("- Channel: %d\n", channel);
-            debug_print("- Buffer ID: %d\n", li_position);
-            debug_print("- Data Size: %d\n", lui_size);
+            debug_error("CAN: Read Buffer ERROR!\n");
+            debug_error("- Channel: %d\n", channel);
+            debug_error("- Buffer ID: %d\n", li_position);
+            debug_error("- Data Size: %d\n", lui_size);
             #endif
             li_return = CAN_RECEIVE_BUFFER_ERROR;
         }
@@ -619,10 +862,10 @@ int canbuf_getReadMsgFromBuffer(int channel, struct can_frame* pcf_Frame,
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("CAN: Read Buffer ERROR - Data Size is 0!\n");
-        debug_print("- Channel: %d\n", channel);
-        debug_print("- Buffer ID: %d\n", li_position);
-        debug_print("- Data Size: %d\n", lui_size);
+        debug_error("CAN: Read Buffer ERROR - Data Size is 0!\n");
+        debug_error("- Channel: %d\n", channel);
+        debug_error("- Buffer ID: %d\n", li_position);
+        debug_error("- Data Size: %d\n", lui_size);
         #endif
         li_return = CAN_RECEIVE_BUFFER_ERROR;
     }
@@ -631,16 +874,15 @@ int canbuf_getReadMsgFromBuffer(int channel, struct can_frame* pcf_Frame,
     lui_size = buffer_popSize(canbufID[channel][li_position]);
     if(lui_size > 0)
     {
-        li_temp = buffer_pop(canbufID[channel][li_position], 
-                millisecondsSinceEpoch, sizeof(*millisecondsSinceEpoch));
-        if( (li_temp != BUFFER_OK) || 
-                (lui_size != sizeof(*millisecondsSinceEpoch)) )
+        li_temp = buffer_pop(canbufID[channel][li_position], &stamp, 
+                sizeof(stamp));
+        if( (li_temp != BUFFER_OK) || (lui_size != sizeof(stamp)) )
         {
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("CAN: Read Buffer ERROR!\n");
-            debug_print("- Channel: %d\n", channel);
-            debug_print("- Buffer ID: %d\n", li_position);
-            debug_print("- Data Size: %d\n", lui_size);
+            debug_error("CAN: Read Buffer ERROR!\n");
+            debug_error("- Channel: %d\n", channel);
+            debug_error("- Buffer ID: %d\n", li_position);
+            debug_error("- Data Size: %d\n", lui_size);
             #endif
             li_return = CAN_RECEIVE_BUFFER_ERROR;
         }
@@ -651,15 +893,20 @@ int canbuf_getReadMsgFromBuffer(int channel, struct can_frame* pcf_Frame,
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("CAN: Read Buffer ERROR - Data Size is 0!\n");
-        debug_print("- Channel: %d\n", channel);
-        debug_print("- Buffer ID: %d\n", li_position);
-        debug_print("- Data Size: %d\n", lui_size);
+        debug_error("CAN: Read Buffer ERROR - Data Size is 0!\n");
+        debug_error("- Channel: %d\n", channel);
+        debug_error("- Buffer ID: %d\n", li_position);
+        debug_error("- Data Size: %d\n", lui_size);
         #endif
         li_return = CAN_RECEIVE_BUFFER_ERROR;
     }
     // UNLOCK BUFFERS:
     pthread_mutex_unlock(&cb_read_mutex[channel]);    
+    if(li_return == CAN_RECEIVE_OK)
+    {
+        *millisecondsSinceEpoch = stamp.millisecondsSinceEpoch;
+        latency_dequeued(&stamp.latency);
+    }
     // Return
     return li_return;
 }
@@ -667,7 +914,7 @@ int canbuf_getReadMsgFromBuffer(int channel, struct can_frame* pcf_Frame,
 /* CAN read Data and fill Read Buffer */
 int canbuf_receive(int channel, int timeout)
 {
-    unsigned long long millisecondsSinceEpoch;
+    canbufStamp_t stamp;
     int socketReturn;
     struct can_frame cf_Frame;
     int check[NUMBER_OF_CAN_READ_BUFFERS];
@@ -681,7 +928,7 @@ int canbuf_receive(int channel, int timeout)
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_CANBUF_ERRORS
-        debug_print("CAN: Socket Read ERROR - Channel Error!\n");
+        debug_error("CAN: Socket Read ERROR - Channel Error!\n");
         #endif
         return CAN_RECEIVE_PARAMETER_ERROR;
     }
@@ -694,7 +941,11 @@ int canbuf_receive(int channel, int timeout)
     {
         case SOCKETCAN_OK:
             // Get Timestamp
-            millisecondsSinceEpoch = aux_getmsSinceEpoch();
+            stamp.millisecondsSinceEpoch = aux_getmsSinceEpoch();
+            latency_stampRx(&stamp.latency, LATENCY_PATH_CAN2MQTT);
+            metrics_add(METRICS_CAN_RX_FRAMES, channel, 1);
+            trace_record(channel, TRACE_RX, &cf_Frame, 
+                    stamp.millisecondsSinceEpoch);
             break;
 
         case SOCKETCAN_TIMEOUT:
@@ -706,7 +957,7 @@ int canbuf_receive(int channel, int timeout)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("CAN: Socket Read ERROR - SOCKETCAN_ERROR!\n");
+            debug_error("CAN: Socket Read ERROR - SOCKETCAN_ERROR!\n");
             #endif
             return CAN_RECEIVE_SOCKET_ERROR;
             break;
@@ -716,7 +967,7 @@ int canbuf_receive(int channel, int timeout)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("CAN: Socket Read ERROR - SOCKETCAN_OTHER_ERROR!\n");
+            debug_error("CAN: Socket Read ERROR - SOCKETCAN_OTHER_ERROR!\n");
             #endif
             return CAN_RECEIVE_SOCKET_ERROR;
             break;
@@ -726,7 +977,7 @@ int canbuf_receive(int channel, int timeout)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("CAN: Socket Read ERROR - NON-STANDARD ERROR!\n");
+            debug_error("CAN: Socket Read ERROR - NON-STANDARD ERROR!\n");
             #endif
             return CAN_RECEIVE_SOCKET_ERROR;
             break;
@@ -742,25 +993,40 @@ int canbuf_receive(int channel, int timeout)
     // LOCK BUFFERS: Protect data and timestamp buffers from being read/written 
     // at different times
     pthread_mutex_lock(&cb_read_mutex[channel]);
-    check[li_index] = buffer_push(canbufID[channel][li_position], &cf_Frame, 
-            sizeof(cf_Frame));
-    li_position++;
-    li_index++;
-    check[li_index] = buffer_push(canbufID[channel][li_position], 
-            &millisecondsSinceEpoch, sizeof(millisecondsSinceEpoch));
+    // Wait for a free position (only if the overflow policy is "block"). The 
+    // lock is released while waiting - it is also needed to read.
+    if(buffer_waitNotFull(canbufID[channel][li_position], 
+            &cb_read_mutex[channel]) == BUFFER_ERROR)
+    {
+        // Still full: the frame is dropped
+        check[li_index] = BUFFER_OVERFLOW;
+        li_index++;
+        check[li_index] = BUFFER_OVERFLOW;
+    }
+    else
+    {
+        check[li_index] = buffer_push(canbufID[channel][li_position], 
+                &cf_Frame, sizeof(cf_Frame));
+        li_position++;
+        li_index++;
+        check[li_index] = buffer_push(canbufID[channel][li_position], &stamp, 
+                sizeof(stamp));
+    }
     // UNLOCK BUFFERS:
     pthread_mutex_unlock(&cb_read_mutex[channel]);
     
     /* Check for critical errors */
     for(li_index = 0; li_index < NUMBER_OF_CAN_READ_BUFFERS; li_index++)
     {
-        if( check[li_index] != BUFFER_OK )
+        // Overflow is handled by the buffer policy (frame dropped)
+        if( (check[li_index] != BUFFER_OK) && 
+                (check[li_index] != BUFFER_OVERFLOW) )
         {
             /***************/
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_CANBUF_ERRORS
-            debug_print("CAN: Socket Read ERROR - Buffer ERROR!\n");
+            debug_error("CAN: Socket Read ERROR - Buffer ERROR!\n");
             #endif
             return CAN_RECEIVE_BUFFER_ERROR;
         }
@@ -6,6 +6,19 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add canbuf_getDropCount (frames dropped by the overflow policy)          //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add canbuf_updateQueues (buffer sizes and policies after a reload)       //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add canbuf_getQueueDepth (metrics)                                       //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Up to SOCKETCAN_CHANNELS channels, interface of each channel from        //
+// "canInterfaces". Add canbuf_getChannels                                    //
+//----------------------------------------------------------------------------//
 
 #ifndef CANBUF_H
 #define CANBUF_H
@@ -20,12 +33,15 @@ extern "C" {
 //----------------------------------------------------------------------------//
 // EXTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
-#define CAN_BUFFER_SIZE    60
+#define CAN_BUFFER_SIZE    60  // Default - canRead/canWriteQueueSize
+#define CAN_DEFAULT_INTERFACE   "can0"  // Channel 0 if no canInterfaces
 enum
 {
     SOCKETCAN_CHANNEL_0 = 0, // First CAN channel
-    // SOCKETCAN_CHANNEL_1, // Second CAN channel
-    SOCKETCAN_CHANNELS
+    SOCKETCAN_CHANNEL_1,     // Second CAN channel
+    SOCKETCAN_CHANNEL_2,
+    SOCKETCAN_CHANNEL_3,
+    SOCKETCAN_CHANNELS       // Maximum number of channels
 };
 enum
 {
@@ -61,10 +77,17 @@ typedef enum
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
+/**
+ * Number of CAN channels: one for each interface of "canInterfaces" (e.g. 
+ * ["can0", "can1"]), up to SOCKETCAN_CHANNELS; 1 (CAN_DEFAULT_INTERFACE) if 
+ * not configured. Read once - a new number of channels needs a restart.
+ * \return  number of channels
+ */
+int canbuf_getChannels(void);
+
 /**
  * CAN Buffers Initialization
- * \param   channel     Channel 0 (SOCKETCAN_CHANNEL_0): can0 
- *                      Channel 1 (SOCKETCAN_CHANNEL_1): can1
+ * \param   channel     CAN channel: 0 to canbuf_getChannels() - 1
  * \return  EXIT_SUCCESS
  *          EXIT_FAILURE (Close and Reinit Buffers)
  */
@@ -72,8 +95,7 @@ int canbuf_init(int channel);
 
 /**
  * CAN Initialization - Socket Connection
- * \param   channel     Channel 0 (SOCKETCAN_CHANNEL_0): can0 
- *                      Channel 1 (SOCKETCAN_CHANNEL_1): can1
+ * \param   channel     CAN channel: 0 to canbuf_getChannels() - 1
  * \return  EXIT_SUCCESS
  *          EXIT_FAILURE (Close and Reinit Buffers)
  */
@@ -81,8 +103,7 @@ int canbuf_connect(int channel);
 
 /**
  * CAN Close connection: Close socket, re-inits buffers if needed.
- * \param   channel     Channel 0 (SOCKETCAN_CHANNEL_0): can0 
- *                      Channel 1 (SOCKETCAN_CHANNEL_1): can1
+ * \param   channel     CAN channel: 0 to canbuf_getChannels() - 1
  * \param   cleanBuffers    if buffers shall be reinitialized (>0 = Yes)
  * \return  EXIT_SUCCESS / EXIT_FAILURE
  */
@@ -90,13 +111,42 @@ int canbuf_close(int channel, int cleanBuffers);
 
 /**
  * CAN Get State (Socket State)
- * \param   channel     Channel 0 (SOCKETCAN_CHANNEL_0): can0 
- *                      Channel 1 (SOCKETCAN_CHANNEL_1): can1
+ * \param   channel     CAN channel: 0 to canbuf_getChannels() - 1
  * \param   scp_state   State to be filled (CAN_DISCONNECTED / CAN_CONNECTED)
  * \return  EXIT_SUCCESS / EXIT_FAILURE
  */
 int canbuf_getState(int channel, stateCAN_t* scp_state);
 
+/**
+ * Resize the buffers and set the overflow policies again from the 
+ * configuration (<queue>QueueSize, <queue>QueuePolicy...). The frames stored 
+ * in the buffers are kept. If the interface of the channel has changed, the
+ * socket is closed (to be connected again to the new interface).
+ * \param   channel     CAN channel: 0 to canbuf_getChannels() - 1
+ * \return  EXIT_SUCCESS / EXIT_FAILURE
+ */
+int canbuf_updateQueues(int channel);
+
+/**
+ * Number of frames dropped by the overflow policy of the buffers - Monitoring
+ * \param   channel     CAN channel: 0 to canbuf_getChannels() - 1
+ * \param   read        frames dropped from the read buffer (OUTPUT)
+ * \param   write       frames dropped from the write buffer (OUTPUT)
+ * \return  EXIT_SUCCESS / EXIT_FAILURE
+ */
+int canbuf_getDropCount(int channel, unsigned long *read, 
+        unsigned long *write);
+
+/**
+ * Number of frames in the buffers - Monitoring
+ * \param   channel     CAN channel: 0 to canbuf_getChannels() - 1
+ * \param   read        frames in the read buffer (OUTPUT)
+ * \param   write       frames in the write buffer (OUTPUT)
+ * \return  EXIT_SUCCESS / EXIT_FAILURE
+ */
+int canbuf_getQueueDepth(int channel, unsigned long *read, 
+        unsigned long *write);
+
 /**
  * Set Write buffer with data from parameters.
  * 
@@ -112,8 +162,7 @@ int canbuf_setWriteMsgToBuffer(int channel, struct can_frame* pcf_Frame, unsigne
 /**
  * CAN Send Data from Write Buffer
  * 
- * \param   channel     Channel 0 (SOCKETCAN_CHANNEL_0): can0 
- *                      Channel 1 (SOCKETCAN_CHANNEL_1): can1
+ * \param   channel     CAN channel: 0 to canbuf_getChannels() - 1
  * \return  CAN_SEND_OK                 if data was sent
  *          CAN_SEND_NO_DATA            if no data available to be sent
  *          CAN_SEND_BUFFER_ERROR       if no data was sent due to buffer error
@@ -139,8 +188,7 @@ int canbuf_getReadMsgFromBuffer(int channel, struct can_frame* pcf_Frame, unsign
  * CAN read Data and fill Read Buffer
  * \param   timeout     timeout to wait for data on each channel in milliseconds
  *                      -1 equals to no timeout
- * \param   channel     Channel 0 (SOCKETCAN_CHANNEL_0): can0 
- *                      Channel 1 (SOCKETCAN_CHANNEL_1): can1
+ * \param   channel     CAN channel: 0 to canbuf_getChannels() - 1
  * \return  CAN_RECEIVE_OK              if data was received
  *          CAN_RECEIVE_NO_DATA         if no data was received due to timeout
  *          CAN_RECEIVE_BUFFER_ERROR    if no data was received due to buffer error
@@ -0,0 +1,194 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_CAN
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "canbuf.h"
+#include "canroute.h"
+#include "debug.h"
+#include "hapcan.h"
+#include "jsonhandler.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+// Route of a node / group: 0 (unknown), channel + 1 or CANROUTE_MULTIPLE,
+// with CANROUTE_CONFIGURED if set by the configuration (not learned)
+#define CANROUTE_UNKNOWN        0x00
+#define CANROUTE_MULTIPLE       0x7F
+#define CANROUTE_CHANNEL_MASK   0x7F
+#define CANROUTE_CONFIGURED     0x80
+#define CANROUTE_SECTION        "CANRoutes"
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+// Routes are read by every thread writing to the bus: single bytes, a route
+// being changed is either the old or the new one
+static volatile uint8_t g_node[256][256];   // [group][node]
+static volatile uint8_t g_group[256];
+// Learning and configuration (writers only)
+static pthread_mutex_t g_route_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static void addToGroup(int group, uint8_t route);
+
+// Add a node route to its group: one channel or CANROUTE_MULTIPLE
+static void addToGroup(int group, uint8_t route)
+{
+    uint8_t current = g_group[group];
+    if((current & CANROUTE_CHANNEL_MASK) == CANROUTE_UNKNOWN)
+    {
+        g_group[group] = route;
+    }
+    else if((current & CANROUTE_CHANNEL_MASK) !=
+            (route & CANROUTE_CHANNEL_MASK))
+    {
+        g_group[group] = (current & CANROUTE_CONFIGURED) | CANROUTE_MULTIPLE;
+    }
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/* Read the configured routes */
+void canroute_init(void)
+{
+    int i;
+    int j;
+    int n_routes;
+    int channel;
+    int node;
+    int group;
+    int check;
+    uint8_t route;
+    // LOCK ROUTES
+    pthread_mutex_lock(&g_route_mutex);
+    //------------------------------------------------
+    // Remove the routes of the previous configuration
+    //------------------------------------------------
+    for(i = 0; i < 256; i++)
+    {
+        if(g_group[i] & CANROUTE_CONFIGURED)
+        {
+            g_group[i] = CANROUTE_UNKNOWN;
+        }
+        for(j = 0; j < 256; j++)
+        {
+            if(g_node[i][j] & CANROUTE_CONFIGURED)
+            {
+                g_node[i][j] = CANROUTE_UNKNOWN;
+            }
+        }
+    }
+    //------------------------------------------------
+    // Configured routes (optional section)
+    //------------------------------------------------
+    check = jh_getJArrayElements(CANROUTE_SECTION, 0, NULL, JSON_DEPTH_LEVEL,
+            &n_routes);
+    if(check != JSON_OK)
+    {
+        n_routes = 0;
+    }
+    for(i = 0; i < n_routes; i++)
+    {
+        check = jh_getJFieldInt(CANROUTE_SECTION, i, "channel", 0, NULL,
+                &channel);
+        if(check == JSON_OK)
+        {
+            check = jh_getJFieldInt(CANROUTE_SECTION, i, "group", 0, NULL,
+                    &group);
+        }
+        if((check != JSON_OK) || (channel < 0) ||
+                (channel >= canbuf_getChannels()) || (group < 0) ||
+                (group > 255))
+        {
+            #ifdef DEBUG_CANROUTE_ERRORS
+            debug_error("canroute_init: Route Error - Index %d\n", i);
+            #endif
+            continue;
+        }
+        route = CANROUTE_CONFIGURED | (channel + 1);
+        // Node is optional: without node, it is the route of the group
+        check = jh_getJFieldInt(CANROUTE_SECTION, i, "node", 0, NULL, &node);
+        if((check == JSON_OK) && (node >= 0) && (node <= 255))
+        {
+            g_node[group][node] = route;
+            addToGroup(group, route);
+        }
+        else
+        {
+            g_group[group] = route;
+        }
+    }
+    // UNLOCK ROUTES
+    pthread_mutex_unlock(&g_route_mutex);
+}
+
+/* Learn the channel of the node that sent a frame */
+void canroute_learn(hapcanCANData *hd_received, int channel)
+{
+    uint8_t route = channel + 1;
+    int node = hd_received->module;
+    int group = hd_received->group;
+    // Nothing changes for most of the frames - no lock
+    if((g_node[group][node] == route) ||
+            (g_node[group][node] & CANROUTE_CONFIGURED))
+    {
+        return;
+    }
+    // LOCK ROUTES
+    pthread_mutex_lock(&g_route_mutex);
+    if((g_node[group][node] & CANROUTE_CONFIGURED) == 0)
+    {
+        g_node[group][node] = route;
+        if((g_group[group] & CANROUTE_CONFIGURED) == 0)
+        {
+            addToGroup(group, route);
+        }
+    }
+    // UNLOCK ROUTES
+    pthread_mutex_unlock(&g_route_mutex);
+}
+
+/* Get the CAN channel of a frame to be sent */
+int canroute_getChannel(hapcanCANData *hd_send)
+{
+    uint8_t route;
+    // Only one channel: no need to search
+    if(canbuf_getChannels() <= 1)
+    {
+        return SOCKETCAN_CHANNEL_0;
+    }
+    // Normal messages are for every module that listens to them
+    if(hd_send->frametype >= HAPCAN_START_NORMAL_MESSAGES)
+    {
+        return CANROUTE_ALL_CHANNELS;
+    }
+    // Destination node, then destination group
+    route = g_node[hd_send->data[3]][hd_send->data[2]] & CANROUTE_CHANNEL_MASK;
+    if(route == CANROUTE_UNKNOWN)
+    {
+        route = g_group[hd_send->data[3]] & CANROUTE_CHANNEL_MASK;
+    }
+    if((route == CANROUTE_UNKNOWN) || (route == CANROUTE_MULTIPLE))
+    {
+        return CANROUTE_ALL_CHANNELS;
+    }
+    return route - 1;
+}
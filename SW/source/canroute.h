@@ -0,0 +1,60 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef CANROUTE_H
+#define CANROUTE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "hapcan.h"
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+/* Frame has to be sent to every CAN channel */
+#define CANROUTE_ALL_CHANNELS   -1
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Read the configured routes (section "CANRoutes": "channel", "group" and
+ * optional "node"). Configured routes of the previous configuration are
+ * removed; learned routes are kept.
+ */
+void canroute_init(void);
+
+/**
+ * Learn the channel of a node: the module / group that sent a frame lives on
+ * the channel the frame was received from (configured routes are not
+ * changed).
+ *
+ * \param   hd_received (INPUT) frame received
+ * \param   channel     (INPUT) CAN channel the frame was received from
+ */
+void canroute_learn(hapcanCANData *hd_received, int channel);
+
+/**
+ * Get the CAN channel of a frame to be sent. System and direct control frames
+ * (below HAPCAN_START_NORMAL_MESSAGES) go to the channel of the destination
+ * node (data[2]) / group (data[3]). Other frames, and frames to a node / group
+ * not known or on more than one channel, go to every channel.
+ *
+ * \param   hd_send     (INPUT) frame to be sent
+ * \return  CAN channel / CANROUTE_ALL_CHANNELS
+ */
+int canroute_getChannel(hapcanCANData *hd_send);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CANROUTE_H */
@@ -6,6 +6,34 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add config_getQueuePolicy (overflow policy of each queue)                //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add config_getQueueSize                                                  //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add config_getLogLevel                                                   //
+// - Debug messages use the runtime log level of DEBUG_MODULE_CONFIG          //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - New file detected with inotify (config_waitNewConfig) and checked before //
+// it replaces the current one (jh_reloadConfigFile)                          //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Add config_getFileHash (hash of the file in use - configuration cache)   //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - The configuration file is checked at start-up (errors are printed)       //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - The file is read once: the hash and the parse use the same contents      //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_CONFIG
 
 /*
 * Includes
@@ -17,6 +45,9 @@
 #include <stdbool.h>
 #include <pthread.h>
 #include <time.h>
+#include <poll.h>
+#include <libgen.h>
+#include <sys/inotify.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include "auxiliary.h"
@@ -36,6 +67,11 @@
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
 static time_t g_last_date;
+// inotify: -1 if not started / not available
+static int g_watch_fd = -1;
+static bool g_watch_init = false;
+// Hash of the file in use (same contents as the ones parsed)
+static uint64_t g_file_hash = 0;
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS
@@ -43,6 +79,10 @@ static time_t g_last_date;
 static bool getConfigFileModifiedDate(time_t *date);
 static bool isFileChanged(void);
 static void updateConfigFromFile(void);
+static char* readConfigFile(size_t *len);
+static uint64_t getHash(const char *text, size_t len);
+static void startWatch(void);
+static bool readWatchEvents(void);
 
 /**
  * Check if configuration file was changed
@@ -91,8 +131,15 @@ static bool isFileChanged(void)
  **/
 static void updateConfigFromFile(void)
 {
-    // JSON: Read File
-    jh_readConfigFile();
+    char *text;
+    size_t len;
+    // Read once: the hash matches the contents parsed
+    text = readConfigFile(&len);
+    g_file_hash = getHash(text, len);
+    // JSON: Parse File - nothing to keep at start-up: only print the errors
+    jh_readConfigFile(text);
+    jh_checkConfigFile();
+    free(text);
     // Update file date
     if( !getConfigFileModifiedDate(&g_last_date) )
     {
@@ -100,6 +147,136 @@ static void updateConfigFromFile(void)
     }
 }
 
+/**
+ * Read the contents of the configuration file
+ * \param   len     (OUTPUT) length of the contents
+ * \return   contents ending with '\0' (has to be freed), NULL if the file 
+ *           cannot be read
+ */
+static char* readConfigFile(size_t *len)
+{
+    FILE *file;
+    char *text;
+    char *temp;
+    size_t size;
+    size_t n;
+    *len = 0;
+    file = fopen(JSON_CONFIG_FILE_PATH, "rb");
+    if(file == NULL)
+    {
+        return NULL;
+    }
+    size = 4096;
+    text = malloc(size);
+    while(text != NULL)
+    {
+        n = fread(text + *len, 1, size - *len - 1, file);
+        *len += n;
+        if(n == 0)
+        {
+            break;
+        }
+        if(*len == size - 1)
+        {
+            // Full: double the size
+            size = 2*size;
+            temp = realloc(text, size);
+            if(temp == NULL)
+            {
+                free(text);
+            }
+            text = temp;
+        }
+    }
+    if((text != NULL) && ferror(file))
+    {
+        free(text);
+        text = NULL;
+    }
+    fclose(file);
+    if(text == NULL)
+    {
+        *len = 0;
+        return NULL;
+    }
+    text[*len] = '\0';
+    return text;
+}
+
+/**
+ * Hash of the contents of the configuration file (FNV-1a, 64 bits)
+ * \param   text    contents of the file (NULL if it cannot be read)
+ * \param   len     length of the contents
+ * \return   hash (0 if the file cannot be read)
+ */
+static uint64_t getHash(const char *text, size_t len)
+{
+    size_t i;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    if(text == NULL)
+    {
+        return 0;
+    }
+    for(i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)text[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * Start watching the directory of the configuration file (a file replaced by 
+ * an editor is a new file: the file itself cannot be watched)
+ **/
+static void startWatch(void)
+{
+    char path[] = JSON_CONFIG_FILE_PATH;
+    g_watch_init = true;
+    g_watch_fd = inotify_init1(IN_CLOEXEC);
+    if(g_watch_fd < 0)
+    {
+        #ifdef DEBUG_CONFIG_ERRORS
+        debug_error("config - startWatch: inotify not available!\n");
+        #endif
+        return;
+    }
+    if(inotify_add_watch(g_watch_fd, dirname(path), 
+            IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        #ifdef DEBUG_CONFIG_ERRORS
+        debug_error("config - startWatch: directory not watched!\n");
+        #endif
+        close(g_watch_fd);
+        g_watch_fd = -1;
+    }
+}
+
+/**
+ * Read the pending inotify events
+ * \return   TRUE if one of them is the configuration file
+ */
+static bool readWatchEvents(void)
+{
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    char path[] = JSON_CONFIG_FILE_PATH;
+    const char *name = basename(path);
+    const struct inotify_event *event;
+    ssize_t len;
+    ssize_t i;
+    bool ret = false;
+    len = read(g_watch_fd, buf, sizeof(buf));
+    for(i = 0; i < len; i += sizeof(*event) + event->len)
+    {
+        event = (const struct inotify_event *)&buf[i];
+        if((event->len > 0) && (strcmp(event->name, name) == 0))
+        {
+            ret = true;
+        }
+    }
+    return ret;
+}
+
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
@@ -114,6 +291,11 @@ void config_end(void)
     jh_freeConfigFile();
 }
 
+uint64_t config_getFileHash(void)
+{
+    return g_file_hash;
+}
+
 int config_isNewConfigAvailable(void)
 {
     int ret;
@@ -128,10 +310,47 @@ int config_isNewConfigAvailable(void)
     return ret;
 }
 
-void config_reload(bool *reloadMQTT, bool *reload_socket_server)
+bool config_waitNewConfig(void)
+{
+    struct pollfd pfd;
+    if(!g_watch_init)
+    {
+        startWatch();
+    }
+    //--------------------------------------
+    // No inotify: check the file date
+    //--------------------------------------
+    if(g_watch_fd < 0)
+    {
+        sleep(CONFIG_POLL_PERIOD);
+        return isFileChanged();
+    }
+    //--------------------------------------
+    // Wait (no timeout) for the file to be written
+    //--------------------------------------
+    if(!readWatchEvents())
+    {
+        return false;
+    }
+    //--------------------------------------
+    // Debounce: wait until the file is not changed for a moment
+    //--------------------------------------
+    pfd.fd = g_watch_fd;
+    pfd.events = POLLIN;
+    while(poll(&pfd, 1, CONFIG_RELOAD_DEBOUNCE) > 0)
+    {
+        readWatchEvents();
+    }
+    return true;
+}
+
+int config_reload(bool *reloadMQTT, bool *reload_socket_server)
 {        
     int check;
     bool temp;
+    uint64_t hash;
+    char *text;
+    size_t len;
     char *old_mqtt_server = NULL;
     char *new_mqtt_server = NULL;
     char *old_mqtt_ID = NULL;
@@ -192,13 +411,34 @@ void config_reload(bool *reloadMQTT, bool *reload_socket_server)
         old_port = NULL;
     }
     //--------------------------------------
-    // JSON: Free
-    //--------------------------------------
-    jh_freeConfigFile(); 
+    // Read NEW configuration file (replaces the current one only if valid)
     //--------------------------------------
-    // Read NEW configuration file
-    //--------------------------------------
-    updateConfigFromFile();
+    text = readConfigFile(&len);
+    hash = getHash(text, len);
+    check = jh_reloadConfigFile(text);
+    free(text);
+    if( !getConfigFileModifiedDate(&g_last_date) )
+    {
+        g_last_date = 0;
+    }
+    if(check != JSON_OK)
+    {
+        #ifdef DEBUG_CONFIG_ERRORS
+        debug_error("config_reload: Invalid file - configuration kept!\n");
+        #endif
+        for (i = 0; i < old_n_sub_topics; i++)
+        {
+            free(old_sub_topics[i]);
+        }
+        free(old_sub_topics);
+        free(old_mqtt_server);
+        free(old_mqtt_ID);
+        free(old_port);
+        *reloadMQTT = false;
+        *reload_socket_server = false;
+        return EXIT_FAILURE;
+    }
+    g_file_hash = hash;
     //--------------------------------------
     // Read current configurations for MQTT
     //--------------------------------------
@@ -305,6 +545,7 @@ void config_reload(bool *reloadMQTT, bool *reload_socket_server)
     free(new_mqtt_ID);
     free(old_port);
     free(new_port);
+    return EXIT_SUCCESS;
 }
 
 int config_getBool(const char *level, int levelIndex, const char *field, 
@@ -389,4 +630,122 @@ int config_getStringArray(const char *level, const char *field,
         check = EXIT_SUCCESS;
     }
     return check;
+}
+
+void config_getQueuePolicy(const char *queue, unsigned int elements, 
+        bufferPolicySettings_t *settings)
+{
+    int check;
+    int value;
+    char *policy = NULL;
+    char field[64];
+    // Defaults
+    settings->policy = BUFFER_POLICY_DROP_OLDEST;
+    settings->timeout = CONFIG_QUEUE_DEFAULT_TIMEOUT;
+    settings->maxElements = elements * CONFIG_QUEUE_DEFAULT_GROW_FACTOR;
+    // Policy
+    snprintf(field, sizeof(field), "%sQueuePolicy", queue);
+    check = config_getString(CONFIG_GENERAL_SETTINGS_LEVEL, 0, field, 0, NULL, 
+            &policy);
+    if(check == EXIT_SUCCESS)
+    {
+        if(aux_compareStrings(policy, "dropNewest"))
+        {
+            settings->policy = BUFFER_POLICY_DROP_NEWEST;
+        }
+        else if(aux_compareStrings(policy, "block"))
+        {
+            settings->policy = BUFFER_POLICY_BLOCK;
+        }
+        else if(aux_compareStrings(policy, "grow"))
+        {
+            settings->policy = BUFFER_POLICY_GROW;
+        }
+        #ifdef DEBUG_CONFIG_ERRORS
+        else if(!aux_compareStrings(policy, "dropOldest"))
+        {
+            debug_error("config_getQueuePolicy: invalid %s!\n", field);
+        }
+        #endif
+    }
+    free(policy);
+    // Timeout
+    snprintf(field, sizeof(field), "%sQueueTimeout", queue);
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0, field, 0, NULL, 
+            &value);
+    if((check == EXIT_SUCCESS) && (value >= 0))
+    {
+        settings->timeout = value;
+    }
+    // Maximum size
+    snprintf(field, sizeof(field), "%sQueueMaxSize", queue);
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0, field, 0, NULL, 
+            &value);
+    if((check == EXIT_SUCCESS) && (value > 0))
+    {
+        settings->maxElements = value;
+    }
+}
+
+unsigned int config_getQueueSize(const char *queue, 
+        unsigned int defaultElements)
+{
+    int check;
+    int value;
+    char field[64];
+    snprintf(field, sizeof(field), "%sQueueSize", queue);
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0, field, 0, NULL, 
+            &value);
+    if((check == EXIT_SUCCESS) && (value > 0))
+    {
+        return value;
+    }
+    #ifdef DEBUG_CONFIG_ERRORS
+    if(check == EXIT_SUCCESS)
+    {
+        debug_error("config_getQueueSize: invalid %s!\n", field);
+    }
+    #endif
+    return defaultElements;
+}
+
+/* Log level of a module */
+int config_getLogLevel(const char *module, int defaultLevel)
+{
+    int check;
+    int level;
+    char *value = NULL;
+    char field[64];
+    snprintf(field, sizeof(field), "%sLogLevel", module);
+    check = config_getString(CONFIG_GENERAL_SETTINGS_LEVEL, 0, field, 0, NULL, 
+            &value);
+    if(check != EXIT_SUCCESS)
+    {
+        return defaultLevel;
+    }
+    level = defaultLevel;
+    if(aux_compareStrings(value, "off"))
+    {
+        level = DEBUG_LEVEL_OFF;
+    }
+    else if(aux_compareStrings(value, "error"))
+    {
+        level = DEBUG_LEVEL_ERROR;
+    }
+    else if(aux_compareStrings(value, "info"))
+    {
+        level = DEBUG_LEVEL_INFO;
+    }
+    else if(aux_compareStrings(value, "debug"))
+    {
+        level = DEBUG_LEVEL_DEBUG;
+    }
+    #ifdef DEBUG_CONFIG_ERRORS
+    else
+    {
+        debug_error("config_getLogLevel: invalid %s!\n", field);
+    }
+    #endif
+    free(value);
+    return level;
 }
\ No newline at end of file
@@ -9,6 +9,22 @@
 //  1.01     | 01/Jul/2023 |                               | ALCP             //
 // - Use relative path for JSON config file.                                  //
 //----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add config_getQueuePolicy (overflow policy of each queue)                //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add config_getQueueSize (number of elements of each queue)               //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Add config_getLogLevel (runtime log level of each module)                //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Add config_waitNewConfig (inotify, debounced); config_reload returns     //
+// EXIT_FAILURE and keeps the current file if the new one is not valid        //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Add config_getFileHash and JSON_CONFIG_CACHE_PATH                        //
+//----------------------------------------------------------------------------//
 
 #ifndef CONFIG_H
 #define CONFIG_H
@@ -21,6 +37,8 @@ extern "C" {
 * Includes
 */
 #include <stdbool.h>
+#include <stdint.h>
+#include "buffer.h"
     
 //----------------------------------------------------------------------------//
 // EXTERNAL DEFINITIONS
@@ -28,6 +46,22 @@ extern "C" {
 #define CONFIG_GENERAL_SETTINGS_LEVEL  "GeneralSettings"
 /* Other Definitions */
 #define JSON_CONFIG_FILE_PATH  "./config.json"
+/* Configuration cache - built from the configuration file (configcache.h) */
+#define JSON_CONFIG_CACHE_PATH "./config.cache"
+/* Queue names - prefix of the queue fields in GeneralSettings */
+#define CONFIG_QUEUE_CAN_READ               "canRead"
+#define CONFIG_QUEUE_CAN_WRITE              "canWrite"
+#define CONFIG_QUEUE_MQTT_SUB               "mqttSub"
+#define CONFIG_QUEUE_MQTT_PUB               "mqttPub"
+#define CONFIG_QUEUE_SOCKETSERVER_READ      "socketServerRead"
+#define CONFIG_QUEUE_SOCKETSERVER_WRITE     "socketServerWrite"
+/* Queue defaults */
+#define CONFIG_QUEUE_DEFAULT_TIMEOUT        10  // ms
+#define CONFIG_QUEUE_DEFAULT_GROW_FACTOR    4
+/* Time without changes to the file before it is reloaded (ms) */
+#define CONFIG_RELOAD_DEBOUNCE              200
+/* Period to check the file date if inotify is not available (s) */
+#define CONFIG_POLL_PERIOD                  10
     
 //----------------------------------------------------------------------------//
 // EXTERNAL TYPES
@@ -49,6 +83,14 @@ void config_init(void);
  **/
 void config_end(void);
 
+/**
+ * Hash of the configuration file in use, read when the file was loaded 
+ * (before it was parsed).
+ * 
+ * \return  hash (0 if the file could not be read)
+ **/
+uint64_t config_getFileHash(void);
+
 /**
  * Inform if a new configuraton file is available
  * 
@@ -57,6 +99,18 @@ void config_end(void);
  **/
 int config_isNewConfigAvailable(void);
 
+/**
+ * Wait for a new configuration file: the directory of the file is watched 
+ * (inotify - file written and closed, or moved to its name). After a change, 
+ * it waits for CONFIG_RELOAD_DEBOUNCE ms without other changes, so an editor 
+ * writing the file in parts causes only one reload. If inotify is not 
+ * available, the file date is checked every CONFIG_POLL_PERIOD seconds.
+ * 
+ * \return  true    new file available
+ *          false   no new file available (call again)
+ **/
+bool config_waitNewConfig(void);
+
 /**
  * Fill the entire configuration file with data from the available file
  * \param   reloadMQTT              (OUTPUT) Flag to signal if MQTT parameters 
@@ -64,8 +118,10 @@ int config_isNewConfigAvailable(void);
  * \param   reload_socket_server   (OUTPUT) Flag to signal if socket parameters 
  *                                  were changed, and a restart is needed.
  * 
+ * \return  EXIT_SUCCESS    new file in use
+ *          EXIT_FAILURE    new file not valid - current configuration kept
  **/
-void config_reload(bool *reloadMQTT, bool *reload_socket_server);
+int config_reload(bool *reloadMQTT, bool *reload_socket_server);
 
 /**
  * Get a boolean from a JSON object
@@ -158,6 +214,42 @@ int config_getString(const char *level, int levelIndex, const char *field,
 int config_getStringArray(const char *level, const char *field, 
         int *elementslen, char ***value);
 
+/**
+ * Get the overflow policy of a queue from GeneralSettings: 
+ * <queue>QueuePolicy ("dropOldest", "dropNewest", "block", "grow"), 
+ * <queue>QueueTimeout (ms, for "block") and <queue>QueueMaxSize (for "grow").
+ * Missing / invalid fields are set with the defaults ("dropOldest", 
+ * CONFIG_QUEUE_DEFAULT_TIMEOUT, elements * CONFIG_QUEUE_DEFAULT_GROW_FACTOR).
+ * 
+ * \param   queue       queue name, e.g. CONFIG_QUEUE_CAN_READ (INPUT)
+ * \param   elements    number of elements of the queue (INPUT)
+ * \param   settings    policy settings to be filled (OUTPUT)
+ **/
+void config_getQueuePolicy(const char *queue, unsigned int elements, 
+        bufferPolicySettings_t *settings);
+
+/**
+ * Get the number of elements of a queue from GeneralSettings: 
+ * <queue>QueueSize. Missing / invalid field: defaultElements.
+ * 
+ * \param   queue           queue name, e.g. CONFIG_QUEUE_CAN_READ (INPUT)
+ * \param   defaultElements number of elements if not configured (INPUT)
+ * \return  number of elements of the queue
+ **/
+unsigned int config_getQueueSize(const char *queue, 
+        unsigned int defaultElements);
+
+/**
+ * Get the log level of a module from GeneralSettings: <module>LogLevel
+ * ("off", "error", "info" or "debug"). Missing / invalid field: 
+ * defaultLevel.
+ * 
+ * \param   module          module name, e.g. "can" (INPUT)
+ * \param   defaultLevel    level if not configured (INPUT)
+ * \return  debugLevel_t (see debug.h)
+ **/
+int config_getLogLevel(const char *module, int defaultLevel);
+
 
 #ifdef __cplusplus
 }
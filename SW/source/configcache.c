@@ -0,0 +1,664 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - The module lists are allocated before anything is added (no memory:      //
+// the cache is not used)                                                     //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_CONFIG
+
+/*
+* Includes
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "config.h"
+#include "configcache.h"
+#include "debug.h"
+#include "gateway.h"
+#include "hapcan.h"
+#include "hapcanbutton.h"
+#include "hapcanrelay.h"
+#include "hapcanrgb.h"
+#include "hapcantemperature.h"
+#include "hrgbw.h"
+#include "htim.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+#if (CCACHE_MODULE_TOPICS < HRGBW_MODULE_TOPICS) || \
+        (CCACHE_MODULE_TOPICS < HRGB_MODULE_TOPICS)
+#error "CCACHE_MODULE_TOPICS is too small"
+#endif
+#define CCACHE_TEMP_PATH        JSON_CONFIG_CACHE_PATH ".tmp"
+/* Flags of a module */
+#define CCACHE_FLAG_RGB         0x01
+#define CCACHE_FLAG_RGBW        0x02
+
+enum
+{
+    CCACHE_SECTION_ENTRIES = 0,
+    CCACHE_SECTION_RGB,
+    CCACHE_SECTION_RGBW,
+    CCACHE_SECTION_CONTEXT,
+    CCACHE_SECTION_STRINGS,
+    CCACHE_N_SECTIONS
+};
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+typedef struct
+{
+    uint32_t offset;    // from the start of the image
+    uint32_t len;       // bytes
+} ccacheSection_t;
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t entrySize;
+    uint32_t moduleSize;
+    uint32_t nHandlers;
+    uint32_t reserved;
+    uint64_t hash;      // config_getFileHash of the file it was built from
+    ccacheSection_t section[CCACHE_N_SECTIONS];
+} ccacheHeader_t;
+
+// Gateway element (see gateway_AddElementToList)
+typedef struct
+{
+    hapcanCANData hd_mask;
+    hapcanCANData hd_check;
+    hapcanCANData hd_result;
+    uint32_t state_topic;   // offset in the string table / CCACHE_NO_STRING
+    uint32_t command_topic; // offset in the string table / CCACHE_NO_STRING
+    uint32_t context;       // offset in the context section
+    uint32_t context_len;
+    uint8_t list;
+    uint8_t handler;        // index of g_handlers
+} ccacheEntry_t;
+
+// Module of the RGB / RGBW lists
+typedef struct
+{
+    uint8_t node;
+    uint8_t group;
+    uint8_t flags;
+    uint32_t state_str[CCACHE_MODULE_TOPICS];  // offset / CCACHE_NO_STRING
+} ccacheModule_t;
+
+// Section being built
+typedef struct
+{
+    uint8_t *data;
+    size_t len;
+    size_t size;
+} ccacheBuffer_t;
+
+// Image being built
+typedef struct
+{
+    ccacheBuffer_t section[CCACHE_N_SECTIONS];
+    int list;       // list being walked
+    bool error;
+} ccacheBuilder_t;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+// Handlers of the gateway elements - the index is stored in the image (add new
+// handlers at the end and change CCACHE_VERSION if this table changes)
+static const gatewayHandler g_handlers[] =
+{
+    {hrelay_setCAN2MQTTResponse, hrelay_setMQTT2CANResponse},
+    {hbutton_setCAN2MQTTResponse, hbutton_setMQTT2CANResponse},
+    {htemp_setCAN2MQTTResponse, htemp_setMQTT2CANResponse},
+    {hrgb_setCAN2MQTTResponse, hrgb_setMQTT2CANResponse},
+    {hrgbw_setCAN2MQTTResponse, hrgbw_setMQTT2CANResponse},
+    {htim_setCAN2MQTTResponse, htim_setMQTT2CANResponse}
+};
+static const int g_nHandlers = sizeof(g_handlers) / sizeof(g_handlers[0]);
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static bool isEnabled(void);
+static uint32_t bufAppend(ccacheBuffer_t *buf, const void *data, size_t len,
+        bool *error);
+static uint32_t addString(ccacheBuilder_t *b, const char *str);
+static void addEntry(const gatewayEntry *entry, void *arg);
+static void addRGBModule(const hrgbModule *module, void *arg);
+static void addRGBWModule(const hrgbwModule *module, void *arg);
+static int writeImage(ccacheBuilder_t *b, uint64_t hash);
+static bool checkString(const ccacheHeader_t *h, uint32_t offset);
+static bool checkImage(const uint8_t *image, size_t size);
+static const char* getString(const uint8_t *image, uint32_t offset);
+static void loadEntries(const uint8_t *image);
+static int allocModules(const uint8_t *image, hrgbModule **rgb,
+        hrgbwModule **rgbw);
+static void loadModules(const uint8_t *image, hrgbModule *rgb,
+        hrgbwModule *rgbw);
+
+// Cache enabled (GeneralSettings: configCache, default true)
+static bool isEnabled(void)
+{
+    int check;
+    bool enable;
+    check = config_getBool(CONFIG_GENERAL_SETTINGS_LEVEL, 0, "configCache", 0,
+            NULL, &enable);
+    return (check != EXIT_SUCCESS) || enable;
+}
+
+// Append data to a section - returns its offset in the section
+static uint32_t bufAppend(ccacheBuffer_t *buf, const void *data, size_t len,
+        bool *error)
+{
+    uint32_t offset;
+    uint8_t *p;
+    size_t size;
+    if(*error)
+    {
+        return 0;
+    }
+    if(buf->len + len > buf->size)
+    {
+        size = (buf->size == 0) ? 4096 : buf->size;
+        while(size < buf->len + len)
+        {
+            size *= 2;
+        }
+        p = realloc(buf->data, size);
+        if(p == NULL)
+        {
+            *error = true;
+            return 0;
+        }
+        buf->data = p;
+        buf->size = size;
+    }
+    offset = buf->len;
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    return offset;
+}
+
+// Add a topic to the string table
+static uint32_t addString(ccacheBuilder_t *b, const char *str)
+{
+    if(str == NULL)
+    {
+        return CCACHE_NO_STRING;
+    }
+    return bufAppend(&b->section[CCACHE_SECTION_STRINGS], str,
+            strlen(str) + 1, &b->error);
+}
+
+// gateway_walkList: add an element
+static void addEntry(const gatewayEntry *entry, void *arg)
+{
+    ccacheBuilder_t *b = (ccacheBuilder_t *)arg;
+    ccacheEntry_t e;
+    int i;
+    memset(&e, 0, sizeof(e));
+    for(i = 0; i < g_nHandlers; i++)
+    {
+        if((g_handlers[i].can2mqtt == entry->handler.can2mqtt) &&
+                (g_handlers[i].mqtt2can == entry->handler.mqtt2can))
+        {
+            break;
+        }
+    }
+    if(i == g_nHandlers)
+    {
+        // Handler not in the table: the element cannot be cached
+        b->error = true;
+        return;
+    }
+    e.handler = i;
+    e.list = b->list;
+    e.hd_mask = entry->hd_mask;
+    e.hd_check = entry->hd_check;
+    e.hd_result = entry->hd_result;
+    e.state_topic = addString(b, entry->state_topic);
+    e.command_topic = addString(b, entry->command_topic);
+    e.context_len = 0;
+    if((entry->context != NULL) && (entry->context_len > 0))
+    {
+        e.context = bufAppend(&b->section[CCACHE_SECTION_CONTEXT],
+                entry->context, entry->context_len, &b->error);
+        e.context_len = entry->context_len;
+    }
+    bufAppend(&b->section[CCACHE_SECTION_ENTRIES], &e, sizeof(e), &b->error);
+}
+
+// hrgb_walkModules: add a module
+static void addRGBModule(const hrgbModule *module, void *arg)
+{
+    ccacheBuilder_t *b = (ccacheBuilder_t *)arg;
+    ccacheModule_t m;
+    int i;
+    memset(&m, 0, sizeof(m));
+    m.node = module->node;
+    m.group = module->group;
+    m.flags = module->isRGB ? CCACHE_FLAG_RGB : 0;
+    for(i = 0; i < CCACHE_MODULE_TOPICS; i++)
+    {
+        m.state_str[i] = (i < HRGB_MODULE_TOPICS) ?
+                addString(b, module->state_str[i]) : CCACHE_NO_STRING;
+    }
+    bufAppend(&b->section[CCACHE_SECTION_RGB], &m, sizeof(m), &b->error);
+}
+
+// hrgbw_walkModules: add a module
+static void addRGBWModule(const hrgbwModule *module, void *arg)
+{
+    ccacheBuilder_t *b = (ccacheBuilder_t *)arg;
+    ccacheModule_t m;
+    int i;
+    memset(&m, 0, sizeof(m));
+    m.node = module->node;
+    m.group = module->group;
+    m.flags = (module->isRGB ? CCACHE_FLAG_RGB : 0) |
+            (module->isRGBW ? CCACHE_FLAG_RGBW : 0);
+    for(i = 0; i < CCACHE_MODULE_TOPICS; i++)
+    {
+        m.state_str[i] = (i < HRGBW_MODULE_TOPICS) ?
+                addString(b, module->state_str[i]) : CCACHE_NO_STRING;
+    }
+    bufAppend(&b->section[CCACHE_SECTION_RGBW], &m, sizeof(m), &b->error);
+}
+
+// Write the image to a temporary file and rename it
+static int writeImage(ccacheBuilder_t *b, uint64_t hash)
+{
+    FILE *file;
+    ccacheHeader_t h;
+    static const uint8_t pad[CCACHE_ALIGN] = {0};
+    size_t offset;
+    size_t padLen;
+    bool ok;
+    int i;
+    //--------------------------------------
+    // Header
+    //--------------------------------------
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CCACHE_MAGIC, sizeof(h.magic));
+    h.version = CCACHE_VERSION;
+    h.headerSize = sizeof(ccacheHeader_t);
+    h.entrySize = sizeof(ccacheEntry_t);
+    h.moduleSize = sizeof(ccacheModule_t);
+    h.nHandlers = g_nHandlers;
+    h.hash = hash;
+    offset = sizeof(h);
+    for(i = 0; i < CCACHE_N_SECTIONS; i++)
+    {
+        offset = (offset + CCACHE_ALIGN - 1) & ~(size_t)(CCACHE_ALIGN - 1);
+        h.section[i].offset = offset;
+        h.section[i].len = b->section[i].len;
+        offset += b->section[i].len;
+    }
+    //--------------------------------------
+    // Sections
+    //--------------------------------------
+    file = fopen(CCACHE_TEMP_PATH, "wb");
+    if(file == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+    ok = (fwrite(&h, sizeof(h), 1, file) == 1);
+    offset = sizeof(h);
+    for(i = 0; ok && (i < CCACHE_N_SECTIONS); i++)
+    {
+        padLen = h.section[i].offset - offset;
+        if(padLen > 0)
+        {
+            ok = (fwrite(pad, 1, padLen, file) == padLen);
+        }
+        if(ok && (b->section[i].len > 0))
+        {
+            ok = (fwrite(b->section[i].data, 1, b->section[i].len, file) ==
+                    b->section[i].len);
+        }
+        offset = h.section[i].offset + h.section[i].len;
+    }
+    ok = (fclose(file) == 0) && ok;
+    // Replace the cache only when the new one is complete
+    if(!ok || (rename(CCACHE_TEMP_PATH, JSON_CONFIG_CACHE_PATH) != 0))
+    {
+        unlink(CCACHE_TEMP_PATH);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Topic offset inside the string table (the table ends with '\0')
+static bool checkString(const ccacheHeader_t *h, uint32_t offset)
+{
+    return (offset == CCACHE_NO_STRING) ||
+            (offset < h->section[CCACHE_SECTION_STRINGS].len);
+}
+
+// Check the whole image before anything is added
+static bool checkImage(const uint8_t *image, size_t size)
+{
+    const ccacheHeader_t *h = (const ccacheHeader_t *)image;
+    const ccacheEntry_t *e;
+    const ccacheModule_t *m;
+    uint32_t n;
+    uint32_t i;
+    int s;
+    int t;
+    //--------------------------------------
+    // Header: same format and same configuration file
+    //--------------------------------------
+    if((size < sizeof(*h)) ||
+            (memcmp(h->magic, CCACHE_MAGIC, sizeof(h->magic)) != 0) ||
+            (h->version != CCACHE_VERSION) ||
+            (h->headerSize != sizeof(ccacheHeader_t)) ||
+            (h->entrySize != sizeof(ccacheEntry_t)) ||
+            (h->moduleSize != sizeof(ccacheModule_t)) ||
+            (h->nHandlers != g_nHandlers) ||
+            (h->hash == 0) || (h->hash != config_getFileHash()))
+    {
+        return false;
+    }
+    //--------------------------------------
+    // Sections
+    //--------------------------------------
+    for(s = 0; s < CCACHE_N_SECTIONS; s++)
+    {
+        if((h->section[s].offset % CCACHE_ALIGN != 0) ||
+                (h->section[s].offset > size) ||
+                (h->section[s].len > size - h->section[s].offset))
+        {
+            return false;
+        }
+    }
+    if((h->section[CCACHE_SECTION_ENTRIES].len % sizeof(ccacheEntry_t)) ||
+            (h->section[CCACHE_SECTION_RGB].len % sizeof(ccacheModule_t)) ||
+            (h->section[CCACHE_SECTION_RGBW].len % sizeof(ccacheModule_t)))
+    {
+        return false;
+    }
+    n = h->section[CCACHE_SECTION_STRINGS].len;
+    if((n > 0) && (image[h->section[CCACHE_SECTION_STRINGS].offset + n - 1]
+            != '\0'))
+    {
+        return false;
+    }
+    //--------------------------------------
+    // Gateway elements
+    //--------------------------------------
+    e = (const ccacheEntry_t *)(image +
+            h->section[CCACHE_SECTION_ENTRIES].offset);
+    n = h->section[CCACHE_SECTION_ENTRIES].len / sizeof(ccacheEntry_t);
+    for(i = 0; i < n; i++)
+    {
+        if((e[i].list >= NUMBER_OF_GATEWAY_LISTS) ||
+                (e[i].handler >= g_nHandlers) ||
+                !checkString(h, e[i].state_topic) ||
+                !checkString(h, e[i].command_topic) ||
+                (e[i].context > h->section[CCACHE_SECTION_CONTEXT].len) ||
+                (e[i].context_len > h->section[CCACHE_SECTION_CONTEXT].len -
+                e[i].context))
+        {
+            return false;
+        }
+    }
+    //--------------------------------------
+    // Modules
+    //--------------------------------------
+    for(s = CCACHE_SECTION_RGB; s <= CCACHE_SECTION_RGBW; s++)
+    {
+        m = (const ccacheModule_t *)(image + h->section[s].offset);
+        n = h->section[s].len / sizeof(ccacheModule_t);
+        for(i = 0; i < n; i++)
+        {
+            for(t = 0; t < CCACHE_MODULE_TOPICS; t++)
+            {
+                if(!checkString(h, m[i].state_str[t]))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Topic of the string table (NULL if not used)
+static const char* getString(const uint8_t *image, uint32_t offset)
+{
+    const ccacheHeader_t *h = (const ccacheHeader_t *)image;
+    if(offset == CCACHE_NO_STRING)
+    {
+        return NULL;
+    }
+    return (const char *)(image + h->section[CCACHE_SECTION_STRINGS].offset +
+            offset);
+}
+
+// Add the gateway elements (in the order they were added from the file)
+static void loadEntries(const uint8_t *image)
+{
+    const ccacheHeader_t *h = (const ccacheHeader_t *)image;
+    const ccacheEntry_t *e;
+    const uint8_t *context;
+    hapcanCANData hd_mask;
+    hapcanCANData hd_check;
+    hapcanCANData hd_result;
+    int n;
+    int i;
+    e = (const ccacheEntry_t *)(image +
+            h->section[CCACHE_SECTION_ENTRIES].offset);
+    n = h->section[CCACHE_SECTION_ENTRIES].len / sizeof(ccacheEntry_t);
+    context = image + h->section[CCACHE_SECTION_CONTEXT].offset;
+    // Walked from the last element added to the first one
+    for(i = n - 1; i >= 0; i--)
+    {
+        hd_mask = e[i].hd_mask;
+        hd_check = e[i].hd_check;
+        hd_result = e[i].hd_result;
+        gateway_AddElementToList(e[i].list, &hd_mask, &hd_check,
+                (char *)getString(image, e[i].state_topic),
+                (char *)getString(image, e[i].command_topic), &hd_result,
+                &g_handlers[e[i].handler],
+                (e[i].context_len > 0) ? context + e[i].context : NULL,
+                e[i].context_len);
+    }
+}
+
+// Allocate the RGB and RGBW lists (EXIT_FAILURE: no memory)
+static int allocModules(const uint8_t *image, hrgbModule **rgb,
+        hrgbwModule **rgbw)
+{
+    const ccacheHeader_t *h = (const ccacheHeader_t *)image;
+    int n;
+    n = h->section[CCACHE_SECTION_RGB].len / sizeof(ccacheModule_t);
+    *rgb = malloc((n > 0 ? n : 1) * sizeof(**rgb));
+    n = h->section[CCACHE_SECTION_RGBW].len / sizeof(ccacheModule_t);
+    *rgbw = malloc((n > 0 ? n : 1) * sizeof(**rgbw));
+    if((*rgb == NULL) || (*rgbw == NULL))
+    {
+        free(*rgb);
+        free(*rgbw);
+        *rgb = NULL;
+        *rgbw = NULL;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Set the RGB and RGBW lists (allocated by allocModules - freed here)
+static void loadModules(const uint8_t *image, hrgbModule *rgb,
+        hrgbwModule *rgbw)
+{
+    const ccacheHeader_t *h = (const ccacheHeader_t *)image;
+    const ccacheModule_t *m;
+    int n;
+    int i;
+    int j;
+    int t;
+    //--------------------------------------
+    // RGB (walked from the last module added to the first one)
+    //--------------------------------------
+    m = (const ccacheModule_t *)(image + h->section[CCACHE_SECTION_RGB].offset);
+    n = h->section[CCACHE_SECTION_RGB].len / sizeof(ccacheModule_t);
+    for(i = n - 1, j = 0; i >= 0; i--, j++)
+    {
+        rgb[j].node = m[i].node;
+        rgb[j].group = m[i].group;
+        rgb[j].isRGB = (m[i].flags & CCACHE_FLAG_RGB) != 0;
+        for(t = 0; t < HRGB_MODULE_TOPICS; t++)
+        {
+            rgb[j].state_str[t] = getString(image, m[i].state_str[t]);
+        }
+    }
+    hrgb_setModules(rgb, n);
+    free(rgb);
+    //--------------------------------------
+    // RGBW
+    //--------------------------------------
+    m = (const ccacheModule_t *)(image + h->section[CCACHE_SECTION_RGBW].offset);
+    n = h->section[CCACHE_SECTION_RGBW].len / sizeof(ccacheModule_t);
+    for(i = n - 1, j = 0; i >= 0; i--, j++)
+    {
+        rgbw[j].node = m[i].node;
+        rgbw[j].group = m[i].group;
+        rgbw[j].isRGB = (m[i].flags & CCACHE_FLAG_RGB) != 0;
+        rgbw[j].isRGBW = (m[i].flags & CCACHE_FLAG_RGBW) != 0;
+        for(t = 0; t < HRGBW_MODULE_TOPICS; t++)
+        {
+            rgbw[j].state_str[t] = getString(image, m[i].state_str[t]);
+        }
+    }
+    hrgbw_setModules(rgbw, n);
+    free(rgbw);
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+int ccache_load(void)
+{
+    int fd;
+    struct stat st;
+    uint8_t *image;
+    size_t size;
+    hrgbModule *rgb;
+    hrgbwModule *rgbw;
+    if(!isEnabled())
+    {
+        return EXIT_FAILURE;
+    }
+    //--------------------------------------
+    // Map the image
+    //--------------------------------------
+    fd = open(JSON_CONFIG_CACHE_PATH, O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+    {
+        return EXIT_FAILURE;
+    }
+    if((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(ccacheHeader_t)))
+    {
+        close(fd);
+        return EXIT_FAILURE;
+    }
+    size = st.st_size;
+    image = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(image == MAP_FAILED)
+    {
+        return EXIT_FAILURE;
+    }
+    //--------------------------------------
+    // Check it, then add the modules
+    //--------------------------------------
+    if(!checkImage(image, size))
+    {
+        #ifdef DEBUG_CONFIG_RELOAD
+        debug_print("ccache_load: cache not used (other file / format)\n");
+        #endif
+        munmap(image, size);
+        return EXIT_FAILURE;
+    }
+    // Nothing is added if the module lists cannot be allocated
+    if(allocModules(image, &rgb, &rgbw) != EXIT_SUCCESS)
+    {
+        #ifdef DEBUG_CONFIG_RELOAD
+        debug_print("ccache_load: cache not used (no memory)\n");
+        #endif
+        munmap(image, size);
+        return EXIT_FAILURE;
+    }
+    loadEntries(image);
+    loadModules(image, rgb, rgbw);
+    munmap(image, size);
+    #ifdef DEBUG_CONFIG_RELOAD
+    debug_print("ccache_load: modules added from the cache\n");
+    #endif
+    return EXIT_SUCCESS;
+}
+
+int ccache_save(void)
+{
+    ccacheBuilder_t b;
+    uint64_t hash;
+    int ret;
+    int i;
+    hash = config_getFileHash();
+    if(!isEnabled() || (hash == 0))
+    {
+        return EXIT_FAILURE;
+    }
+    memset(&b, 0, sizeof(b));
+    //--------------------------------------
+    // Build the sections
+    //--------------------------------------
+    for(b.list = GATEWAY_MQTT2CAN_LIST; b.list < NUMBER_OF_GATEWAY_LISTS;
+            b.list++)
+    {
+        gateway_walkList(b.list, addEntry, &b);
+    }
+    hrgb_walkModules(addRGBModule, &b);
+    hrgbw_walkModules(addRGBWModule, &b);
+    //--------------------------------------
+    // Write
+    //--------------------------------------
+    ret = EXIT_FAILURE;
+    if(!b.error)
+    {
+        ret = writeImage(&b, hash);
+    }
+    #ifdef DEBUG_CONFIG_ERRORS
+    if(ret != EXIT_SUCCESS)
+    {
+        debug_error("ccache_save: cache not written!\n");
+    }
+    #endif
+    for(i = 0; i < CCACHE_N_SECTIONS; i++)
+    {
+        free(b.section[i].data);
+    }
+    return ret;
+}
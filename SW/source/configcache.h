@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef CONFIGCACHE_H
+#define CONFIGCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+/* Image (binary, native byte order - only used on the machine that built it):
+ *   header, gateway elements, RGB modules, RGBW modules, contexts and topic
+ *   strings. Each section starts on a multiple of 8 bytes. */
+#define CCACHE_MAGIC            "HMSGCC\0"
+#define CCACHE_VERSION          1
+#define CCACHE_ALIGN            8
+/* Topic not used (offset in the string table) */
+#define CCACHE_NO_STRING        0xFFFFFFFF
+/* Topics of a module: HRGBW_MODULE_TOPICS (RGB modules use the first
+ * HRGB_MODULE_TOPICS) */
+#define CCACHE_MODULE_TOPICS    5
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Add the configured modules to the gateway (and the RGB / RGBW lists) from
+ * the cache JSON_CONFIG_CACHE_PATH. The image is mapped (mmap) and used only
+ * if it is valid and it was built from the configuration file in use (same
+ * hash, see config_getFileHash). Nothing is added if the image is not used.
+ *
+ * \return  EXIT_SUCCESS    modules added from the cache
+ *          EXIT_FAILURE    cache disabled (configCache), missing or not valid:
+ *                          the modules have to be added from the file
+ */
+int ccache_load(void);
+
+/**
+ * Build the cache from the gateway and the RGB / RGBW lists, after the
+ * modules were added from the configuration file. The image is written to a
+ * temporary file and then renamed.
+ *
+ * \return  EXIT_SUCCESS    cache written
+ *          EXIT_FAILURE    cache disabled (configCache) or not written
+ */
+int ccache_save(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIGCACHE_H */
@@ -6,12 +6,28 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Asynchronous logging: each thread writes fixed size records (format and  //
+// arguments) to its own ring, a background thread formats and prints them    //
+// in batches. Runtime log level of each module.                              //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Strings that do not fit in a record go on in an overflow buffer (freed   //
+// by the writer). Level of the frame messages (debug_verbose*).              //
+//----------------------------------------------------------------------------//
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "config.h"
 #include "hapcan.h"
 #include "hapcansocket.h"
 #include "debug.h"
@@ -19,14 +35,745 @@
 //----------------------------------------------------------------------------//
 // INTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
+// Records of each thread ring (power of 2)
+#define DEBUG_RING_RECORDS      512
+// Arguments of a record (width / precision given by '*' count as arguments)
+#define DEBUG_RECORD_ARGS       12
+// Size of the strings of a record (%s arguments, or the formatted text when
+// the format is not supported) - longer strings go on in an overflow buffer
+#define DEBUG_RECORD_STRINGS    128
+// Maximum size of a printed line (and of the strings of a record)
+#define DEBUG_LINE_SIZE         1024
+// End of a truncated string
+#define DEBUG_TRUNCATED         "..."
+// Size of a batch written at once
+#define DEBUG_BATCH_SIZE        8192
+// Maximum size of a conversion specification (e.g. "%-08.3llx")
+#define DEBUG_SPEC_SIZE         32
+// Writer thread: sleep when there is nothing to print (us)
+#define DEBUG_WRITER_PERIOD     10000
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Argument of a record
+typedef union
+{
+    long long i;            // Integer conversions (d i u o x X c) and '*'
+    double d;               // Floating point conversions
+    const void *p;          // %p
+    int offset;             // %s: position in the strings of the record
+} debugArg_t;
+
+// Record - fixed size (256 bytes)
+typedef struct
+{
+    unsigned long long time;    // ns since epoch
+    const char *format;         // NULL: text already formatted in strings
+    char *overflow;             // Strings, when they do not fit in strings
+                                // (allocated, freed when printed)
+    uint8_t module;
+    uint8_t level;
+    uint8_t nargs;
+    debugArg_t args[DEBUG_RECORD_ARGS];
+    char strings[DEBUG_RECORD_STRINGS];
+} debugRecord_t;
+
+// Ring of a thread: single producer (the thread), single consumer (writer)
+typedef struct debugRing_t
+{
+    debugRecord_t record[DEBUG_RING_RECORDS];
+    unsigned long head;         // written by the producer
+    unsigned long tail;         // written by the consumer
+    unsigned long dropped;      // written by the producer
+    unsigned long reported;     // dropped messages already reported (writer)
+    bool inUse;                 // false: the thread has ended
+    struct debugRing_t *next;
+} debugRing_t;
+
+// Length modifier of a conversion
+typedef enum
+{
+    LEN_NONE = 0,
+    LEN_HH,
+    LEN_H,
+    LEN_L,
+    LEN_LL,
+    LEN_J,
+    LEN_Z,
+    LEN_T,
+    LEN_BIG_L
+} debugLength_t;
+
+// Conversion specification
+typedef struct
+{
+    const char *start;      // '%'
+    int prefixLen;          // '%', flags, width and precision
+    int len;                // whole specification
+    int stars;              // arguments for width / precision
+    debugLength_t length;
+    char conv;
+} debugSpec_t;
 
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
+static pthread_mutex_t g_debug_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t g_debug_output_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t g_debug_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_debug_key;
+static pthread_t g_debug_thread;
+static bool g_debug_running = false;
+static debugRing_t* g_debug_head = NULL;
+static __thread debugRing_t* t_ring = NULL;
+static int g_level[DEBUG_NUMBER_OF_MODULES] = {
+    DEBUG_LEVEL_INFO, DEBUG_LEVEL_INFO, DEBUG_LEVEL_INFO, DEBUG_LEVEL_INFO,
+    DEBUG_LEVEL_INFO, DEBUG_LEVEL_INFO, DEBUG_LEVEL_INFO, DEBUG_LEVEL_INFO,
+    DEBUG_LEVEL_INFO, DEBUG_LEVEL_INFO};
+static const char* const g_moduleName[DEBUG_NUMBER_OF_MODULES] = {
+    "general", "buffer", "can", "mqtt", "socketServer", "hapcan", "gateway",
+    "config", "manager", "monitoring"};
+// Timestamp of the last printed second (thread that formats the records)
+static __thread time_t t_lastSecond = 0;
+static __thread char t_timestamp[20];
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
+static void initKey(void);
+static void releaseRing(void *ring);
+static debugRing_t* getRing(void);
+static const char* parseSpec(const char *p, debugSpec_t *spec);
+static void markTruncated(char *str, int len);
+static int addString(debugRecord_t *record, int *used, int *size, 
+        const char *str);
+static const char* getStrings(const debugRecord_t *record);
+static void formatText(debugRecord_t *record, const char *format, 
+        va_list args);
+static bool captureArgs(debugRecord_t *record, const char *format,
+        va_list args);
+static int formatRecord(const debugRecord_t *record, char *line, int size);
+static void writeText(const char *text, int len);
+static int printPending(char *batch, int *batchLen);
+static void* writerThread(void *arg);
+static void logHAPCANFields(int module, int level, hapcanCANData *hd);
+
+// Key used to release the ring of a thread when it ends
+static void initKey(void)
+{
+    pthread_key_create(&g_debug_key, releaseRing);
+}
+
+// Thread ended: the writer still prints the pending records, the ring can be
+// used by a new thread
+static void releaseRing(void *ring)
+{
+    __atomic_store_n(&((debugRing_t*)ring)->inUse, false, __ATOMIC_RELEASE);
+}
+
+// Ring of the current thread - created when first used
+static debugRing_t* getRing(void)
+{
+    debugRing_t* ring;
+    if(t_ring != NULL)
+    {
+        return t_ring;
+    }
+    pthread_once(&g_debug_once, initKey);
+    // LOCK LIST
+    pthread_mutex_lock(&g_debug_mutex);
+    // Reuse the ring of a thread that has ended
+    for(ring = g_debug_head; ring != NULL; ring = ring->next)
+    {
+        if(!__atomic_load_n(&ring->inUse, __ATOMIC_ACQUIRE))
+        {
+            break;
+        }
+    }
+    if(ring == NULL)
+    {
+        ring = calloc(1, sizeof(*ring));
+        if(ring != NULL)
+        {
+            ring->next = g_debug_head;
+            g_debug_head = ring;
+        }
+    }
+    if(ring != NULL)
+    {
+        __atomic_store_n(&ring->inUse, true, __ATOMIC_RELEASE);
+    }
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_debug_mutex);
+    if(ring != NULL)
+    {
+        pthread_setspecific(g_debug_key, ring);
+    }
+    t_ring = ring;
+    return ring;
+}
+
+// Parse a conversion specification (p points to '%'). Returns the character
+// after the specification.
+static const char* parseSpec(const char *p, debugSpec_t *spec)
+{
+    spec->start = p;
+    spec->stars = 0;
+    spec->length = LEN_NONE;
+    p++;
+    // Flags
+    while((*p != '\0') && (strchr("-+ #0'", *p) != NULL))
+    {
+        p++;
+    }
+    // Width
+    if(*p == '*')
+    {
+        spec->stars++;
+        p++;
+    }
+    while((*p >= '0') && (*p <= '9'))
+    {
+        p++;
+    }
+    // Precision
+    if(*p == '.')
+    {
+        p++;
+        if(*p == '*')
+        {
+            spec->stars++;
+            p++;
+        }
+        while((*p >= '0') && (*p <= '9'))
+        {
+            p++;
+        }
+    }
+    spec->prefixLen = p - spec->start;
+    // Length
+    switch(*p)
+    {
+        case 'h':
+            p++;
+            spec->length = LEN_H;
+            if(*p == 'h')
+            {
+                p++;
+                spec->length = LEN_HH;
+            }
+            break;
+        case 'l':
+            p++;
+            spec->length = LEN_L;
+            if(*p == 'l')
+            {
+                p++;
+                spec->length = LEN_LL;
+            }
+            break;
+        case 'q':
+            p++;
+            spec->length = LEN_LL;
+            break;
+        case 'j':
+            p++;
+            spec->length = LEN_J;
+            break;
+        case 'z':
+            p++;
+            spec->length = LEN_Z;
+            break;
+        case 't':
+            p++;
+            spec->length = LEN_T;
+            break;
+        case 'L':
+            p++;
+            spec->length = LEN_BIG_L;
+            break;
+        default:
+            break;
+    }
+    spec->conv = *p;
+    if(*p != '\0')
+    {
+        p++;
+    }
+    spec->len = p - spec->start;
+    return p;
+}
+
+// Mark the end of a truncated string (buffer of len characters)
+static void markTruncated(char *str, int len)
+{
+    int n = sizeof(DEBUG_TRUNCATED) - 1;
+    if(len >= n)
+    {
+        memcpy(str + len - n, DEBUG_TRUNCATED, n);
+    }
+}
+
+// Copy a string to the strings of a record (used: bytes used, size: size of
+// the strings). The strings go on in an overflow buffer when they do not fit 
+// in the record. Returns the position of the string.
+static int addString(debugRecord_t *record, int *used, int *size, 
+        const char *str)
+{
+    char *strings;
+    char *overflow;
+    int len;
+    int need;
+    int offset;
+    bool truncated;
+    len = strnlen(str, DEBUG_LINE_SIZE);
+    need = *used + len + 1;
+    if((need > *size) && (*size < DEBUG_LINE_SIZE))
+    {
+        if(need > DEBUG_LINE_SIZE)
+        {
+            need = DEBUG_LINE_SIZE;
+        }
+        overflow = realloc(record->overflow, need);
+        if(overflow != NULL)
+        {
+            if(record->overflow == NULL)
+            {
+                memcpy(overflow, record->strings, *used);
+            }
+            record->overflow = overflow;
+            *size = need;
+        }
+    }
+    strings = (record->overflow != NULL) ? record->overflow : record->strings;
+    offset = *used;
+    truncated = false;
+    if(len > *size - 1 - *used)
+    {
+        len = *size - 1 - *used;
+        truncated = true;
+    }
+    memcpy(strings + offset, str, len);
+    strings[offset + len] = '\0';
+    if(truncated)
+    {
+        markTruncated(strings + offset, len);
+    }
+    *used += len + 1;
+    if(*used >= *size)
+    {
+        // No space for more strings
+        *used = *size - 1;
+    }
+    return offset;
+}
+
+// Strings of a record
+static const char* getStrings(const debugRecord_t *record)
+{
+    return (record->overflow != NULL) ? record->overflow : record->strings;
+}
+
+// Store the formatted text of a message (format not supported)
+static void formatText(debugRecord_t *record, const char *format, 
+        va_list args)
+{
+    va_list copy;
+    int len;
+    int size;
+    va_copy(copy, args);
+    record->format = NULL;
+    len = vsnprintf(record->strings, sizeof(record->strings), format, args);
+    if(len >= (int)sizeof(record->strings))
+    {
+        size = (len < DEBUG_LINE_SIZE) ? len + 1 : DEBUG_LINE_SIZE;
+        record->overflow = malloc(size);
+        if(record->overflow != NULL)
+        {
+            vsnprintf(record->overflow, size, format, copy);
+        }
+        else
+        {
+            markTruncated(record->strings, sizeof(record->strings) - 1);
+        }
+    }
+    va_end(copy);
+}
+
+// Store the arguments of a message. false: format not supported
+static bool captureArgs(debugRecord_t *record, const char *format,
+        va_list args)
+{
+    const char *p;
+    const char *s;
+    debugSpec_t spec;
+    int i;
+    int used;
+    int size;
+    long long value;
+    record->nargs = 0;
+    used = 0;
+    size = DEBUG_RECORD_STRINGS;
+    p = format;
+    while(*p != '\0')
+    {
+        if(*p != '%')
+        {
+            p++;
+            continue;
+        }
+        if(p[1] == '%')
+        {
+            p += 2;
+            continue;
+        }
+        p = parseSpec(p, &spec);
+        if((spec.len >= DEBUG_SPEC_SIZE) ||
+                (record->nargs + spec.stars + 1 > DEBUG_RECORD_ARGS))
+        {
+            return false;
+        }
+        // Width / precision
+        for(i = 0; i < spec.stars; i++)
+        {
+            record->args[record->nargs++].i = va_arg(args, int);
+        }
+        switch(spec.conv)
+        {
+            case 'd':
+            case 'i':
+                switch(spec.length)
+                {
+                    case LEN_L: value = va_arg(args, long); break;
+                    case LEN_LL: value = va_arg(args, long long); break;
+                    case LEN_J: value = va_arg(args, intmax_t); break;
+                    case LEN_Z: value = va_arg(args, ssize_t); break;
+                    case LEN_T: value = va_arg(args, ptrdiff_t); break;
+                    case LEN_HH: value = (signed char)va_arg(args, int); break;
+                    case LEN_H: value = (short)va_arg(args, int); break;
+                    default: value = va_arg(args, int); break;
+                }
+                record->args[record->nargs++].i = value;
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                switch(spec.length)
+                {
+                    case LEN_L:
+                        value = va_arg(args, unsigned long);
+                        break;
+                    case LEN_LL:
+                        value = va_arg(args, unsigned long long);
+                        break;
+                    case LEN_J:
+                        value = va_arg(args, uintmax_t);
+                        break;
+                    case LEN_Z:
+                        value = va_arg(args, size_t);
+                        break;
+                    case LEN_T:
+                        value = va_arg(args, ptrdiff_t);
+                        break;
+                    case LEN_HH:
+                        value = (unsigned char)va_arg(args, unsigned int);
+                        break;
+                    case LEN_H:
+                        value = (unsigned short)va_arg(args, unsigned int);
+                        break;
+                    default:
+                        value = va_arg(args, unsigned int);
+                        break;
+                }
+                record->args[record->nargs++].i = value;
+                break;
+            case 'c':
+                if(spec.length != LEN_NONE)
+                {
+                    return false;
+                }
+                record->args[record->nargs++].i = va_arg(args, int);
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if(spec.length == LEN_BIG_L)
+                {
+                    record->args[record->nargs++].d =
+                            va_arg(args, long double);
+                }
+                else
+                {
+                    record->args[record->nargs++].d = va_arg(args, double);
+                }
+                break;
+            case 's':
+                if(spec.length != LEN_NONE)
+                {
+                    return false;
+                }
+                // Copy the string (it may not exist when it is printed)
+                s = va_arg(args, const char *);
+                if(s == NULL)
+                {
+                    s = "(null)";
+                }
+                record->args[record->nargs++].offset = addString(record, 
+                        &used, &size, s);
+                break;
+            case 'p':
+                record->args[record->nargs++].p = va_arg(args, void *);
+                break;
+            default:
+                // %n, wide characters, invalid...
+                return false;
+        }
+    }
+    return true;
+}
+
+// Print one argument with the conversion specification rebuilt by
+// formatRecord (with the '*' width / precision)
+#define DEBUG_PRINT_ARG(arg) \
+    ((spec.stars == 0) ? \
+        snprintf(line + len, size - len, format, arg) : \
+    (spec.stars == 1) ? \
+        snprintf(line + len, size - len, format, width[0], arg) : \
+        snprintf(line + len, size - len, format, width[0], width[1], arg))
+
+// Format a record as a line (with the timestamp). Returns the line length.
+static int formatRecord(const debugRecord_t *record, char *line, int size)
+{
+    const char *p;
+    const char *literal;
+    debugSpec_t spec;
+    char format[DEBUG_SPEC_SIZE + 4];
+    int width[2];
+    int len;
+    int ret;
+    int n;
+    int i;
+    time_t seconds;
+    struct tm sTm;
+    // Timestamp (only formatted when the second changes)
+    seconds = record->time / 1000000000ULL;
+    if(seconds != t_lastSecond)
+    {
+        t_lastSecond = seconds;
+        gmtime_r(&seconds, &sTm);
+        strftime(t_timestamp, sizeof(t_timestamp), "%Y-%m-%d %H:%M:%S",
+                &sTm);
+    }
+    len = snprintf(line, size, "%s: ", t_timestamp);
+    if(record->format == NULL)
+    {
+        // Already formatted
+        len += snprintf(line + len, size - len, "%s", getStrings(record));
+        return (len < size) ? len : size - 1;
+    }
+    p = record->format;
+    n = 0;
+    while((*p != '\0') && (len < size - 1))
+    {
+        // Literal text
+        literal = p;
+        while((*p != '\0') && (*p != '%'))
+        {
+            p++;
+        }
+        if(p > literal)
+        {
+            ret = p - literal;
+            if(ret > size - 1 - len)
+            {
+                ret = size - 1 - len;
+            }
+            memcpy(line + len, literal, ret);
+            len += ret;
+            continue;
+        }
+        if(p[1] == '%')
+        {
+            line[len++] = '%';
+            p += 2;
+            continue;
+        }
+        // Conversion: flags, width and precision are kept, the length is
+        // the one of the stored argument
+        p = parseSpec(p, &spec);
+        memcpy(format, spec.start, spec.prefixLen);
+        i = spec.prefixLen;
+        if(strchr("diuoxX", spec.conv) != NULL)
+        {
+            format[i++] = 'l';
+            format[i++] = 'l';
+        }
+        format[i++] = spec.conv;
+        format[i] = '\0';
+        for(i = 0; i < spec.stars; i++)
+        {
+            width[i] = record->args[n++].i;
+        }
+        ret = 0;
+        switch(spec.conv)
+        {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+                ret = DEBUG_PRINT_ARG(record->args[n].i);
+                break;
+            case 'c':
+                ret = DEBUG_PRINT_ARG((int)record->args[n].i);
+                break;
+            case 'e': case 'E': case 'f': case 'F': case 'g': case 'G':
+            case 'a': case 'A':
+                ret = DEBUG_PRINT_ARG(record->args[n].d);
+                break;
+            case 's':
+                ret = DEBUG_PRINT_ARG(getStrings(record) +
+                        record->args[n].offset);
+                break;
+            case 'p':
+                ret = DEBUG_PRINT_ARG(record->args[n].p);
+                break;
+            default:
+                break;
+        }
+        n++;
+        if(ret > 0)
+        {
+            len += ret;
+        }
+    }
+    if(len > size - 1)
+    {
+        len = size - 1;
+    }
+    line[len] = '\0';
+    return len;
+}
+#undef DEBUG_PRINT_ARG
+
+// Write text to the output
+static void writeText(const char *text, int len)
+{
+    // LOCK OUTPUT
+    pthread_mutex_lock(&g_debug_output_mutex);
+    fwrite(text, 1, len, stdout);
+    fflush(stdout);
+    // UNLOCK OUTPUT
+    pthread_mutex_unlock(&g_debug_output_mutex);
+}
+
+// Print the pending records of all rings, oldest first. Returns the number of
+// records printed.
+static int printPending(char *batch, int *batchLen)
+{
+    debugRing_t* head;
+    debugRing_t* ring;
+    debugRing_t* oldest;
+    debugRecord_t* record;
+    unsigned long tail;
+    unsigned long dropped;
+    char line[DEBUG_LINE_SIZE];
+    int len;
+    int count;
+    // LOCK LIST: rings are only added to the list (never removed)
+    pthread_mutex_lock(&g_debug_mutex);
+    head = g_debug_head;
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_debug_mutex);
+    count = 0;
+    while(1)
+    {
+        // Ring with the oldest pending record
+        oldest = NULL;
+        for(ring = head; ring != NULL; ring = ring->next)
+        {
+            tail = ring->tail;
+            if(tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE))
+            {
+                continue;
+            }
+            if((oldest == NULL) ||
+                    (ring->record[tail % DEBUG_RING_RECORDS].time <
+                    oldest->record[oldest->tail % DEBUG_RING_RECORDS].time))
+            {
+                oldest = ring;
+            }
+        }
+        if(oldest == NULL)
+        {
+            break;
+        }
+        record = &oldest->record[oldest->tail % DEBUG_RING_RECORDS];
+        len = formatRecord(record, line, sizeof(line));
+        free(record->overflow);
+        record->overflow = NULL;
+        __atomic_store_n(&oldest->tail, oldest->tail + 1, __ATOMIC_RELEASE);
+        if(*batchLen + len > DEBUG_BATCH_SIZE)
+        {
+            writeText(batch, *batchLen);
+            *batchLen = 0;
+        }
+        memcpy(batch + *batchLen, line, len);
+        *batchLen += len;
+        count++;
+    }
+    // Lost messages (ring full)
+    for(ring = head; ring != NULL; ring = ring->next)
+    {
+        dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+        if(dropped != ring->reported)
+        {
+            len = snprintf(line, sizeof(line), "%s: DEBUG: %lu messages "
+                    "lost (log ring full)!\n", t_timestamp,
+                    dropped - ring->reported);
+            ring->reported = dropped;
+            if(*batchLen + len > DEBUG_BATCH_SIZE)
+            {
+                writeText(batch, *batchLen);
+                *batchLen = 0;
+            }
+            memcpy(batch + *batchLen, line, len);
+            *batchLen += len;
+        }
+    }
+    return count;
+}
+
+// THREAD - Print the records in batches
+static void* writerThread(void *arg)
+{
+    static char batch[DEBUG_BATCH_SIZE];
+    int batchLen = 0;
+    int count;
+    while(__atomic_load_n(&g_debug_running, __ATOMIC_ACQUIRE))
+    {
+        count = printPending(batch, &batchLen);
+        if(batchLen > 0)
+        {
+            writeText(batch, batchLen);
+            batchLen = 0;
+        }
+        if(count == 0)
+        {
+            usleep(DEBUG_WRITER_PERIOD);
+        }
+    }
+    // Print what is left
+    printPending(batch, &batchLen);
+    if(batchLen > 0)
+    {
+        writeText(batch, batchLen);
+    }
+    return NULL;
+}
 
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
@@ -36,6 +783,18 @@
  */
 int debug_init(void)
 {
+    int check;
+    if(g_debug_running)
+    {
+        return EXIT_SUCCESS;
+    }
+    __atomic_store_n(&g_debug_running, true, __ATOMIC_RELEASE);
+    check = pthread_create(&g_debug_thread, NULL, writerThread, NULL);
+    if(check != 0)
+    {
+        __atomic_store_n(&g_debug_running, false, __ATOMIC_RELEASE);
+        return EXIT_FAILURE;
+    }
     //return  EXIT_SUCCESS / EXIT_FAILURE
     return  EXIT_SUCCESS;
 }
@@ -45,120 +804,240 @@ int debug_init(void)
  */
 int debug_end(void)
 {
+    if(!g_debug_running)
+    {
+        return EXIT_SUCCESS;
+    }
+    __atomic_store_n(&g_debug_running, false, __ATOMIC_RELEASE);
+    pthread_join(g_debug_thread, NULL);
     //return  EXIT_SUCCESS / EXIT_FAILURE
     return  EXIT_SUCCESS;
 }
 
 /**
- * Print Debug Message
+ * Log a message
  */
-void debug_print(const char * format, ...)
-{
-    char buff[20];
-    struct tm *sTm;
-    
-    #ifdef DEBUG_ON    
-    // Get Timestamp
-    time_t now = time(0);
-    sTm = gmtime (&now);
-    strftime (buff, sizeof(buff), "%Y-%m-%d %H:%M:%S", sTm);    
-    
-    // Print
+void debug_log(int module, int level, const char * format, ...)
+{
+    #ifdef DEBUG_ON
     va_list args;
-    va_start (args, format);
-    printf ("%s: ", buff);
-    vprintf (format, args);
-    va_end (args);
-    
-    // Will now print everything in the stdout buffer
-    fflush(stdout);
+    va_list copy;
+    debugRecord_t local;
+    debugRecord_t* record;
+    debugRing_t* ring;
+    unsigned long head;
+    struct timespec ts;
+    char line[DEBUG_LINE_SIZE];
+    int len;
+    bool ok;
+
+    // Level of the module
+    if(!debug_isEnabled(module, level))
+    {
+        return;
+    }
+    // Record: the ring of the thread when the writer is running
+    ring = NULL;
+    record = &local;
+    if(__atomic_load_n(&g_debug_running, __ATOMIC_ACQUIRE))
+    {
+        ring = getRing();
+    }
+    if(ring != NULL)
+    {
+        head = ring->head;
+        if(head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >=
+                DEBUG_RING_RECORDS)
+        {
+            // Ring full - never wait (the message is lost)
+            __atomic_store_n(&ring->dropped, ring->dropped + 1,
+                    __ATOMIC_RELAXED);
+            return;
+        }
+        record = &ring->record[head % DEBUG_RING_RECORDS];
+    }
+    clock_gettime(CLOCK_REALTIME, &ts);
+    record->time = (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    record->module = module;
+    record->level = level;
+    record->format = format;
+    record->overflow = NULL;
+    va_start(args, format);
+    va_copy(copy, args);
+    ok = captureArgs(record, format, args);
+    if(!ok)
+    {
+        // Not supported: store the formatted text
+        free(record->overflow);
+        record->overflow = NULL;
+        formatText(record, format, copy);
+    }
+    va_end(copy);
+    va_end(args);
+    if(ring != NULL)
+    {
+        __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    }
+    else
+    {
+        // No writer: print now
+        len = formatRecord(record, line, sizeof(line));
+        free(record->overflow);
+        writeText(line, len);
+    }
     #endif
 }
 
+/**
+ * Check if the messages of a level are printed for a module
+ */
+bool debug_isEnabled(int module, int level)
+{
+    return (module >= 0) && (module < DEBUG_NUMBER_OF_MODULES) &&
+            (level <= __atomic_load_n(&g_level[module], __ATOMIC_RELAXED));
+}
+
+/**
+ * Set the log level of a module
+ */
+void debug_setLevel(int module, int level)
+{
+    if((module < 0) || (module >= DEBUG_NUMBER_OF_MODULES))
+    {
+        return;
+    }
+    __atomic_store_n(&g_level[module], level, __ATOMIC_RELAXED);
+}
+
+/**
+ * Read the log level of each module from the configuration
+ */
+void debug_updateLevels(void)
+{
+    int module;
+    for(module = 0; module < DEBUG_NUMBER_OF_MODULES; module++)
+    {
+        debug_setLevel(module, config_getLogLevel(g_moduleName[module],
+                DEBUG_LEVEL_INFO));
+    }
+}
+
+/**
+ * Name of a module
+ */
+const char* debug_moduleName(int module)
+{
+    if((module < 0) || (module >= DEBUG_NUMBER_OF_MODULES))
+    {
+        return "";
+    }
+    return g_moduleName[module];
+}
+
+// Print the fields of a HAPCAN frame
+static void logHAPCANFields(int module, int level, hapcanCANData *hd)
+{
+    int li_Temp;
+    int li_len;
+    char data[64];
+    debug_log(module, level, "- HAPCAN Frame Type: 0x%03X\n",
+            hd->frametype);
+    debug_log(module, level, "- HAPCAN Flags: 0x%X\n", hd->flags);
+    debug_log(module, level, "- HAPCAN Module: 0x%02X (%d in "
+            "decimal)\n", hd->module, hd->module);
+    debug_log(module, level, "- HAPCAN Group: 0x%02X (%d in "
+            "decimal)\n", hd->group, hd->group);
+    li_len = 0;
+    for(li_Temp = 0; li_Temp < HAPCAN_DATA_LEN; li_Temp++)
+    {
+        li_len += snprintf(data + li_len, sizeof(data) - li_len, "0x%02X ",
+                hd->data[li_Temp]);
+    }
+    debug_log(module, level, "- HAPCAN Data D0 to D7: %s\n", data);
+}
+
 /**
  * Print CAN Message
  */
-void debug_printCAN(const char * text, struct can_frame* const pcf_Frame)
+void debug_logCAN(int module, int level, const char * text,
+        struct can_frame* const pcf_Frame)
 {
+    if(!debug_isEnabled(module, level))
+    {
+        return;
+    }
+    #ifdef DEBUG_CAN_STANDARD
     int li_Temp;
-    hapcanCANData hapcanData;    
-    
-    #ifdef DEBUG_CAN_STANDARD    
-    debug_print(text);
-    debug_print("- CAN ID: 0x%08X\n", pcf_Frame->can_id);
-    debug_print("- CAN Data:");
+    int li_len;
+    char data[64];
+    debug_log(module, level, "%s", text);
+    debug_log(module, level, "- CAN ID: 0x%08X\n",
+            pcf_Frame->can_id);
+    li_len = 0;
     for(li_Temp = 0; li_Temp < CAN_MAX_DLEN; li_Temp++)
     {
-        printf("0x%02X ", pcf_Frame->data[li_Temp]);
+        li_len += snprintf(data + li_len, sizeof(data) - li_len, "0x%02X ",
+                pcf_Frame->data[li_Temp]);
     }
-    printf("\n");
+    debug_log(module, level, "- CAN Data:%s\n", data);
     #endif
-    
-    #ifdef DEBUG_CAN_HAPCAN 
+
+    #ifdef DEBUG_CAN_HAPCAN
+    hapcanCANData hapcanData;
     hapcan_getHAPCANDataFromCAN(pcf_Frame, &hapcanData);
-    debug_print(text);
-    debug_print("- HAPCAN Frame Type: 0x%03X\n", hapcanData.frametype);
-    debug_print("- HAPCAN Flags: 0x%X\n", hapcanData.flags);
-    debug_print("- HAPCAN Module: 0x%02X (%d in decimal)\n", hapcanData.module, hapcanData.module);
-    debug_print("- HAPCAN Group: 0x%02X (%d in decimal)\n", hapcanData.group, hapcanData.group);
-    debug_print("- HAPCAN Data D0 to D7: ");
-    for(li_Temp = 0; li_Temp < HAPCAN_DATA_LEN; li_Temp++)
-    {
-        printf("0x%02X ", hapcanData.data[li_Temp]);
-    }
-    printf("\n");
+    debug_log(module, level, "%s", text);
+    logHAPCANFields(module, level, &hapcanData);
     #endif
 }
 
 /**
- * Print CAN Message
+ * Print HAPCAN Message
  */
-void debug_printHAPCAN(const char * text, hapcanCANData *hd)
-{
-    int li_Temp;    
-    debug_print(text);
-    debug_print("- HAPCAN Frame Type: 0x%03X\n", hd->frametype);
-    debug_print("- HAPCAN Flags: 0x%X\n", hd->flags);
-    debug_print("- HAPCAN Module: 0x%02X (%d in decimal)\n", hd->module, hd->module);
-    debug_print("- HAPCAN Group: 0x%02X (%d in decimal)\n", hd->group, hd->group);
-    debug_print("- HAPCAN Data D0 to D7: ");
-    for(li_Temp = 0; li_Temp < HAPCAN_DATA_LEN; li_Temp++)
+void debug_logHAPCAN(int module, int level, const char * text, 
+        hapcanCANData *hd)
+{
+    if(!debug_isEnabled(module, level))
     {
-        printf("0x%02X ", hd->data[li_Temp]);
+        return;
     }
-    printf("\n");
+    debug_log(module, level, "%s", text);
+    logHAPCANFields(module, level, hd);
 }
 
-void debug_printSocket(const char * text, uint8_t* data, int dataLen)
+/**
+ * Print HAPCAN Socket Message
+ */
+void debug_logSocket(int module, int level, const char * text, 
+        uint8_t* data, int dataLen)
 {
     int li_Temp;
+    int li_len;
+    char line[DEBUG_RECORD_STRINGS];
     hapcanCANData hapcanData;
+    if(!debug_isEnabled(module, level))
+    {
+        return;
+    }
+    debug_log(module, level, "%s", text);
+    debug_log(module, level, "- HAPCAN SOCKET DATA: \n");
     if(dataLen == HAPCAN_SOCKET_DATA_LEN)
     {
         hs_getHAPCANFromSocketArray(data, &hapcanData);
-        debug_print(text);
-        debug_print("- HAPCAN SOCKET DATA: \n");
-        debug_print("- HAPCAN Frame Type: 0x%03X\n", hapcanData.frametype);
-        debug_print("- HAPCAN Flags: 0x%X\n", hapcanData.flags);
-        debug_print("- HAPCAN Module: 0x%02X (%d in decimal)\n", hapcanData.module, hapcanData.module);
-        debug_print("- HAPCAN Group: 0x%02X (%d in decimal)\n", hapcanData.group, hapcanData.group);
-        debug_print("- HAPCAN Data D0 to D7: ");
-        for(li_Temp = 0; li_Temp < HAPCAN_DATA_LEN; li_Temp++)
-        {
-            printf("0x%02X ", hapcanData.data[li_Temp]);
-        }
-        printf("\n");
+        logHAPCANFields(module, level, &hapcanData);
     }
     else
     {
         // Data not formatted as CAN Frame
-        debug_print(text);
-        debug_print("- HAPCAN SOCKET DATA: \n");
-        debug_print(" (Data not formatted as CAN - only %d bytes) \n", dataLen);
-        for(li_Temp = 0; li_Temp < dataLen; li_Temp++)
+        debug_log(module, level, " (Data not formatted as CAN - "
+                "only %d bytes) \n", dataLen);
+        li_len = 0;
+        line[0] = '\0';
+        for(li_Temp = 0; (li_Temp < dataLen) &&
+                (li_len < (int)sizeof(line) - 6); li_Temp++)
         {
-            printf("0x%02X ", data[li_Temp]);
+            li_len += snprintf(line + li_len, sizeof(line) - li_len,
+                    "0x%02X ", data[li_Temp]);
         }
-        printf("\n");
+        debug_log(module, level, "%s\n", line);
     }
 }
\ No newline at end of file
@@ -15,15 +15,43 @@
 //  1.03     | 22/Oct/2024 |                               | ALCP             //
 // - Add HAPCAN CONFIG Error debug flag                                       //
 //----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Add TOPIC (interned topics) Error debug flag                             //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Add LATENCY report debug flag                                            //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Add METRICS Error debug flag                                             //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - Asynchronous logging: records are written to a ring of each thread and   //
+// printed by a background thread. Runtime log level of each module. The      //
+// DEBUG_* flags only select what is compiled.                                //
+//----------------------------------------------------------------------------//
+//  1.08     | 18/Oct/2026 |                               | ALCP             //
+// - Add TRACE Error debug flag                                               //
+//----------------------------------------------------------------------------//
+//  1.09     | 18/Oct/2026 |                               | ALCP             //
+// - Add CAN route Error debug flag                                           //
+//----------------------------------------------------------------------------//
+//  1.10     | 18/Oct/2026 |                               | ALCP             //
+// - Add DEBUG_MANAGER_THREADS (scheduling profile of the threads)            //
+//----------------------------------------------------------------------------//
+//  1.11     | 18/Oct/2026 |                               | ALCP             //
+// - All the DEBUG_* flags are compiled: the messages only compiled for       //
+// debugging are printed with the "debug" log level (debug_verbose)           //
+//----------------------------------------------------------------------------//
 
 #ifndef DEBUG_H
-//#define DEBUG_H
+#define DEBUG_H
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <linux/can.h>
 #include <linux/can/raw.h>
 #include "hapcan.h"
@@ -35,50 +63,72 @@ extern "C" {
 #define DEBUG_ON
 #define DEBUG_VERSION
 
+/* Module of the messages of a file: defined before the includes, e.g. 
+ * #define DEBUG_MODULE DEBUG_MODULE_CAN. The flags below select what is 
+ * compiled, the log level of each module ("<module>LogLevel") selects what is 
+ * printed. */
+#ifndef DEBUG_MODULE
+#define DEBUG_MODULE        DEBUG_MODULE_GENERAL
+#endif
+/* Print a message (INFO level) of the module of the file */
+#define debug_print(...)    debug_log(DEBUG_MODULE, DEBUG_LEVEL_INFO, \
+        __VA_ARGS__)
+/* Print an error message of the module of the file */
+#define debug_error(...)    debug_log(DEBUG_MODULE, DEBUG_LEVEL_ERROR, \
+        __VA_ARGS__)
+/* Print a detailed message (DEBUG level - e.g. each frame) of the module of 
+ * the file */
+#define debug_verbose(...)  debug_log(DEBUG_MODULE, DEBUG_LEVEL_DEBUG, \
+        __VA_ARGS__)
+
 /* MQTT - Only Events */
 #define DEBUG_MQTT_ERRORS
 #define DEBUG_MQTT_CONNECTED
 #define DEBUG_MQTT_PUBLISH_TIMEOUT
-//#define DEBUG_MQTT_CONNECT // Disable for production
-//#define DEBUG_MQTT_RECEIVED // Disable for production
-//#define DEBUG_MQTT_SENT // Disable for production
+#define DEBUG_MQTT_CONNECT // "debug" log level
+#define DEBUG_MQTT_RECEIVED // "debug" log level
+#define DEBUG_MQTT_SENT // "debug" log level
     
 /* SocketCAN */
 #define DEBUG_SOCKETCAN_ERROR
 #define DEBUG_SOCKETCAN_OPENED
-//#define DEBUG_SOCKETCAN_OPEN // Disable for production
-//#define DEBUG_SOCKETCAN_READ_FULL // Disable for production
-//#define DEBUG_SOCKETCAN_READ_EVENTS // Disable for production
-//#define DEBUG_SOCKETCAN_WRITE // Disable for production
+#define DEBUG_SOCKETCAN_OPEN // "debug" log level
+#define DEBUG_SOCKETCAN_READ_FULL // "debug" log level
+#define DEBUG_SOCKETCAN_READ_EVENTS // "debug" log level
+#define DEBUG_SOCKETCAN_WRITE // "debug" log level
 
 /* Buffer */
-//#define DEBUG_BUFFER
+#define DEBUG_BUFFER // "debug" log level
     
 /* Manager */
 #define DEBUG_MANAGER_ERRORS
 #define DEBUG_MANAGER_CONFIG_EVENTS
+#define DEBUG_MANAGER_THREADS
     
 /* CAN Buffer */
 #define DEBUG_CANBUF_ERRORS
-//#define DEBUG_CANBUF_SEND // Disable for production
+#define DEBUG_CANBUF_SEND // "debug" log level
+
+/* CAN Routes */
+#define DEBUG_CANROUTE_ERRORS
 
 
 /* Socket Server Buffer */
 #define DEBUG_SOCKETSERVERBUF_ERRORS
-//#define DEBUG_SOCKETSERVERBUF_SEND // Disable for production
+#define DEBUG_SOCKETSERVERBUF_SEND // "debug" log level
     
 /* Socket Server */
 #define DEBUG_SOCKETSERVER_ERROR
 #define DEBUG_SOCKETSERVER_OPENED
-//#define DEBUG_SOCKETSERVER_PROCESS_ERROR // Disable for production
-//#define DEBUG_SOCKETSERVER_OPEN // Disable for production
-//#define DEBUG_SOCKETSERVER_READ_FULL // Disable for production
-//#define DEBUG_SOCKETSERVER_READ_EVENTS // Disable for production
-//#define DEBUG_SOCKETSERVER_WRITE // Disable for production
+#define DEBUG_SOCKETSERVER_PROCESS_ERROR // "debug" log level
+#define DEBUG_SOCKETSERVER_OPEN // "debug" log level
+#define DEBUG_SOCKETSERVER_READ_FULL // "debug" log level
+#define DEBUG_SOCKETSERVER_READ_EVENTS // "debug" log level
+#define DEBUG_SOCKETSERVER_WRITE // "debug" log level
 
 /* CAN DEBUG */   
 #define DEBUG_CAN_HAPCAN
-//#define DEBUG_CAN_STANDARD // Disable for production
+//#define DEBUG_CAN_STANDARD // Also print the raw CAN fields
     
 /* HAPCAN DEBUG */   
 #define DEBUG_HAPCAN_ERRORS
@@ -90,28 +140,64 @@ extern "C" {
 #define DEBUG_HAPCAN_CONFIG_ERRORS
 #define DEBUG_RGBW_ERRORS
 #define DEBUG_TIM_ERRORS
-//#define DEBUG_RGBW_FULL // Disable for production
-//#define DEBUG_HAPCAN_CAN2MQTT // Disable for production
-//#define DEBUG_HAPCAN_MQTT2CAN // Disable for production
+#define DEBUG_RGBW_FULL // "debug" log level
+#define DEBUG_HAPCAN_CAN2MQTT // "debug" log level
+#define DEBUG_HAPCAN_MQTT2CAN // "debug" log level
     
 /* CONFIG DEBUG */
 #define DEBUG_CONFIG_ERRORS
 #define DEBUG_CONFIG_RELOAD
-//#define DEBUG_CONFIG_FULL // Disable for production
+#define DEBUG_CONFIG_FULL // "debug" log level
     
 /* JSON DEBUG */
-//#define DEBUG_JSON_ERRORS // Disable for production
-//#define DEBUG_JSON_FULL // Disable for production
+#define DEBUG_JSON_ERRORS // "debug" log level
+#define DEBUG_JSON_FULL // "debug" log level
 
 /* GATEWAY DEBUG */
 #define DEBUG_GATEWAY_ERRORS
-//#define DEBUG_GATEWAY_PRINT // Disable for production
-//#define DEBUG_GATEWAY_LISTS // Disable for production 
-//#define DEBUG_GATEWAY_SEARCH // Disable for production
+#define DEBUG_GATEWAY_PRINT // "debug" log level
+#define DEBUG_GATEWAY_LISTS // "debug" log level 
+#define DEBUG_GATEWAY_SEARCH // "debug" log level
+
+/* TOPIC DEBUG */
+#define DEBUG_TOPIC_ERRORS
+
+/* LATENCY DEBUG */
+#define DEBUG_LATENCY
+
+/* METRICS DEBUG */
+#define DEBUG_METRICS_ERRORS
+
+/* TRACE DEBUG */
+#define DEBUG_TRACE_ERRORS
     
 //----------------------------------------------------------------------------//
 // EXTERNAL TYPES
 //----------------------------------------------------------------------------//
+// Modules - see debug_moduleName for the names used in the configuration
+typedef enum
+{
+    DEBUG_MODULE_GENERAL = 0,
+    DEBUG_MODULE_BUFFER,
+    DEBUG_MODULE_CAN,
+    DEBUG_MODULE_MQTT,
+    DEBUG_MODULE_SOCKETSERVER,
+    DEBUG_MODULE_HAPCAN,
+    DEBUG_MODULE_GATEWAY,
+    DEBUG_MODULE_CONFIG,
+    DEBUG_MODULE_MANAGER,
+    DEBUG_MODULE_MONITORING,
+    DEBUG_NUMBER_OF_MODULES
+} debugModule_t;
+
+// Levels - a message is printed if its level is <= the level of the module
+typedef enum
+{
+    DEBUG_LEVEL_OFF = 0,
+    DEBUG_LEVEL_ERROR,
+    DEBUG_LEVEL_INFO,
+    DEBUG_LEVEL_DEBUG
+} debugLevel_t;
 
 //----------------------------------------------------------------------------//
 // EXTERNAL CONSTANTS
@@ -125,7 +211,8 @@ extern "C" {
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
 /**
- * Debug Initialization
+ * Debug Initialization - starts the thread that prints the messages. Before 
+ * it (and after debug_end) messages are printed by the calling thread.
  * 
  * \param   None
  * \return  EXIT_SUCCESS / EXIT_FAILURE
@@ -133,7 +220,7 @@ extern "C" {
 int debug_init(void);
 
 /**
- * Debug End
+ * Debug End - prints the pending messages and stops the thread.
  * 
  * \param   None
  * \return  EXIT_SUCCESS / EXIT_FAILURE
@@ -141,36 +228,104 @@ int debug_init(void);
 int debug_end(void);
 
 /**
- * Debug Print
+ * Debug Log - use debug_print / debug_error / debug_verbose. The format and 
+ * the arguments are stored (strings are copied) in a fixed size record of the 
+ * thread ring, without formatting or I/O. Strings that do not fit in the 
+ * record are copied to an overflow buffer (up to a line, longer strings end 
+ * with "..."). If the ring is full, the message is lost (the number of lost 
+ * messages is printed). The format has to be a constant.
  * 
- * \param   same as printf
+ * \param   module  debugModule_t
+ * \param   level   debugLevel_t
+ * \param   format  same as printf
  * \return  none
  */
-void debug_print(const char * format, ...);
+void debug_log(int module, int level, const char * format, ...)
+        __attribute__((format(printf, 3, 4)));
+
+/**
+ * Check if the messages of a level are printed for a module (e.g. to skip 
+ * preparing a debug message)
+ * 
+ * \param   module  debugModule_t
+ * \param   level   debugLevel_t
+ * \return  true / false
+ */
+bool debug_isEnabled(int module, int level);
+
+/**
+ * Set the log level of a module
+ * 
+ * \param   module  debugModule_t
+ * \param   level   debugLevel_t
+ */
+void debug_setLevel(int module, int level);
+
+/**
+ * Read the log level of each module from the configuration 
+ * ("<module>LogLevel": "off", "error", "info" or "debug" - default "info")
+ */
+void debug_updateLevels(void);
+
+/**
+ * Name of a module in the configuration
+ * 
+ * \param   module  debugModule_t
+ * \return  name (e.g. "can")
+ */
+const char* debug_moduleName(int module);
 
 /**
- * Debug Print CAN Frame
+ * Debug Print CAN Frame - use debug_printCAN(text, pcf_Frame) or 
+ * debug_verboseCAN(text, pcf_Frame)
  * 
- * \param   same as printf
+ * \param   module      debugModule_t
+ * \param   level       debugLevel_t
+ * \param   text        text printed before the frame
+ * \param   pcf_Frame   CAN frame
  * \return  none
  */
-void debug_printCAN(const char * text, struct can_frame* const pcf_Frame);
+void debug_logCAN(int module, int level, const char * text, 
+        struct can_frame* const pcf_Frame);
+#define debug_printCAN(text, pcf_Frame) \
+        debug_logCAN(DEBUG_MODULE, DEBUG_LEVEL_INFO, text, pcf_Frame)
+#define debug_verboseCAN(text, pcf_Frame) \
+        debug_logCAN(DEBUG_MODULE, DEBUG_LEVEL_DEBUG, text, pcf_Frame)
 
 /**
- * Debug Print HAPCAN Frame
+ * Debug Print HAPCAN Frame - use debug_printHAPCAN(text, hd) or 
+ * debug_verboseHAPCAN(text, hd)
  * 
- * \param   same as printf
+ * \param   module      debugModule_t
+ * \param   level       debugLevel_t
+ * \param   text        text printed before the frame
+ * \param   hd          HAPCAN frame
  * \return  none
  */
-void debug_printHAPCAN(const char * text, hapcanCANData *hd);
+void debug_logHAPCAN(int module, int level, const char * text, 
+        hapcanCANData *hd);
+#define debug_printHAPCAN(text, hd) \
+        debug_logHAPCAN(DEBUG_MODULE, DEBUG_LEVEL_INFO, text, hd)
+#define debug_verboseHAPCAN(text, hd) \
+        debug_logHAPCAN(DEBUG_MODULE, DEBUG_LEVEL_DEBUG, text, hd)
 
 /**
- * Debug Print HAPCAN Socket Frame
+ * Debug Print HAPCAN Socket Frame - use debug_printSocket(text, data, dataLen)
+ * or debug_verboseSocket(text, data, dataLen)
  * 
- * \param   same as printf
+ * \param   module      debugModule_t
+ * \param   level       debugLevel_t
+ * \param   text        text printed before the frame
+ * \param   data        socket data
+ * \param   dataLen     socket data length
  * \return  none
  */
-void debug_printSocket(const char * text, uint8_t* data, int dataLen);
+void debug_logSocket(int module, int level, const char * text, uint8_t* data, 
+        int dataLen);
+#define debug_printSocket(text, data, dataLen) \
+        debug_logSocket(DEBUG_MODULE, DEBUG_LEVEL_INFO, text, data, dataLen)
+#define debug_verboseSocket(text, data, dataLen) \
+        debug_logSocket(DEBUG_MODULE, DEBUG_LEVEL_DEBUG, text, data, dataLen)
 
 #ifdef __cplusplus
 }
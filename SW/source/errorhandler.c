@@ -6,6 +6,20 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Count the resets of each module (metrics)                                //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_MANAGER         //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add errorh_isCANError: CAN errors reset the channel that set them        //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_MANAGER
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,6 +28,7 @@
 #include "canbuf.h"
 #include "debug.h"
 #include "errorhandler.h"
+#include "metrics.h"
 #include "mqttbuf.h"
 #include "socketserverbuf.h"
 
@@ -36,6 +51,15 @@
  * Check the error response set by a module.
  */
 bool errorh_isError(errorh_module_t module, int error)
+{
+    // CAN errors without a channel are from the first channel
+    return errorh_isCANError(SOCKETCAN_CHANNEL_0, module, error);
+}
+
+/*
+ * Check the error response set by a module, for a CAN channel.
+ */
+bool errorh_isCANError(int channel, errorh_module_t module, int error)
 {
     bool ret = false;
     switch(module)
@@ -52,7 +76,7 @@ bool errorh_isError(errorh_module_t module, int error)
                 case CAN_SEND_PARAMETER_ERROR:    
                 default:
                     // Re-Init and clean Buffers                    
-                    canbuf_close(0, 1);
+                    canbuf_close(channel, 1);
                     ret = true;                
                     break;
             }
@@ -69,7 +93,7 @@ bool errorh_isError(errorh_module_t module, int error)
                 case CAN_RECEIVE_PARAMETER_ERROR:
                 default:
                     // Re-Init and clean Buffers                    
-                    canbuf_close(0, 1);
+                    canbuf_close(channel, 1);
                     ret = true;
                     break;
             }
@@ -148,6 +172,10 @@ bool errorh_isError(errorh_module_t module, int error)
             ret = false;
             break;
     }
+    if(ret)
+    {
+        metrics_add(METRICS_ERROR_RESETS, module, 1);
+    }
     // Return
     return ret;
 }
\ No newline at end of file
@@ -6,6 +6,12 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add ERROR_NUMBER_OF_MODULES (resets are counted per module)              //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add errorh_isCANError (CAN errors of a channel)                          //
+//----------------------------------------------------------------------------//
 
 #ifndef ERRORHANDLER_H
 #define ERRORHANDLER_H
@@ -27,7 +33,8 @@ typedef enum
     ERROR_MODULE_SOCKETSERVER_SEND,
     ERROR_MODULE_SOCKETSERVER_RECEIVE,
     ERROR_MODULE_MQTT_PUB,
-    ERROR_MODULE_MQTT_SUB    
+    ERROR_MODULE_MQTT_SUB,
+    ERROR_NUMBER_OF_MODULES
 } errorh_module_t;
     
 //----------------------------------------------------------------------------//
@@ -42,6 +49,17 @@ typedef enum
  */
 bool errorh_isError(errorh_module_t module, int error);
 
+/*
+ * Check the error response set by a module, for a CAN channel (the CAN 
+ * errors reset this channel only).
+ * \param   channel (INPUT) CAN channel
+ * \param   module  (INPUT) module that set the response
+ * \param   error   (INPUT) error - the error response to be checked 
+ * \return  TRUE: ERROR
+ *          FALSE: NOT AN ERROR
+ */
+bool errorh_isCANError(int channel, errorh_module_t module, int error);
+
 #ifdef __cplusplus
 }
 #endif
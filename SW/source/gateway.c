@@ -6,6 +6,47 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Elements carry the module handlers and an opaque per-channel context.    //
+// Add gateway_handleCAN2MQTT / gateway_handleMQTT2CAN: a single list walk    //
+// calling the handler of each match                                          //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Topics are interned (topic.c): a single shared copy per topic, handed    //
+// over to the list instead of copied twice                                   //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Lookups and matches of the handlers are counted (metrics)                //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_GATEWAY         //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Add gateway_beginUpdate / gateway_endUpdate: on a configuration reload,  //
+// elements that did not change are kept and only the others are added /      //
+// removed                                                                    //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Add gateway_walkList                                                     //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - Lists are protected by read / write locks: frames and topics are         //
+// handled in parallel (e.g. CAN->MQTT workers), only updates are exclusive   //
+//----------------------------------------------------------------------------//
+//  1.08     | 18/Oct/2026 |                               | ALCP             //
+// - Handlers are called after the list is unlocked: the matched elements     //
+// are referenced (an element removed meanwhile is freed by its last user)    //
+//----------------------------------------------------------------------------//
+//  1.09     | 18/Oct/2026 |                               | ALCP             //
+// - Reload: the new configuration is added to a separate list, swapped in    //
+// by gateway_endUpdate (elements not changed are found by hash and kept).    //
+// Handlers never see the old and new copies of an element at once            //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_GATEWAY
 
 //----------------------------------------------------------------------------//
 // Includes
@@ -14,6 +55,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <limits.h>
 #include <errno.h>
 #include <pthread.h>
@@ -21,12 +63,15 @@
 #include "hapcan.h"
 #include "auxiliary.h"
 #include "debug.h"
+#include "metrics.h"
+#include "topic.h"
 
 //----------------------------------------------------------------------------//
 // INTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
- 
- 
+// Matches of a frame / topic kept without allocation (more are allocated)
+#define GATEWAY_LOCAL_MATCHES   16
+
 //----------------------------------------------------------------------------//
 // INTERNAL TYPES
 //----------------------------------------------------------------------------//
@@ -35,27 +80,65 @@ typedef struct gatewayList
 {
     hapcanCANData hd_mask;      // CAN2MQTT (INPUT)
     hapcanCANData hd_check;     // CAN2MQTT (INPUT)
-    char* state_topic;          // CAN2MQTT (OUTPUT)
-    char* command_topic;        // MQTT2CAN (INPUT)
+    const char* state_topic;    // CAN2MQTT (OUTPUT) - interned
+    const char* command_topic;  // MQTT2CAN (INPUT) - interned
     hapcanCANData hd_result;    // MQTT2CAN (OUTPUT)
+    gatewayHandler handler;     // BOTH (called on a match)
+    void *context;              // BOTH (passed to the handler)
+    int context_len;            // BOTH
+    struct gatewayList *keep;   // Reload: equal element of the current list
+    int refs;                   // List (1) and handlers being called
     struct gatewayList *next;
 } gatewayList;
 
+// Elements matched by a frame / topic (referenced while the handlers run)
+typedef struct
+{
+    gatewayList* local[GATEWAY_LOCAL_MATCHES];
+    gatewayList** element;
+    int n;
+    int size;
+} gatewayMatches;
+
+// Element of the current list indexed on a reload (see gateway_endUpdate)
+typedef struct
+{
+    gatewayList* element;       // NULL: kept in the new list
+    int next;                   // Next of the same bucket (-1: last)
+} gatewayIndexNode;
+
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
-static pthread_mutex_t g_CAN2MQTT_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t g_MQTT2CAN_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Read: search / handle. Write: lists changed (init, add, update)
+static pthread_rwlock_t g_CAN2MQTT_lock = PTHREAD_RWLOCK_INITIALIZER;
+static pthread_rwlock_t g_MQTT2CAN_lock = PTHREAD_RWLOCK_INITIALIZER;
 static gatewayList* head[NUMBER_OF_GATEWAY_LISTS] = {NULL, NULL};
+// Reload: elements added since gateway_beginUpdate (not used to match until 
+// gateway_endUpdate). Lock order: g_update_mutex, then the lists
+static pthread_mutex_t g_update_mutex = PTHREAD_MUTEX_INITIALIZER;
+static gatewayList* g_update[NUMBER_OF_GATEWAY_LISTS] = {NULL, NULL};
+static bool g_updating = false;
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
 static void clearElementData(gatewayList* element);
 static void freeElementData(gatewayList* element);
-static void gateway_addToList(int list, gatewayList* element);
+static void releaseElement(gatewayList* element);
+static void initMatches(gatewayMatches* matches);
+static void addMatch(gatewayMatches* matches, gatewayList* element);
+static void releaseMatches(gatewayMatches* matches);
+static void gateway_addToList(gatewayList** first, gatewayList* element);
 static gatewayList* gateway_getFromOffset(int list, int offset);    // NULL means error
 static int gateway_deleteList(int list);       // EXIT_SUCCESS / EXIT_FAILURE
+static bool sameFrame(hapcanCANData *a, hapcanCANData *b);
+static bool sameElement(gatewayList* a, gatewayList* b);
+static uint32_t hashBytes(uint32_t hash, const void *data, size_t len);
+static uint32_t hashFrame(uint32_t hash, const hapcanCANData *hd);
+static uint32_t hashElement(const gatewayList* element);
+static void releaseUpdate(int list);
+static void gateway_swapList(int list);
 #ifdef DEBUG_GATEWAY_PRINT
 static void gateway_printElement(gatewayList* current);
 #endif
@@ -67,6 +150,12 @@ static void clearElementData(gatewayList* element)
     aux_clearHAPCANFrame(&(element->hd_check));
     element->state_topic = NULL;
     element->command_topic = NULL;
+    element->handler.can2mqtt = NULL;
+    element->handler.mqtt2can = NULL;
+    element->context = NULL;
+    element->context_len = 0;
+    element->keep = NULL;
+    element->refs = 0;
     element->next = NULL;
 }
 
@@ -76,57 +165,116 @@ static void freeElementData(gatewayList* element)
     // Topic
     if(element->state_topic != NULL)
     {
-        free(element->state_topic);
+        topic_release(element->state_topic);
         element->state_topic = NULL;
     }
     // Payload
     if(element->command_topic != NULL)
     {
-        free(element->command_topic);
+        topic_release(element->command_topic);
         element->command_topic = NULL;
     }
+    // Context
+    if(element->context != NULL)
+    {
+        free(element->context);
+        element->context = NULL;
+    }
 }
 
-// Add element to a given list
-static void gateway_addToList(int list, gatewayList* element)
+// Drop a reference: the element is freed by the last one (removed from the 
+// list and no handler running)
+static void releaseElement(gatewayList* element)
 {
-    gatewayList *link;
-            
-    // Check list index parameter
-    if((list < 0) || (list >= NUMBER_OF_GATEWAY_LISTS))
+    if(__atomic_sub_fetch(&element->refs, 1, __ATOMIC_ACQ_REL) == 0)
     {
-        #ifdef DEBUG_GATEWAY_ERRORS
-        debug_print("gateway_addToList ERROR: list ERROR!\n");
-        #endif
-        return;
-    }    
-    // Create a new element to the list
-    link = (gatewayList*)malloc(sizeof(*link));	
-    // Copy structure data ("shallow" copy)
-    *link = *element;   
-    // Create and copy field that are pointers
-    // - STATE TOPIC
-    if(element->state_topic != NULL)
+        freeElementData(element);
+        free(element);
+    }
+}
+
+// No element matched yet
+static void initMatches(gatewayMatches* matches)
+{
+    matches->element = matches->local;
+    matches->n = 0;
+    matches->size = GATEWAY_LOCAL_MATCHES;
+}
+
+// Reference a matched element - LOCKED BY THE CALLER (read)
+static void addMatch(gatewayMatches* matches, gatewayList* element)
+{
+    gatewayList** grown;
+    if(matches->n == matches->size)
     {
-        link->state_topic = strdup(element->state_topic);
+        if(matches->element == matches->local)
+        {
+            grown = malloc(2 * matches->size * sizeof(*grown));
+            if(grown != NULL)
+            {
+                memcpy(grown, matches->local, sizeof(matches->local));
+            }
+        }
+        else
+        {
+            grown = realloc(matches->element, 
+                    2 * matches->size * sizeof(*grown));
+        }
+        if(grown == NULL)
+        {
+            #ifdef DEBUG_GATEWAY_ERRORS
+            debug_error("gateway addMatch ERROR: no memory - match "
+                    "ignored!\n");
+            #endif
+            return;
+        }
+        matches->element = grown;
+        matches->size *= 2;
     }
-    else
+    __atomic_add_fetch(&element->refs, 1, __ATOMIC_RELAXED);
+    matches->element[matches->n] = element;
+    matches->n++;
+}
+
+// Drop the references of the matched elements
+static void releaseMatches(gatewayMatches* matches)
+{
+    int i;
+    for(i = 0; i < matches->n; i++)
     {
-        link->state_topic = NULL;
+        releaseElement(matches->element[i]);
     }
-    // - COMMAND TOPIC
-    if(element->command_topic != NULL)
+    if(matches->element != matches->local)
     {
-        link->command_topic = strdup(element->command_topic);
+        free(matches->element);
     }
-    else
+    initMatches(matches);
+}
+
+// Add element to a given list (first element of the list or of a reload)
+static void gateway_addToList(gatewayList** first, gatewayList* element)
+{
+    gatewayList *link;
+            
+    // Create a new element to the list
+    link = (gatewayList*)malloc(sizeof(*link));	
+    if(link == NULL)
     {
-        link->command_topic = NULL;
-    }	
+        #ifdef DEBUG_GATEWAY_ERRORS
+        debug_error("gateway_addToList ERROR: no memory!\n");
+        #endif
+        freeElementData(element);
+        return;
+    }
+    // Copy structure data ("shallow" copy): the fields that are pointers 
+    // (topics and context) are handed over to the list
+    *link = *element;   
+    // Reference of the list
+    link->refs = 1;
     // Set next in list to previous header (previous first node)
-    link->next = head[list];	
+    link->next = *first;	
     // Point header (first node) to current element (new first node)
-    head[list] = link;
+    *first = link;
 }
 
 // get element from header (after offset positions)
@@ -179,12 +327,10 @@ static int gateway_deleteList(int list)
         next = current->next;
         //*******************************//
         // Free fields that are pointers //
+        // and structure itself (when no //
+        // handler uses it)              //
         //*******************************//
-        freeElementData(current);
-        //*******************************//
-        // Free structure itself         //
-        //*******************************//
-        free(current);
+        releaseElement(current);
         //*******************************//
         // Get new current address       //
         //*******************************//
@@ -195,24 +341,241 @@ static int gateway_deleteList(int list)
     return EXIT_SUCCESS;
 }
 
+// Same HAPCAN Frame (field by field: the structure has padding)
+static bool sameFrame(hapcanCANData *a, hapcanCANData *b)
+{
+    return (a->frametype == b->frametype) && (a->flags == b->flags) && 
+            (a->module == b->module) && (a->group == b->group) && 
+            (memcmp(a->data, b->data, HAPCAN_DATA_LEN) == 0);
+}
+
+// Same configuration (topics are interned: same topic is same pointer)
+static bool sameElement(gatewayList* a, gatewayList* b)
+{
+    return sameFrame(&a->hd_mask, &b->hd_mask) && 
+            sameFrame(&a->hd_check, &b->hd_check) && 
+            sameFrame(&a->hd_result, &b->hd_result) && 
+            (a->state_topic == b->state_topic) && 
+            (a->command_topic == b->command_topic) && 
+            (a->handler.can2mqtt == b->handler.can2mqtt) && 
+            (a->handler.mqtt2can == b->handler.mqtt2can) && 
+            (a->context_len == b->context_len) && 
+            ((a->context_len == 0) || 
+            (memcmp(a->context, b->context, a->context_len) == 0));
+}
+
+// FNV-1a hash of some bytes
+static uint32_t hashBytes(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *byte = data;
+    size_t i;
+    for(i = 0; i < len; i++)
+    {
+        hash = (hash ^ byte[i]) * 16777619U;
+    }
+    return hash;
+}
+
+// Hash of a HAPCAN Frame (field by field: the structure has padding)
+static uint32_t hashFrame(uint32_t hash, const hapcanCANData *hd)
+{
+    hash = hashBytes(hash, &hd->frametype, sizeof(hd->frametype));
+    hash = hashBytes(hash, &hd->flags, sizeof(hd->flags));
+    hash = hashBytes(hash, &hd->module, sizeof(hd->module));
+    hash = hashBytes(hash, &hd->group, sizeof(hd->group));
+    return hashBytes(hash, hd->data, HAPCAN_DATA_LEN);
+}
+
+// Hash of the configuration of an element (equal elements - see sameElement 
+// - have the same hash)
+static uint32_t hashElement(const gatewayList* element)
+{
+    uint32_t hash = 2166136261U;
+    hash = hashFrame(hash, &element->hd_mask);
+    hash = hashFrame(hash, &element->hd_check);
+    hash = hashFrame(hash, &element->hd_result);
+    // Topics are interned: same topic is same pointer
+    hash = hashBytes(hash, &element->state_topic, 
+            sizeof(element->state_topic));
+    return hashBytes(hash, &element->command_topic, 
+            sizeof(element->command_topic));
+}
+
+// Free the elements added since gateway_beginUpdate - LOCKED BY THE CALLER 
+// (g_update_mutex)
+static void releaseUpdate(int list)
+{
+    gatewayList* current;
+    gatewayList* next;
+    for(current = g_update[list]; current != NULL; current = next)
+    {
+        next = current->next;
+        releaseElement(current);
+    }
+    g_update[list] = NULL;
+}
+
+// Replace a list by the elements added since gateway_beginUpdate. Elements 
+// equal to one of the current list are replaced by it (not changed: handlers 
+// using them are not affected) - LOCKED BY THE CALLER (g_update_mutex)
+static void gateway_swapList(int list)
+{
+    gatewayList* current;
+    gatewayList* next;
+    gatewayList* element;
+    gatewayList* tail;
+    gatewayList* old;
+    gatewayList* dropped;
+    gatewayIndexNode* node;
+    int* bucket;
+    unsigned int n_buckets;
+    unsigned int h;
+    int n;
+    int i;
+    int kept;
+    //---------------------------------------------
+    // Index the current list by hash (only this thread changes the lists: 
+    // read without the list locks)
+    //---------------------------------------------
+    n = 0;
+    for(current = head[list]; current != NULL; current = current->next) 
+    {
+        n++;
+    }
+    n_buckets = 1;
+    while(n_buckets < (unsigned int)n)
+    {
+        n_buckets <<= 1;
+    }
+    node = (n > 0) ? malloc(n * sizeof(*node)) : NULL;
+    bucket = (node != NULL) ? malloc(n_buckets * sizeof(*bucket)) : NULL;
+    kept = 0;
+    if(bucket != NULL)
+    {
+        for(h = 0; h < n_buckets; h++)
+        {
+            bucket[h] = -1;
+        }
+        i = 0;
+        for(current = head[list]; current != NULL; current = current->next) 
+        {
+            h = hashElement(current) & (n_buckets - 1);
+            node[i].element = current;
+            node[i].next = bucket[h];
+            bucket[h] = i;
+            i++;
+        }
+        // Elements of the new configuration already in the list
+        for(current = g_update[list]; current != NULL; 
+                current = current->next) 
+        {
+            h = hashElement(current) & (n_buckets - 1);
+            for(i = bucket[h]; i >= 0; i = node[i].next)
+            {
+                if((node[i].element != NULL) && 
+                        sameElement(node[i].element, current))
+                {
+                    current->keep = node[i].element;
+                    node[i].element = NULL;
+                    kept++;
+                    break;
+                }
+            }
+        }
+    }
+    //---------------------------------------------
+    // Swap - PROTECTED
+    //---------------------------------------------
+    dropped = NULL;
+    tail = NULL;
+    // LOCK GATEWAY: CAN2MQTT and MQTT2CAN data
+    pthread_rwlock_wrlock(&g_CAN2MQTT_lock);
+    pthread_rwlock_wrlock(&g_MQTT2CAN_lock);
+    old = head[list];
+    head[list] = NULL;
+    for(current = g_update[list]; current != NULL; current = next) 
+    {
+        next = current->next;
+        element = current;
+        if(current->keep != NULL)
+        {
+            // Not changed since the last configuration: keep it
+            element = current->keep;
+            current->keep = NULL;
+            current->next = dropped;
+            dropped = current;
+        }
+        element->next = NULL;
+        if(tail == NULL)
+        {
+            head[list] = element;
+        }
+        else
+        {
+            tail->next = element;
+        }
+        tail = element;
+    }
+    // UNLOCK GATEWAY: CAN2MQTT and MQTT2CAN data
+    pthread_rwlock_unlock(&g_CAN2MQTT_lock);
+    pthread_rwlock_unlock(&g_MQTT2CAN_lock);
+    g_update[list] = NULL;
+    //---------------------------------------------
+    // Free the elements not used (no longer reachable from the list: freed 
+    // by the last handler still using them)
+    //---------------------------------------------
+    for(current = dropped; current != NULL; current = next)
+    {
+        next = current->next;
+        releaseElement(current);
+    }
+    if(bucket != NULL)
+    {
+        for(i = 0; i < n; i++)
+        {
+            if(node[i].element != NULL)
+            {
+                releaseElement(node[i].element);
+            }
+        }
+    }
+    else
+    {
+        // Nothing kept: the old list is not changed
+        for(current = old; current != NULL; current = next)
+        {
+            next = current->next;
+            releaseElement(current);
+        }
+    }
+    free(bucket);
+    free(node);
+    #ifdef DEBUG_GATEWAY_LISTS
+    debug_verbose("gateway_swapList: List = %d - %d kept, %d removed\n", 
+            list, kept, n - kept);
+    #endif
+}
+
 // Print all fields from a given element
 #ifdef DEBUG_GATEWAY_PRINT
 static void gateway_printElement(gatewayList* current)
 {
-    debug_print("gateway_printElement\n");
-    debug_print("CAN2MQTT fields:\n");
-    debug_printHAPCAN("    - MASK (IN):\n", 
+    debug_verbose("gateway_printElement\n");
+    debug_verbose("CAN2MQTT fields:\n");
+    debug_verboseHAPCAN("    - MASK (IN):\n", 
             &(current->hd_mask));
-    debug_printHAPCAN("    - CHECK (IN):\n", 
+    debug_verboseHAPCAN("    - CHECK (IN):\n", 
             &(current->hd_check));
-    debug_print("    - STATE TOPIC (OUT) = %s\n", 
+    debug_verbose("    - STATE TOPIC (OUT) = %s\n", 
             current->state_topic);
-    debug_print("MQTT2CAN fields:\n");
-    debug_print("    - COMMAND TOPIC (IN) = %s\n", 
+    debug_verbose("MQTT2CAN fields:\n");
+    debug_verbose("    - COMMAND TOPIC (IN) = %s\n", 
             current->command_topic);
-    debug_printHAPCAN("    - HAPCAN Frame (OUT):\n", 
+    debug_verboseHAPCAN("    - HAPCAN Frame (OUT):\n", 
             &(current->hd_result));
-    debug_print("    *NEXT = %d\n----\n", (int)current->next);
+    debug_verbose("Handler fields:\n");
+    debug_verbose("    - CONTEXT LEN = %d\n", current->context_len);
+    debug_verbose("    *NEXT = %p\n----\n", (void*)current->next);
 }
 #endif
 
@@ -224,32 +587,74 @@ void gateway_init(void)
 {
     int list;
     int check;
+    // LOCK GATEWAY: reload
+    pthread_mutex_lock(&g_update_mutex);
+    g_updating = false;
     for(list = GATEWAY_MQTT2CAN_LIST; list < NUMBER_OF_GATEWAY_LISTS; list++)
     {        
+        releaseUpdate(list);
         //---------------------------------------------
         // Delete list - PROTECTED
         //---------------------------------------------
         // LOCK GATEWAY: CAN2MQTT and MQTT2CAN data
-        pthread_mutex_lock(&g_CAN2MQTT_mutex);
-        pthread_mutex_lock(&g_MQTT2CAN_mutex);
+        pthread_rwlock_wrlock(&g_CAN2MQTT_lock);
+        pthread_rwlock_wrlock(&g_MQTT2CAN_lock);
         // Delete
         check = gateway_deleteList(list);
         // UNLOCK GATEWAY: CAN2MQTT and MQTT2CAN data
-        pthread_mutex_unlock(&g_CAN2MQTT_mutex);
-        pthread_mutex_unlock(&g_MQTT2CAN_mutex);
+        pthread_rwlock_unlock(&g_CAN2MQTT_lock);
+        pthread_rwlock_unlock(&g_MQTT2CAN_lock);
         if( check == EXIT_FAILURE )
         {
             #ifdef DEBUG_GATEWAY_ERRORS
-            debug_print("gateway_init error - List = %d\n", list);    
+            debug_error("gateway_init error - List = %d\n", list);    
             #endif
         }
     }
+    // UNLOCK GATEWAY: reload
+    pthread_mutex_unlock(&g_update_mutex);
+}
+
+// Start a reload: the new configuration is added to a separate list
+void gateway_beginUpdate(void)
+{
+    int list;
+    // LOCK GATEWAY: reload
+    pthread_mutex_lock(&g_update_mutex);
+    for(list = GATEWAY_MQTT2CAN_LIST; list < NUMBER_OF_GATEWAY_LISTS; list++)
+    {
+        // Reload not ended
+        releaseUpdate(list);
+    }
+    g_updating = true;
+    // UNLOCK GATEWAY: reload
+    pthread_mutex_unlock(&g_update_mutex);
+}
+
+// Use the new configuration (elements that did not change are kept)
+void gateway_endUpdate(void)
+{
+    int list;
+    // LOCK GATEWAY: reload
+    pthread_mutex_lock(&g_update_mutex);
+    if(g_updating)
+    {
+        for(list = GATEWAY_MQTT2CAN_LIST; list < NUMBER_OF_GATEWAY_LISTS; 
+                list++)
+        {
+            gateway_swapList(list);
+        }
+        g_updating = false;
+    }
+    // UNLOCK GATEWAY: reload
+    pthread_mutex_unlock(&g_update_mutex);
 }
 
 // Add elements to the List
 int gateway_AddElementToList(int list, hapcanCANData *phd_mask, 
         hapcanCANData *phd_check, char *state_topic, char* command_topic,         
-        hapcanCANData *phd_result)
+        hapcanCANData *phd_result, const gatewayHandler *handler, 
+        const void *context, int context_len)
 {
     int ret = 0;
     gatewayList element;
@@ -264,38 +669,61 @@ int gateway_AddElementToList(int list, hapcanCANData *phd_mask,
     }
     if(state_topic != NULL)
     {
-        element.state_topic = strdup(state_topic);
+        element.state_topic = topic_intern(state_topic);
     }
     if(command_topic != NULL)
     {
-        element.command_topic = strdup(command_topic);
+        element.command_topic = topic_intern(command_topic);
     }
     if(phd_result != NULL)
     {
         element.hd_result = *phd_result;
     }
+    if(handler != NULL)
+    {
+        element.handler = *handler;
+    }
+    if((context != NULL) && (context_len > 0))
+    {
+        element.context = malloc(context_len);
+        memcpy(element.context, context, context_len);
+        element.context_len = context_len;
+    }
     // Check list index parameter
     if((list < 0) || (list >= NUMBER_OF_GATEWAY_LISTS))
     {
         ret = EXIT_FAILURE;
+        // Not added - free data
+        freeElementData(&element);
     }
     else
     {
         ret = EXIT_SUCCESS;
-        //---------------------------------------------
-        // Add to list - PROTECTED
-        //---------------------------------------------
-        // LOCK GATEWAY: CAN2MQTT and MQTT2CAN data
-        pthread_mutex_lock(&g_CAN2MQTT_mutex);
-        pthread_mutex_lock(&g_MQTT2CAN_mutex);
-        // Add
-        gateway_addToList(list, &element);
-        // UNLOCK GATEWAY: CAN2MQTT and MQTT2CAN data
-        pthread_mutex_unlock(&g_CAN2MQTT_mutex);
-        pthread_mutex_unlock(&g_MQTT2CAN_mutex);
+        // LOCK GATEWAY: reload
+        pthread_mutex_lock(&g_update_mutex);
+        if(g_updating)
+        {
+            // Reload: not used to match until gateway_endUpdate (element 
+            // data is handed over to the list)
+            gateway_addToList(&g_update[list], &element);
+        }
+        else
+        {
+            //---------------------------------------------
+            // Add to list - PROTECTED
+            //---------------------------------------------
+            // LOCK GATEWAY: CAN2MQTT and MQTT2CAN data
+            pthread_rwlock_wrlock(&g_CAN2MQTT_lock);
+            pthread_rwlock_wrlock(&g_MQTT2CAN_lock);
+            // Add (element data is handed over to the list)
+            gateway_addToList(&head[list], &element);
+            // UNLOCK GATEWAY: CAN2MQTT and MQTT2CAN data
+            pthread_rwlock_unlock(&g_CAN2MQTT_lock);
+            pthread_rwlock_unlock(&g_MQTT2CAN_lock);
+        }
+        // UNLOCK GATEWAY: reload
+        pthread_mutex_unlock(&g_update_mutex);
     }
-    // Free data and then return
-    freeElementData(&element);
     return ret;
 }
 
@@ -308,11 +736,12 @@ int gateway_AddElementToList(int list, hapcanCANData *phd_mask,
     int position;
     bool match;    
     // LOCK GATEWAY: CAN2MQTT data
-    pthread_mutex_lock(&g_CAN2MQTT_mutex);
+    pthread_rwlock_rdlock(&g_CAN2MQTT_lock);
     // Get element from offset position
     current = gateway_getFromOffset(list, offset);
     #ifdef DEBUG_GATEWAY_SEARCH
-    debug_printHAPCAN("gateway_searchMQTTFromCAN - CAN Frame to be matched:\n", 
+    debug_verboseHAPCAN(
+            "gateway_searchMQTTFromCAN - CAN Frame to be matched:\n", 
             phd_received);    
     #endif     
     // Check remaining from offset
@@ -328,7 +757,7 @@ int gateway_AddElementToList(int list, hapcanCANData *phd_mask,
         if(match)
         {
             #ifdef DEBUG_GATEWAY_SEARCH
-            debug_print("gateway_searchMQTTFromCAN - Frame Matched \n");
+            debug_verbose("gateway_searchMQTTFromCAN - Frame Matched \n");
             #endif
             // Found - stop searching
             break;
@@ -344,44 +773,87 @@ int gateway_AddElementToList(int list, hapcanCANData *phd_mask,
         position = -1;
     }
     // UNLOCK GATEWAY: CAN2MQTT data
-    pthread_mutex_unlock(&g_CAN2MQTT_mutex);
+    pthread_rwlock_unlock(&g_CAN2MQTT_lock);
     // return
     return position;    
  }
 
+// Call the handler of each element matching a HAPCAN Frame
+int gateway_handleCAN2MQTT(hapcanCANData *phd_received, 
+        unsigned long long timestamp)
+{
+    const int list = GATEWAY_CAN2MQTT_LIST;
+    gatewayList* current;
+    gatewayMatches matches;
+    int ret;
+    int i;
+    bool match;
+    // Init with no response
+    ret = HAPCAN_NO_RESPONSE;
+    initMatches(&matches);
+    // LOCK GATEWAY: CAN2MQTT data
+    pthread_rwlock_rdlock(&g_CAN2MQTT_lock);
+    for(current = head[list]; current != NULL; current = current->next)
+    {
+        match = aux_checkCAN2MQTTMatch(phd_received, &(current->hd_mask), 
+                &(current->hd_check));
+        if(match && (current->handler.can2mqtt != NULL))
+        {
+            #ifdef DEBUG_GATEWAY_SEARCH
+            debug_verbose("gateway_handleCAN2MQTT - Frame Matched \n");
+            #endif
+            addMatch(&matches, current);
+        }
+    }
+    // UNLOCK GATEWAY: CAN2MQTT data (handlers may wait for the MQTT queue)
+    pthread_rwlock_unlock(&g_CAN2MQTT_lock);
+    for(i = 0; i < matches.n; i++)
+    {
+        current = matches.element[i];
+        ret = current->handler.can2mqtt((char *)current->state_topic, 
+                phd_received, current->context, timestamp);
+        if(ret == HAPCAN_MQTT_RESPONSE_ERROR)
+        {
+            // Leave - MQTT Pub Buffer error
+            break;
+        }
+    }
+    metrics_add(METRICS_GATEWAY_LOOKUPS, METRICS_GATEWAY_CAN2MQTT, 1);
+    if(matches.n > 0)
+    {
+        metrics_add(METRICS_GATEWAY_MATCHES, METRICS_GATEWAY_CAN2MQTT, 1);
+    }
+    releaseMatches(&matches);
+    // return
+    return ret;
+}
+
 // Returns the MQTT data from a given position. EXIT_SUCCESS / EXIT_FAILURE
-int gateway_getMQTTFromCAN(int offset, char** topic)
+int gateway_getMQTTFromCAN(int offset, const char** topic)
 {
     int ret = EXIT_SUCCESS;
     const int list = GATEWAY_CAN2MQTT_LIST;
     gatewayList* current;    
     // LOCK GATEWAY: CAN2MQTT data
-    pthread_mutex_lock(&g_CAN2MQTT_mutex);
+    pthread_rwlock_rdlock(&g_CAN2MQTT_lock);
     // Get element from offset position
     current = gateway_getFromOffset(list, offset);    
     // Check
     if(current == NULL)
     {
         #ifdef DEBUG_GATEWAY_ERRORS
-        debug_print("gateway_getMQTTFromCAN ERROR: Nothing to get!\n");
+        debug_error("gateway_getMQTTFromCAN ERROR: Nothing to get!\n");
         #endif
         ret = EXIT_FAILURE;
     }
     if(ret == EXIT_SUCCESS)
     {
         // Copy data
-        // - TOPIC
-        if(current->state_topic != NULL)
-        {
-            *topic = strdup(current->state_topic);
-        }
-        else
-        {
-            *topic = NULL;
-        }
+        // - TOPIC (one more reference of the interned topic)
+        *topic = topic_acquire(current->state_topic);
     }
     // UNLOCK GATEWAY: CAN2MQTT data
-    pthread_mutex_unlock(&g_CAN2MQTT_mutex);
+    pthread_rwlock_unlock(&g_CAN2MQTT_lock);
     // RETURN
     return ret;
 }
@@ -394,12 +866,12 @@ int gateway_getMQTTFromCAN(int offset, char** topic)
     int position;
     bool match;
     // LOCK GATEWAY: MQTT2CAN data
-    pthread_mutex_lock(&g_MQTT2CAN_mutex);
+    pthread_rwlock_rdlock(&g_MQTT2CAN_lock);
     // Get element from offset position
     current = gateway_getFromOffset(list, offset);
     // Debug
     #ifdef DEBUG_GATEWAY_SEARCH
-    debug_print("gateway_searchCANFromMQTT - MQTT Frame to Match - TOPIC: %s\n", 
+    debug_verbose("gateway_searchCANFromMQTT - MQTT Frame to Match - TOPIC: %s\n", 
             topic);
     #endif    
     // Check remaining from offset
@@ -410,11 +882,11 @@ int gateway_getMQTTFromCAN(int offset, char** topic)
         //*******************************//
         // Check data                    //
         //*******************************//    
-        if( aux_compareStrings(topic, current->command_topic) && 
+        if( aux_compareStrings(topic, (char *)current->command_topic) && 
                 (topic != NULL) )
         {
             #ifdef DEBUG_GATEWAY_SEARCH
-            debug_print("gateway_searchMQTTFromCAN - Topic Matched \n");
+            debug_verbose("gateway_searchMQTTFromCAN - Topic Matched \n");
             #endif 
             match = true;
             // Found - stop searching
@@ -431,11 +903,66 @@ int gateway_getMQTTFromCAN(int offset, char** topic)
         position = -1;
     }
     // UNLOCK GATEWAY: MQTT2CAN data
-    pthread_mutex_unlock(&g_MQTT2CAN_mutex);
+    pthread_rwlock_unlock(&g_MQTT2CAN_lock);
     // Return
     return position;    
  }
 
+// Call the handler of each element matching a topic
+int gateway_handleMQTT2CAN(char* const topic, void *payload, int payloadlen, 
+        unsigned long long timestamp)
+{
+    const int list = GATEWAY_MQTT2CAN_LIST;
+    gatewayList* current;
+    gatewayMatches matches;
+    hapcanCANData hd_result;
+    int ret;
+    int i;
+    // Init with no response
+    ret = HAPCAN_NO_RESPONSE;
+    if(topic == NULL)
+    {
+        return ret;
+    }
+    initMatches(&matches);
+    // LOCK GATEWAY: MQTT2CAN data
+    pthread_rwlock_rdlock(&g_MQTT2CAN_lock);
+    for(current = head[list]; current != NULL; current = current->next)
+    {
+        if(aux_compareStrings(topic, (char *)current->command_topic) && 
+                (current->handler.mqtt2can != NULL))
+        {
+            #ifdef DEBUG_GATEWAY_SEARCH
+            debug_verbose("gateway_handleMQTT2CAN - Topic Matched \n");
+            #endif
+            addMatch(&matches, current);
+        }
+    }
+    // UNLOCK GATEWAY: MQTT2CAN data (handlers may wait for the CAN queue)
+    pthread_rwlock_unlock(&g_MQTT2CAN_lock);
+    for(i = 0; i < matches.n; i++)
+    {
+        current = matches.element[i];
+        // The handler fills the HAPCAN Frame - use a copy
+        hd_result = current->hd_result;
+        ret = current->handler.mqtt2can(&hd_result, current->context, 
+                payload, payloadlen, timestamp);
+        if(ret == HAPCAN_CAN_RESPONSE_ERROR)
+        {
+            // Leave - CAN Write Buffer error
+            break;
+        }
+    }
+    metrics_add(METRICS_GATEWAY_LOOKUPS, METRICS_GATEWAY_MQTT2CAN, 1);
+    if(matches.n > 0)
+    {
+        metrics_add(METRICS_GATEWAY_MATCHES, METRICS_GATEWAY_MQTT2CAN, 1);
+    }
+    releaseMatches(&matches);
+    // Return
+    return ret;
+}
+
 // Returns the CAN data from a given position. EXIT_SUCCESS / EXIT_FAILURE
 int gateway_getCANFromMQTT(int offset, hapcanCANData *p_hd)
 {
@@ -443,14 +970,14 @@ int gateway_getCANFromMQTT(int offset, hapcanCANData *p_hd)
     const int list = GATEWAY_MQTT2CAN_LIST;
     gatewayList* current;
     // LOCK GATEWAY: MQTT2CAN data
-    pthread_mutex_lock(&g_MQTT2CAN_mutex);
+    pthread_rwlock_rdlock(&g_MQTT2CAN_lock);
     // Get element from offset position
     current = gateway_getFromOffset(list, offset);    
     // Check
     if(current == NULL)
     {
         #ifdef DEBUG_GATEWAY_ERRORS
-        debug_print("gateway_getCANFromMQTT ERROR: Nothing to get!\n");
+        debug_error("gateway_getCANFromMQTT ERROR: Nothing to get!\n");
         #endif
         ret = EXIT_FAILURE;
     }    
@@ -461,19 +988,54 @@ int gateway_getCANFromMQTT(int offset, hapcanCANData *p_hd)
         *p_hd = current->hd_result;
     }      
     // UNLOCK GATEWAY: MQTT2CAN data
-    pthread_mutex_unlock(&g_MQTT2CAN_mutex);
+    pthread_rwlock_unlock(&g_MQTT2CAN_lock);
     // RETURN
     return ret;
 }
 
+// Call a function for each element of a list
+int gateway_walkList(int list, gatewayWalkFn fn, void *arg)
+{
+    gatewayList* current;
+    gatewayEntry entry;
+    // Check list index parameter
+    if((list < 0) || (list >= NUMBER_OF_GATEWAY_LISTS))
+    {
+        return EXIT_FAILURE;
+    }
+    // LOCK GATEWAY: CAN2MQTT and MQTT2CAN data
+    pthread_rwlock_rdlock(&g_CAN2MQTT_lock);
+    pthread_rwlock_rdlock(&g_MQTT2CAN_lock);
+    for(current = head[list]; current != NULL; current = current->next) 
+    {
+        entry.hd_mask = current->hd_mask;
+        entry.hd_check = current->hd_check;
+        entry.state_topic = current->state_topic;
+        entry.command_topic = current->command_topic;
+        entry.hd_result = current->hd_result;
+        entry.handler = current->handler;
+        entry.context = current->context;
+        entry.context_len = current->context_len;
+        fn(&entry, arg);
+    }
+    // UNLOCK GATEWAY: CAN2MQTT and MQTT2CAN data
+    pthread_rwlock_unlock(&g_CAN2MQTT_lock);
+    pthread_rwlock_unlock(&g_MQTT2CAN_lock);
+    return EXIT_SUCCESS;
+}
+
 // Used for debug only:
 // Print all fields from each element of a list
 void gateway_printList(int list)
 {
     #ifdef DEBUG_GATEWAY_LISTS
     gatewayList* current;    
+    if(!debug_isEnabled(DEBUG_MODULE, DEBUG_LEVEL_DEBUG))
+    {
+        return;
+    }
     // Print List number
-    debug_print("gateway_printList: List = %d\n", list);    
+    debug_verbose("gateway_printList: List = %d\n", list);    
     // Check list index parameter
     if((list < 0) || (list >= NUMBER_OF_GATEWAY_LISTS))
     {
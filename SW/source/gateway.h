@@ -6,6 +6,29 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Elements carry the module handlers and an opaque per-channel context.    //
+// Matches are handled directly by the gateway (no frame type dispatch)       //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - gateway_getMQTTFromCAN returns an interned topic (see topic.h)           //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add gateway_beginUpdate / gateway_endUpdate (configuration reload)       //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Add gateway_walkList (elements exported to the configuration cache)      //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Lists are read locked while frames / topics are handled (handlers of     //
+// different threads run in parallel)                                         //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Handlers are called after the list is unlocked                           //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - Reload: the new configuration is used only from gateway_endUpdate        //
+//----------------------------------------------------------------------------//
 
 #ifndef GATEWAY_H
 #define GATEWAY_H
@@ -32,7 +55,64 @@ enum
 //----------------------------------------------------------------------------//
 // EXTERNAL TYPES
 //----------------------------------------------------------------------------//
+/**
+ * Module handler called for a matched HAPCAN Frame (CAN2MQTT)
+ * \param   state_str       (INPUT) MQTT State Topic of the matched element
+ * \param   hd_received     (INPUT) received HAPCAN Frame
+ * \param   context         (INPUT) context registered with the element (NULL 
+ *                              if none)
+ * \param   timestamp       (INPUT) received message timestamp
+ * 
+ * \return  HAPCAN_NO_RESPONSE, HAPCAN_MQTT_RESPONSE, 
+ *          HAPCAN_MQTT_RESPONSE_ERROR or HAPCAN_RESPONSE_ERROR
+ */
+typedef int (*gatewayCAN2MQTTHandler)(char *state_str, 
+        hapcanCANData *hd_received, const void *context, 
+        unsigned long long timestamp);
 
+/**
+ * Module handler called for a matched MQTT Topic (MQTT2CAN)
+ * \param   hd_result       (INPUT / OUTPUT) copy of the HAPCAN Frame of the 
+ *                              matched element
+ * \param   context         (INPUT) context registered with the element (NULL 
+ *                              if none)
+ * \param   payload         (INPUT) received MQTT Payload
+ * \param   payloadlen      (INPUT) received MQTT Payload Length
+ * \param   timestamp       (INPUT) received message timestamp
+ * 
+ * \return  HAPCAN_NO_RESPONSE, HAPCAN_CAN_RESPONSE, 
+ *          HAPCAN_CAN_RESPONSE_ERROR or HAPCAN_RESPONSE_ERROR
+ */
+typedef int (*gatewayMQTT2CANHandler)(hapcanCANData *hd_result, 
+        const void *context, void *payload, int payloadlen, 
+        unsigned long long timestamp);
+
+// Handlers of a module (each list only uses its own handler)
+typedef struct
+{
+    gatewayCAN2MQTTHandler can2mqtt;    // GATEWAY_CAN2MQTT_LIST
+    gatewayMQTT2CANHandler mqtt2can;    // GATEWAY_MQTT2CAN_LIST
+} gatewayHandler;
+
+// Data of an element (same fields as gateway_AddElementToList)
+typedef struct
+{
+    hapcanCANData hd_mask;
+    hapcanCANData hd_check;
+    const char *state_topic;    // interned (NULL if not used)
+    const char *command_topic;  // interned (NULL if not used)
+    hapcanCANData hd_result;
+    gatewayHandler handler;
+    const void *context;        // NULL if not used
+    int context_len;
+} gatewayEntry;
+
+/**
+ * Function called for each element by gateway_walkList
+ * \param   entry   (INPUT) element data (valid only during the call)
+ * \param   arg     (INPUT) argument given to gateway_walkList
+ */
+typedef void (*gatewayWalkFn)(const gatewayEntry *entry, void *arg);
     
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
@@ -44,6 +124,21 @@ enum
  **/
 void gateway_init(void);
 
+/**
+ * Start a configuration reload: the elements added are not used until 
+ * gateway_endUpdate (frames and topics are still handled with the current 
+ * configuration).
+ **/
+void gateway_beginUpdate(void);
+
+/**
+ * End a configuration reload: the lists are replaced by the elements added 
+ * since gateway_beginUpdate. Elements with the same data as a current one 
+ * (frames, topics, handlers and context) are not replaced, the current ones 
+ * not added again are removed.
+ **/
+void gateway_endUpdate(void);
+
 /**
  * Add an element to the list that will be used to match frames / topics
  * 
@@ -57,13 +152,56 @@ void gateway_init(void);
  * USED FOR MATCHING TOPIC (MQTT2CAN): 
  * \param   command_topic   (INPUT) Topic to be matched
  * \param   phd_result      (INPUT) HAPCAN Frame to be returned
+ * 
+ * USED FOR HANDLING A MATCH (BOTH):
+ * \param   handler         (INPUT) Module handlers called on a match
+ * \param   context         (INPUT) Per-channel context passed to the handler 
+ *                              (copied to the list, NULL if not used)
+ * \param   context_len     (INPUT) Size of the context
  *  
  * \return  EXIT_FAILURE     Wrong list used
  *          EXIT_SUCCESS     Element added to the list
  **/
 int gateway_AddElementToList(int list, hapcanCANData *phd_mask, 
         hapcanCANData *phd_check, char *state_topic, char* command_topic,         
-        hapcanCANData *phd_result);
+        hapcanCANData *phd_result, const gatewayHandler *handler, 
+        const void *context, int context_len);
+
+/**
+ * Call the CAN2MQTT handler of every element matching a HAPCAN Frame. The 
+ * matches are collected while the list is read locked and the handlers are 
+ * called in list order after it is unlocked (a handler waiting for the MQTT 
+ * queue does not block the list; other threads can handle frames at the same 
+ * time, so handlers have to be thread safe). The calls stop on the first 
+ * HAPCAN_MQTT_RESPONSE_ERROR.
+ * 
+ * \param   phd_received    (INPUT) The HAPCAN Frame to be searched
+ * \param   timestamp       (INPUT) Received message timestamp
+ *  
+ * \return  Response of the last handler called (HAPCAN_NO_RESPONSE if there 
+ *          was no match)
+ **/
+int gateway_handleCAN2MQTT(hapcanCANData *phd_received, 
+        unsigned long long timestamp);
+
+/**
+ * Call the MQTT2CAN handler of every element matching a topic. The matches 
+ * are collected while the list is read locked and the handlers are called in 
+ * list order after it is unlocked (a handler waiting for the CAN queue does 
+ * not block the list; other threads can handle topics at the same time, so 
+ * handlers have to be thread safe). The calls stop on the first 
+ * HAPCAN_CAN_RESPONSE_ERROR.
+ * 
+ * \param   topic           (INPUT) received topic
+ * \param   payload         (INPUT) received payload
+ * \param   payloadlen      (INPUT) received payload len
+ * \param   timestamp       (INPUT) Received message timestamp
+ *  
+ * \return  Response of the last handler called (HAPCAN_NO_RESPONSE if there 
+ *          was no match)
+ **/
+int gateway_handleMQTT2CAN(char* const topic, void *payload, int payloadlen, 
+        unsigned long long timestamp);
 
 /**
  * Search for a HAPCAN Frame starting from position offset
@@ -80,12 +218,13 @@ int gateway_searchMQTTFromCAN(hapcanCANData *phd_received, int offset);
  * Return the state topic of a given list index (offset)
  * 
  * \param   offset  (INPUT) Starting list index for the search
- * \param   topic   (OUTPUT) topic to be populated
+ * \param   topic   (OUTPUT) interned topic to be populated
  *  
- * \return  EXIT_SUCCESS    topic is copied (to be freed by application)
+ * \return  EXIT_SUCCESS    topic is set (to be released by application with 
+ *                          topic_release)
  *          EXIT_FAILURE    Nothing to get
  **/
-int gateway_getMQTTFromCAN(int offset, char** topic);
+int gateway_getMQTTFromCAN(int offset, const char** topic);
 
 /**
  * Search for a topic starting from position offset
@@ -109,6 +248,22 @@ int gateway_searchCANFromMQTT(char* const topic, int offset);
  **/
 int gateway_getCANFromMQTT(int offset, hapcanCANData *p_hd);
 
+/**
+ * Call a function for each element of a list, from the last element added to 
+ * the first one (adding them again in this order rebuilds the same list). 
+ * Elements added by a reload not ended (see gateway_beginUpdate) are not 
+ * walked. The list is locked during the walk: the function must not use the 
+ * gateway.
+ * 
+ * \param   list    (INPUT) GATEWAY_MQTT2CAN_LIST or GATEWAY_CAN2MQTT_LIST
+ * \param   fn      (INPUT) function called for each element
+ * \param   arg     (INPUT) argument passed to the function
+ * 
+ * \return  EXIT_FAILURE     Wrong list used
+ *          EXIT_SUCCESS     List walked
+ **/
+int gateway_walkList(int list, gatewayWalkFn fn, void *arg);
+
 /**
  * USED FOR DEBUG ONLY
  * Print the gateway list
@@ -9,6 +9,38 @@
 //  1.01     | 18/Jun/2023 |                               | ALCP             //
 // - Add new frame types (HTIM and HRGBW)                                     //
 //----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Raw CAN2MQTT payload is built on a fixed size buffer                     //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Configured responses are handled by the gateway, calling the module      //
+// handler registered with each element (no frame type dispatch)              //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_HAPCAN          //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - CAN frames are written to the channel(s) of their destination            //
+// (canroute.h), routes read with the gateway                                 //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Raw frames can be published / received in batches (hapcanfed.h)          //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - Configured modules are added from the configuration cache when it was    //
+// built from the same file (configcache.h)                                   //
+//----------------------------------------------------------------------------//
+//  1.08     | 18/Oct/2026 |                               | ALCP             //
+// - Publish topics are interned (see topic.h)                                //
+//----------------------------------------------------------------------------//
+//  1.09     | 18/Oct/2026 |                               | ALCP             //
+// - Raw frames are published with the interned rawHapcanPubTopic             //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
 
 /*
 * Includes
@@ -21,12 +53,15 @@
 #include <limits.h>
 #include "auxiliary.h"
 #include "canbuf.h"
+#include "canroute.h"
 #include "config.h"
+#include "configcache.h"
 #include "debug.h"
 #include "errorhandler.h"
 #include "gateway.h"
 #include "hapcan.h"
 #include "hapcanconfig.h"
+#include "hapcanfed.h"
 #include "hapcanmqtt.h"
 #include "hapcanbutton.h"
 #include "hapcanrelay.h"
@@ -61,15 +96,11 @@ static int handleRawFromCAN(hapcanCANData* hapcanData,
         unsigned long long timestamp);
 static int handleConfiguredFromCAN(hapcanCANData* hapcanData, 
         unsigned long long timestamp);
-static int getModuleResponseFromCAN(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp);
 // From MQTT to CAN: use MQTT data to send CAN response(s)
 static int handleRawFromMQTT(char* topic, void* payload, int payloadlen, 
         unsigned long long timestamp);
 static int handleConfiguredFromMQTT(char* topic, void* payload, int payloadlen, 
         unsigned long long timestamp);
-static int getModuleResponseFromMQTT(hapcanCANData *hd_result, char* topic, 
-        void* payload, int payloadlen, unsigned long long timestamp);
 #ifdef DEBUG_HAPCAN_CAN2MQTT
 static void printDebugReturn(int ret);
 #endif
@@ -88,16 +119,25 @@ static int handleRawFromCAN(hapcanCANData* hapcanData,
 {
     int check;
     int ret;
-    char* topic = NULL;
-    void* payload = NULL;
+    const char* topic = NULL;
+    char payload[HAPCAN_MQTT_PAYLOAD_MAX_LEN];
     int payloadlen;
     // Init with no response
     ret = HAPCAN_NO_RESPONSE;
+    // Batches: the frame is published with the next ones
+    if(hfed_isEnabled())
+    {
+        if(hm_isRawPublished(hapcanData))
+        {
+            ret = hfed_addFrame(hapcanData, timestamp);
+        }
+        return ret;
+    }
     // Use CAN message to set MQTT Generic message response
     check = hm_setRawResponseFromCAN(hapcanData, &topic, 
-            &payload, &payloadlen);
+            payload, sizeof(payload), &payloadlen);
     #if defined(DEBUG_HAPCAN_CAN2MQTT)
-    debug_print("handleRawFromCAN - Raw message check = %d\n", 
+    debug_verbose("handleRawFromCAN - Raw message check = %d\n", 
             check);
     #endif
     if(check == HAPCAN_RESPONSE_ERROR)
@@ -113,11 +153,6 @@ static int handleRawFromCAN(hapcanCANData* hapcanData,
     {
         ret = hapcan_addToMQTTPubBuffer(topic, payload, payloadlen, timestamp);
     }
-    // FREE RAW MQTT DATA
-    free(topic);
-    topic = NULL;
-    free(payload);
-    payload = NULL;
     // Return
     return ret;
 }
@@ -134,125 +169,16 @@ static int handleRawFromCAN(hapcanCANData* hapcanData,
 static int handleConfiguredFromCAN(hapcanCANData* hapcanData, 
         unsigned long long timestamp)
 {
-    int check;
     int ret;
-    char* topic = NULL;
-    int offset;
-    // Init with no response
-    ret = HAPCAN_NO_RESPONSE;
     //------------------------------------------
     // Specific (configured) MQTT response
     //------------------------------------------
-    // Search for a gateway match
-    check = 0;
-    offset = 0;
-    while(check >=0)
-    {
-        check = gateway_searchMQTTFromCAN(hapcanData, offset);
-        if(check >= 0)                            
-        {
-            // Match found
-            offset = check;
-            #ifdef DEBUG_HAPCAN_CAN2MQTT
-            debug_print("handleConfiguredFromCAN - match found at "
-                    "offset = %d\n", offset);
-            #endif
-            check = gateway_getMQTTFromCAN(offset, &topic);
-            if(check == EXIT_SUCCESS)
-            {
-                // Match found - check the frame type to send the response
-                ret = getModuleResponseFromCAN(topic, hapcanData, 
-                        timestamp);
-                #ifdef DEBUG_HAPCAN_CAN2MQTT
-                debug_print("handleConfiguredFromCAN - Response: \n");
-                printDebugReturn(ret);
-                #endif
-                if(ret != HAPCAN_MQTT_RESPONSE_ERROR)
-                {
-                    // Set check to offset to continue loop to check for other 
-                    // matches
-                    check = offset;
-                }
-                else
-                {
-                    // Free memory and leave loop
-                    check = -1;
-                }
-            }
-            else
-            {
-                //------------------
-                // GATEWAY ERROR
-                //------------------
-                #if defined(DEBUG_HAPCAN_CAN2MQTT)||defined(DEBUG_HAPCAN_ERRORS)
-                debug_print("handleConfiguredFromCAN - MQTT Data read ERROR\n");
-                #endif
-                // Free memory and leave loop
-                check = -1;
-            }
-            // Skip to the next position - This one was valuated already.
-            offset++;
-            // FREE DATA
-            free(topic);
-            topic = NULL;
-        }
-        else
-        {
-            #ifdef DEBUG_HAPCAN_CAN2MQTT
-            debug_print("handleConfiguredFromCAN - No match found since "
-                    "offset = %d\n", offset);
-            #endif
-        }
-    }
-    return ret;
-}
-
-/*
- * Check which module shall process the incoming message to set the payload and 
- * send it to the defined topic
- * 
- * \param   state_str       (INPUT) state topic found by the gateway
- *          hd_received     (INPUT) Received HAPCAN Frame
- *          timestamp       (INPUT) Received message timestamp
- * 
- * \return  HAPCAN_NO_RESPONSE: No response was added to MQTT Pub Buffer
- *          HAPCAN_MQTT_RESPONSE: Response added to MQTT Buffer (OK)
- *          HAPCAN_MQTT_RESPONSE_ERROR: Error adding to MQTT Pub Buffer (FAIL)
- *          HAPCAN_RESPONSE_ERROR: Other error
- */
-static int getModuleResponseFromCAN(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp)
-{
-    int ret = HAPCAN_NO_RESPONSE;    
-    switch(hd_received->frametype)
-    {
-        case HAPCAN_BUTTON_FRAME_TYPE:
-            ret = hbutton_setCAN2MQTTResponse(state_str, hd_received, 
-                    timestamp);
-            break;
-        case HAPCAN_RELAY_FRAME_TYPE:
-            ret = hrelay_setCAN2MQTTResponse(state_str, hd_received, 
-                    timestamp);
-            break;
-        case HAPCAN_TEMPERATURE_FRAME_TYPE:
-            ret = htemp_setCAN2MQTTResponse(state_str, hd_received, 
-                    timestamp);
-            break;
-        case HAPCAN_RGB_FRAME_TYPE:
-            ret = hrgb_setCAN2MQTTResponse(state_str, hd_received, 
-                    timestamp);
-            break;
-        case HAPCAN_RGBW_FRAME_TYPE:
-            ret = hrgbw_setCAN2MQTTResponse(state_str, hd_received, 
-                    timestamp);
-            break;
-        case HAPCAN_MULTIPLE_TEMPERATURE_FRAME_TYPE:
-            ret = htim_setCAN2MQTTResponse(state_str, hd_received, 
-                    timestamp);
-            break;
-        default:
-            break;
-    }
+    // Each gateway match calls the handler of the module that added it
+    ret = gateway_handleCAN2MQTT(hapcanData, timestamp);
+    #ifdef DEBUG_HAPCAN_CAN2MQTT
+    debug_verbose("handleConfiguredFromCAN - Response: \n");
+    printDebugReturn(ret);
+    #endif
     return ret;
 }
 
@@ -277,19 +203,32 @@ static int handleRawFromMQTT(char* topic, void* payload, int payloadlen,
     hapcanCANData hapcanData;
     // Init with no response
     ret = HAPCAN_NO_RESPONSE;
-    // Use CAN message to set MQTT Generic message response
-    check = hm_setRawResponseFromMQTT(topic, payload, payloadlen, &hapcanData);
-    #if defined(DEBUG_HAPCAN_MQTT2CAN)
-    debug_print("handleRawFromMQTT - Raw message check = %d\n", check);
-    #endif
-    if(check == HAPCAN_CAN_RESPONSE)
+    if(hfed_isBatch(payload, payloadlen))
     {
-        check = hapcan_addToCANWriteBuffer(&hapcanData, timestamp, true);
+        // Batch from another gateway: all its frames to CAN
+        check = HAPCAN_NO_RESPONSE;
+        if(hm_isRawSubTopic(topic))
+        {
+            check = hfed_handleBatch(payload, payloadlen, timestamp);
+        }
+    }
+    else
+    {
+        // Use CAN message to set MQTT Generic message response
+        check = hm_setRawResponseFromMQTT(topic, payload, payloadlen, 
+                &hapcanData);
         if(check == HAPCAN_CAN_RESPONSE)
         {
-            ret = HAPCAN_MQTT_RESPONSE;
+            check = hapcan_addToCANWriteBuffer(&hapcanData, timestamp, true);
         }
     }
+    #if defined(DEBUG_HAPCAN_MQTT2CAN)
+    debug_verbose("handleRawFromMQTT - Raw message check = %d\n", check);
+    #endif
+    if(check == HAPCAN_CAN_RESPONSE)
+    {
+        ret = HAPCAN_MQTT_RESPONSE;
+    }
     // Return
     return ret;
 }
@@ -311,124 +250,16 @@ static int handleRawFromMQTT(char* topic, void* payload, int payloadlen,
 static int handleConfiguredFromMQTT(char* topic, void* payload, int payloadlen, 
         unsigned long long timestamp)
 {
-    int check;
     int ret;
-    int offset;
-    hapcanCANData hapcanResult;
-    // Init with no response
-    ret = HAPCAN_NO_RESPONSE;
     //------------------------------------------
     // Specific (configured) HAPCAN response
     //------------------------------------------
-    // Search for a gateway match
-    check = 0;
-    offset = 0;
-    while(check >=0)
-    {
-        check = gateway_searchCANFromMQTT(topic, offset);
-        if(check >= 0)                            
-        {
-            // Match found
-            offset = check;
-            #ifdef DEBUG_HAPCAN_MQTT2CAN
-            debug_print("handleConfiguredFromMQTT - match found at "
-                    "offset = %d\n", offset);
-            #endif
-            check = gateway_getCANFromMQTT(offset, &hapcanResult);
-            if(check == EXIT_SUCCESS)
-            {
-                // Match found - check the frame type to send the response
-                ret = getModuleResponseFromMQTT(&hapcanResult, topic, payload, 
-                        payloadlen, timestamp);
-                #ifdef DEBUG_HAPCAN_MQTT2CAN
-                debug_print("handleConfiguredFromMQTT: Response: \n");
-                printDebugReturn(ret);
-                #endif
-                if(ret != HAPCAN_CAN_RESPONSE_ERROR)
-                {
-                    // Set check to offset to continue loop to check for other 
-                    // matches
-                    check = offset;
-                }
-                else
-                {
-                    // Free memory and leave loop
-                    check = -1;
-                }
-            }
-            else
-            {
-                //------------------
-                // GATEWAY ERROR
-                //------------------
-                #if defined(DEBUG_HAPCAN_MQTT2CAN)||defined(DEBUG_HAPCAN_ERRORS)
-                debug_print("handleConfiguredFromMQTT - CAN Data read ERROR\n");
-                #endif
-                // Free memory and leave loop
-                check = -1;
-            }
-            // Skip to the next position - This one was valuated already.
-            offset++;
-        }
-        else
-        {
-            #ifdef DEBUG_HAPCAN_MQTT2CAN
-            debug_print("handleConfiguredFromMQTT - No match found since "
-                    "offset = %d\n", offset);
-            #endif
-        }
-    }
-    return ret;
-}
-
-/*
- * Check which module shall process the incoming message to set the HAPCAN 
- * response
- * 
- * \param   hd_result       (INPUT) HAPCAN frame found by the gateway
- *          topic           (INPUT) received topic
- *          payload         (INPUT) received payload
- *          payloadlen      (INPUT) received payload len
- *          timestamp       (INPUT) Received message timestamp
- * 
- * \return  HAPCAN_NO_RESPONSE: No response was added to MQTT Pub Buffer
- *          HAPCAN_MQTT_RESPONSE: Response added to MQTT Buffer (OK)
- *          HAPCAN_MQTT_RESPONSE_ERROR: Error adding to MQTT Pub Buffer (FAIL)
- *          HAPCAN_RESPONSE_ERROR: Other error
- */
-static int getModuleResponseFromMQTT(hapcanCANData *hd_result, char* topic, 
-        void* payload, int payloadlen, unsigned long long timestamp)
-{
-    int ret = HAPCAN_RESPONSE_ERROR;
-    switch(hd_result->frametype)
-    {
-        case HAPCAN_BUTTON_FRAME_TYPE:
-            ret = hbutton_setMQTT2CANResponse(hd_result, payload, payloadlen, 
-                    timestamp);
-            break;
-        case HAPCAN_RELAY_FRAME_TYPE:
-            ret = hrelay_setMQTT2CANResponse(hd_result, payload, payloadlen, 
-                    timestamp);            
-            break;
-        case HAPCAN_TEMPERATURE_FRAME_TYPE:
-            ret = htemp_setMQTT2CANResponse(hd_result, payload, payloadlen, 
-                    timestamp);
-            break;
-        case HAPCAN_RGB_FRAME_TYPE:
-            ret = hrgb_setMQTT2CANResponse(hd_result, payload, payloadlen, 
-                    timestamp);
-            break;
-        case HAPCAN_RGBW_FRAME_TYPE:
-            ret = hrgbw_setMQTT2CANResponse(hd_result, payload, payloadlen, 
-                    timestamp);
-            break;
-        case HAPCAN_MULTIPLE_TEMPERATURE_FRAME_TYPE:
-            ret = htim_setMQTT2CANResponse(hd_result, payload, payloadlen, 
-                    timestamp);
-            break;
-        default:
-            break;
-    }
+    // Each gateway match calls the handler of the module that added it
+    ret = gateway_handleMQTT2CAN(topic, payload, payloadlen, timestamp);
+    #ifdef DEBUG_HAPCAN_MQTT2CAN
+    debug_verbose("handleConfiguredFromMQTT: Response: \n");
+    printDebugReturn(ret);
+    #endif
     return ret;
 }
 
@@ -439,28 +270,28 @@ static void printDebugReturn(int ret)
     switch(ret)
     {
         case HAPCAN_GENERIC_OK_RESPONSE:
-            debug_print(" - HAPCAN_GENERIC_OK_RESPONSE\n");
+            debug_verbose(" - HAPCAN_GENERIC_OK_RESPONSE\n");
             break;
         case HAPCAN_NO_RESPONSE:
-            debug_print(" - HAPCAN_NO_RESPONSE\n");
+            debug_verbose(" - HAPCAN_NO_RESPONSE\n");
             break;
         case HAPCAN_SOCKET_RESPONSE:
-            debug_print(" - HAPCAN_SOCKET_RESPONSE\n");
+            debug_verbose(" - HAPCAN_SOCKET_RESPONSE\n");
             break;
         case HAPCAN_MQTT_RESPONSE:
-            debug_print(" - HAPCAN_MQTT_RESPONSE\n");
+            debug_verbose(" - HAPCAN_MQTT_RESPONSE\n");
             break;
         case HAPCAN_CAN_RESPONSE:
-            debug_print(" - HAPCAN_CAN_RESPONSE\n");
+            debug_verbose(" - HAPCAN_CAN_RESPONSE\n");
             break;
         case HAPCAN_RESPONSE_ERROR:
-            debug_print(" - HAPCAN_RESPONSE_ERROR\n");
+            debug_verbose(" - HAPCAN_RESPONSE_ERROR\n");
             break;
         case HAPCAN_MQTT_RESPONSE_ERROR:
-            debug_print(" - HAPCAN_MQTT_RESPONSE_ERROR\n");
+            debug_verbose(" - HAPCAN_MQTT_RESPONSE_ERROR\n");
             break;
         case HAPCAN_CAN_RESPONSE_ERROR:
-            debug_print(" - HAPCAN_CAN_RESPONSE_ERROR\n");
+            debug_verbose(" - HAPCAN_CAN_RESPONSE_ERROR\n");
             break;
     }
 }
@@ -650,15 +481,22 @@ void hapcan_initGateway(void)
     // Get Configuration
     //--------------------------------------------
     hconfig_init();
+    canroute_init();
+    hfed_init();
     //--------------------------------------------
-    // Add configured modules to the gateway
+    // Add configured modules to the gateway: from the cache if it was built 
+    // from this file, otherwise from the file (and then build the cache)
     //--------------------------------------------
-    hrelay_addToGateway();   
-    hbutton_addToGateway(); 
-    htemp_addToGateway();
-    hrgb_addToGateway();
-    hrgbw_addToGateway();
-    htim_addToGateway();
+    if(ccache_load() != EXIT_SUCCESS)
+    {
+        hrelay_addToGateway();   
+        hbutton_addToGateway(); 
+        htemp_addToGateway();
+        hrgb_addToGateway();
+        hrgbw_addToGateway();
+        htim_addToGateway();
+        ccache_save();
+    }
 }
 
 /**
@@ -784,18 +622,37 @@ int hapcan_addToCANWriteBuffer(hapcanCANData* hapcanData,
         unsigned long long timestamp, bool sendToSocket)
 {
     int check;
+    int li_check;
+    int channel;
+    int first;
+    int last;
     struct can_frame cf_Frame;
     int ret = HAPCAN_CAN_RESPONSE_ERROR;
     int dataLen;
     uint8_t data[HAPCAN_SOCKET_DATA_LEN];
     //---------------------------------
-    // Add data to CAN Write Buffer
+    // Add data to CAN Write Buffer(s)
     //---------------------------------    
     aux_clearCANFrame(&cf_Frame);
     hapcan_getCANDataFromHAPCAN(hapcanData, &cf_Frame);
-    check = canbuf_setWriteMsgToBuffer(0, &cf_Frame, timestamp);
-    // Check if error occurred when adding to buffer
-    errorh_isError(ERROR_MODULE_CAN_SEND, check);
+    first = canroute_getChannel(hapcanData);
+    last = first;
+    if(first == CANROUTE_ALL_CHANNELS)
+    {
+        first = SOCKETCAN_CHANNEL_0;
+        last = canbuf_getChannels() - 1;
+    }
+    check = CAN_SEND_OK;
+    for(channel = first; channel <= last; channel++)
+    {
+        li_check = canbuf_setWriteMsgToBuffer(channel, &cf_Frame, timestamp);
+        // Check if error occurred when adding to buffer
+        errorh_isCANError(channel, ERROR_MODULE_CAN_SEND, li_check);
+        if(li_check != CAN_SEND_OK)
+        {
+            check = li_check;
+        }
+    }
     if(check != CAN_SEND_OK)
     {
         // Here we have to set to error to inform the application to 
@@ -828,8 +685,8 @@ int hapcan_addToCANWriteBuffer(hapcanCANData* hapcanData,
  *          HAPCAN_MQTT_RESPONSE: Response added to CAN Write Buffer (OK)
  *          HAPCAN_MQTT_RESPONSE_ERROR: Buffer Error
  */
-int hapcan_addToMQTTPubBuffer(char* topic, void* payload, int payloadlen, 
-        unsigned long long timestamp)
+int hapcan_addToMQTTPubBuffer(const char* topic, void* payload, 
+        int payloadlen, unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
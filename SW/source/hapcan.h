@@ -9,6 +9,19 @@
 //  1.01     | 18/Jun/2023 |                               | ALCP             //
 // - Add new frame types (HTIM and HRGBW)                                     //
 //----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add fixed payload strings and maximum payload size for CAN2MQTT          //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add maximum size of MQTT2CAN text commands                               //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - hapcan_addToCANWriteBuffer: frame sent to the channel(s) of its          //
+// destination (canroute.h)                                                   //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - hapcan_addToMQTTPubBuffer gets an interned topic (see topic.h)           //
+//----------------------------------------------------------------------------//
 
 #ifndef HAPCAN_H
 #define HAPCAN_H
@@ -102,6 +115,16 @@ enum
 // When the configuration file returns error on computer ID1 or computer ID2, 
 // this default value is used for both
 #define HAPCAN_DEFAULT_CIDx 254
+// CAN2MQTT payloads: state strings are constant, and the other payloads are 
+// written to fixed size buffers owned by the caller (no allocation per frame)
+#define HAPCAN_PAYLOAD_ON           "ON"
+#define HAPCAN_PAYLOAD_OFF          "OFF"
+#define HAPCAN_PAYLOAD_ON_LEN       (sizeof(HAPCAN_PAYLOAD_ON) - 1)
+#define HAPCAN_PAYLOAD_OFF_LEN      (sizeof(HAPCAN_PAYLOAD_OFF) - 1)
+#define HAPCAN_MQTT_PAYLOAD_MAX_LEN 256
+// MQTT2CAN text commands ("ON", "255", "255,255,255", ...) are copied to a 
+// fixed size string. Longer payloads can only be JSON commands.
+#define HAPCAN_MQTT_COMMAND_STR_LEN 64
     
 //----------------------------------------------------------------------------//
 // EXTERNAL TYPES
@@ -205,7 +228,8 @@ int hapcan_handleMQTT2CAN(char* topic, void* payload, int payloadlen,
         unsigned long long timestamp);
 
 /**
- * Add a HAPCAN Message to the CAN Write Buffer
+ * Add a HAPCAN Message to the CAN Write Buffer of the channel of its destination
+ * (every channel if not known - see canroute_getChannel)
  * \param   hapcanData      (INPUT) HAPCAN Frame to be added to CAN write buffer
  * \param   timestamp       (INPUT) Timestamp
  * \param   sendToSocket    (INPUT) If the message has to be added to the socket
@@ -220,7 +244,7 @@ int hapcan_addToCANWriteBuffer(hapcanCANData* hapcanData,
 
 /**
  * Add a MQTT Message to the MQTT Pub Buffer
- * \param   topic           (INPUT) received topic
+ * \param   topic           (INPUT) interned topic (see topic_intern)
  *          payload         (INPUT) received payload
  *          payloadlen      (INPUT) received payload len
  *          timestamp       (INPUT) Received message timestamp
@@ -229,8 +253,8 @@ int hapcan_addToCANWriteBuffer(hapcanCANData* hapcanData,
  *          HAPCAN_MQTT_RESPONSE: Response added to CAN Write Buffer (OK)
  *          HAPCAN_MQTT_RESPONSE_ERROR: Buffer Error
  */
-int hapcan_addToMQTTPubBuffer(char* topic, void* payload, int payloadlen, 
-        unsigned long long timestamp);
+int hapcan_addToMQTTPubBuffer(const char* topic, void* payload, 
+        int payloadlen, unsigned long long timestamp);
 
 #ifdef __cplusplus
 }
@@ -6,6 +6,33 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - CAN2MQTT payloads use constant strings (no allocation per frame)         //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - MQTT2CAN JSON commands are parsed with jh_parseFlatObject (no            //
+// allocation, no JSON lock)                                                  //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Register the module handlers with the gateway elements (called directly  //
+// on a match)                                                                //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Command frames are precomputed per channel when the gateway is built and //
+// registered as the gateway element context (text commands are a table       //
+// lookup)                                                                    //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_HAPCAN          //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Text commands are read with hm_getOnOffCommand (shared with the relays)  //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
 
 /*
 * Includes
@@ -24,6 +51,7 @@
 #include "hapcan.h"
 #include "hapcanbutton.h"
 #include "hapcanconfig.h"
+#include "hapcanmqtt.h"
 #include "jsonhandler.h"
 #include "mqtt.h"
 #include "mqttbuf.h"
@@ -31,24 +59,61 @@
 //----------------------------------------------------------------------------//
 // INTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
+// Maximum number of MQTT payloads sent for a single button frame
+#define BUTTON_MAX_PAYLOADS 2
+// Text commands accepted on the command topic
+enum
+{
+    BUTTON_COMMAND_OFF = HAPCAN_ONOFF_COMMAND_OFF,
+    BUTTON_COMMAND_ON = HAPCAN_ONOFF_COMMAND_ON,
+    BUTTON_COMMAND_TOGGLE,
+    BUTTON_N_COMMANDS
+};
 
 //----------------------------------------------------------------------------//
 // INTERNAL TYPES
 //----------------------------------------------------------------------------//
+// Per-channel MQTT2CAN template (gateway element context): complete HAPCAN 
+// Frame for each text command
+typedef struct
+{
+    hapcanCANData hd_command[BUTTON_N_COMMANDS];
+} buttonTemplate;
 
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
+// Handlers called by the gateway for the elements added by this module
+static const gatewayHandler g_hbutton_handler = 
+{
+    hbutton_setCAN2MQTTResponse,
+    hbutton_setMQTT2CANResponse
+};
+// Text commands strings (same order as the text commands enum)
+static const char* const g_button_commands[BUTTON_N_COMMANDS] = 
+{
+    "OFF",
+    "ON",
+    "TOGGLE"
+};
+// INSTR1 for each text command (same order as the text commands enum)
+static const uint8_t g_button_instr1[BUTTON_N_COMMANDS] = 
+{
+    0x00,   // Turn OFF
+    0x01,   // Turn ON
+    0x02    // Toggle
+};
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
 static void addButtonChannelToGateway(int node, int group, int channel, 
         char *state_str, char *command_str);
-static int getButtonPayloads(hapcanCANData *hd_received, char*** a_payload, 
-        int **a_payloadlen, int* n_payloads);
+static void setButtonTemplate(hapcanCANData *hd_result, buttonTemplate *tmpl);
+static int getButtonPayloads(hapcanCANData *hd_received, 
+        const char **a_payload, int *a_payloadlen, int* n_payloads);
 static int getButtonHAPCANFrame(void *payload, int payloadlen, 
-        hapcanCANData *hd_result);
+        const buttonTemplate *tmpl, hapcanCANData *hd_result);
 
 /*
  * Add a single button to the HAPCAN <--> MQTT gateway based on the data read 
@@ -71,6 +136,7 @@ static void addButtonChannelToGateway(int node, int group, int channel,
     hapcanCANData hd_mask;
     hapcanCANData hd_check;
     hapcanCANData hd_result;
+    buttonTemplate tmpl;
     int temp;
     // Clear data
     aux_clearHAPCANFrame(&hd_mask);
@@ -86,7 +152,7 @@ static void addButtonChannelToGateway(int node, int group, int channel,
     if(!valid)
     {
         #ifdef DEBUG_HAPCAN_BUTTON_ERRORS
-        debug_print("addButtonChannelToGateway: parameter error!\n");
+        debug_error("addButtonChannelToGateway: parameter error!\n");
         #endif
     }
     else
@@ -125,11 +191,12 @@ static void addButtonChannelToGateway(int node, int group, int channel,
             hd_check.data[2] = channel;
             // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
             check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, &hd_mask, 
-                &hd_check, state_str, NULL, &hd_result);
+                &hd_check, state_str, NULL, &hd_result, 
+                &g_hbutton_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_BUTTON_ERRORS
-                debug_print("addButtonChannelToGateway: Error "
+                debug_error("addButtonChannelToGateway: Error "
                         "adding to CAN2MQTT!\n");
                 #endif
             }
@@ -158,13 +225,16 @@ static void addButtonChannelToGateway(int node, int group, int channel,
             temp = (1 << (channel - 1));
             hd_result.data[1] = (uint8_t)(temp & 0xFF); // INSTR2
             hd_result.data[4] = (uint8_t)((temp & 0xFF00) >> 8); // INSTR3        
-            // Add to list CAN2MQTT: command_str, hd_result
+            // Precompute the frames for the text commands
+            setButtonTemplate(&hd_result, &tmpl);
+            // Add to list CAN2MQTT: command_str, hd_result, template
             check = gateway_AddElementToList(GATEWAY_MQTT2CAN_LIST, &hd_mask, 
-                &hd_check, NULL, command_str, &hd_result);
+                &hd_check, NULL, command_str, &hd_result, 
+                &g_hbutton_handler, &tmpl, sizeof(tmpl));
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_BUTTON_ERRORS
-                debug_print("addButtonChannelToGateway: Error "
+                debug_error("addButtonChannelToGateway: Error "
                         "adding to MQTT2CAN!\n");
                 #endif
             }
@@ -172,12 +242,36 @@ static void addButtonChannelToGateway(int node, int group, int channel,
     }
 }
 
+/**
+ * Fill the template with the HAPCAN Frame of each text command
+ * 
+ * \param   hd_result       (INPUT) HAPCAN Frame with node, group, channel and 
+ *                              computer ID set
+ * \param   tmpl            (OUTPUT) template to be filled
+ *  
+ */
+static void setButtonTemplate(hapcanCANData *hd_result, buttonTemplate *tmpl)
+{
+    int i;
+    for(i = 0; i < BUTTON_N_COMMANDS; i++)
+    {
+        tmpl->hd_command[i] = *hd_result;
+        tmpl->hd_command[i].frametype = HAPCAN_DIRECT_CONTROL_FRAME_TYPE;
+        tmpl->hd_command[i].data[0] = g_button_instr1[i]; // INSTR1
+        tmpl->hd_command[i].data[5] = 0xFF; // INSTR4 = 0xXX
+        tmpl->hd_command[i].data[6] = 0xFF; // INSTR5 = 0xXX
+        tmpl->hd_command[i].data[7] = 0xFF; // INSTR6 = 0xXX
+    }
+}
+
 /**
  * Set a payload based on the data received
  * 
  * \param   hd_received     (INPUT) pointer to HAPCAN message received
- * \param   a_payload       (OUTPUT) array of payloads to be filled
- * \param   a_payloadlen    (OUTPUT) array of payloadlens to be filled
+ * \param   a_payload       (OUTPUT) array of payloads to be filled (at least 
+ *                              BUTTON_MAX_PAYLOADS constant strings)
+ * \param   a_payloadlen    (OUTPUT) array of payloadlens to be filled (at 
+ *                              least BUTTON_MAX_PAYLOADS elements)
  * \param   n_payloads      (OUTPUT) number of payloads to be filled
  *                      
  * \return  HAPCAN_MQTT_RESPONSE: Payload set (OK)
@@ -185,8 +279,8 @@ static void addButtonChannelToGateway(int node, int group, int channel,
  *          HAPCAN_NO_RESPONSE: No response
  *          
  */
-static int getButtonPayloads(hapcanCANData *hd_received, char*** a_payload, 
-        int **a_payloadlen, int* n_payloads)
+static int getButtonPayloads(hapcanCANData *hd_received, 
+        const char **a_payload, int *a_payloadlen, int* n_payloads)
 {
     // D3 is BUTTON:
     //    - 0x00 – open
@@ -204,7 +298,7 @@ static int getButtonPayloads(hapcanCANData *hd_received, char*** a_payload,
     // REMARK: If BUTTON and LED are both enabled on the configuration, the 
     // status will be sent based on the BUTTON status.
     int ret = HAPCAN_MQTT_RESPONSE;
-    unsigned int len;
+    *n_payloads = 0;
     // Check if button is disabled
     if(hd_received->data[3] == 0x01)
     {
@@ -218,23 +312,15 @@ static int getButtonPayloads(hapcanCANData *hd_received, char*** a_payload,
         {
             // LED is OFF
             *n_payloads = 1;
-            (*a_payload) = malloc(sizeof(void *)); 
-            *(a_payloadlen) = malloc(sizeof(int));              
-            len = strlen("OFF");
-            (*a_payloadlen)[0] = len;
-            (*a_payload)[0] = malloc(len + 1);
-            strcpy((*a_payload)[0], "OFF");
+            a_payload[0] = HAPCAN_PAYLOAD_OFF;
+            a_payloadlen[0] = HAPCAN_PAYLOAD_OFF_LEN;
         }
         else if(hd_received->data[4] == 0xFF)
         {
             // LED is ON
             *n_payloads = 1;
-            (*a_payload) = malloc(sizeof(void *)); 
-            *(a_payloadlen) = malloc(sizeof(int));              
-            len = strlen("ON");
-            (*a_payloadlen)[0] = len;
-            (*a_payload)[0] = malloc(len + 1);
-            strcpy((*a_payload)[0], "ON");
+            a_payload[0] = HAPCAN_PAYLOAD_ON;
+            a_payloadlen[0] = HAPCAN_PAYLOAD_ON_LEN;
         }
         else
         {
@@ -249,38 +335,24 @@ static int getButtonPayloads(hapcanCANData *hd_received, char*** a_payload,
     {
         // Button is OFF
         *n_payloads = 1;
-        (*a_payload) = malloc(sizeof(void *)); 
-        *(a_payloadlen) = malloc(sizeof(int));              
-        len = strlen("OFF");
-        (*a_payloadlen)[0] = len;
-        (*a_payload)[0] = malloc(len + 1);
-        strcpy((*a_payload)[0], "OFF");
+        a_payload[0] = HAPCAN_PAYLOAD_OFF;
+        a_payloadlen[0] = HAPCAN_PAYLOAD_OFF_LEN;
     }
     else if(hd_received->data[3] >= 0xFD)
     {
         // Button is Closed
         *n_payloads = 1;
-        (*a_payload) = malloc(sizeof(void *)); 
-        *(a_payloadlen) = malloc(sizeof(int));              
-        len = strlen("ON");
-        (*a_payloadlen)[0] = len;
-        (*a_payload)[0] = malloc(len + 1);
-        strcpy((*a_payload)[0], "ON");
+        a_payload[0] = HAPCAN_PAYLOAD_ON;
+        a_payloadlen[0] = HAPCAN_PAYLOAD_ON_LEN;
     }
     else if(hd_received->data[3] >= 0xFA)
     {
         // Button was closed and then was opened
         *n_payloads = 2;
-        (*a_payload) = malloc(2*sizeof(void *)); 
-        *(a_payloadlen) = malloc(2*sizeof(int));              
-        len = strlen("ON");
-        (*a_payloadlen)[0] = len;
-        (*a_payload)[0] = malloc(len + 1);
-        strcpy((*a_payload)[0], "ON");
-        len = strlen("OFF");
-        (*a_payloadlen)[1] = len;
-        (*a_payload)[1] = malloc(len + 1);
-        strcpy((*a_payload)[1], "OFF");
+        a_payload[0] = HAPCAN_PAYLOAD_ON;
+        a_payloadlen[0] = HAPCAN_PAYLOAD_ON_LEN;
+        a_payload[1] = HAPCAN_PAYLOAD_OFF;
+        a_payloadlen[1] = HAPCAN_PAYLOAD_OFF_LEN;
     }
     else
     {
@@ -299,6 +371,7 @@ static int getButtonPayloads(hapcanCANData *hd_received, char*** a_payload,
  * 
  * \param   payload         (INPUT) payload to be filled
  * \param   payloadlen      (INPUT) payloadlen to be filled
+ * \param   tmpl            (INPUT) template of the matched channel
  * \param   hd_result       (INPUT / OUTPUT) pointer to HAPCAN message matched
  *                      
  * \return  HAPCAN_NO_RESPONSE: HAPCAN Frame not set
@@ -306,17 +379,18 @@ static int getButtonPayloads(hapcanCANData *hd_received, char*** a_payload,
  *          HAPCAN_RESPONSE_ERROR: Other error
  *       
  */
-static int getButtonHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd_result)
+static int getButtonHAPCANFrame(void *payload, int payloadlen, 
+        const buttonTemplate *tmpl, hapcanCANData *hd_result)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
-    char *str = NULL;
+    char str[HAPCAN_MQTT_COMMAND_STR_LEN];
     bool valid = true;
-    long val;
     int temp;
-    json_object *obj = NULL;
+    int command;
+    jsonFlatObject obj;
     // Check NULL or size 0
-    if((payload == NULL) || (payloadlen <= 0))
+    if((payload == NULL) || (payloadlen <= 0) || (tmpl == NULL))
     {
         valid = false;
     }
@@ -325,9 +399,7 @@ static int getButtonHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd
         // set to false unless there is a payload match 
         valid = false;
         // payload does not end with 0 for a string - copy it here
-        str = malloc(payloadlen + 1);
-        memcpy(str, payload, payloadlen);
-        str[payloadlen] = 0;
+        aux_getPayloadString(payload, payloadlen, str, sizeof(str));
         //----------------------------------------------------------------------
         // COMMAND TOPIC ACCEPTED PAYLOADS:
         // 1. command strings: "ON", "OFF", "TOGGLE"
@@ -335,61 +407,24 @@ static int getButtonHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd
         // 3. JSON: {"INSTR1":Integer, "INSTR4":Integer, 
         //          "INSTR5":Integer, "INSTR6":Integer}
         //----------------------------------------------------------------------
-        if( aux_compareStrings(str, "ON") )
-        {
-            hd_result->data[0] = 0x01; // INSTR1. 0x01 = Turn ON
-            hd_result->data[5] = 0xFF; // INSTR4 = 0xXX
-            hd_result->data[6] = 0xFF; // INSTR5 = 0xXX   
-            hd_result->data[7] = 0xFF; // INSTR6 = 0xXX
-            valid = true;
-        }
-        else if( aux_compareStrings(str, "OFF") )
+        command = hm_getOnOffCommand(str, g_button_commands, 
+                BUTTON_N_COMMANDS);
+        if(command >= 0)
         {
-            hd_result->data[0] = 0x00; // INSTR1. 0x01 = Turn OFF
-            hd_result->data[5] = 0xFF; // INSTR4 = 0xXX
-            hd_result->data[6] = 0xFF; // INSTR5 = 0xXX   
-            hd_result->data[7] = 0xFF; // INSTR6 = 0xXX
+            // Text command - precomputed frame
+            *hd_result = tmpl->hd_command[command];
             valid = true;
         }
-        else if( aux_compareStrings(str, "TOGGLE") )
-        {
-            hd_result->data[0] = 0x02; // INSTR1. 0x01 = Toggle
-            hd_result->data[5] = 0xFF; // INSTR4 = 0xXX
-            hd_result->data[6] = 0xFF; // INSTR5 = 0xXX   
-            hd_result->data[7] = 0xFF; // INSTR6 = 0xXX
-            valid = true;
-        }
-        else if(aux_parseValidateLong(str, &val, 0, 0, 255))
-        {
-            // 0x00 or 0 are set to OFF
-            if(val == 0)
-            {
-                hd_result->data[0] = 0x00; // INSTR1. 0x00 = Turn OFF
-                hd_result->data[5] = 0xFF; // INSTR4 = 0xXX
-                hd_result->data[6] = 0xFF; // INSTR5 = 0xXX   
-                hd_result->data[7] = 0xFF; // INSTR6 = 0xXX
-                valid = true;
-            }
-            // 0xFF or 255 are set to ON
-            else if(val == 255)
-            {
-                hd_result->data[0] = 0x01; // INSTR1. 0x01 = Turn ON
-                hd_result->data[5] = 0xFF; // INSTR4 = 0xXX
-                hd_result->data[6] = 0xFF; // INSTR5 = 0xXX   
-                hd_result->data[7] = 0xFF; // INSTR6 = 0xXX
-                valid = true;
-            }
-        }
         else
         {
             // Check for JSON - Get the JSON Object
-            jh_getObject(str, &obj);
+            check = jh_parseFlatObject(payload, payloadlen, &obj);
             // Check if error parsing
-            if(obj != NULL)
+            if(check == JSON_OK)
             {
                 valid = true;
                 // INSTR1
-                check = jh_getObjectFieldAsInt(obj, "INSTR1", &temp);
+                check = jh_getFlatFieldAsInt(&obj, "INSTR1", &temp);
                 valid = valid && (check == JSON_OK) && 
                         (temp >= 0) && (temp <= 255);                
                 if( valid )
@@ -397,7 +432,7 @@ static int getButtonHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd
                     hd_result->data[0] = (uint8_t)temp;
                 }
                 // INSTR4
-                check = jh_getObjectFieldAsInt(obj, "INSTR4", &temp);
+                check = jh_getFlatFieldAsInt(&obj, "INSTR4", &temp);
                 valid = valid && (check == JSON_OK) && 
                         (temp >= 0) && (temp <= 255);
                 if( valid )
@@ -405,7 +440,7 @@ static int getButtonHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd
                     hd_result->data[5] = (uint8_t)temp;
                 }
                 // INSTR5
-                check = jh_getObjectFieldAsInt(obj, "INSTR5", &temp);
+                check = jh_getFlatFieldAsInt(&obj, "INSTR5", &temp);
                 valid = valid && (check == JSON_OK) && 
                         (temp >= 0) && (temp <= 255);
                 if( valid )
@@ -413,7 +448,7 @@ static int getButtonHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd
                     hd_result->data[6] = (uint8_t)temp;
                 }
                 // INSTR6
-                check = jh_getObjectFieldAsInt(obj, "INSTR6", &temp);
+                check = jh_getFlatFieldAsInt(&obj, "INSTR6", &temp);
                 valid = valid && (check == JSON_OK) && 
                         (temp >= 0) && (temp <= 255);
                 if( valid )
@@ -433,9 +468,6 @@ static int getButtonHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd
         hd_result->frametype = HAPCAN_DIRECT_CONTROL_FRAME_TYPE;
         ret = HAPCAN_CAN_RESPONSE;
     }
-    // Free
-    jh_freeObject(obj);
-    free(str);
     // Leave
     return ret; 
 }
@@ -488,7 +520,7 @@ void hbutton_addToGateway(void)
             #ifdef DEBUG_HAPCAN_BUTTON_ERRORS
             if(!valid)
             {
-                debug_print("hbutton_addToGateway: Module Information Error!\n");
+                debug_error("hbutton_addToGateway: Module Information Error!\n");
             }
             #endif
             if(valid)
@@ -523,7 +555,7 @@ void hbutton_addToGateway(void)
                     #ifdef DEBUG_HAPCAN_BUTTON_ERRORS
                     if(!valid)
                     {
-                        debug_print("hbutton_addToGateway: channel Information "
+                        debug_error("hbutton_addToGateway: channel Information "
                                 "Error!\n");
                     }
                     #endif
@@ -542,36 +574,29 @@ void hbutton_addToGateway(void)
  * Set a payload based on the data received, and add it to the MQTT Pub Buffer.       
  */
 int hbutton_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp)
+        const void *context, unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
-    char **a_payload = NULL;
-    int *a_payloadlen = NULL;
+    const char *a_payload[BUTTON_MAX_PAYLOADS];
+    int a_payloadlen[BUTTON_MAX_PAYLOADS];
     int n_payloads = 0;
     int i;
     // Set the payloads
-    check = getButtonPayloads(hd_received, &a_payload, &a_payloadlen, 
+    check = getButtonPayloads(hd_received, a_payload, a_payloadlen, 
             &n_payloads);
     if(check == HAPCAN_MQTT_RESPONSE)
     {
         for(i = 0; i < n_payloads; i++)
         {
-            // Set MQTT Pub buffer
+            // Set MQTT Pub buffer (payload is copied to the buffer)
             if(state_str != NULL)
             {
-                ret = hapcan_addToMQTTPubBuffer(state_str, a_payload[i], 
-                        a_payloadlen[i], timestamp);
+                ret = hapcan_addToMQTTPubBuffer(state_str, 
+                        (void *)a_payload[i], a_payloadlen[i], timestamp);
             }
         }
     }
-    // Free
-    for(i = 0; i < n_payloads; i++)
-    {
-        free(a_payload[i]);
-    }
-    free(a_payloadlen);
-    free(a_payload);
     // Return
     return ret;
 }
@@ -580,13 +605,15 @@ int hbutton_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
  * Set a HAPCAN message based on the payload received, and add it to the CAN 
  * write Buffer.    
  */
-int hbutton_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload, 
-        int payloadlen, unsigned long long timestamp)
+int hbutton_setMQTT2CANResponse(hapcanCANData *hd_result, 
+        const void *context, void *payload, int payloadlen, 
+        unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
-    // Set the payload
-    check = getButtonHAPCANFrame(payload, payloadlen, hd_result);
+    // Set the frame - context is the template of the matched channel
+    check = getButtonHAPCANFrame(payload, payloadlen, 
+            (const buttonTemplate *)context, hd_result);
     if(check == HAPCAN_CAN_RESPONSE)
     {        
         ret = hapcan_addToCANWriteBuffer(hd_result, timestamp, true);
@@ -6,6 +6,10 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Module handlers receive the per-channel context registered with the      //
+// gateway element                                                            //
+//----------------------------------------------------------------------------//
 
 #ifndef HAPCANBUTTON_H
 #define HAPCANBUTTON_H
@@ -42,6 +46,7 @@ void hbutton_addToGateway(void);
  * Set a payload based on the data received, and add it to the MQTT Pub Buffer.
  * \param   state_str       (INPUT) string with the MQTT State Topic
  * \param   hd_received     (INPUT) pointer to HAPCAN message received
+ * \param   context         (INPUT) context registered with the gateway element
  * \param   timestamp       (INPUT) timestamp of the CAN message
  *                      
  * \return  HAPCAN_NO_RESPONSE: No response was added to MQTT Pub Buffer
@@ -51,12 +56,13 @@ void hbutton_addToGateway(void);
  *          
  */
 int hbutton_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp);
+        const void *context, unsigned long long timestamp);
 
 /**
  * Set a HAPCAN message based on the payload received, and add it to the CAN 
  * write Buffer.
  * \param   hd_result   (INPUT) matched results from the gateway
+ * \param   context     (INPUT) context registered with the gateway element
  * \param   payload     (INPUT) received MQTT Payload
  * \param   payloadlen  (INPUT) received MQTT Payload Length
  * \param   timestamp   (INPUT) timestamp of the CAN message
@@ -67,8 +73,9 @@ int hbutton_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
  *          HAPCAN_RESPONSE_ERROR: Other error
  *          
  */
-int hbutton_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload, 
-        int payloadlen, unsigned long long timestamp);
+int hbutton_setMQTT2CANResponse(hapcanCANData *hd_result, 
+        const void *context, void *payload, int payloadlen, 
+        unsigned long long timestamp);
 
 
 #ifdef __cplusplus
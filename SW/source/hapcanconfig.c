@@ -11,6 +11,25 @@
 // - config.json: add fields rawHapcanSubTopics, rawHapcanPubAll,             //
 // rawHapcanPubModules                                                        //
 //----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_HAPCAN          //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - config.json: add field rawHapcanEncoding                                 //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - rawHapcanPubModules compiled into a node x group bitmap (one bit test    //
+// for each frame, hconfig_isRawPubModule)                                    //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - rawHapcanPubTopic interned when the configuration is read                //
+// (hconfig_getRawPubTopic - no copy for each frame)                          //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
 
 /*
  * ----------------------------------------------------------------------------
@@ -38,10 +57,13 @@
 #include "hapcan.h"
 #include "hapcanconfig.h"
 #include "jsonhandler.h"
+#include "topic.h"
 
 //----------------------------------------------------------------------------//
 // INTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
+// One bit for each node of each group (8 KB)
+#define RAW_PUB_BITMAP_LEN  (256*256/8)
 
 //----------------------------------------------------------------------------//
 // INTERNAL TYPES
@@ -57,10 +79,18 @@ static int g_computerID2 = HAPCAN_DEFAULT_CIDx;
 static bool enableRawHapcan = false;
 static bool rawHapcanPubAll = false;
 static char *rawHapcanPubTopic = NULL;
+// Interned rawHapcanPubTopic - the previous one is released only on the next
+// reload (a frame being published may still use it)
+static const char * volatile rawPubTopicInterned = NULL;
+static const char *rawPubTopicPrevious = NULL;
 static int n_rawSubtopics = 0;
 static char **rawHapcanSubTopics = NULL;
 static int n_rawPubModules = 0;
 rawModuleID_t *rawModulesPubList = NULL;
+static int rawHapcanEncoding = HAPCAN_RAW_ENCODING_JSON;
+// Bitmap of rawHapcanPubModules: two, the one not in use is set on a reload
+static uint8_t rawModulesPubBitmap[2][RAW_PUB_BITMAP_LEN];
+static uint8_t * volatile rawModulesPubBits = rawModulesPubBitmap[0];
 // MQTT <--> Hapcan System Messages config
 static bool enableHapcanStatus;
 static char *statusPubTopic = NULL;
@@ -87,6 +117,9 @@ static void getHAPCANConfiguration(void)
     int n;
     int node;
     int group;
+    int encoding;
+    char *str = NULL;
+    uint8_t *bits;
     //--------------------------------------------------------------------------
     // Init - Free all values to default in case it is a reload
     //     REMARK: temporary save n to prevent simultaneous read while config 
@@ -158,6 +191,9 @@ static void getHAPCANConfiguration(void)
     {            
         rawHapcanPubTopic = NULL;
     }
+    topic_release(rawPubTopicPrevious);
+    rawPubTopicPrevious = rawPubTopicInterned;
+    rawPubTopicInterned = topic_intern(rawHapcanPubTopic);
     check = config_getStringArray(CONFIG_GENERAL_SETTINGS_LEVEL,
             "rawHapcanSubTopics", &n_rawSubtopics, &rawHapcanSubTopics);
     if (check != EXIT_SUCCESS) 
@@ -165,9 +201,34 @@ static void getHAPCANConfiguration(void)
         rawHapcanSubTopics = NULL;
         n_rawSubtopics = 0;
     }
+    encoding = HAPCAN_RAW_ENCODING_JSON;
+    check = config_getString(CONFIG_GENERAL_SETTINGS_LEVEL, 0, 
+        "rawHapcanEncoding", 0, NULL, &str);
+    if(check == EXIT_SUCCESS)
+    {
+        if(aux_compareStrings(str, "hex"))
+        {
+            encoding = HAPCAN_RAW_ENCODING_HEX;
+        }
+        else if(aux_compareStrings(str, "binary"))
+        {
+            encoding = HAPCAN_RAW_ENCODING_BINARY;
+        }
+        #ifdef DEBUG_HAPCAN_CONFIG_ERRORS
+        else if(!aux_compareStrings(str, "json"))
+        {
+            debug_error("getHAPCANConfiguration: invalid rawHapcanEncoding!\n");
+        }
+        #endif
+    }
+    free(str);
+    rawHapcanEncoding = encoding;
     //------------------------------------------------
     // Get the number of configured RAW Modules
     //------------------------------------------------
+    bits = (rawModulesPubBits == rawModulesPubBitmap[0]) ? 
+            rawModulesPubBitmap[1] : rawModulesPubBitmap[0];
+    memset(bits, 0, RAW_PUB_BITMAP_LEN);
     check = jh_getJArrayElementsObj(CONFIG_GENERAL_SETTINGS_LEVEL, 
         "rawHapcanPubModules", 0, NULL, JSON_DEPTH_LEVEL, &n_rawPubModules);
     if(check == JSON_OK)
@@ -191,12 +252,18 @@ static void getHAPCANConfiguration(void)
             {
                 rawModulesPubList[i].node = node;
                 rawModulesPubList[i].group = group;
+                bits[(group << 5) | (node >> 3)] |= (uint8_t)(1 << (node & 7));
+            }
+            else
+            {
+                // List error: no module is published
+                memset(bits, 0, RAW_PUB_BITMAP_LEN);
             }
             #ifdef DEBUG_HAPCAN_CONFIG_ERRORS
             if(!valid)
             {
                 n_rawPubModules = 0;
-                debug_print("getHAPCANConfiguration: Raw Pub List Error!\n");
+                debug_error("getHAPCANConfiguration: Raw Pub List Error!\n");
             }
             #endif
         }
@@ -206,6 +273,7 @@ static void getHAPCANConfiguration(void)
         n_rawPubModules = 0;
         rawModulesPubList = NULL;
     }
+    rawModulesPubBits = bits;
     //-----------------------------------
     // MQTT <--> Hapcan System Messages config
     //-----------------------------------
@@ -383,6 +451,9 @@ int hconfig_getConfigInt(hapcanConfigID config, int *value)
         case HAPCAN_CONFIG_N_PUB_MODULES:
             *value = n_rawPubModules;
             break;
+        case HAPCAN_CONFIG_RAW_ENCODING:
+            *value = rawHapcanEncoding;
+            break;
         default:
             *value = 0;
             ret = EXIT_FAILURE;
@@ -420,4 +491,20 @@ int hconfig_getConfigID(hapcanConfigID config, uint16_t i_field,
             break;
     }
     return ret;
+}
+
+/**
+ * Return the interned topic of the raw frames published (rawHapcanPubTopic)
+ */
+const char* hconfig_getRawPubTopic(void)
+{
+    return rawPubTopicInterned;
+}
+
+/**
+ * Check if a module is in the list of modules to have their frames published
+ */
+bool hconfig_isRawPubModule(uint8_t node, uint8_t group)
+{
+    return (rawModulesPubBits[(group << 5) | (node >> 3)] >> (node & 7)) & 1;
 }
\ No newline at end of file
@@ -11,6 +11,15 @@
 // - config.json: add fields rawHapcanSubTopics, rawHapcanPubAll,             //
 // rawHapcanPubModules                                                        //
 //----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add HAPCAN_CONFIG_RAW_ENCODING (rawHapcanEncoding)                       //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add hconfig_isRawPubModule                                               //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Add hconfig_getRawPubTopic                                               //
+//----------------------------------------------------------------------------//
 
 #ifndef HAPCANCONFIG_H
 #define HAPCANCONFIG_H
@@ -32,6 +41,14 @@ typedef struct
     uint8_t group;
 } rawModuleID_t;
 
+// Payload of the raw frames published (rawHapcanEncoding)
+enum
+{
+    HAPCAN_RAW_ENCODING_JSON = 0,       // "json" (default)
+    HAPCAN_RAW_ENCODING_HEX,            // "hex": 30 characters
+    HAPCAN_RAW_ENCODING_BINARY          // "binary": 15 bytes, socket format
+};
+
 //----------------------------------------------------------------------------//
 // EXTERNAL TYPES
 //----------------------------------------------------------------------------//
@@ -45,6 +62,7 @@ typedef enum
     HAPCAN_CONFIG_RAW_PUB,
     HAPCAN_CONFIG_N_RAW_SUBS,
     HAPCAN_CONFIG_RAW_SUBS,
+    HAPCAN_CONFIG_RAW_ENCODING,
     HAPCAN_CONFIG_N_PUB_MODULES,
     HAPCAN_CONFIG_PUB_MODULES,
     HAPCAN_CONFIG_ENABLE_STATUS,
@@ -120,6 +138,29 @@ int hconfig_getConfigInt(hapcanConfigID config, int *value);
 int hconfig_getConfigID(hapcanConfigID config, uint16_t i_field, 
     rawModuleID_t *id);
 
+/**
+ * Return the interned rawHapcanPubTopic (interned when the configuration is
+ * read - no copy). The topic is valid at least until the configuration is 
+ * reloaded twice: pass it on to hapcan_addToMQTTPubBuffer (that takes a
+ * reference) and do not keep it.
+ *                      
+ * \return  interned topic, NULL if not configured
+ *          
+ */
+const char* hconfig_getRawPubTopic(void);
+
+/**
+ * Check if a module is in the list of modules to have their frames published 
+ * (rawHapcanPubModules - compiled into a bitmap when the configuration is 
+ * read)
+ * \param   node    (INPUT) HAPCAN module
+ *          group   (INPUT) HAPCAN group
+ *                      
+ * \return  true: module is in the list
+ *          
+ */
+bool hconfig_isRawPubModule(uint8_t node, uint8_t group);
+
 #ifdef __cplusplus
 }
 #endif
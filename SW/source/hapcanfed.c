@@ -0,0 +1,525 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - The batch is published with an interned topic                            //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - The batch is published with the interned rawHapcanPubTopic               //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - g_nFrames is read without the lock by hfed_flush (atomic). The own       //
+// gateway ID is read under the lock by hfed_handleBatch                      //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Batches are published after the lock is released (a full MQTT queue      //
+// does not stop the frames added / received). Published in sequence order    //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
+
+/*
+* Includes
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "auxiliary.h"
+#include "config.h"
+#include "debug.h"
+#include "hapcan.h"
+#include "hapcanconfig.h"
+#include "hapcanfed.h"
+#include "metrics.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Last frame received from a gateway (duplicate suppression)
+typedef struct
+{
+    bool used;
+    uint16_t origin;
+    uint32_t session;
+    uint32_t sequence;
+    unsigned long long millisecondsSinceEpoch;
+} hfedOrigin_t;
+
+// Frame published (loop suppression)
+typedef struct
+{
+    hapcanCANData frame;
+    unsigned long long millisecondsSinceEpoch;
+} hfedEcho_t;
+
+// Batch taken from the one being filled (published without the lock)
+typedef struct
+{
+    uint8_t payload[HFED_PAYLOAD_MAX_LEN];
+    int payloadlen;
+    int n_frames;
+    uint32_t sequence;
+    const char *topic;
+} hfedBatch_t;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+// Configuration
+static bool g_enabled = false;
+static int g_gatewayID = 0;
+static int g_batchTime = HFED_DEFAULT_TIME;
+static int g_batchFrames = HFED_MAX_FRAMES;
+// Batch being filled
+static uint8_t g_payload[HFED_PAYLOAD_MAX_LEN];
+static int g_nFrames = 0;    // Atomic: read without the lock by hfed_flush
+static unsigned long long g_firstTimestamp = 0;
+static uint32_t g_session = 0;
+static uint32_t g_sequence = 0;
+// Received gateways and published frames
+static hfedOrigin_t g_origins[HFED_MAX_ORIGINS];
+static hfedEcho_t g_echo[HFED_ECHO_FRAMES];
+static int g_echoIndex = 0;
+static pthread_mutex_t g_fed_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Batches published in sequence order: sequence of the next one
+static uint32_t g_pubSequence = 0;
+static pthread_mutex_t g_pub_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_pub_turn = PTHREAD_COND_INITIALIZER;
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static void setUInt32(uint8_t *data, uint32_t value);
+static uint32_t getUInt32(uint8_t *data);
+static void setFrame(uint8_t *data, hapcanCANData *hd);
+static bool getFrame(uint8_t *data, hapcanCANData *hd);
+static bool sameFrame(hapcanCANData *a, hapcanCANData *b);
+static bool isDuplicate(uint16_t origin, uint32_t session, uint32_t sequence,
+        unsigned long long timestamp);
+static bool isEcho(hapcanCANData *hd, unsigned long long timestamp);
+static bool takeBatch(hfedBatch_t *batch);
+static int publishBatch(hfedBatch_t *batch, unsigned long long timestamp);
+
+// Big endian 32 bits
+static void setUInt32(uint8_t *data, uint32_t value)
+{
+    data[0] = (uint8_t)(value >> 24);
+    data[1] = (uint8_t)(value >> 16);
+    data[2] = (uint8_t)(value >> 8);
+    data[3] = (uint8_t)value;
+}
+
+static uint32_t getUInt32(uint8_t *data)
+{
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+            ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+}
+
+// Frame of the batch (HFED_FRAME_LEN bytes)
+static void setFrame(uint8_t *data, hapcanCANData *hd)
+{
+    data[0] = (uint8_t)(hd->frametype >> 4);
+    data[1] = (uint8_t)(((hd->frametype & 0x0F) << 4) | (hd->flags & 0x0F));
+    data[2] = hd->module;
+    data[3] = hd->group;
+    memcpy(&data[4], hd->data, HAPCAN_DATA_LEN);
+}
+
+static bool getFrame(uint8_t *data, hapcanCANData *hd)
+{
+    hd->frametype = ((uint16_t)data[0] << 4) | (data[1] >> 4);
+    hd->flags = data[1] & 0x0F;
+    hd->module = data[2];
+    hd->group = data[3];
+    memcpy(hd->data, &data[4], HAPCAN_DATA_LEN);
+    // Same check as the JSON raw frame
+    return (hd->flags <= 1);
+}
+
+// Same frame type, flags, module, group and data
+static bool sameFrame(hapcanCANData *a, hapcanCANData *b)
+{
+    return (a->frametype == b->frametype) && (a->flags == b->flags) &&
+            (a->module == b->module) && (a->group == b->group) &&
+            (memcmp(a->data, b->data, HAPCAN_DATA_LEN) == 0);
+}
+
+// Frame already received from this gateway - LOCKED BY THE CALLER
+static bool isDuplicate(uint16_t origin, uint32_t session, uint32_t sequence,
+        unsigned long long timestamp)
+{
+    int i;
+    int oldest = 0;
+    hfedOrigin_t *item = NULL;
+    for(i = 0; i < HFED_MAX_ORIGINS; i++)
+    {
+        if(g_origins[i].used && (g_origins[i].origin == origin))
+        {
+            item = &g_origins[i];
+            break;
+        }
+        if(!g_origins[i].used || (g_origins[oldest].used &&
+                (g_origins[i].millisecondsSinceEpoch <
+                g_origins[oldest].millisecondsSinceEpoch)))
+        {
+            oldest = i;
+        }
+    }
+    if(item == NULL)
+    {
+        // New gateway: replace the one not heard from for the longest time
+        item = &g_origins[oldest];
+        item->used = true;
+        item->origin = origin;
+        item->session = session;
+        item->sequence = sequence - 1;
+    }
+    item->millisecondsSinceEpoch = timestamp;
+    if(item->session != session)
+    {
+        // Gateway restarted: new sequence
+        item->session = session;
+        item->sequence = sequence - 1;
+    }
+    // Sequence not after the last one (with wrap around)
+    if((int32_t)(sequence - item->sequence) <= 0)
+    {
+        return true;
+    }
+    item->sequence = sequence;
+    return false;
+}
+
+// Frame published by this gateway a moment ago - LOCKED BY THE CALLER
+static bool isEcho(hapcanCANData *hd, unsigned long long timestamp)
+{
+    int i;
+    hfedEcho_t *echo;
+    for(i = 0; i < HFED_ECHO_FRAMES; i++)
+    {
+        echo = &g_echo[i];
+        if((echo->millisecondsSinceEpoch + HFED_ECHO_TIME >= timestamp) &&
+                sameFrame(&echo->frame, hd))
+        {
+            // Only once: the next equal frame is a new one
+            echo->millisecondsSinceEpoch = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Take the frames of the batch to be published - LOCKED BY THE CALLER
+static bool takeBatch(hfedBatch_t *batch)
+{
+    if(g_nFrames <= 0)
+    {
+        return false;
+    }
+    // Header
+    g_payload[0] = HFED_MAGIC_0;
+    g_payload[1] = HFED_MAGIC_1;
+    g_payload[2] = HFED_VERSION;
+    g_payload[3] = (uint8_t)g_nFrames;
+    g_payload[4] = (uint8_t)(g_gatewayID >> 8);
+    g_payload[5] = (uint8_t)g_gatewayID;
+    setUInt32(&g_payload[6], g_session);
+    setUInt32(&g_payload[10], g_sequence);
+    batch->payloadlen = HFED_HEADER_LEN + g_nFrames*HFED_FRAME_LEN;
+    memcpy(batch->payload, g_payload, batch->payloadlen);
+    batch->n_frames = g_nFrames;
+    batch->sequence = g_sequence;
+    batch->topic = hconfig_getRawPubTopic();
+    // Next batch: sequences go on even if this one is not published
+    g_sequence = g_sequence + g_nFrames;
+    __atomic_store_n(&g_nFrames, 0, __ATOMIC_RELAXED);
+    return true;
+}
+
+// Publish a batch taken (takeBatch) - NOT LOCKED: waits for the batches 
+// taken before (a later sequence would make them duplicates)
+static int publishBatch(hfedBatch_t *batch, unsigned long long timestamp)
+{
+    int ret;
+    // LOCK PUBLISH
+    pthread_mutex_lock(&g_pub_mutex);
+    while(g_pubSequence != batch->sequence)
+    {
+        pthread_cond_wait(&g_pub_turn, &g_pub_mutex);
+    }
+    // UNLOCK PUBLISH (the next batches wait for this one)
+    pthread_mutex_unlock(&g_pub_mutex);
+    if(batch->topic == NULL)
+    {
+        #ifdef DEBUG_HAPCAN_ERRORS
+        debug_error("hfed - publishBatch: no rawHapcanPubTopic\n");
+        #endif
+        ret = HAPCAN_NO_RESPONSE;
+    }
+    else
+    {
+        // May wait for the MQTT Pub Buffer (BLOCK policy)
+        ret = hapcan_addToMQTTPubBuffer(batch->topic, batch->payload, 
+                batch->payloadlen, timestamp);
+        if(ret == HAPCAN_MQTT_RESPONSE)
+        {
+            metrics_add(METRICS_FEDERATION_BATCHES, METRICS_FEDERATION_TX, 1);
+            metrics_add(METRICS_FEDERATION_FRAMES, METRICS_FEDERATION_TX,
+                    batch->n_frames);
+        }
+    }
+    // LOCK PUBLISH
+    pthread_mutex_lock(&g_pub_mutex);
+    g_pubSequence = batch->sequence + batch->n_frames;
+    pthread_cond_broadcast(&g_pub_turn);
+    // UNLOCK PUBLISH
+    pthread_mutex_unlock(&g_pub_mutex);
+    return ret;
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/* Read the configuration */
+void hfed_init(void)
+{
+    int check;
+    bool enable;
+    int value;
+    bool taken = false;
+    hfedBatch_t batch;
+    // LOCK FEDERATION
+    pthread_mutex_lock(&g_fed_mutex);
+    // Frames of the previous configuration
+    if(g_enabled)
+    {
+        taken = takeBatch(&batch);
+    }
+    // Session: frames of a restarted gateway are not duplicates
+    if(g_session == 0)
+    {
+        g_session = (uint32_t)(aux_getmsSinceEpoch() / 1000);
+    }
+    check = config_getBool(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "rawHapcanBatch", 0, NULL, &enable);
+    if(check != EXIT_SUCCESS)
+    {
+        enable = false;
+    }
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "rawHapcanGatewayID", 0, NULL, &value);
+    if((check != EXIT_SUCCESS) || (value < 1) || (value > 0xFFFF))
+    {
+        #ifdef DEBUG_HAPCAN_ERRORS
+        if(enable)
+        {
+            debug_error("hfed_init: rawHapcanGatewayID Error - batches "
+                    "disabled\n");
+        }
+        #endif
+        value = 0;
+        enable = false;
+    }
+    g_gatewayID = value;
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "rawHapcanBatchTime", 0, NULL, &value);
+    if((check != EXIT_SUCCESS) || (value < 0) || (value > HFED_MAX_TIME))
+    {
+        value = HFED_DEFAULT_TIME;
+    }
+    g_batchTime = value;
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "rawHapcanBatchFrames", 0, NULL, &value);
+    if((check != EXIT_SUCCESS) || (value < 1) || (value > HFED_MAX_FRAMES))
+    {
+        value = HFED_MAX_FRAMES;
+    }
+    g_batchFrames = value;
+    g_enabled = enable;
+    // UNLOCK FEDERATION
+    pthread_mutex_unlock(&g_fed_mutex);
+    if(taken)
+    {
+        publishBatch(&batch, aux_getmsSinceEpoch());
+    }
+}
+
+/* Check if raw frames are published in batches */
+bool hfed_isEnabled(void)
+{
+    return g_enabled;
+}
+
+/* Add a frame to the batch */
+int hfed_addFrame(hapcanCANData* hapcanData, unsigned long long timestamp)
+{
+    int ret = HAPCAN_NO_RESPONSE;
+    bool taken = false;
+    hfedEcho_t *echo;
+    hfedBatch_t batch;
+    // LOCK FEDERATION
+    pthread_mutex_lock(&g_fed_mutex);
+    if(g_nFrames == 0)
+    {
+        g_firstTimestamp = timestamp;
+    }
+    setFrame(&g_payload[HFED_HEADER_LEN + g_nFrames*HFED_FRAME_LEN],
+            hapcanData);
+    __atomic_store_n(&g_nFrames, g_nFrames + 1, __ATOMIC_RELAXED);
+    // Remember it: if it comes back from another gateway, it is not written
+    echo = &g_echo[g_echoIndex];
+    echo->frame = *hapcanData;
+    echo->millisecondsSinceEpoch = timestamp;
+    g_echoIndex = (g_echoIndex + 1) % HFED_ECHO_FRAMES;
+    if(g_nFrames >= g_batchFrames)
+    {
+        taken = takeBatch(&batch);
+    }
+    // UNLOCK FEDERATION
+    pthread_mutex_unlock(&g_fed_mutex);
+    if(taken)
+    {
+        ret = publishBatch(&batch, timestamp);
+    }
+    return ret;
+}
+
+/* Publish the batch if it waits for too long */
+int hfed_flush(unsigned long long timestamp)
+{
+    int ret = HAPCAN_NO_RESPONSE;
+    bool taken = false;
+    hfedBatch_t batch;
+    // Nothing to do for most of the calls - no lock
+    if(__atomic_load_n(&g_nFrames, __ATOMIC_RELAXED) == 0)
+    {
+        return ret;
+    }
+    // LOCK FEDERATION
+    pthread_mutex_lock(&g_fed_mutex);
+    if((g_nFrames > 0) && (timestamp >= g_firstTimestamp + g_batchTime))
+    {
+        taken = takeBatch(&batch);
+    }
+    // UNLOCK FEDERATION
+    pthread_mutex_unlock(&g_fed_mutex);
+    if(taken)
+    {
+        ret = publishBatch(&batch, timestamp);
+    }
+    return ret;
+}
+
+/* Check if a MQTT payload is a batch */
+bool hfed_isBatch(void* payload, int payloadlen)
+{
+    uint8_t *data = payload;
+    return (payload != NULL) && (payloadlen >= HFED_HEADER_LEN) &&
+            (data[0] == HFED_MAGIC_0) && (data[1] == HFED_MAGIC_1);
+}
+
+/* Write the frames of a batch to the CAN Write Buffer(s) */
+int hfed_handleBatch(void* payload, int payloadlen,
+        unsigned long long timestamp)
+{
+    int i;
+    int n;
+    int check;
+    int ret;
+    uint16_t origin;
+    uint32_t session;
+    uint32_t sequence;
+    uint8_t *data = payload;
+    hapcanCANData frames[HFED_MAX_FRAMES];
+    bool valid[HFED_MAX_FRAMES];
+    //-------------------------------------------
+    // Check the whole batch before writing to CAN
+    //-------------------------------------------
+    if(!hfed_isBatch(payload, payloadlen) || (data[2] != HFED_VERSION) ||
+            (data[3] < 1) || (data[3] > HFED_MAX_FRAMES) ||
+            (payloadlen != HFED_HEADER_LEN + data[3]*HFED_FRAME_LEN))
+    {
+        #ifdef DEBUG_HAPCAN_ERRORS
+        debug_error("hfed_handleBatch: Invalid batch\n");
+        #endif
+        return HAPCAN_RESPONSE_ERROR;
+    }
+    n = data[3];
+    origin = ((uint16_t)data[4] << 8) | data[5];
+    session = getUInt32(&data[6]);
+    sequence = getUInt32(&data[10]);
+    for(i = 0; i < n; i++)
+    {
+        if(!getFrame(&data[HFED_HEADER_LEN + i*HFED_FRAME_LEN], &frames[i]))
+        {
+            #ifdef DEBUG_HAPCAN_ERRORS
+            debug_error("hfed_handleBatch: Invalid frame %d\n", i);
+            #endif
+            return HAPCAN_RESPONSE_ERROR;
+        }
+    }
+    //-------------------------------------------
+    // Duplicates and loops
+    //-------------------------------------------
+    // LOCK FEDERATION
+    pthread_mutex_lock(&g_fed_mutex);
+    // Own batch (this gateway is also subscribed to its topic)
+    if(origin == g_gatewayID)
+    {
+        // UNLOCK FEDERATION
+        pthread_mutex_unlock(&g_fed_mutex);
+        return HAPCAN_NO_RESPONSE;
+    }
+    metrics_add(METRICS_FEDERATION_BATCHES, METRICS_FEDERATION_RX, 1);
+    for(i = 0; i < n; i++)
+    {
+        valid[i] = false;
+        if(isDuplicate(origin, session, sequence + i, timestamp))
+        {
+            metrics_add(METRICS_FEDERATION_DROPS, METRICS_FEDERATION_DUPLICATE,
+                    1);
+        }
+        else if(isEcho(&frames[i], timestamp))
+        {
+            metrics_add(METRICS_FEDERATION_DROPS, METRICS_FEDERATION_LOOP, 1);
+        }
+        else
+        {
+            valid[i] = true;
+        }
+    }
+    // UNLOCK FEDERATION
+    pthread_mutex_unlock(&g_fed_mutex);
+    //-------------------------------------------
+    // Write the frames of the batch
+    //-------------------------------------------
+    ret = HAPCAN_NO_RESPONSE;
+    for(i = 0; i < n; i++)
+    {
+        if(!valid[i])
+        {
+            continue;
+        }
+        check = hapcan_addToCANWriteBuffer(&frames[i], timestamp, true);
+        if(check != HAPCAN_CAN_RESPONSE)
+        {
+            // Error already handled - CAN will be restarted
+            ret = HAPCAN_CAN_RESPONSE_ERROR;
+            break;
+        }
+        metrics_add(METRICS_FEDERATION_FRAMES, METRICS_FEDERATION_RX, 1);
+        ret = HAPCAN_CAN_RESPONSE;
+    }
+    return ret;
+}
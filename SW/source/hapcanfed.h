@@ -0,0 +1,116 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef HAPCANFED_H
+#define HAPCANFED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include "hapcan.h"
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+/* Batch payload (binary, big endian):
+ *   "HF", version, number of frames,
+ *   origin gateway ID (2 bytes), session (4 bytes), sequence of the first
+ *   frame (4 bytes - the next frames are sequence + 1, + 2...)
+ *   and for each frame: frame type (12 bits) + flags (4 bits), module, group,
+ *   D0 to D7 */
+#define HFED_MAGIC_0            'H'
+#define HFED_MAGIC_1            'F'
+#define HFED_VERSION            1
+#define HFED_HEADER_LEN         14
+#define HFED_FRAME_LEN          12
+/* Default / maximum number of frames of a batch - rawHapcanBatchFrames */
+#define HFED_MAX_FRAMES         32
+/* Default time a batch waits for more frames (ms) - rawHapcanBatchTime */
+#define HFED_DEFAULT_TIME       5
+#define HFED_MAX_TIME           1000
+#define HFED_PAYLOAD_MAX_LEN    (HFED_HEADER_LEN + \
+                                HFED_MAX_FRAMES*HFED_FRAME_LEN)
+/* Gateways (origins) remembered for duplicate suppression */
+#define HFED_MAX_ORIGINS        16
+/* Frames published that are remembered for loop suppression */
+#define HFED_ECHO_FRAMES        64
+/* A frame received up to this time after being published is an echo (ms) */
+#define HFED_ECHO_TIME          500
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Read the configuration (rawHapcanBatch, rawHapcanGatewayID,
+ * rawHapcanBatchTime, rawHapcanBatchFrames). Frames waiting in a batch are
+ * published first.
+ */
+void hfed_init(void);
+
+/**
+ * Check if raw frames are published in batches
+ *
+ * \return  true: batches enabled (and gateway ID configured)
+ */
+bool hfed_isEnabled(void);
+
+/**
+ * Add a frame to the batch. The batch is published (raw pub topic) when it
+ * has rawHapcanBatchFrames frames.
+ *
+ * \param   hapcanData      (INPUT) received HAPCAN Frame
+ * \param   timestamp       (INPUT) Received message timestamp
+ *
+ * \return  HAPCAN_NO_RESPONSE: frame waiting in the batch
+ *          HAPCAN_MQTT_RESPONSE: batch added to MQTT Pub Buffer (OK)
+ *          HAPCAN_MQTT_RESPONSE_ERROR: Error adding to MQTT Pub Buffer (FAIL)
+ */
+int hfed_addFrame(hapcanCANData* hapcanData, unsigned long long timestamp);
+
+/**
+ * Publish the batch if its first frame waits for rawHapcanBatchTime
+ *
+ * \param   timestamp       (INPUT) current time (ms since epoch)
+ *
+ * \return  same as hfed_addFrame
+ */
+int hfed_flush(unsigned long long timestamp);
+
+/**
+ * Check if a MQTT payload is a batch (and not a JSON frame)
+ *
+ * \param   payload         (INPUT) received payload
+ * \param   payloadlen      (INPUT) received payload len
+ */
+bool hfed_isBatch(void* payload, int payloadlen);
+
+/**
+ * Write the frames of a batch to the CAN Write Buffer(s). Frames from this
+ * gateway, already received (sequence of its origin) or that this gateway
+ * published a moment ago (loop through another gateway) are not written.
+ *
+ * \param   payload         (INPUT) received payload
+ * \param   payloadlen      (INPUT) received payload len
+ * \param   timestamp       (INPUT) Received message timestamp
+ *
+ * \return  HAPCAN_NO_RESPONSE: No frame was added to CAN Write Buffer
+ *          HAPCAN_CAN_RESPONSE: Frames added to CAN Write Buffer (OK)
+ *          HAPCAN_CAN_RESPONSE_ERROR: Error adding to CAN Write Buffer (FAIL)
+ *          HAPCAN_RESPONSE_ERROR: Invalid batch
+ */
+int hfed_handleBatch(void* payload, int payloadlen,
+        unsigned long long timestamp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAPCANFED_H */
@@ -11,6 +11,38 @@
 // - config.json: add fields rawHapcanSubTopics, rawHapcanPubAll,             //
 // rawHapcanPubModules                                                        //
 //----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Raw CAN2MQTT payload is written to a caller provided buffer              //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Raw MQTT2CAN JSON is parsed with jh_parseFlatObject (no allocation, no   //
+// JSON lock)                                                                 //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_HAPCAN          //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - hm_isRawPublished / hm_isRawSubTopic: raw frame filters, also used by    //
+// the batches of hapcanfed.h                                                 //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Raw frames published as JSON, hex string or socket format binary         //
+// (rawHapcanEncoding); the three formats are accepted when received          //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - Raw pub modules checked with a single bit test (hconfig_isRawPubModule)  //
+//----------------------------------------------------------------------------//
+//  1.08     | 18/Oct/2026 |                               | ALCP             //
+// - Raw frames use the interned rawHapcanPubTopic (no copy for each frame)   //
+//----------------------------------------------------------------------------//
+//  1.09     | 18/Oct/2026 |                               | ALCP             //
+// - Add hm_getOnOffCommand (text commands of the relays and buttons)         //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
 
 /*
 * Includes
@@ -27,6 +59,7 @@
 #include "hapcan.h"
 #include "hapcanconfig.h"
 #include "hapcanmqtt.h"
+#include "hapcansocket.h"
 #include "jsonhandler.h"
 #include "mqtt.h"
 #include "mqttbuf.h"
@@ -52,6 +85,69 @@
 static int getHAPCANFromRawMQTT(void* payload, int payloadlen, 
         hapcanCANData* hCD_ptr);
 static int checkRawSubTopic(char *str_command_topic);
+static bool checkRawPubModule(hapcanCANData* hapcanData);
+static int getHexDigit(char c);
+static bool getSocketArrayFromRawMQTT(void* payload, int payloadlen, 
+        uint8_t* data);
+static int setRawJSON(hapcanCANData* hapcanData, char* payload, 
+        unsigned int size);
+static int setRawHex(hapcanCANData* hapcanData, char* payload, 
+        unsigned int size);
+
+/* Value of a hex digit - returns -1 if it is not a hex digit */
+static int getHexDigit(char c)
+{
+    if((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+    if((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+    if((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/* Socket format frame (binary or hex string) from MQTT
+ * - returns false if the payload is not a socket format frame
+ */
+static bool getSocketArrayFromRawMQTT(void* payload, int payloadlen, 
+        uint8_t* data)
+{
+    int i;
+    int hi;
+    int lo;
+    const char *str = payload;
+    if(payloadlen == HAPCAN_SOCKET_DATA_LEN)
+    {
+        // Binary
+        memcpy(data, payload, HAPCAN_SOCKET_DATA_LEN);
+    }
+    else if(payloadlen == 2*HAPCAN_SOCKET_DATA_LEN)
+    {
+        // Hex string
+        for(i = 0; i < HAPCAN_SOCKET_DATA_LEN; i++)
+        {
+            hi = getHexDigit(str[2*i]);
+            lo = getHexDigit(str[2*i + 1]);
+            if((hi < 0) || (lo < 0))
+            {
+                return false;
+            }
+            data[i] = (uint8_t)((hi << 4) | lo);
+        }
+    }
+    else
+    {
+        return false;
+    }
+    // START and STOP
+    return (data[0] == 0xAA) && (data[HAPCAN_SOCKET_DATA_LEN - 1] == 0xA5);
+}
 
 /* From MQTT GENERIC to HAPCAN 
  * - returns HAPCAN_NO_RESPONSE / HAPCAN_CAN_RESPONSE / HAPCAN_RESPONSE_ERROR 
@@ -62,79 +158,81 @@ static int getHAPCANFromRawMQTT(void* payload, int payloadlen,
     // GENERIC FRAME:
     /* {"Frame":Frame,"Flags":Flags,"Module":Module,"Group":Group,
      * "D0":D0,"D1":D1,"D2":D2,"D3":D3,"D4":D4,"D5":D5,"D6":D6,"D7":D7} */
-    json_object *obj = NULL;
+    static const char* const c_data_fields[HAPCAN_DATA_LEN] = 
+            {"D0", "D1", "D2", "D3", "D4", "D5", "D6", "D7"};
+    jsonFlatObject obj;
     int ret;
     int check;
     int value;
     int i;
-    char *str = NULL;
     bool valid;
+    bool json = true;
+    uint8_t data[HAPCAN_SOCKET_DATA_LEN];
     // Check NULL or size 0
     if((payload == NULL) || (payloadlen <= 0))
     {
         valid = false;
     }
+    else if(getSocketArrayFromRawMQTT(payload, payloadlen, data))
+    {
+        // HEX / BINARY FRAME: same as the socket server frame
+        hs_getHAPCANFromSocketArray(data, hCD_ptr);
+        valid = (hapcan_getChecksumFromCAN(hCD_ptr) == 
+                data[HAPCAN_SOCKET_DATA_LEN - 2]);
+        json = false;
+    }
     else
     {
         // Set valid and check if all is OK at the end
         valid = true;
-        // payload does not end with 0 for a string - copy it here
-        str = malloc(payloadlen + 1);
-        memcpy(str, payload, payloadlen);
-        str[payloadlen] = 0;
         // Get the JSON Object
-        jh_getObject(str, &obj);
-        free(str);
-        str = NULL;
+        check = jh_parseFlatObject(payload, payloadlen, &obj);
         // Check if error parsing
-        if(obj == NULL)
+        if(check != JSON_OK)
         {
             valid = false;
         }
     }
     // Parse fields
-    if(valid)
+    if(valid && json)
     {
         // Frame
-        check = jh_getObjectFieldAsInt(obj, "Frame", &value);
+        check = jh_getFlatFieldAsInt(&obj, "Frame", &value);
         valid = valid && (check == JSON_OK) && (value >= 0) && (value <= 0xFFF);
         if( valid )
         {
             hCD_ptr->frametype = (uint16_t)value;
         }
         // Flags
-        check = jh_getObjectFieldAsInt(obj, "Flags", &value);
+        check = jh_getFlatFieldAsInt(&obj, "Flags", &value);
         valid = valid && (check == JSON_OK) && (value >= 0) && (value <= 1);
         if( valid )
         {
             hCD_ptr->flags = (uint8_t)value;
         }
         // Module
-        check = jh_getObjectFieldAsInt(obj, "Module", &value);
+        check = jh_getFlatFieldAsInt(&obj, "Module", &value);
         valid = valid && (check == JSON_OK) && (value >= 0) && (value <= 255);
         if( valid )
         {
             hCD_ptr->module = (uint8_t)value;
         }
         // Group
-        check = jh_getObjectFieldAsInt(obj, "Group", &value);
+        check = jh_getFlatFieldAsInt(&obj, "Group", &value);
         valid = valid && (check == JSON_OK) && (value >= 0) && (value <= 255);
         if( valid )
         {
             hCD_ptr->group = (uint8_t)value;
         }
-        str = strdup("D0");    
-        for(i = 0; i < 8; i++)
+        for(i = 0; i < HAPCAN_DATA_LEN; i++)
         {
-            check = jh_getObjectFieldAsInt(obj, str, &value);
+            check = jh_getFlatFieldAsInt(&obj, c_data_fields[i], &value);
             valid = valid && (check == JSON_OK) && (value >= 0) && 
                     (value <= 255);
             if( valid )
             {
                 hCD_ptr->data[i] = (uint8_t)value;
             }
-            // increment delimeter ("D0" to "D1" and so on)
-            str[1]++;            
         }
     }    
     // Set return and Clean
@@ -148,9 +246,6 @@ static int getHAPCANFromRawMQTT(void* payload, int payloadlen,
     {
         ret = HAPCAN_CAN_RESPONSE;
     }
-    // Free
-    jh_freeObject(obj);
-    free(str);
     // Leave
     return ret;    
 }
@@ -202,6 +297,124 @@ static int checkRawSubTopic(char *str_command_topic)
     return ret;
 }
 
+/**
+ * Check if the frames of a module are published as raw frames (rawHapcanPubAll
+ * or rawHapcanPubModules - application frames only)
+ * 
+ * \param   hapcanData      HAPCAN Data revceived (INPUT)
+ *  
+ * \return  true: frame is published
+ */
+static bool checkRawPubModule(hapcanCANData* hapcanData)
+{
+    bool enable;
+    int check;
+    // Application messagens only (Frame Type > 0x200)
+    if(hapcanData->frametype <= HAPCAN_START_NORMAL_MESSAGES)
+    {
+        return false;
+    }
+    //-------------------------------------------
+    // Initial configuration check
+    //-------------------------------------------
+    check = hconfig_getConfigBool(HAPCAN_CONFIG_PUB_ALL, &enable);
+    if(check == EXIT_FAILURE)
+    {
+       enable = false;
+    }
+    if(!enable)
+    {
+        // Configured modules: one bit for each node / group
+        enable = hconfig_isRawPubModule(hapcanData->module, hapcanData->group);
+    }
+    return enable;
+}
+
+/* JSON raw frame - returns the payload length (0 if it does not fit) */
+static int setRawJSON(hapcanCANData* hapcanData, char* payload, 
+        unsigned int size)
+{
+    int field;
+    int len;
+    jsonFieldData j_arr[12];
+    field = 0;
+    j_arr[field].field = "Frame";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->frametype;
+    field++;
+    j_arr[field].field = "Flags";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->flags;
+    field++;
+    j_arr[field].field = "Module";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->module;
+    field++;
+    j_arr[field].field = "Group";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->group;
+    field++;
+    j_arr[field].field = "D0";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->data[0];
+    field++;
+    j_arr[field].field = "D1";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->data[1];
+    field++;
+    j_arr[field].field = "D2";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->data[2];
+    field++;
+    j_arr[field].field = "D3";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->data[3];
+    field++;
+    j_arr[field].field = "D4";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->data[4];
+    field++;
+    j_arr[field].field = "D5";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->data[5];
+    field++;
+    j_arr[field].field = "D6";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->data[6];
+    field++;
+    j_arr[field].field = "D7";
+    j_arr[field].value_type = JSON_TYPE_INT;
+    j_arr[field].int_value = hapcanData->data[7];
+    field++;
+    len = jh_formatFieldValuePairs(j_arr, field, payload, size);
+    // Text: it must fit with the terminating character
+    if((len <= 0) || (len >= (int)size))
+    {
+        len = 0;
+    }
+    return len;
+}
+
+/* Hex string raw frame (socket format) - returns the payload length */
+static int setRawHex(hapcanCANData* hapcanData, char* payload, 
+        unsigned int size)
+{
+    static const char c_hex[] = "0123456789ABCDEF";
+    uint8_t data[HAPCAN_SOCKET_DATA_LEN];
+    int i;
+    if(size < 2*HAPCAN_SOCKET_DATA_LEN)
+    {
+        return 0;
+    }
+    hs_getSocketArrayFromHAPCAN(hapcanData, data);
+    for(i = 0; i < HAPCAN_SOCKET_DATA_LEN; i++)
+    {
+        payload[2*i] = c_hex[data[i] >> 4];
+        payload[2*i + 1] = c_hex[data[i] & 0x0F];
+    }
+    return 2*HAPCAN_SOCKET_DATA_LEN;
+}
+
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
@@ -221,146 +434,115 @@ int hm_setRawResponseFromMQTT(char* topic, void* payload, int payloadlen,
 }
 
 /**
- * Define a MQTT Raw response to a HAPCAN message received on CAN Socket
+ * Check if a HAPCAN message received on CAN Socket is published as raw frame
  **/
-int hm_setRawResponseFromCAN(hapcanCANData* hapcanData, char** topic, 
-        void** payload, int *payloadlen)
-{        
-    bool valid;
-    bool enable;
-    int nPubModules;
+bool hm_isRawPublished(hapcanCANData* hapcanData)
+{
+    return checkRawPubModule(hapcanData);
+}
+
+/**
+ * Check if a MQTT topic is one of the raw sub topics
+ **/
+bool hm_isRawSubTopic(char* topic)
+{
+    return (checkRawSubTopic(topic) == HAPCAN_CAN_RESPONSE);
+}
+
+/**
+ * Get the text command of an on / off channel payload
+ **/
+int hm_getOnOffCommand(char *str, const char* const *commands, 
+        int n_commands)
+{
     int i;
-    rawModuleID_t id;
-    unsigned int size;
-    int check;
-    int ret;
-    int field;
-    char *str = NULL;
-    jsonFieldData j_arr[12];
-    // Init returns
-    *topic = NULL;
-    *payload = NULL;
-    *payloadlen = 0; 
-    //-------------------------------------------
-    // Initial configuration check
-    //-------------------------------------------
-    valid = true;
-    check = hconfig_getConfigBool(HAPCAN_CONFIG_PUB_ALL, &enable);
-    if(check == EXIT_FAILURE)
-    {
-       enable = false;
-    }
-    check = hconfig_getConfigInt(HAPCAN_CONFIG_N_PUB_MODULES, &nPubModules);
-    if(check != EXIT_SUCCESS)
+    long val;
+    for(i = 0; i < n_commands; i++)
     {
-        nPubModules = 0;
+        if( aux_compareStrings(str, (char *)commands[i]) )
+        {
+            return i;
+        }
     }
-    if(!enable)
+    if(aux_parseValidateLong(str, &val, 0, 0, 255))
     {
-        for(i = 0; i < nPubModules; i++)
+        // 0x00 or 0 are set to OFF, 0xFF or 255 are set to ON
+        if(val == 0)
         {
-            // Read configured ID
-            check = hconfig_getConfigID(HAPCAN_CONFIG_PUB_MODULES, i, &id);
-            if(check != EXIT_SUCCESS)
-            {
-                valid = false;
-                break;
-            }
-            // Check configured ID
-            enable = true;
-            enable = enable && (id.group == hapcanData->group);
-            enable = enable && (id.node == hapcanData->module);
-            if(enable)
-            {
-                // Match found
-                break;
-            }
+            return HAPCAN_ONOFF_COMMAND_OFF;
+        }
+        else if(val == 255)
+        {
+            return HAPCAN_ONOFF_COMMAND_ON;
         }
     }
-    valid = valid && enable;
-    // Application messagens only (Frame Type > 0x200)
-    valid = valid && hapcanData->frametype > HAPCAN_START_NORMAL_MESSAGES;
+    return -1;
+}
+
+/**
+ * Define a MQTT Raw response to a HAPCAN message received on CAN Socket
+ **/
+int hm_setRawResponseFromCAN(hapcanCANData* hapcanData, const char** topic, 
+        char* payload, unsigned int size, int *payloadlen)
+{        
+    int len;
+    int check;
+    int ret;
+    int encoding;
+    const char *str;
+    // Init returns
+    *topic = NULL;
+    *payloadlen = 0; 
     //-------------------------------------------    
     // Set MQTT message if it is OK to respond
     //-------------------------------------------
-    if(valid)
+    if(checkRawPubModule(hapcanData))
     {
-        // GET TOPIC
-        check = hconfig_getConfigStr(HAPCAN_CONFIG_RAW_PUB, &str);      
-        if(check != EXIT_SUCCESS)
-        {            
-            ret = HAPCAN_RESPONSE_ERROR;
-        }
-        else if(str == NULL)
+        // GET TOPIC - interned when the configuration is read
+        str = hconfig_getRawPubTopic();
+        if(str == NULL)
         {
             ret = HAPCAN_NO_RESPONSE;
         }
         else
         {
-            // GET TOPIC
-            size = strlen(str);
-            *topic = malloc(size + 1);
-            strcpy(*topic, str);
-            free(str);
+            *topic = str;
             // SET PAYLOAD
-            field = 0;
-            j_arr[field].field = "Frame";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->frametype;
-            field++;
-            j_arr[field].field = "Flags";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->flags;
-            field++;
-            j_arr[field].field = "Module";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->module;
-            field++;
-            j_arr[field].field = "Group";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->group;
-            field++;
-            j_arr[field].field = "D0";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->data[0];
-            field++;
-            j_arr[field].field = "D1";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->data[1];
-            field++;
-            j_arr[field].field = "D2";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->data[2];
-            field++;
-            j_arr[field].field = "D3";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->data[3];
-            field++;
-            j_arr[field].field = "D4";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->data[4];
-            field++;
-            j_arr[field].field = "D5";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->data[5];
-            field++;
-            j_arr[field].field = "D6";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->data[6];
-            field++;
-            j_arr[field].field = "D7";
-            j_arr[field].value_type = JSON_TYPE_INT;
-            j_arr[field].int_value = hapcanData->data[7];
-            field++;
-            jh_getStringFromFieldValuePairs(j_arr, field, &str);            
-            size = strlen(str);
-            *payload = malloc(size + 1);
-            strcpy(*payload, str);
-            ret = HAPCAN_MQTT_RESPONSE;
-            // SET PAYLOAD LEN
-            *payloadlen = size; 
-            // free
-            free(str);
+            check = hconfig_getConfigInt(HAPCAN_CONFIG_RAW_ENCODING, 
+                    &encoding);
+            if(check != EXIT_SUCCESS)
+            {
+                encoding = HAPCAN_RAW_ENCODING_JSON;
+            }
+            switch(encoding)
+            {
+                case HAPCAN_RAW_ENCODING_HEX:
+                    len = setRawHex(hapcanData, payload, size);
+                    break;
+                case HAPCAN_RAW_ENCODING_BINARY:
+                    len = 0;
+                    if(size >= HAPCAN_SOCKET_DATA_LEN)
+                    {
+                        hs_getSocketArrayFromHAPCAN(hapcanData, 
+                                (uint8_t*)payload);
+                        len = HAPCAN_SOCKET_DATA_LEN;
+                    }
+                    break;
+                default:
+                    len = setRawJSON(hapcanData, payload, size);
+                    break;
+            }
+            if((len > 0) && (len <= (int)size))
+            {
+                ret = HAPCAN_MQTT_RESPONSE;
+                // SET PAYLOAD LEN
+                *payloadlen = len; 
+            }
+            else
+            {
+                *topic = NULL;
+                ret = HAPCAN_RESPONSE_ERROR;
+            }
         }               
     }
     else
@@ -6,6 +6,18 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Raw CAN2MQTT payload is written to a caller provided buffer              //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add hm_isRawPublished and hm_isRawSubTopic                               //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - hm_setRawResponseFromCAN sets the interned raw topic (not freed)         //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Add hm_getOnOffCommand                                                   //
+//----------------------------------------------------------------------------//
 
 #ifndef HAPCANMQTT_H
 #define HAPCANMQTT_H
@@ -17,6 +29,9 @@ extern "C" {
 //----------------------------------------------------------------------------//
 // EXTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
+// Text commands of an on / off channel (hm_getOnOffCommand)
+#define HAPCAN_ONOFF_COMMAND_OFF    0
+#define HAPCAN_ONOFF_COMMAND_ON     1
     
 //----------------------------------------------------------------------------//
 // EXTERNAL TYPES
@@ -40,8 +55,10 @@ int hm_setRawResponseFromMQTT(char* topic, void* payload, int payloadlen,
  * Define a MQTT Generic response to a HAPCAN message received on CAN Socket
  * 
  * \param   hapcanData      HAPCAN Data revceived (INPUT)
- * \param   topic           MQTT Topic (OUTPUT)
- * \param   payload         MQTT payload (OUTPUT) 
+ * \param   topic           MQTT Topic (OUTPUT) - interned rawHapcanPubTopic
+ *                          (see hconfig_getRawPubTopic, not freed)
+ * \param   payload         MQTT payload buffer to be filled (OUTPUT) 
+ * \param   size            size of the payload buffer (INPUT)
  * \param   payloadlen      MQTT payload length (OUTPUT)
  *  
  * \return  HAPCAN_NO_RESPONSE          No response needed
@@ -49,7 +66,42 @@ int hm_setRawResponseFromMQTT(char* topic, void* payload, int payloadlen,
  *          HAPCAN_RESPONSE_ERROR       No defined answer found - error
  **/
 int hm_setRawResponseFromCAN(hapcanCANData* hapcanData, 
-        char** topic, void** payload, int *payloadlen);
+        const char** topic, char* payload, unsigned int size, int *payloadlen);
+
+/**
+ * Check if a HAPCAN message received on CAN Socket is published as raw frame
+ * (rawHapcanPubAll / rawHapcanPubModules, application frames only)
+ * 
+ * \param   hapcanData      HAPCAN Data revceived (INPUT)
+ *  
+ * \return  true: frame is published
+ **/
+bool hm_isRawPublished(hapcanCANData* hapcanData);
+
+/**
+ * Check if a MQTT topic is one of the raw sub topics (rawHapcanSubTopics)
+ * 
+ * \param   topic           MQTT Topic (INPUT)
+ *  
+ * \return  true: topic matches
+ **/
+bool hm_isRawSubTopic(char* topic);
+
+/**
+ * Get the text command of an on / off channel payload (relays, buttons)
+ * 
+ * \param   str             payload string (INPUT)
+ * \param   commands        text commands, HAPCAN_ONOFF_COMMAND_OFF and 
+ *                          HAPCAN_ONOFF_COMMAND_ON first (INPUT)
+ * \param   n_commands      number of text commands (INPUT)
+ *  
+ * \return  index of the text command matched
+ *          HAPCAN_ONOFF_COMMAND_OFF: "0" or "0x00"
+ *          HAPCAN_ONOFF_COMMAND_ON: "255" or "0xFF"
+ *          -1: not a text command
+ **/
+int hm_getOnOffCommand(char *str, const char* const *commands, 
+        int n_commands);
 
 #ifdef __cplusplus
 }
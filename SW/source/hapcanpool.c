@@ -0,0 +1,251 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - A worker that is not created frees its queue and locks                   //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
+
+/*
+* Includes
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "config.h"
+#include "debug.h"
+#include "hapcan.h"
+#include "hapcanpool.h"
+#include "latency.h"
+#include "threadprof.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+#define HPOOL_THREAD_NAME       "can2mqttWorker"
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Frame waiting in the queue of a worker
+typedef struct
+{
+    hapcanCANData frame;
+    unsigned long long timestamp;
+    latencyStamp_t latency;
+} hpoolEntry_t;
+
+// Worker: circular queue (one producer per CAN channel, one consumer)
+typedef struct
+{
+    hpoolEntry_t *entry;
+    unsigned int head;      // Next entry to be read
+    unsigned int count;
+    pthread_mutex_t mutex;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    pthread_t thread;
+} hpoolWorker_t;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+static hpoolWorker_t g_workers[HPOOL_MAX_WORKERS];
+static int g_nWorkers = 0;
+static unsigned int g_queueSize = HPOOL_DEFAULT_QUEUE_SIZE;
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static int getWorker(const hapcanCANData *hapcanData);
+static int initWorker(hpoolWorker_t *worker);
+static void freeWorker(hpoolWorker_t *worker);
+static void* handleWorker(void *arg);
+
+// Worker of a module (node and group of the frame)
+static int getWorker(const hapcanCANData *hapcanData)
+{
+    uint32_t key;
+    key = ((uint32_t)hapcanData->module << 8) | hapcanData->group;
+    // Multiplicative hash: consecutive nodes / groups go to different workers
+    key = key * 2654435761U;
+    return (int)((key >> 16) % (uint32_t)g_nWorkers);
+}
+
+// Queue and locks of a worker
+static int initWorker(hpoolWorker_t *worker)
+{
+    worker->entry = malloc(g_queueSize * sizeof(hpoolEntry_t));
+    if(worker->entry == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+    worker->head = 0;
+    worker->count = 0;
+    pthread_mutex_init(&worker->mutex, NULL);
+    pthread_cond_init(&worker->notEmpty, NULL);
+    pthread_cond_init(&worker->notFull, NULL);
+    return EXIT_SUCCESS;
+}
+
+// Queue and locks of a worker that was not created
+static void freeWorker(hpoolWorker_t *worker)
+{
+    pthread_cond_destroy(&worker->notFull);
+    pthread_cond_destroy(&worker->notEmpty);
+    pthread_mutex_destroy(&worker->mutex);
+    free(worker->entry);
+    worker->entry = NULL;
+}
+
+/* THREAD - Handle the frames of a worker (arg: worker) */
+static void* handleWorker(void *arg)
+{
+    hpoolWorker_t *worker = (hpoolWorker_t*)arg;
+    hpoolEntry_t entry;
+    while(1)
+    {
+        // LOCK WORKER
+        pthread_mutex_lock(&worker->mutex);
+        while(worker->count == 0)
+        {
+            pthread_cond_wait(&worker->notEmpty, &worker->mutex);
+        }
+        entry = worker->entry[worker->head];
+        worker->head = (worker->head + 1) % g_queueSize;
+        worker->count--;
+        pthread_cond_signal(&worker->notFull);
+        // UNLOCK WORKER
+        pthread_mutex_unlock(&worker->mutex);
+        //-------------------------------------------------
+        // Process CAN Message and send MQTT response
+        //-------------------------------------------------
+        latency_takeOver(&entry.latency);
+        // Error is handled within the function
+        hapcan_handleCAN2MQTT(&entry.frame, entry.timestamp);
+        latency_handled();
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+void hpool_init(void)
+{
+    int i;
+    int check;
+    int value;
+    int workers;
+    //--------------------------------------
+    // Number of workers
+    //--------------------------------------
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "can2mqttWorkers", 0, NULL, &value);
+    if((check != EXIT_SUCCESS) || (value <= 0))
+    {
+        return;
+    }
+    if(value > HPOOL_MAX_WORKERS)
+    {
+        #ifdef DEBUG_HAPCAN_ERRORS
+        debug_error("hpool_init: can2mqttWorkers %d - using %d\n", value,
+                HPOOL_MAX_WORKERS);
+        #endif
+        value = HPOOL_MAX_WORKERS;
+    }
+    workers = value;
+    //--------------------------------------
+    // Queue size
+    //--------------------------------------
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "can2mqttWorkerQueueSize", 0, NULL, &value);
+    if((check == EXIT_SUCCESS) && (value > 0) &&
+            (value <= HPOOL_MAX_QUEUE_SIZE))
+    {
+        g_queueSize = (unsigned int)value;
+    }
+    //--------------------------------------
+    // Workers (frames are dispatched to the workers created)
+    //--------------------------------------
+    for(i = 0; i < workers; i++)
+    {
+        if(initWorker(&g_workers[i]) != EXIT_SUCCESS)
+        {
+            break;
+        }
+        check = tprof_create(&g_workers[i].thread, HPOOL_THREAD_NAME,
+                TPROF_NO_CHANNEL, handleWorker, &g_workers[i]);
+        if(check)
+        {
+            freeWorker(&g_workers[i]);
+            break;
+        }
+    }
+    if(i < workers)
+    {
+        #ifdef DEBUG_HAPCAN_ERRORS
+        debug_error("hpool_init: Worker %d not created - %d workers\n", i, i);
+        #endif
+    }
+    g_nWorkers = i;
+}
+
+/* Check if the CAN->MQTT frames are handled by the workers */
+bool hpool_isEnabled(void)
+{
+    return (g_nWorkers > 0);
+}
+
+int hpool_dispatch(const hapcanCANData *hapcanData,
+        unsigned long long timestamp)
+{
+    hpoolWorker_t *worker;
+    unsigned int tail;
+    if(g_nWorkers == 0)
+    {
+        return EXIT_FAILURE;
+    }
+    worker = &g_workers[getWorker(hapcanData)];
+    // LOCK WORKER
+    pthread_mutex_lock(&worker->mutex);
+    while(worker->count == g_queueSize)
+    {
+        pthread_cond_wait(&worker->notFull, &worker->mutex);
+    }
+    tail = (worker->head + worker->count) % g_queueSize;
+    worker->entry[tail].frame = *hapcanData;
+    worker->entry[tail].timestamp = timestamp;
+    latency_handOver(&worker->entry[tail].latency);
+    worker->count++;
+    pthread_cond_signal(&worker->notEmpty);
+    // UNLOCK WORKER
+    pthread_mutex_unlock(&worker->mutex);
+    return EXIT_SUCCESS;
+}
+
+int hpool_getQueueDepth(unsigned long *depth)
+{
+    int i;
+    for(i = 0; i < g_nWorkers; i++)
+    {
+        // LOCK WORKER
+        pthread_mutex_lock(&g_workers[i].mutex);
+        depth[i] = g_workers[i].count;
+        // UNLOCK WORKER
+        pthread_mutex_unlock(&g_workers[i].mutex);
+    }
+    return g_nWorkers;
+}
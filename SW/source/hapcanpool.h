@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+
+#ifndef HAPCANPOOL_H
+#define HAPCANPOOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include "hapcan.h"
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+/* Maximum number of workers - can2mqttWorkers (0: frames handled by the CAN
+ * buffers threads) */
+#define HPOOL_MAX_WORKERS       8
+/* Default / maximum frames in the queue of each worker -
+ * can2mqttWorkerQueueSize */
+#define HPOOL_DEFAULT_QUEUE_SIZE    256
+#define HPOOL_MAX_QUEUE_SIZE        65536
+/* Queue name (metrics) */
+#define HPOOL_QUEUE_NAME        "can2mqttWorker"
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Read the configuration (can2mqttWorkers, can2mqttWorkerQueueSize - read
+ * only at start-up) and create the workers (thread "can2mqttWorker", see
+ * "ThreadProfiles"). If no worker is created, the pool is not used.
+ */
+void hpool_init(void);
+
+/**
+ * Check if the CAN->MQTT frames are handled by the workers
+ *
+ * \return  true / false
+ */
+bool hpool_isEnabled(void);
+
+/**
+ * Add a frame read from a CAN channel to the queue of its worker. The worker
+ * is chosen from the node and group of the frame: the frames of a module are
+ * handled in order, the frames of different modules in parallel. Waits while
+ * the queue is full (frames are not dropped). The frame being handled by this
+ * thread (see latency_dequeued) is handed over to the worker.
+ *
+ * \param   hapcanData  (INPUT) frame
+ * \param   timestamp   (INPUT) time the frame was received
+ *
+ * \return  EXIT_SUCCESS    added to the queue
+ *          EXIT_FAILURE    pool not used - the frame has to be handled by the
+ *                          caller (hapcan_handleCAN2MQTT)
+ */
+int hpool_dispatch(const hapcanCANData *hapcanData,
+        unsigned long long timestamp);
+
+/**
+ * Get the number of workers and the frames waiting in the queue of each one
+ *
+ * \param   depth       (OUTPUT) frames of each worker (HPOOL_MAX_WORKERS)
+ *
+ * \return  number of workers
+ */
+int hpool_getQueueDepth(unsigned long *depth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAPCANPOOL_H */
@@ -6,6 +6,33 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - CAN2MQTT payloads use constant strings (no allocation per frame)         //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - MQTT2CAN JSON commands are parsed with jh_parseFlatObject (no            //
+// allocation, no JSON lock)                                                  //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Register the module handlers with the gateway elements (called directly  //
+// on a match)                                                                //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Command frames are precomputed per channel when the gateway is built and //
+// registered as the gateway element context (text commands are a table       //
+// lookup)                                                                    //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_HAPCAN          //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Text commands are read with hm_getOnOffCommand (shared with buttons)    //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
 
 /*
 * Includes
@@ -23,6 +50,7 @@
 #include "gateway.h"
 #include "hapcan.h"
 #include "hapcanconfig.h"
+#include "hapcanmqtt.h"
 #include "hapcanrelay.h"
 #include "jsonhandler.h"
 #include "mqtt.h"
@@ -31,24 +59,59 @@
 //----------------------------------------------------------------------------//
 // INTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
+// Text commands accepted on the command topic
+enum
+{
+    RELAY_COMMAND_OFF = HAPCAN_ONOFF_COMMAND_OFF,
+    RELAY_COMMAND_ON = HAPCAN_ONOFF_COMMAND_ON,
+    RELAY_COMMAND_TOGGLE,
+    RELAY_N_COMMANDS
+};
 
 //----------------------------------------------------------------------------//
 // INTERNAL TYPES
 //----------------------------------------------------------------------------//
+// Per-channel MQTT2CAN template (gateway element context): complete HAPCAN 
+// Frame for each text command
+typedef struct
+{
+    hapcanCANData hd_command[RELAY_N_COMMANDS];
+} relayTemplate;
 
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
+// Handlers called by the gateway for the elements added by this module
+static const gatewayHandler g_hrelay_handler = 
+{
+    hrelay_setCAN2MQTTResponse,
+    hrelay_setMQTT2CANResponse
+};
+// Text commands strings (same order as the text commands enum)
+static const char* const g_relay_commands[RELAY_N_COMMANDS] = 
+{
+    "OFF",
+    "ON",
+    "TOGGLE"
+};
+// INSTR1 for each text command (same order as the text commands enum)
+static const uint8_t g_relay_instr1[RELAY_N_COMMANDS] = 
+{
+    0x00,   // Turn OFF
+    0x01,   // Turn ON
+    0x02    // Toggle
+};
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
 static void addRelayChannelToGateway(int node, int group, int channel, 
         char *state_str, char *command_str);
-static int getRelayPayload(hapcanCANData *hd_received, void** payload, 
+static void setRelayTemplate(hapcanCANData *hd_result, relayTemplate *tmpl);
+static int getRelayPayload(hapcanCANData *hd_received, const char** payload, 
         int *payloadlen);
 static int getRelayHAPCANFrame(void *payload, int payloadlen, 
-        hapcanCANData *hd_result);
+        const relayTemplate *tmpl, hapcanCANData *hd_result);
 
 /*
  * Add a single relay to the HAPCAN <--> MQTT gateway based on the data read 
@@ -71,6 +134,7 @@ static void addRelayChannelToGateway(int node, int group, int channel,
     hapcanCANData hd_mask;
     hapcanCANData hd_check;
     hapcanCANData hd_result;
+    relayTemplate tmpl;
     // Clear data
     aux_clearHAPCANFrame(&hd_mask);
     aux_clearHAPCANFrame(&hd_check);
@@ -85,7 +149,7 @@ static void addRelayChannelToGateway(int node, int group, int channel,
     if(!valid)
     {
         #ifdef DEBUG_HAPCAN_RELAY_ERRORS
-        debug_print("addRelayChannelToGateway: parameter error!\n");
+        debug_error("addRelayChannelToGateway: parameter error!\n");
         #endif
     }
     else
@@ -124,11 +188,12 @@ static void addRelayChannelToGateway(int node, int group, int channel,
             hd_check.data[2] = channel;
             // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
             check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, &hd_mask, 
-                &hd_check, state_str, NULL, &hd_result);
+                &hd_check, state_str, NULL, &hd_result, 
+                &g_hrelay_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_RELAY_ERRORS
-                debug_print("addRelayChannelToGateway: Error "
+                debug_error("addRelayChannelToGateway: Error "
                         "adding to CAN2MQTT!\n");
                 #endif
             }
@@ -155,13 +220,16 @@ static void addRelayChannelToGateway(int node, int group, int channel,
             hd_result.data[1] = (1 << (channel - 1));
             hd_result.data[2] = node;
             hd_result.data[3] = group;
-            // Add to list CAN2MQTT: command_str, hd_result
+            // Precompute the frames for the text commands
+            setRelayTemplate(&hd_result, &tmpl);
+            // Add to list CAN2MQTT: command_str, hd_result, template
             check = gateway_AddElementToList(GATEWAY_MQTT2CAN_LIST, &hd_mask, 
-                &hd_check, NULL, command_str, &hd_result);
+                &hd_check, NULL, command_str, &hd_result, 
+                &g_hrelay_handler, &tmpl, sizeof(tmpl));
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_RELAY_ERRORS
-                debug_print("addRelayChannelToGateway: Error adding "
+                debug_error("addRelayChannelToGateway: Error adding "
                         "to MQTT2CAN!\n");
                 #endif
             }
@@ -169,35 +237,53 @@ static void addRelayChannelToGateway(int node, int group, int channel,
     }
 }
 
+/**
+ * Fill the template with the HAPCAN Frame of each text command
+ * 
+ * \param   hd_result       (INPUT) HAPCAN Frame with node, group, channel and 
+ *                              computer ID set
+ * \param   tmpl            (OUTPUT) template to be filled
+ *  
+ */
+static void setRelayTemplate(hapcanCANData *hd_result, relayTemplate *tmpl)
+{
+    int i;
+    for(i = 0; i < RELAY_N_COMMANDS; i++)
+    {
+        tmpl->hd_command[i] = *hd_result;
+        tmpl->hd_command[i].frametype = HAPCAN_DIRECT_CONTROL_FRAME_TYPE;
+        tmpl->hd_command[i].data[0] = g_relay_instr1[i]; // INSTR1
+        tmpl->hd_command[i].data[4] = 0x00; // INSTR3 = Timer. 0 = immediately
+        tmpl->hd_command[i].data[5] = 0xFF; // INSTR4 = 0xXX
+        tmpl->hd_command[i].data[6] = 0xFF; // INSTR5 = 0xXX
+        tmpl->hd_command[i].data[7] = 0xFF; // INSTR6 = 0xXX
+    }
+}
+
 /**
  * Set a payload based on the data received
  * 
  * \param   hd_received     (INPUT) pointer to HAPCAN message received
- * \param   payload         (OUTPUT) payload to be filled
+ * \param   payload         (OUTPUT) payload to be set (constant string)
  * \param   payloadlen      (OUTPUT) payloadlen to be filled
  *                      
  * \return  HAPCAN_MQTT_RESPONSE: Payload set (OK)
  *          HAPCAN_RESPONSE_ERROR: Error - Payload not set
  *          
  */
-static int getRelayPayload(hapcanCANData *hd_received, void** payload, 
+static int getRelayPayload(hapcanCANData *hd_received, const char** payload, 
         int *payloadlen)
 {
     int ret = HAPCAN_MQTT_RESPONSE;
-    unsigned int len;
     if(hd_received->data[3] == 0x00)
     {
-        len = strlen("OFF");
-        *payload = malloc(len + 1);
-        strcpy(*payload, "OFF");
-        *payloadlen = len;
+        *payload = HAPCAN_PAYLOAD_OFF;
+        *payloadlen = HAPCAN_PAYLOAD_OFF_LEN;
     }
     else if(hd_received->data[3] == 0xFF)
     {
-        len = strlen("ON");
-        *payload = malloc(len + 1);
-        strcpy(*payload, "ON");
-        *payloadlen = len;
+        *payload = HAPCAN_PAYLOAD_ON;
+        *payloadlen = HAPCAN_PAYLOAD_ON_LEN;
     }
     else
     {
@@ -216,6 +302,7 @@ static int getRelayPayload(hapcanCANData *hd_received, void** payload,
  * 
  * \param   payload         (INPUT) payload to be filled
  * \param   payloadlen      (INPUT) payloadlen to be filled
+ * \param   tmpl            (INPUT) template of the matched channel
  * \param   hd_result       (INPUT / OUTPUT) pointer to HAPCAN message matched
  *                      
  * \return  HAPCAN_NO_RESPONSE: HAPCAN Frame not set
@@ -224,17 +311,17 @@ static int getRelayPayload(hapcanCANData *hd_received, void** payload,
  *       
  */
 static int getRelayHAPCANFrame(void *payload, int payloadlen, 
-        hapcanCANData *hd_result)
+        const relayTemplate *tmpl, hapcanCANData *hd_result)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
-    char *str = NULL;
+    char str[HAPCAN_MQTT_COMMAND_STR_LEN];
     bool valid = true;
-    long val;
     int temp;
-    json_object *obj = NULL;
+    int command;
+    jsonFlatObject obj;
     // Check NULL or size 0
-    if((payload == NULL) || (payloadlen <= 0))
+    if((payload == NULL) || (payloadlen <= 0) || (tmpl == NULL))
     {
         valid = false;
     }
@@ -243,9 +330,7 @@ static int getRelayHAPCANFrame(void *payload, int payloadlen,
         // set to false unless there is a payload match 
         valid = false;
         // payload does not end with 0 for a string - copy it here
-        str = malloc(payloadlen + 1);
-        memcpy(str, payload, payloadlen);
-        str[payloadlen] = 0;
+        aux_getPayloadString(payload, payloadlen, str, sizeof(str));
         //----------------------------------------------------------------------
         // COMMAND TOPIC ACCEPTED PAYLOADS:
         // 1. command strings: "ON", "OFF", "TOGGLE"
@@ -253,66 +338,24 @@ static int getRelayHAPCANFrame(void *payload, int payloadlen,
         // 3. JSON: {"INSTR1":Integer, "INSTR3":Integer, "INSTR4":Integer, 
         //          "INSTR5":Integer, "INSTR6":Integer}
         //----------------------------------------------------------------------
-        if( aux_compareStrings(str, "ON") )
-        {
-            hd_result->data[0] = 0x01; // INSTR1. 0x01 = Turn ON
-            hd_result->data[4] = 0x00; // INSTR3 = Timer. 0 = set immediately.
-            hd_result->data[5] = 0xFF; // INSTR4 = 0xXX
-            hd_result->data[6] = 0xFF; // INSTR5 = 0xXX   
-            hd_result->data[7] = 0xFF; // INSTR6 = 0xXX
-            valid = true;
-        }
-        else if( aux_compareStrings(str, "OFF") )
+        command = hm_getOnOffCommand(str, g_relay_commands, 
+                RELAY_N_COMMANDS);
+        if(command >= 0)
         {
-            hd_result->data[0] = 0x00; // INSTR1. 0x00 = Turn OFF
-            hd_result->data[4] = 0x00; // INSTR3 = Timer. 0 = set immediately.
-            hd_result->data[5] = 0xFF; // INSTR4 = 0xXX
-            hd_result->data[6] = 0xFF; // INSTR5 = 0xXX   
-            hd_result->data[7] = 0xFF; // INSTR6 = 0xXX
+            // Text command - precomputed frame
+            *hd_result = tmpl->hd_command[command];
             valid = true;
         }
-        else if( aux_compareStrings(str, "TOGGLE") )
-        {
-            hd_result->data[0] = 0x02; // INSTR1. 0x02 = Toggle
-            hd_result->data[4] = 0x00; // INSTR3 = Timer. 0 = set immediately.
-            hd_result->data[5] = 0xFF; // INSTR4 = 0xXX
-            hd_result->data[6] = 0xFF; // INSTR5 = 0xXX   
-            hd_result->data[7] = 0xFF; // INSTR6 = 0xXX
-            valid = true;
-        }
-        else if(aux_parseValidateLong(str, &val, 0, 0, 255))
-        {
-            // 0x00 or 0 are set to OFF
-            if(val == 0)
-            {
-                hd_result->data[0] = 0x00; // INSTR1. 0x00 = Turn OFF
-                hd_result->data[4] = 0x00; // INSTR3 = Timer.
-                hd_result->data[5] = 0xFF; // INSTR4 = 0xXX
-                hd_result->data[6] = 0xFF; // INSTR5 = 0xXX   
-                hd_result->data[7] = 0xFF; // INSTR6 = 0xXX
-                valid = true;
-            }
-            // 0xFF or 255 are set to ON
-            else if(val == 255)
-            {
-                hd_result->data[0] = 0x01; // INSTR1. 0x01 = Turn ON
-                hd_result->data[4] = 0x00; // INSTR3 = Timer.
-                hd_result->data[5] = 0xFF; // INSTR4 = 0xXX
-                hd_result->data[6] = 0xFF; // INSTR5 = 0xXX   
-                hd_result->data[7] = 0xFF; // INSTR6 = 0xXX
-                valid = true;
-            }
-        }
         else
         {
             // Check for JSON - Get the JSON Object
-            jh_getObject(str, &obj);
+            check = jh_parseFlatObject(payload, payloadlen, &obj);
             // Check if error parsing
-            if(obj != NULL)
+            if(check == JSON_OK)
             {
                 valid = true;
                 // INSTR1
-                check = jh_getObjectFieldAsInt(obj, "INSTR1", &temp);
+                check = jh_getFlatFieldAsInt(&obj, "INSTR1", &temp);
                 valid = valid && (check == JSON_OK) && 
                         (temp >= 0) && (temp <= 255);
                 if( valid )
@@ -320,7 +363,7 @@ static int getRelayHAPCANFrame(void *payload, int payloadlen,
                     hd_result->data[0] = (uint8_t)temp;
                 }
                 // INSTR3
-                check = jh_getObjectFieldAsInt(obj, "INSTR3", &temp);
+                check = jh_getFlatFieldAsInt(&obj, "INSTR3", &temp);
                 valid = valid && (check == JSON_OK) && 
                         (temp >= 0) && (temp <= 255);
                 if( valid )
@@ -328,7 +371,7 @@ static int getRelayHAPCANFrame(void *payload, int payloadlen,
                     hd_result->data[4] = (uint8_t)temp;
                 }
                 // INSTR4
-                check = jh_getObjectFieldAsInt(obj, "INSTR4", &temp);
+                check = jh_getFlatFieldAsInt(&obj, "INSTR4", &temp);
                 valid = valid && (check == JSON_OK) && 
                         (temp >= 0) && (temp <= 255);
                 if( valid )
@@ -336,7 +379,7 @@ static int getRelayHAPCANFrame(void *payload, int payloadlen,
                     hd_result->data[5] = (uint8_t)temp;
                 }
                 // INSTR5
-                check = jh_getObjectFieldAsInt(obj, "INSTR5", &temp);
+                check = jh_getFlatFieldAsInt(&obj, "INSTR5", &temp);
                 valid = valid && (check == JSON_OK) && 
                         (temp >= 0) && (temp <= 255);
                 if( valid )
@@ -344,7 +387,7 @@ static int getRelayHAPCANFrame(void *payload, int payloadlen,
                     hd_result->data[6] = (uint8_t)temp;
                 }
                 // INSTR6
-                check = jh_getObjectFieldAsInt(obj, "INSTR6", &temp);
+                check = jh_getFlatFieldAsInt(&obj, "INSTR6", &temp);
                 valid = valid && (check == JSON_OK) && 
                         (temp >= 0) && (temp <= 255);
                 if( valid )
@@ -364,9 +407,6 @@ static int getRelayHAPCANFrame(void *payload, int payloadlen,
         hd_result->frametype = HAPCAN_DIRECT_CONTROL_FRAME_TYPE;
         ret = HAPCAN_CAN_RESPONSE;
     }
-    // Free
-    jh_freeObject(obj);
-    free(str);
     // Leave
     return ret; 
     
@@ -420,7 +460,7 @@ void hrelay_addToGateway(void)
             #ifdef DEBUG_HAPCAN_RELAY_ERRORS
             if(!valid)
             {
-                debug_print("hrelay_addToGateway: Module Information Error!\n");
+                debug_error("hrelay_addToGateway: Module Information Error!\n");
             }
             #endif
             if(valid)
@@ -456,7 +496,7 @@ void hrelay_addToGateway(void)
                     #ifdef DEBUG_HAPCAN_RELAY_ERRORS
                     if(!valid)
                     {
-                        debug_print("hrelay_addToGateway: channel Information "
+                        debug_error("hrelay_addToGateway: channel Information "
                                 "Error!\n");
                     }
                     #endif
@@ -475,11 +515,11 @@ void hrelay_addToGateway(void)
  * Set a payload based on the data received, and add it to the MQTT Pub Buffer.       
  */
 int hrelay_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp)
+        const void *context, unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
-    void* payload = NULL;
+    const char* payload = NULL;
     int payloadlen;
     // Set the payload
     check = getRelayPayload(hd_received, &payload, &payloadlen);
@@ -487,13 +527,11 @@ int hrelay_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
     {
         if(state_str != NULL)
         {
-            // Set MQTT Pub buffer
-            ret = hapcan_addToMQTTPubBuffer(state_str, payload, payloadlen, 
-                    timestamp);
+            // Set MQTT Pub buffer (payload is copied to the buffer)
+            ret = hapcan_addToMQTTPubBuffer(state_str, (void *)payload, 
+                    payloadlen, timestamp);
         }
     }
-    // Free
-    free(payload);
     // Return
     return ret;
 }
@@ -502,13 +540,15 @@ int hrelay_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
  * Set a HAPCAN message based on the payload received, and add it to the CAN 
  * write Buffer.    
  */
-int hrelay_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload, 
-        int payloadlen, unsigned long long timestamp)
+int hrelay_setMQTT2CANResponse(hapcanCANData *hd_result, 
+        const void *context, void *payload, int payloadlen, 
+        unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
-    // Set the payload
-    check = getRelayHAPCANFrame(payload, payloadlen, hd_result);
+    // Set the frame - context is the template of the matched channel
+    check = getRelayHAPCANFrame(payload, payloadlen, 
+            (const relayTemplate *)context, hd_result);
     if(check == HAPCAN_CAN_RESPONSE)
     {
         ret = hapcan_addToCANWriteBuffer(hd_result, timestamp, true);
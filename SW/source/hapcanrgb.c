@@ -12,6 +12,36 @@
 //  1.10     | 27/Jun/2023 |                               | ALCP             //
 // - New module version - baseed on new RGB module                           //
 //----------------------------------------------------------------------------//
+//  1.11     | 18/Oct/2026 |                               | ALCP             //
+// - CAN2MQTT payload is written to a fixed size buffer                       //
+//----------------------------------------------------------------------------//
+//  1.12     | 18/Oct/2026 |                               | ALCP             //
+// - MQTT2CAN JSON commands are parsed with jh_parseFlatObject (no            //
+// allocation, no JSON lock)                                                  //
+//----------------------------------------------------------------------------//
+//  1.13     | 18/Oct/2026 |                               | ALCP             //
+// - Register the module handlers with the gateway elements (called directly  //
+// on a match)                                                                //
+//----------------------------------------------------------------------------//
+//  1.14     | 18/Oct/2026 |                               | ALCP             //
+// - State topics of the list are interned (topic.c): shared with the         //
+// gateway and compared by pointer                                            //
+//----------------------------------------------------------------------------//
+//  1.15     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_HAPCAN          //
+//----------------------------------------------------------------------------//
+//  1.16     | 18/Oct/2026 |                               | ALCP             //
+// - On a configuration reload, modules that did not change keep their        //
+// outputs and update flags (only new / removed modules are changed)          //
+//----------------------------------------------------------------------------//
+//  1.17     | 18/Oct/2026 |                               | ALCP             //
+// - Add hrgb_walkModules / hrgb_setModules (configuration cache)             //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
 
 /*
 * Includes
@@ -34,6 +64,7 @@
 #include "jsonhandler.h"
 #include "mqtt.h"
 #include "mqttbuf.h"
+#include "topic.h"
 
 //----------------------------------------------------------------------------//
 // INTERNAL DEFINITIONS
@@ -71,16 +102,17 @@ typedef struct rgbList_t
     //------------------------
     bool isColourUpdated[RGB_N_COLOURS];
     bool ignore;
+    bool stale;     // Not configured again since the reload started
     //------------------------
     // RGB State Topic
     //------------------------
-    char *rgb_state_str;
+    const char *rgb_state_str;   // interned
     //------------------------
     // Independent Channels State Topics
     //------------------------
-    char *channel1_state_str;
-    char *channel2_state_str;
-    char *channel3_state_str;
+    const char *channel1_state_str;   // interned
+    const char *channel2_state_str;   // interned
+    const char *channel3_state_str;   // interned
     //------------------------
     // Linked List Control
     //------------------------
@@ -90,6 +122,12 @@ typedef struct rgbList_t
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
+// Handlers called by the gateway for the elements added by this module
+static const gatewayHandler g_hrgb_handler = 
+{
+    hrgb_setCAN2MQTTResponse,
+    hrgb_setMQTT2CANResponse
+};
 static pthread_mutex_t g_rgb_mutex = PTHREAD_MUTEX_INITIALIZER;
 static rgbList_t* g_hrgb_head = NULL;
 static int g_lastSentNode;
@@ -104,7 +142,9 @@ static void rgbl_clearElementData(rgbList_t* element);
 static void rgbl_freeElementData(rgbList_t* element);
 static void rgbl_addToList(rgbList_t* element);
 static rgbList_t* rgbl_getFromOffset(int offset);    // NULL means error
-static void rgbl_deleteList(void);
+static void rgbl_setStale(void);
+static void rgbl_deleteStale(void);
+static rgbList_t* rgbl_getStale(int node, int group, bool isRGB);
 static void rgbl_addElementToList(int node, int group, bool isRGB, 
         char *rgb_state_str, char *channel1_state_str, 
         char *channel2_state_str, char *channel3_state_str);
@@ -112,7 +152,7 @@ static void rgbl_addElementToList(int node, int group, bool isRGB,
 static void rgb_addrgbChannelToGateway(int node, int group, bool isRGB,
         int channel, char *state_str, char *command_str);
 static int rgb_getrgbPayload(char *state_str, hapcanCANData *hd_received, 
-        void** payload, int *payloadlen);
+        int channel, char* payload, unsigned int size, int *payloadlen);
 static int rgb_checkAndSendCAN(void);
 
 //------------------------------------------------------------------------------
@@ -133,10 +173,10 @@ static void rgbl_clearElementData(rgbList_t* element)
 static void rgbl_freeElementData(rgbList_t* element)
 {
     // Free pointers
-    free(element->rgb_state_str);    
-    free(element->channel1_state_str);    
-    free(element->channel2_state_str);    
-    free(element->channel3_state_str);    
+    topic_release(element->rgb_state_str);    
+    topic_release(element->channel1_state_str);    
+    topic_release(element->channel2_state_str);    
+    topic_release(element->channel3_state_str);    
     element->rgb_state_str = NULL;
     element->channel1_state_str = NULL;
     element->channel2_state_str = NULL;
@@ -148,7 +188,6 @@ static void rgbl_addToList(rgbList_t* element)
 {
     rgbList_t *link;
     int i;
-    unsigned int len;
     // Create a new element to the list
     link = (rgbList_t*)malloc(sizeof(*link));	
     // Copy structure data
@@ -156,58 +195,23 @@ static void rgbl_addToList(rgbList_t* element)
     link->group = element->group;
     link->isRGB = element->isRGB;
     link->ignore = element->ignore;
+    link->stale = false;
     for(i = 0; i < RGB_N_COLOURS; i++)
     {
         link->colour[i] = element->colour[i];
         link->isColourUpdated[i] = element->isColourUpdated[i];
     }
     //---------------------
-    // Copy strings
+    // Strings (interned topics) are handed over to the list
     //---------------------
     // RGB State
-    if(element->rgb_state_str != NULL)
-    {
-        len = strlen(element->rgb_state_str);
-        link->rgb_state_str = malloc(len + 1);
-        strcpy(link->rgb_state_str, element->rgb_state_str);
-    }
-    else
-    {
-        link->rgb_state_str = NULL;
-    }
+    link->rgb_state_str = element->rgb_state_str;
     // Channel 1 State
-    if(element->channel1_state_str != NULL)
-    {
-        len = strlen(element->channel1_state_str);
-        link->channel1_state_str = malloc(len + 1);
-        strcpy(link->channel1_state_str, element->channel1_state_str);
-    }
-    else
-    {
-        link->channel1_state_str = NULL;
-    }
+    link->channel1_state_str = element->channel1_state_str;
     // Channel 2 State
-    if(element->channel2_state_str != NULL)
-    {
-        len = strlen(element->channel2_state_str);
-        link->channel2_state_str = malloc(len + 1);
-        strcpy(link->channel2_state_str, element->channel2_state_str);
-    }
-    else
-    {
-        link->channel2_state_str = NULL;
-    }
+    link->channel2_state_str = element->channel2_state_str;
     // Channel 3 State
-    if(element->channel3_state_str != NULL)
-    {
-        len = strlen(element->channel3_state_str);
-        link->channel3_state_str = malloc(len + 1);
-        strcpy(link->channel3_state_str, element->channel3_state_str);
-    }
-    else
-    {
-        link->channel3_state_str = NULL;
-    }    
+    link->channel3_state_str = element->channel3_state_str;
     // Set next in list to previous g_hrgb_header (previous first node)
     link->next = g_hrgb_head;	
     // Point g_hrgb_header (first node) to current element (new first node)
@@ -238,33 +242,51 @@ static rgbList_t* rgbl_getFromOffset(int offset)
     return current;
 }
 
-// Delete list
-static void rgbl_deleteList(void)
+// Mark every element as stale (configuration reload)
+static void rgbl_setStale(void)
 {
     rgbList_t* current;
-    rgbList_t* next;
-    // Check all
-    current = g_hrgb_head;
-    while(current != NULL) 
+    for(current = g_hrgb_head; current != NULL; current = current->next) 
     {
-        //*******************************//
-        // Get next structure address    //
-        //*******************************//
-        next = current->next;
-        //*******************************//
-        // Free fields that are pointers //
-        //*******************************//
-        rgbl_freeElementData(current);
-        //*******************************//
-        // Free structure itself         //
-        //*******************************//
-        free(current);
-        //*******************************//
-        // Get new current address       //
-        //*******************************//
-        current = next;
-        g_hrgb_head = current;
-    }    
+        current->stale = true;
+    }
+}
+
+// Delete the elements that were not configured again
+static void rgbl_deleteStale(void)
+{
+    rgbList_t** link;
+    rgbList_t* current;
+    link = &g_hrgb_head;
+    while(*link != NULL) 
+    {
+        current = *link;
+        if(current->stale)
+        {
+            *link = current->next;
+            rgbl_freeElementData(current);
+            free(current);
+        }
+        else
+        {
+            link = &current->next;
+        }
+    }
+}
+
+// Get a stale element of a module (same node, group and type)
+static rgbList_t* rgbl_getStale(int node, int group, bool isRGB)
+{
+    rgbList_t* current;
+    for(current = g_hrgb_head; current != NULL; current = current->next) 
+    {
+        if(current->stale && (current->node == node) && 
+                (current->group == group) && (current->isRGB == isRGB))
+        {
+            break;
+        }
+    }
+    return current;
 }
 
 // Add elements to the List
@@ -273,8 +295,22 @@ static void rgbl_addElementToList(int node, int group, bool isRGB,
         char *channel2_state_str, char *channel3_state_str)
 {
     rgbList_t element;
+    rgbList_t* current;
     int i;
-    unsigned int len;
+    //-----------------------------
+    // Module already in the list: keep outputs and flags, update the topics
+    //-----------------------------
+    current = rgbl_getStale(node, group, isRGB);
+    if(current != NULL)
+    {
+        rgbl_freeElementData(current);
+        current->rgb_state_str = topic_intern(rgb_state_str);
+        current->channel1_state_str = topic_intern(channel1_state_str);
+        current->channel2_state_str = topic_intern(channel2_state_str);
+        current->channel3_state_str = topic_intern(channel3_state_str);
+        current->stale = false;
+        return;
+    }
     rgbl_clearElementData(&element);
     element.group = group;
     element.node = node;
@@ -286,40 +322,18 @@ static void rgbl_addElementToList(int node, int group, bool isRGB,
     }
     element.ignore = false;
     //-----------------------------
-    // Copy strings
+    // Get the interned topics
     //-----------------------------
     // RGB State
-    if(rgb_state_str != NULL)
-    {
-        len = strlen(rgb_state_str);
-        element.rgb_state_str = malloc(len + 1);
-        strcpy(element.rgb_state_str, rgb_state_str);
-    }
+    element.rgb_state_str = topic_intern(rgb_state_str);
     // Channel 1 State
-    if(channel1_state_str != NULL)
-    {
-        len = strlen(channel1_state_str);
-        element.channel1_state_str = malloc(len + 1);
-        strcpy(element.channel1_state_str, channel1_state_str);
-    }
+    element.channel1_state_str = topic_intern(channel1_state_str);
     // Channel 2 State
-    if(channel2_state_str != NULL)
-    {
-        len = strlen(channel2_state_str);
-        element.channel2_state_str = malloc(len + 1);
-        strcpy(element.channel2_state_str, channel2_state_str);
-    }
+    element.channel2_state_str = topic_intern(channel2_state_str);
     // Channel 3 State
-    if(channel3_state_str != NULL)
-    {
-        len = strlen(channel3_state_str);
-        element.channel3_state_str = malloc(len + 1);
-        strcpy(element.channel3_state_str, channel3_state_str);
-    }
+    element.channel3_state_str = topic_intern(channel3_state_str);
     // Add
     rgbl_addToList(&element);
-    // Free temp data and then return
-    rgbl_freeElementData(&element);
 }
 
 //------------------------------------------------------------------------------
@@ -368,11 +382,11 @@ static void rgb_addrgbChannelToGateway(int node, int group, bool isRGB,
     if(!valid)
     {
         #ifdef DEBUG_HAPCAN_RGB_ERRORS
-        debug_print("rgb_addrgbChannelToGateway - parameter error!\n");
-        debug_print("rgb_addrgbChannelToGateway - node:%d!\n", node);
-        debug_print("rgb_addrgbChannelToGateway - group:%d!\n", group);
-        debug_print("rgb_addrgbChannelToGateway - channel:%d!\n", channel);
-        debug_print("rgb_addrgbChannelToGateway - isrgb:%d!\n", isRGB);
+        debug_error("rgb_addrgbChannelToGateway - parameter error!\n");
+        debug_error("rgb_addrgbChannelToGateway - node:%d!\n", node);
+        debug_error("rgb_addrgbChannelToGateway - group:%d!\n", group);
+        debug_error("rgb_addrgbChannelToGateway - channel:%d!\n", channel);
+        debug_error("rgb_addrgbChannelToGateway - isrgb:%d!\n", isRGB);
         #endif
     }
     else
@@ -409,11 +423,12 @@ static void rgb_addrgbChannelToGateway(int node, int group, bool isRGB,
         hd_check.data[2] = channel;        
         // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
         check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, &hd_mask, 
-            &hd_check, state_str, NULL, &hd_result);
+            &hd_check, state_str, NULL, &hd_result, 
+            &g_hrgb_handler, &channel, sizeof(channel));
         if(check != EXIT_SUCCESS)
         {
             #ifdef DEBUG_HAPCAN_RGB_ERRORS
-            debug_print("rgb_addrgbChannelToGateway: Error "
+            debug_error("rgb_addrgbChannelToGateway: Error "
                     "adding to CAN2MQTT!\n");
             #endif
         }
@@ -442,11 +457,12 @@ static void rgb_addrgbChannelToGateway(int node, int group, bool isRGB,
             hd_result.data[3] = group;        
             // Add to list CAN2MQTT: command_str, hd_result
             check = gateway_AddElementToList(GATEWAY_MQTT2CAN_LIST, &hd_mask, 
-                &hd_check, NULL, command_str, &hd_result);
+                &hd_check, NULL, command_str, &hd_result, 
+                &g_hrgb_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_RGB_ERRORS
-                debug_print("rgb_addrgbChannelToGateway: Error adding "
+                debug_error("rgb_addrgbChannelToGateway: Error adding "
                         "to MQTT2CAN!\n");
                 #endif
             }
@@ -458,8 +474,9 @@ static void rgb_addrgbChannelToGateway(int node, int group, bool isRGB,
  * Set a payload based on the data received
  * 
  * \param   hd_received     (INPUT) pointer to HAPCAN message received
- * \param   hd_received     (INPUT) pointer to HAPCAN message received
- * \param   payload         (OUTPUT) payload to be filled
+ * \param   channel         (INPUT) channel of the matched gateway element
+ * \param   payload         (OUTPUT) payload buffer to be filled
+ * \param   size            (INPUT) size of the payload buffer
  * \param   payloadlen      (OUTPUT) payloadlen to be filled
  *                      
  * \return  HAPCAN_MQTT_RESPONSE: Payload set (OK)
@@ -468,12 +485,11 @@ static void rgb_addrgbChannelToGateway(int node, int group, bool isRGB,
  *          
  */
 static int rgb_getrgbPayload(char *state_str, hapcanCANData *hd_received, 
-        void** payload, int *payloadlen)
+        int channel, char* payload, unsigned int size, int *payloadlen)
 {
     int ret = HAPCAN_RESPONSE_ERROR;
     int node;
     int group;
-    int channel;
     bool match;
     bool isChannel1State;
     bool isChannel2State;
@@ -484,12 +500,10 @@ static int rgb_getrgbPayload(char *state_str, hapcanCANData *hd_received,
     int temp[RGB_MASTER];
     bool test;
     int len;
-    char str[20]; // 255,255,255/0
     int n_colors;
-    // Get node, group and channel from received message
+    // Get node and group from received message (channel is from the gateway)
     node = hd_received->module;
     group = hd_received->group;
-    channel = hd_received->data[2];
     if(channel < 1 || channel > RGB_N_COLOURS)
     {
         // Channel error
@@ -539,12 +553,9 @@ static int rgb_getrgbPayload(char *state_str, hapcanCANData *hd_received,
         else
         {
             // Check if state topic is for RGB status
-            isChannel1State = aux_compareStrings(element.channel1_state_str, 
-                state_str);
-            isChannel2State = aux_compareStrings(element.channel2_state_str, 
-                state_str);
-            isChannel3State = aux_compareStrings(element.channel3_state_str, 
-                state_str);
+            isChannel1State = (element.channel1_state_str == state_str);
+            isChannel2State = (element.channel2_state_str == state_str);
+            isChannel3State = (element.channel3_state_str == state_str);
             // Check if single channel
             if(!element.isRGB)
             {
@@ -583,12 +594,9 @@ static int rgb_getrgbPayload(char *state_str, hapcanCANData *hd_received,
                         temp[0] = temp[0] * (element.colour[RGB_MASTER] + 1);
                         temp[0] = temp[0] >> 8;
                     }                    
-                    // Add to temp string
-                    snprintf(str, 4, "%d", temp[0]);
-                    len = strlen(str);
-                    // Set payload and payloadlen
-                    *payload = malloc(len + 1);
-                    strcpy(*payload, str);
+                    // Set payload
+                    len = snprintf(payload, size, "%d", temp[0]);
+                    // Set payloadlen
                     *payloadlen = len;
                     ret = HAPCAN_MQTT_RESPONSE;
                 }
@@ -641,12 +649,9 @@ static int rgb_getrgbPayload(char *state_str, hapcanCANData *hd_received,
                     else
                     {
                         // 255,255,255/0
-                        snprintf(str, 16, "%d,%d,%d", temp[0], temp[1], 
+                        len = snprintf(payload, size, "%d,%d,%d", temp[0], temp[1], 
                                 temp[2]);
-                        len = strlen(str); 
-                        // Set payload and payloadlen
-                        *payload = malloc(len + 1);
-                        strcpy(*payload, str);
+                        // Set payloadlen
                         *payloadlen = len;
                         ret = HAPCAN_MQTT_RESPONSE;
                     }                    
@@ -709,7 +714,7 @@ static int rgb_checkAndSendCAN(void)
                     if(g_lastSentCount >= HAPCAN_CAN_STATUS_SEND_RETRIES)
                     {                                        
                         #ifdef DEBUG_HAPCAN_RGB_ERRORS
-                        debug_print("INFO: rgb_checkAndSendCAN: Module is not "
+                        debug_error("INFO: rgb_checkAndSendCAN: Module is not "
                                 "responding - Node = %d, Group = %d!\n", 
                                 node, group);
                         #endif
@@ -779,12 +784,12 @@ void hrgb_addToGateway(void)
     bool valid;
     bool configured[RGB_N_COLOURS];
     //---------------------------------------------
-    // Delete and Add to list: PROTECTED
+    // Update list: PROTECTED
     //---------------------------------------------
     // LOCK LIST
     pthread_mutex_lock(&g_rgb_mutex);
-    // Delete
-    rgbl_deleteList();
+    // Modules not configured again are deleted at the end
+    rgbl_setStale();
     // UNLOCK LIST
     pthread_mutex_unlock(&g_rgb_mutex);
     // Add to list
@@ -829,7 +834,7 @@ void hrgb_addToGateway(void)
                 #ifdef DEBUG_HAPCAN_RGB_ERRORS
                 if(!valid)
                 {
-                    debug_print("INFO: hrgb_addToGateway: isRGB check "
+                    debug_error("INFO: hrgb_addToGateway: isRGB check "
                             "Error - module %d!\n", i_module);
                 }
                 #endif
@@ -858,7 +863,7 @@ void hrgb_addToGateway(void)
                 #ifdef DEBUG_HAPCAN_RGB_ERRORS
                 if(!valid)
                 {
-                    debug_print("INFO: hrgb_addToGateway: single channels "
+                    debug_error("INFO: hrgb_addToGateway: single channels "
                             "check Error - module %d", i_module);
                 }
                 #endif
@@ -933,7 +938,7 @@ void hrgb_addToGateway(void)
                     #ifdef DEBUG_HAPCAN_RGB_ERRORS
                     if(!valid)
                     {
-                        debug_print("INFO: hrgb_addToGateway: single channels "
+                        debug_error("INFO: hrgb_addToGateway: single channels "
                                 "duplication / wrong colour Error - module %d",
                                 i_module);
                     }
@@ -1011,7 +1016,7 @@ void hrgb_addToGateway(void)
                     #ifdef DEBUG_HAPCAN_RGB_ERRORS
                     if(!valid)
                     {
-                        debug_print("INFO: hrgb_addToGateway: rgb channel "
+                        debug_error("INFO: hrgb_addToGateway: rgb channel "
                                 "check Error - module %d!\n", i_module);
                     }
                     #endif
@@ -1099,20 +1104,82 @@ void hrgb_addToGateway(void)
             command_str = NULL;
         }
     }    
+    //---------------------------------------------
+    // Delete modules removed from the configuration
+    //---------------------------------------------
+    // LOCK LIST
+    pthread_mutex_lock(&g_rgb_mutex);
+    rgbl_deleteStale();
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_rgb_mutex);
+}
+
+/**
+ * Call a function for each module of the RGB list
+ */
+void hrgb_walkModules(hrgbWalkFn fn, void *arg)
+{
+    rgbList_t* current;
+    hrgbModule module;
+    // LOCK LIST
+    pthread_mutex_lock(&g_rgb_mutex);
+    for(current = g_hrgb_head; current != NULL; current = current->next) 
+    {
+        module.node = current->node;
+        module.group = current->group;
+        module.isRGB = current->isRGB;
+        module.state_str[0] = current->rgb_state_str;
+        module.state_str[1] = current->channel1_state_str;
+        module.state_str[2] = current->channel2_state_str;
+        module.state_str[3] = current->channel3_state_str;
+        fn(&module, arg);
+    }
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_rgb_mutex);
+}
+
+/**
+ * Set the RGB list from a module table
+ */
+void hrgb_setModules(const hrgbModule *modules, int n)
+{
+    int i;
+    // LOCK LIST
+    pthread_mutex_lock(&g_rgb_mutex);
+    rgbl_setStale();
+    for(i = 0; i < n; i++)
+    {
+        rgbl_addElementToList(modules[i].node, modules[i].group, 
+                modules[i].isRGB, (char *)modules[i].state_str[0],
+                (char *)modules[i].state_str[1],
+                (char *)modules[i].state_str[2],
+                (char *)modules[i].state_str[3]);
+    }
+    rgbl_deleteStale();
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_rgb_mutex);
 }
 
 /**
  * Set a payload based on the data received, and add it to the MQTT Pub Buffer.       
  */
 int hrgb_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp)
+        const void *context, unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
-    void* payload = NULL;
+    char payload[HAPCAN_MQTT_PAYLOAD_MAX_LEN];
     int payloadlen;
+    const int *channel;
+    // Channel is the context registered with the gateway element
+    channel = (const int *)context;
+    if(channel == NULL)
+    {
+        return HAPCAN_RESPONSE_ERROR;
+    }
     // Set the payload
-    check = rgb_getrgbPayload(state_str, hd_received, &payload, &payloadlen);
+    check = rgb_getrgbPayload(state_str, hd_received, *channel, payload, 
+            sizeof(payload), &payloadlen);
     if(check == HAPCAN_MQTT_RESPONSE)
     {
         // Set MQTT Pub buffer
@@ -1122,8 +1189,6 @@ int hrgb_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
                     timestamp);
         }
     }
-    // Free
-    free(payload);
     // Return
     return ret;
 }
@@ -1132,14 +1197,15 @@ int hrgb_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
  * Set a HAPCAN message based on the payload received, and add it to the CAN 
  * write Buffer.    
  */
-int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload, 
-        int payloadlen, unsigned long long timestamp)
+int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, 
+        const void *context, void *payload, int payloadlen, 
+        unsigned long long timestamp)
 {
     int ret = HAPCAN_RESPONSE_ERROR;
     int channel;    
     long val;
-    char *str = NULL;    
-    json_object *obj = NULL;
+    char str[HAPCAN_MQTT_COMMAND_STR_LEN];
+    jsonFlatObject obj;
     bool valid = true;
     int temp;
     int colors[RGB_N_COLOURS];
@@ -1166,9 +1232,7 @@ int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
     else
     {
         // Copy payload to str
-        str = malloc(payloadlen + 1);
-        memcpy(str, payload, payloadlen);
-        str[payloadlen] = 0;
+        aux_getPayloadString(payload, payloadlen, str, sizeof(str));
         // Set the frame as direct control
         hd_result->frametype = HAPCAN_DIRECT_CONTROL_FRAME_TYPE;
         if(!isRGB)
@@ -1373,13 +1437,13 @@ int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
             else
             {
                 // Check for JSON - Get the JSON Object
-                jh_getObject(str, &obj);
+                check = jh_parseFlatObject(payload, payloadlen, &obj);
                 // Check if error parsing
-                if(obj != NULL)
+                if(check == JSON_OK)
                 {
                     valid = true;
                     // INSTR1
-                    check = jh_getObjectFieldAsInt(obj, "INSTR1", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR1", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1387,7 +1451,7 @@ int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
                         hd_result->data[0] = (uint8_t)temp;
                     }
                     // INSTR2
-                    check = jh_getObjectFieldAsInt(obj, "INSTR2", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR2", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1395,7 +1459,7 @@ int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
                         hd_result->data[1] = (uint8_t)temp;
                     }
                     // INSTR3
-                    check = jh_getObjectFieldAsInt(obj, "INSTR3", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR3", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1403,7 +1467,7 @@ int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
                         hd_result->data[4] = (uint8_t)temp;
                     }
                     // INSTR4
-                    check = jh_getObjectFieldAsInt(obj, "INSTR4", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR4", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1411,7 +1475,7 @@ int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
                         hd_result->data[5] = (uint8_t)temp;
                     }
                     // INSTR5
-                    check = jh_getObjectFieldAsInt(obj, "INSTR5", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR5", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1419,7 +1483,7 @@ int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
                         hd_result->data[6] = (uint8_t)temp;
                     }
                     // INSTR6
-                    check = jh_getObjectFieldAsInt(obj, "INSTR6", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR6", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1437,9 +1501,6 @@ int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
     {
         ret = HAPCAN_RESPONSE_ERROR;
     }    
-    // Free
-    jh_freeObject(obj);
-    free(str);
     // Leave
     return ret;
 }
@@ -6,6 +6,13 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Module handlers receive the per-channel context registered with the      //
+// gateway element                                                            //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add hrgb_walkModules / hrgb_setModules (configuration cache)             //
+//----------------------------------------------------------------------------//
 
 #ifndef HAPCANRGB_H
 #define HAPCANRGB_H
@@ -22,12 +29,27 @@ extern "C" {
 //----------------------------------------------------------------------------//
 // EXTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//    
-
+/* State topics of a module: RGB state, channel 1 to 3 */
+#define HRGB_MODULE_TOPICS     4
     
 //----------------------------------------------------------------------------//
 // EXTERNAL TYPES
 //----------------------------------------------------------------------------//
+// Module of the RGB list (configuration cache)
+typedef struct
+{
+    int node;
+    int group;
+    bool isRGB;
+    const char *state_str[HRGB_MODULE_TOPICS];    // NULL if not used
+} hrgbModule;
 
+/**
+ * Function called for each module by hrgb_walkModules
+ * \param   module  (INPUT) module data (valid only during the call)
+ * \param   arg     (INPUT) argument given to hrgb_walkModules
+ */
+typedef void (*hrgbWalkFn)(const hrgbModule *module, void *arg);
     
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
@@ -38,10 +60,30 @@ extern "C" {
  */
 void hrgb_addToGateway(void);
 
+/**
+ * Call a function for each module of the RGB list (the list is locked during 
+ * the walk).
+ * 
+ * \param   fn      (INPUT) function called for each module
+ * \param   arg     (INPUT) argument passed to the function
+ */
+void hrgb_walkModules(hrgbWalkFn fn, void *arg);
+
+/**
+ * Set the RGB list from a module table, instead of the configuration file 
+ * (the gateway elements are not added). Modules that were already in the list 
+ * keep their outputs and update flags.
+ * 
+ * \param   modules (INPUT) module table
+ * \param   n       (INPUT) number of modules
+ */
+void hrgb_setModules(const hrgbModule *modules, int n);
+
 /**
  * Set a payload based on the data received, and add it to the MQTT Pub Buffer.
  * \param   state_str       (INPUT) string with the MQTT State Topic
  * \param   hd_received     (INPUT) pointer to HAPCAN message received
+ * \param   context         (INPUT) context registered with the gateway element
  * \param   timestamp       (INPUT) timestamp of the CAN message
  *                      
  * \return  HAPCAN_NO_RESPONSE: No response was added to MQTT Pub Buffer
@@ -51,12 +93,13 @@ void hrgb_addToGateway(void);
  *          
  */
 int hrgb_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp);
+        const void *context, unsigned long long timestamp);
 
 /**
  * Set a HAPCAN message based on the payload received, and add it to the CAN 
  * write Buffer.
  * \param   hd_result   (INPUT) matched results from the gateway
+ * \param   context     (INPUT) context registered with the gateway element
  * \param   payload     (INPUT) received MQTT Payload
  * \param   payloadlen  (INPUT) received MQTT Payload Length
  * \param   timestamp   (INPUT) timestamp of the CAN message
@@ -67,8 +110,9 @@ int hrgb_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
  *          HAPCAN_RESPONSE_ERROR: Other error
  *          
  */
-int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload, 
-        int payloadlen, unsigned long long timestamp);
+int hrgb_setMQTT2CANResponse(hapcanCANData *hd_result, 
+        const void *context, void *payload, int payloadlen, 
+        unsigned long long timestamp);
 
 /**
  * To be called periodically to check and update the RGB modules status.
@@ -6,6 +6,14 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_SOCKETSERVER    //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_SOCKETSERVER
 
 /*
 * Includes
@@ -506,9 +514,9 @@ void hs_handleMsgFromSocket(uint8_t* data, int dataLen,
             break;
         case HAPCAN_RESPONSE_ERROR:
             #ifdef DEBUG_SOCKETSERVER_PROCESS_ERROR            
-            debug_printSocket("hs_handleMsgFromSocket - "
+            debug_verboseSocket("hs_handleMsgFromSocket - "
                     "HAPCAN_RESPONSE_ERROR - Socket Data:\n", data, dataLen);
-            debug_printHAPCAN("hs_handleMsgFromSocket - "
+            debug_verboseHAPCAN("hs_handleMsgFromSocket - "
                     "HAPCAN_RESPONSE_ERROR - HAPCAN DATA:\n", &hapcanData);
             #endif
             break;
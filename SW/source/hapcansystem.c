@@ -15,6 +15,27 @@
 //  1.03     | 23/Oct/2024 |                               | ALCP             //
 // - Fix MQTT status topic string                                             //
 //----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Status payload is written to a fixed size buffer                         //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Count the status requests not answered by each module (metrics)          //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_HAPCAN          //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - Add hsystem_update (configuration reload): modules that did not change   //
+// keep their data and flags, only new modules get a status request           //
+//----------------------------------------------------------------------------//
+//  1.08     | 18/Oct/2026 |                               | ALCP             //
+// - The status is published with an interned topic                           //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
 
 //----------------------------------------------------------------------------//
 // Includes
@@ -32,6 +53,7 @@
 #include "hapcanconfig.h"
 #include "hapcansystem.h"
 #include "jsonhandler.h"
+#include "topic.h"
 
 //----------------------------------------------------------------------------//
 // INTERNAL DEFINITIONS
@@ -84,6 +106,8 @@ const int c_frametype_dynamic[HAPCAN_DYNAMIC_N_UPDATES] =
 //----------------------------------------------------------------------------//
 // List element
 #define NODE_LIST_N_FIELDS 26
+// Maximum size of the status payload (26 fields)
+#define NODE_PAYLOAD_MAX_LEN 1024
 typedef struct nodeList_t 
 {
     //------------------------
@@ -142,6 +166,11 @@ typedef struct nodeList_t
     bool isDynamicSent;
     bool isStatusSent;
     //------------------------
+    // Monitoring
+    //------------------------
+    unsigned long noResponse;   // Times the module did not respond
+    bool stale;                 // Not configured again since the reload
+    //------------------------
     // Linked List Control
     //------------------------
     struct nodeList_t *next;
@@ -178,7 +207,9 @@ static void hsystem_freeElementData(nodeList_t* element);
 static void hsystem_addToList(nodeList_t* element);
 static nodeList_t* hsystem_getFromOffset(int offset);    // NULL means error
 static void hsystem_deleteList(void);
-static void hsystem_addElementToList(int node, int group);
+static void hsystem_setStale(void);
+static void hsystem_deleteStale(void);
+static bool hsystem_addElementToList(int node, int group, bool request);
 // Other internal functions
 static void hsystem_setUpdateNodes(int node, int group, int *ig, int *fg, 
         int *in, int *fn);
@@ -187,12 +218,12 @@ static void hsystem_setControlFlags(int ig, int fg, int in, int fn,
         update_t type, bool req);
 static bool hsystem_getGroupNodeFromTopic(char *received_topic, 
         char *configured_topic, int *node, int *group);
-static void hsystem_addModulesToList(void);
+static int hsystem_addModulesToList(bool request);
 static void hsystem_setUpdateFlags(update_t type, int node, int group);
 static int hsystem_updateData(hapcanCANData *hd_received, nodeList_t* element);
 static int hsystem_checkUpdateData(hapcanCANData *hd_received);
 static void hsystem_getMQTTPayload(nodeList_t* element, char **topic, 
-        void **payload, int *payloadlen);
+        char *payload, unsigned int size, int *payloadlen);
 static int hsystem_checkAndSendCAN(void);
 static int hsystem_checkAndSendMQTT(void);
 #ifdef DEBUG_HAPCAN_SYSTEM_PRINT 
@@ -280,19 +311,68 @@ static void hsystem_deleteList(void)
     }    
 }
 
-// Add elements to the List
-static void hsystem_addElementToList(int node, int group)
+// Mark every element as stale (configuration reload)
+static void hsystem_setStale(void)
+{
+    nodeList_t* current;
+    for(current = g_hsystem_head; current != NULL; current = current->next) 
+    {
+        current->stale = true;
+    }
+}
+
+// Delete the elements that were not configured again
+static void hsystem_deleteStale(void)
+{
+    nodeList_t** link;
+    nodeList_t* current;
+    link = &g_hsystem_head;
+    while(*link != NULL) 
+    {
+        current = *link;
+        if(current->stale)
+        {
+            *link = current->next;
+            hsystem_freeElementData(current);
+            free(current);
+        }
+        else
+        {
+            link = &current->next;
+        }
+    }
+}
+
+// Add elements to the List - returns true if the element is a new one
+static bool hsystem_addElementToList(int node, int group, bool request)
 {
     nodeList_t element;
+    nodeList_t* current;
+    // Module already in the list (configuration reload): keep it
+    for(current = g_hsystem_head; current != NULL; current = current->next) 
+    {
+        if(current->stale && (current->node == node) && 
+                (current->group == group))
+        {
+            current->stale = false;
+            return false;
+        }
+    }
     hsystem_clearElementData(&element);
     element.group = group;
     element.node = node;
     // Set flags to clear update request
     hsystem_setListFlags(&element, UPDATE_TYPE_ALL, true);
+    // New module after a reload: request its status
+    if(request)
+    {
+        hsystem_setListFlags(&element, UPDATE_TYPE_STATUS, false);
+    }
     // Add
     hsystem_addToList(&element);
     // Free temp data and then return
     hsystem_freeElementData(&element);
+    return true;
 }
 
 // Set the initial and Final Group / nodes for a given input node and group
@@ -451,8 +531,8 @@ static bool hsystem_getGroupNodeFromTopic(char *received_topic,
     return ret;
 }
 
-// Add a node / group to list
-static void hsystem_addModulesToList(void)
+// Add a node / group to list - returns the number of new elements
+static int hsystem_addModulesToList(bool request)
 {
     int check;
     const char* a_str[] = {"HAPCANRelays", "HAPCANButtons", "HAPCANRGBs", 
@@ -464,6 +544,7 @@ static void hsystem_addModulesToList(void)
     int node;
     int group;
     bool valid;
+    int added = 0;
     // Check all configured modules
     for(i_type = 0; i_type < n_types; i_type++)
     {
@@ -488,17 +569,18 @@ static void hsystem_addModulesToList(void)
                 #ifdef DEBUG_HAPCAN_SYSTEM_ERRORS
                 if(!valid)
                 {
-                    debug_print("hsystem_addModulesToList: Module Information "
+                    debug_error("hsystem_addModulesToList: Module Information "
                             "Error - Type = %s!\n", a_str[i_type]);
                 }
                 #endif
-                if(valid)
+                if(valid && hsystem_addElementToList(node, group, request))
                 {
-                    hsystem_addElementToList(node, group);
+                    added++;
                 }
             }
         }
     }
+    return added;
 }
 
 // Update the flags for updating the fields when messages are received
@@ -772,18 +854,21 @@ static int hsystem_checkUpdateData(hapcanCANData *hd_received)
  * Fill MQTT data with a system MQTT message based on element data
  * \param   element     (INPUT) date to be read
  *          topic       (OUTPUT) topic to be filled
- *          payload     (OUTPUT) payload to be filled
+ *          payload     (OUTPUT) payload buffer to be filled
+ *          size        (INPUT) size of the payload buffer
  *          payloadlen  (OUTPUT) payloadlen to be filled
  * 
  */
 static void hsystem_getMQTTPayload(nodeList_t* element, char **topic, 
-        void **payload, int *payloadlen)
+        char *payload, unsigned int size, int *payloadlen)
 {        
     int check;
     int field;
     char *str = NULL;
     char description[17];
+    char topic_suffix[12];
     unsigned int len;
+    int li_len;
     bool valid = false;
     //-------------------------------------------------
     // Read configuration and validate data
@@ -796,7 +881,6 @@ static void hsystem_getMQTTPayload(nodeList_t* element, char **topic,
     if(!valid)
     {
         *topic = NULL;
-        *payload = NULL;
         *payloadlen = 0;
     }    
     else
@@ -808,12 +892,11 @@ static void hsystem_getMQTTPayload(nodeList_t* element, char **topic,
         *topic = malloc(len + 10); // additional bytes for For "/xxx/xxx" and \0
         // Copy PUB topic to topic
         strcpy(*topic, str);
-        // Get rest of topic "/GROUP/NODE"
-        free(str);
-        str = malloc(12);
-        snprintf(str, 10, "/%d/%d", element->group, element->node);
-        strncat(*topic, str, 10);
         free(str);
+        str = NULL;
+        // Get rest of topic "/GROUP/NODE"
+        snprintf(topic_suffix, 10, "/%d/%d", element->group, element->node);
+        strncat(*topic, topic_suffix, 10);
         //-------------------------------------------------
         // Create Payload
         //-------------------------------------------------
@@ -928,19 +1011,16 @@ static void hsystem_getMQTTPayload(nodeList_t* element, char **topic,
         j_arr[field].int_value = element->txerrcnte;
         field++;        
         // Get Payload string
-        jh_getStringFromFieldValuePairs(j_arr, field, &str);          
-        len = strlen(str);
-        if(str != NULL && len > 0)
+        li_len = jh_formatFieldValuePairs(j_arr, field, payload, size);
+        // SET PAYLOAD LEN
+        if((li_len > 0) && (li_len < (int)size))
         {
-            *payload = malloc(len + 1);
-            strcpy(*payload, str);
+            *payloadlen = li_len;
         }
         else
         {
-            *payload = NULL;
+            *payloadlen = 0;
         }
-        // SET PAYLOAD LEN
-        *payloadlen = len;
     }
     // free
     free(str);
@@ -1076,8 +1156,9 @@ static int hsystem_checkAndSendCAN(void)
                             sendDynamicRequest = false;
                             hsystem_setListFlags(current, UPDATE_TYPE_ALL, 
                                     true);
+                            current->noResponse++;
                             #ifdef DEBUG_HAPCAN_SYSTEM_ERRORS
-                            debug_print("INFO: hsystem_checkAndSendCAN: Module "
+                            debug_error("INFO: hsystem_checkAndSendCAN: Module "
                                     "is not responding - Node = %d, "
                                     "Group = %d!\n", node, group);                            
                             #endif
@@ -1158,7 +1239,8 @@ static int hsystem_checkAndSendMQTT(void)
     bool dynamicReady;
     bool staticReady;
     char *topic = NULL;
-    void *payload = NULL;
+    const char *itopic;
+    char payload[NODE_PAYLOAD_MAX_LEN];
     int payloadlen = 0;
     unsigned long long timestamp;
     nodeList_t* current;
@@ -1210,8 +1292,9 @@ static int hsystem_checkAndSendMQTT(void)
         // Prepare data to be sent
         if(sendDynamic || sendStatic)
         {
-            hsystem_getMQTTPayload(current, &topic, &payload, &payloadlen);
-            if(topic == NULL || payload == NULL || payloadlen <= 0)
+            hsystem_getMQTTPayload(current, &topic, payload, 
+                    sizeof(payload), &payloadlen);
+            if(topic == NULL || payloadlen <= 0)
             {
                 sendStatic = false;
                 sendDynamic = false;
@@ -1228,7 +1311,10 @@ static int hsystem_checkAndSendMQTT(void)
     {
         // Get Timestamp and Set MQTT Pub buffer
         timestamp = aux_getmsSinceEpoch();
-        ret = hapcan_addToMQTTPubBuffer(topic, payload, payloadlen, timestamp);
+        itopic = topic_intern(topic);
+        ret = hapcan_addToMQTTPubBuffer(itopic, payload, payloadlen, 
+                timestamp);
+        topic_release(itopic);
         if(ret == HAPCAN_MQTT_RESPONSE)
         {
             // LOCK LIST
@@ -1247,7 +1333,6 @@ static int hsystem_checkAndSendMQTT(void)
     }
     // Free
     free(topic);
-    free(payload);
     // Return
     return ret;
 }
@@ -1256,7 +1341,7 @@ static int hsystem_checkAndSendMQTT(void)
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
 /*
- * Init - to be called every time the configuration changes
+ * Init - to be called at startup (see hsystem_update for a reload)
  */
 void hsystem_init(void)
 {
@@ -1268,7 +1353,7 @@ void hsystem_init(void)
     // Delete
     hsystem_deleteList();
     // Add to list
-    hsystem_addModulesToList();
+    hsystem_addModulesToList(false);
     // UNLOCK LIST
     pthread_mutex_unlock(&g_hsystem_list_mutex); 
     // LOCK CONTROL
@@ -1281,6 +1366,38 @@ void hsystem_init(void)
     hsystem_statusUpdate();
 }
 
+/*
+ * Update - to be called when the configuration is reloaded
+ */
+void hsystem_update(void)
+{
+    int added;
+    //---------------------------------------------
+    // Update list: PROTECTED
+    //---------------------------------------------
+    // LOCK LIST
+    pthread_mutex_lock(&g_hsystem_list_mutex);
+    hsystem_setStale();
+    // Add new modules (modules not changed are kept)
+    added = hsystem_addModulesToList(true);
+    // Delete modules removed from the configuration
+    hsystem_deleteStale();
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_hsystem_list_mutex); 
+    #ifdef DEBUG_HAPCAN_SYSTEM_PRINT
+    debug_print("hsystem_update: %d new modules\n", added);
+    #endif
+    // Status Update of the new modules only (flags set when added)
+    if(added > 0)
+    {
+        // LOCK CONTROL
+        pthread_mutex_lock(&g_hsystem_control_mutex);
+        hsystem_setControlFlags(1, 255, 1, 255, UPDATE_TYPE_STATUS, false);
+        // UNLOCK CONTROL
+        pthread_mutex_unlock(&g_hsystem_control_mutex);
+    }
+}
+
 /*
  * Request Status Update for all configured modules
  */
@@ -1389,4 +1506,30 @@ int hsystem_periodic(void)
         ret = hsystem_checkAndSendMQTT();
     }
     return ret;
+}
+
+/**
+ * Number of times a configured module did not respond (metrics).
+ */
+int hsystem_getNoResponseCount(int offset, int *node, int *group, 
+        unsigned long *count)
+{
+    int ret = EXIT_SUCCESS;
+    nodeList_t* current;
+    // LOCK LIST
+    pthread_mutex_lock(&g_hsystem_list_mutex);
+    current = hsystem_getFromOffset(offset);
+    if(current == NULL)
+    {
+        ret = EXIT_FAILURE;
+    }
+    else
+    {
+        *node = current->node;
+        *group = current->group;
+        *count = current->noResponse;
+    }
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_hsystem_list_mutex);
+    return ret;
 }
\ No newline at end of file
@@ -9,6 +9,12 @@
 //  1.01     | 19/Aug/2023 |                               | ALCP             //
 // - Perform initial status update for all configured modules on init         //
 //----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add hsystem_getNoResponseCount (metrics)                                 //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add hsystem_update (configuration reload)                                //
+//----------------------------------------------------------------------------//
 
 
 #ifndef HAPCANSYSTEM_H
@@ -37,10 +43,17 @@ extern "C" {
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
 /*
- * Init - to be called every time the configuration changes
+ * Init - to be called at startup (see hsystem_update for a reload)
  */
 void hsystem_init(void);
 
+/*
+ * Update - to be called when the configuration is reloaded. Modules that are 
+ * still configured keep their data and update flags; removed modules are 
+ * deleted and only the new ones get a status request (no full status update).
+ */
+void hsystem_update(void);
+
 /*
  * Request Status Update for all configured modules
  */
@@ -84,6 +97,19 @@ int hsystem_checkCAN(hapcanCANData *hd_received, unsigned long long timestamp);
  */
 int hsystem_periodic(void);
 
+/**
+ * Number of times a configured module did not respond to the status update
+ * requests (since the last hsystem_init) - Monitoring.
+ * \param   offset          (INPUT) position in the list of modules
+ *          node            (OUTPUT) module node
+ *          group           (OUTPUT) module group
+ *          count           (OUTPUT) times the module did not respond
+ *                      
+ * \return  EXIT_SUCCESS / EXIT_FAILURE (no module in this position)
+ */
+int hsystem_getNoResponseCount(int offset, int *node, int *group, 
+        unsigned long *count);
+
 #ifdef __cplusplus
 }
 #endif
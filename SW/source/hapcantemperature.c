@@ -6,6 +6,25 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - CAN2MQTT payloads written to a fixed buffer (no allocation per frame)    //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - MQTT2CAN JSON commands are parsed with jh_parseFlatObject (no            //
+// allocation, no JSON lock)                                                  //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Register the module handlers with the gateway elements (called directly  //
+// on a match)                                                                //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_HAPCAN          //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
 
 /*
 * Includes
@@ -39,6 +58,12 @@
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
+// Handlers called by the gateway for the elements added by this module
+static const gatewayHandler g_htemp_handler = 
+{
+    htemp_setCAN2MQTTResponse,
+    htemp_setMQTT2CANResponse
+};
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS
@@ -49,8 +74,8 @@ static void addThermostatModuleToGateway(int node, int group, char *state_str,
 static void addTControllerModuleToGateway(int node, int group, char *state_str, 
         char *command_str);
 static void addTErrorModuleToGateway(int node, int group, char *state_str);
-static int getTempPayload(hapcanCANData *hd_received, void** payload, 
-        int *payloadlen);
+static int getTempPayload(hapcanCANData *hd_received, char *payload, 
+        unsigned int size, int *payloadlen);
 static int getTempHAPCANFrame(void *payload, int payloadlen, 
         hapcanCANData *hd_result);
 
@@ -85,7 +110,7 @@ static void addTemperatureModuleToGateway(int node, int group, char *state_str)
     if(!valid)
     {
         #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-        debug_print("addTemperatureModuleToGateway: parameter error!\n");
+        debug_error("addTemperatureModuleToGateway: parameter error!\n");
         #endif
     }
     else
@@ -124,11 +149,12 @@ static void addTemperatureModuleToGateway(int node, int group, char *state_str)
             hd_check.data[2] = 0x11;
             // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
             check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, 
-                    &hd_mask, &hd_check, state_str, NULL, &hd_result);
+                    &hd_mask, &hd_check, state_str, NULL, &hd_result, 
+                    &g_htemp_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-                debug_print("addTemperatureModuleToGateway: Error adding "
+                debug_error("addTemperatureModuleToGateway: Error adding "
                         "to CAN2MQTT!\n");
                 #endif
             }
@@ -169,7 +195,7 @@ static void addThermostatModuleToGateway(int node, int group, char *state_str,
     if(!valid)
     {
         #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-        debug_print("addThermostatModuleToGateway: parameter error!\n");
+        debug_error("addThermostatModuleToGateway: parameter error!\n");
         #endif
     }
     else
@@ -208,11 +234,12 @@ static void addThermostatModuleToGateway(int node, int group, char *state_str,
             hd_check.data[2] = 0x12;
             // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
             check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, &hd_mask, 
-                &hd_check, state_str, NULL, &hd_result);
+                &hd_check, state_str, NULL, &hd_result, 
+                &g_htemp_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-                debug_print("addThermostatModuleToGateway: Error adding "
+                debug_error("addThermostatModuleToGateway: Error adding "
                         "to CAN2MQTT!\n");
                 #endif
             }
@@ -244,11 +271,12 @@ static void addThermostatModuleToGateway(int node, int group, char *state_str,
             hd_result.data[3] = group;
             // Add to list CAN2MQTT: command_str, hd_result
             check = gateway_AddElementToList(GATEWAY_MQTT2CAN_LIST, &hd_mask, 
-                &hd_check, NULL, command_str, &hd_result);
+                &hd_check, NULL, command_str, &hd_result, 
+                &g_htemp_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-                debug_print("addThermostatModuleToGateway: Error adding "
+                debug_error("addThermostatModuleToGateway: Error adding "
                         "to MQTT2CAN!\n");
                 #endif
             }
@@ -289,7 +317,7 @@ static void addTControllerModuleToGateway(int node, int group, char *state_str,
     if(!valid)
     {
         #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-        debug_print("addTControllerModuleToGateway: parameter error!\n");
+        debug_error("addTControllerModuleToGateway: parameter error!\n");
         #endif
     }
     else
@@ -328,11 +356,12 @@ static void addTControllerModuleToGateway(int node, int group, char *state_str,
             hd_check.data[2] = 0x13;
             // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
             check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, &hd_mask, 
-                &hd_check, state_str, NULL, &hd_result);
+                &hd_check, state_str, NULL, &hd_result, 
+                &g_htemp_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-                debug_print("addTControllerModuleToGateway: Error adding "
+                debug_error("addTControllerModuleToGateway: Error adding "
                         "to CAN2MQTT!\n");
                 #endif
             }
@@ -364,11 +393,12 @@ static void addTControllerModuleToGateway(int node, int group, char *state_str,
             hd_result.data[3] = group;
             // Add to list CAN2MQTT: command_str, hd_result
             check = gateway_AddElementToList(GATEWAY_MQTT2CAN_LIST, &hd_mask, 
-                &hd_check, NULL, command_str, &hd_result);
+                &hd_check, NULL, command_str, &hd_result, 
+                &g_htemp_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-                debug_print("addTControllerModuleToGateway: Error adding "
+                debug_error("addTControllerModuleToGateway: Error adding "
                         "to MQTT2CAN!\n");
                 #endif
             }
@@ -407,7 +437,7 @@ static void addTErrorModuleToGateway(int node, int group, char *state_str)
     if(!valid)
     {
         #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-        debug_print("addTErrorModuleToGateway: parameter error!\n");
+        debug_error("addTErrorModuleToGateway: parameter error!\n");
         #endif
     }
     else
@@ -446,11 +476,12 @@ static void addTErrorModuleToGateway(int node, int group, char *state_str)
             hd_check.data[2] = 0xF0;
             // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
             check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, &hd_mask, 
-                &hd_check, state_str, NULL, &hd_result);
+                &hd_check, state_str, NULL, &hd_result, 
+                &g_htemp_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-                debug_print("addTErrorModuleToGateway: Error adding to "
+                debug_error("addTErrorModuleToGateway: Error adding to "
                         "CAN2MQTT!\n");
                 #endif
             }
@@ -462,7 +493,8 @@ static void addTErrorModuleToGateway(int node, int group, char *state_str)
  * Set a payload based on the data received
  * 
  * \param   hd_received     (INPUT) pointer to HAPCAN message received
- * \param   payload         (OUTPUT) payload to be filled
+ * \param   payload         (OUTPUT) payload buffer to be filled
+ * \param   size            (INPUT) size of the payload buffer
  * \param   payloadlen      (OUTPUT) payloadlen to be filled
  *                      
  * \return  HAPCAN_MQTT_RESPONSE: Payload set (OK)
@@ -470,8 +502,8 @@ static void addTErrorModuleToGateway(int node, int group, char *state_str)
  *          HAPCAN_NO_RESPONSE: No response
  *          
  */
-static int getTempPayload(hapcanCANData *hd_received, void** payload, 
-        int *payloadlen)
+static int getTempPayload(hapcanCANData *hd_received, char *payload, 
+        unsigned int size, int *payloadlen)
 {
     // D2 is Type of Temperature message:
     //    - 0x11 – current temperature
@@ -480,9 +512,8 @@ static int getTempPayload(hapcanCANData *hd_received, void** payload,
     //    - 0xF0 – temperature error
     int ret = HAPCAN_MQTT_RESPONSE;
     int pair;
-    char *str;
     jsonFieldData j_arr[5];    
-    unsigned int len;
+    int len;
     int16_t i;
     double calc;
     switch(hd_received->data[2])
@@ -512,23 +543,17 @@ static int getTempPayload(hapcanCANData *hd_received, void** payload,
             j_arr[pair].value_type = JSON_TYPE_DOUBLE;
             j_arr[pair].double_value = calc;
             pair++;
-            jh_getStringFromFieldValuePairs(j_arr, pair, &str);
-            len = strlen(str);
-            if(len > 0)
+            len = jh_formatFieldValuePairs(j_arr, pair, payload, size);
+            if((len > 0) && (len < (int)size))
             {
-                *payload = malloc(len + 1);
-                strcpy(*payload, str);
                 ret = HAPCAN_MQTT_RESPONSE;
                 *payloadlen = len; 
             }
             else
             {
-                *payload = NULL;
                 *payloadlen = 0;
                 ret = HAPCAN_RESPONSE_ERROR;
             }
-            // free
-            free(str);
             break;
         //-------------------------------------------
         // Thermostat Frame
@@ -545,33 +570,27 @@ static int getTempPayload(hapcanCANData *hd_received, void** payload,
             {
                 j_arr[pair].field = "State";            
                 j_arr[pair].value_type = JSON_TYPE_STRING;
-                j_arr[pair].str_value = "OFF";
+                j_arr[pair].str_value = HAPCAN_PAYLOAD_OFF;
                 pair++;
             }
             else if(hd_received->data[7] == 0xFF)
             {
                 j_arr[pair].field = "State";            
                 j_arr[pair].value_type = JSON_TYPE_STRING;
-                j_arr[pair].str_value = "ON";
+                j_arr[pair].str_value = HAPCAN_PAYLOAD_ON;
                 pair++;
             }
-            jh_getStringFromFieldValuePairs(j_arr, pair, &str);
-            len = strlen(str);
-            if(len > 0)
+            len = jh_formatFieldValuePairs(j_arr, pair, payload, size);
+            if((len > 0) && (len < (int)size))
             {
-                *payload = malloc(len + 1);
-                strcpy(*payload, str);
                 ret = HAPCAN_MQTT_RESPONSE;
                 *payloadlen = len; 
             }
             else
             {
-                *payload = NULL;
                 *payloadlen = 0;
                 ret = HAPCAN_RESPONSE_ERROR;
             }
-            // free
-            free(str);
             break;
         //-------------------------------------------
         // Temperature Controller Frame
@@ -586,14 +605,14 @@ static int getTempPayload(hapcanCANData *hd_received, void** payload,
             {
                 j_arr[pair].field = "HeatState";            
                 j_arr[pair].value_type = JSON_TYPE_STRING;
-                j_arr[pair].str_value = "OFF";
+                j_arr[pair].str_value = HAPCAN_PAYLOAD_OFF;
                 pair++;
             }
             else if(hd_received->data[3] == 0xFF)
             {
                 j_arr[pair].field = "HeatState";            
                 j_arr[pair].value_type = JSON_TYPE_STRING;
-                j_arr[pair].str_value = "ON";
+                j_arr[pair].str_value = HAPCAN_PAYLOAD_ON;
                 pair++;
             }            
             j_arr[pair].field = "HeatValue";            
@@ -604,14 +623,14 @@ static int getTempPayload(hapcanCANData *hd_received, void** payload,
             {
                 j_arr[pair].field = "CoolState";            
                 j_arr[pair].value_type = JSON_TYPE_STRING;
-                j_arr[pair].str_value = "OFF";
+                j_arr[pair].str_value = HAPCAN_PAYLOAD_OFF;
                 pair++;
             }
             else if(hd_received->data[5] == 0xFF)
             {
                 j_arr[pair].field = "CoolState";            
                 j_arr[pair].value_type = JSON_TYPE_STRING;
-                j_arr[pair].str_value = "ON";
+                j_arr[pair].str_value = HAPCAN_PAYLOAD_ON;
                 pair++;
             }
             j_arr[pair].field = "CoolValue";            
@@ -622,50 +641,41 @@ static int getTempPayload(hapcanCANData *hd_received, void** payload,
             {
                 j_arr[pair].field = "ControlState";            
                 j_arr[pair].value_type = JSON_TYPE_STRING;
-                j_arr[pair].str_value = "OFF";
+                j_arr[pair].str_value = HAPCAN_PAYLOAD_OFF;
                 pair++;
             }
             else if(hd_received->data[7] == 0xFF)
             {
                 j_arr[pair].field = "ControlState";            
                 j_arr[pair].value_type = JSON_TYPE_STRING;
-                j_arr[pair].str_value = "ON";
+                j_arr[pair].str_value = HAPCAN_PAYLOAD_ON;
                 pair++;
             }
-            jh_getStringFromFieldValuePairs(j_arr, pair, &str);
-            len = strlen(str);
-            if(len > 0)
+            len = jh_formatFieldValuePairs(j_arr, pair, payload, size);
+            if((len > 0) && (len < (int)size))
             {
-                *payload = malloc(len + 1);
-                strcpy(*payload, str);
                 ret = HAPCAN_MQTT_RESPONSE;
                 *payloadlen = len; 
             }
             else
             {
-                *payload = NULL;
                 *payloadlen = 0;
                 ret = HAPCAN_RESPONSE_ERROR;
             }
-            // free
-            free(str);
             break;
         //-------------------------------------------
         // Temperature Sensor Error Frame
         //    - Integer (error)
         //-------------------------------------------
         case 0xF0:
-            len = snprintf(NULL, 0, "%d", hd_received->data[3]);
-            if(len > 0)
+            len = snprintf(payload, size, "%d", hd_received->data[3]);
+            if((len > 0) && (len < (int)size))
             {
-                *payload = malloc(len + 1);
-                snprintf(*payload, len + 1, "%d", hd_received->data[3]);
                 *payloadlen = len;
                 ret = HAPCAN_MQTT_RESPONSE;
             }
             else
             {
-                *payload = NULL;
                 *payloadlen = 0;
                 ret = HAPCAN_RESPONSE_ERROR;
             }
@@ -675,8 +685,9 @@ static int getTempPayload(hapcanCANData *hd_received, void** payload,
         //-------------------------------------------
         default:
             #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
-            debug_print("getTempPayload: Unknown Temperature Frame Type!\n");
+            debug_error("getTempPayload: Unknown Temperature Frame Type!\n");
             #endif
+            ret = HAPCAN_NO_RESPONSE;
             break;
     }
     return ret;
@@ -707,8 +718,8 @@ static int getTempHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd_r
     bool valid = false;
     int16_t i;
     double calc;
-    char *str = NULL;
-    json_object *obj = NULL;
+    char str[HAPCAN_MQTT_COMMAND_STR_LEN];
+    jsonFlatObject obj;
     // Check NULL or size 0
     if((payload == NULL) || (payloadlen <= 0))
     {
@@ -719,9 +730,7 @@ static int getTempHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd_r
         // set to false unless there is a payload match 
         valid = false;
         // payload does not end with 0 for a string - copy it here
-        str = malloc(payloadlen + 1);
-        memcpy(str, payload, payloadlen);
-        str[payloadlen] = 0;
+        aux_getPayloadString(payload, payloadlen, str, sizeof(str));
         // Check the result message D1 (previously set when added to gateway)
         switch(hd_result->data[1])
         {
@@ -781,12 +790,12 @@ static int getTempHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd_r
                 {
                     valid = false;
                     // Check for JSON - Get the JSON Object
-                    jh_getObject(str, &obj);                    
+                    check = jh_parseFlatObject(payload, payloadlen, &obj);
                     // Check if error parsing
-                    if(obj != NULL)
+                    if(check == JSON_OK)
                     {                        
                         // Setpoint
-                        check = jh_getObjectFieldAsDouble(obj, "Setpoint", 
+                        check = jh_getFlatFieldAsDouble(&obj, "Setpoint", 
                                 &calc);                        
                         valid = (check == JSON_OK) && (calc >= -55) && 
                                 (calc <= 125);                
@@ -805,7 +814,7 @@ static int getTempHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd_r
                         if(!valid)
                         {
                             // Increase
-                            check = jh_getObjectFieldAsDouble(obj, "Increase", 
+                            check = jh_getFlatFieldAsDouble(&obj, "Increase", 
                                     &calc);
                             valid = !valid && (check == JSON_OK) && (calc > 0) 
                                     && (calc <= 16);
@@ -828,7 +837,7 @@ static int getTempHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd_r
                         if(!valid)
                         {
                             // Decrease
-                            check = jh_getObjectFieldAsDouble(obj, "Decrease", 
+                            check = jh_getFlatFieldAsDouble(&obj, "Decrease", 
                                     &calc);
                             valid = !valid && (check == JSON_OK) && (calc > 0) 
                                     && (calc <= 16);
@@ -902,9 +911,6 @@ static int getTempHAPCANFrame(void *payload, int payloadlen, hapcanCANData *hd_r
         hd_result->frametype = HAPCAN_DIRECT_CONTROL_FRAME_TYPE;
         ret = HAPCAN_CAN_RESPONSE;
     }
-    // Free
-    jh_freeObject(obj);
-    free(str);
     // Leave
     return ret; 
 }
@@ -950,7 +956,7 @@ void htemp_addToGateway(void)
             #ifdef DEBUG_HAPCAN_TEMPERATURE_ERRORS
             if(!valid)
             {
-                debug_print("htemp_addToGateway: Module Information Error!\n");
+                debug_error("htemp_addToGateway: Module Information Error!\n");
             }
             #endif
             //-----------------------------------
@@ -1035,14 +1041,15 @@ void htemp_addToGateway(void)
  * Set a payload based on the data received, and add it to the MQTT Pub Buffer.       
  */
 int htemp_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp)
+        const void *context, unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
-    void* payload = NULL;
+    char payload[HAPCAN_MQTT_PAYLOAD_MAX_LEN];
     int payloadlen;
     // Set the payload
-    check = getTempPayload(hd_received, &payload, &payloadlen);
+    check = getTempPayload(hd_received, payload, sizeof(payload), 
+            &payloadlen);
     if(check == HAPCAN_MQTT_RESPONSE)
     {
         // Set MQTT Pub buffer
@@ -1051,8 +1058,6 @@ int htemp_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
             ret = hapcan_addToMQTTPubBuffer(state_str, payload, payloadlen, timestamp);
         }
     }
-    // Free
-    free(payload);
     // Return
     return ret;
 }
@@ -1061,8 +1066,9 @@ int htemp_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
  * Set a HAPCAN message based on the payload received, and add it to the CAN 
  * write Buffer.    
  */
-int htemp_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload, 
-        int payloadlen, unsigned long long timestamp)
+int htemp_setMQTT2CANResponse(hapcanCANData *hd_result, 
+        const void *context, void *payload, int payloadlen, 
+        unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
@@ -6,6 +6,36 @@
 //  1.00     | 19/Dec/2022 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - CAN2MQTT payload is written to a fixed size buffer                       //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - MQTT2CAN JSON commands are parsed with jh_parseFlatObject (no            //
+// allocation, no JSON lock)                                                  //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Register the module handlers with the gateway elements (called directly  //
+// on a match)                                                                //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - State topics of the list are interned (topic.c): shared with the         //
+// gateway and compared by pointer                                            //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_HAPCAN          //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - On a configuration reload, modules that did not change keep their        //
+// outputs and update flags (only new / removed modules are changed)          //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - Add hrgbw_walkModules / hrgbw_setModules (configuration cache)           //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
 
 /*
 * Includes
@@ -28,6 +58,7 @@
 #include "jsonhandler.h"
 #include "mqtt.h"
 #include "mqttbuf.h"
+#include "topic.h"
 
 //----------------------------------------------------------------------------//
 // INTERNAL DEFINITIONS
@@ -68,17 +99,18 @@ typedef struct rgbwList_t
     //------------------------
     bool isColourUpdated[RGBW_N_COLOURS];
     bool ignore;
+    bool stale;     // Not configured again since the reload started
     //------------------------
     // RGB State Topic
     //------------------------
-    char *rgb_state_str;
+    const char *rgb_state_str;   // interned
     //------------------------
     // Independent Channels State Topics
     //------------------------
-    char *channel1_state_str;
-    char *channel2_state_str;
-    char *channel3_state_str;
-    char *channel4_state_str;
+    const char *channel1_state_str;   // interned
+    const char *channel2_state_str;   // interned
+    const char *channel3_state_str;   // interned
+    const char *channel4_state_str;   // interned
     //------------------------
     // Linked List Control
     //------------------------
@@ -88,6 +120,12 @@ typedef struct rgbwList_t
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
+// Handlers called by the gateway for the elements added by this module
+static const gatewayHandler g_hrgbw_handler = 
+{
+    hrgbw_setCAN2MQTTResponse,
+    hrgbw_setMQTT2CANResponse
+};
 static pthread_mutex_t g_rgbw_mutex = PTHREAD_MUTEX_INITIALIZER;
 static rgbwList_t* g_hrgbw_head = NULL;
 static int g_lastSentNode;
@@ -102,7 +140,9 @@ static void rgbwl_clearElementData(rgbwList_t* element);
 static void rgbwl_freeElementData(rgbwList_t* element);
 static void rgbwl_addToList(rgbwList_t* element);
 static rgbwList_t* rgbwl_getFromOffset(int offset);    // NULL means error
-static void rgbwl_deleteList(void);
+static void rgbwl_setStale(void);
+static void rgbwl_deleteStale(void);
+static rgbwList_t* rgbwl_getStale(int node, int group, bool isRGBW);
 static void rgbwl_addElementToList(int node, int group, bool isRGBW, 
         bool isRGB, char *rgb_state_str, char *channel1_state_str, 
         char *channel2_state_str, char *channel3_state_str, 
@@ -114,7 +154,7 @@ static void rgbwl_printElementData(rgbwList_t* element);
 static void rgbw_addRGBWChannelToGateway(int node, int group, bool isRGBW, 
         bool isRGB, int channel, char *state_str, char *command_str);
 static int rgbw_getRGBWPayload(char *state_str, hapcanCANData *hd_received, 
-        void** payload, int *payloadlen);
+        int channel, char* payload, unsigned int size, int *payloadlen);
 static int rgbw_checkAndSendCAN(void);
 
 //------------------------------------------------------------------------------
@@ -136,11 +176,11 @@ static void rgbwl_clearElementData(rgbwList_t* element)
 static void rgbwl_freeElementData(rgbwList_t* element)
 {
     // Free pointers
-    free(element->rgb_state_str);    
-    free(element->channel1_state_str);    
-    free(element->channel2_state_str);    
-    free(element->channel3_state_str);    
-    free(element->channel4_state_str);
+    topic_release(element->rgb_state_str);    
+    topic_release(element->channel1_state_str);    
+    topic_release(element->channel2_state_str);    
+    topic_release(element->channel3_state_str);    
+    topic_release(element->channel4_state_str);
     element->rgb_state_str = NULL;
     element->channel1_state_str = NULL;
     element->channel2_state_str = NULL;
@@ -153,7 +193,6 @@ static void rgbwl_addToList(rgbwList_t* element)
 {
     rgbwList_t *link;
     int i;
-    unsigned int len;
     // Create a new element to the list
     link = (rgbwList_t*)malloc(sizeof(*link));	
     // Copy structure data
@@ -162,69 +201,25 @@ static void rgbwl_addToList(rgbwList_t* element)
     link->isRGB = element->isRGB;
     link->isRGBW = element->isRGBW;
     link->ignore = element->ignore;
+    link->stale = false;
     for(i = 0; i < RGBW_N_COLOURS; i++)
     {
         link->colour[i] = element->colour[i];
         link->isColourUpdated[i] = element->isColourUpdated[i];
     }
     //---------------------
-    // Copy strings
+    // Strings (interned topics) are handed over to the list
     //---------------------
     // RGB State
-    if(element->rgb_state_str != NULL)
-    {
-        len = strlen(element->rgb_state_str);
-        link->rgb_state_str = malloc(len + 1);
-        strcpy(link->rgb_state_str, element->rgb_state_str);
-    }
-    else
-    {
-        link->rgb_state_str = NULL;
-    }
+    link->rgb_state_str = element->rgb_state_str;
     // Channel 1 State
-    if(element->channel1_state_str != NULL)
-    {
-        len = strlen(element->channel1_state_str);
-        link->channel1_state_str = malloc(len + 1);
-        strcpy(link->channel1_state_str, element->channel1_state_str);
-    }
-    else
-    {
-        link->channel1_state_str = NULL;
-    }
+    link->channel1_state_str = element->channel1_state_str;
     // Channel 2 State
-    if(element->channel2_state_str != NULL)
-    {
-        len = strlen(element->channel2_state_str);
-        link->channel2_state_str = malloc(len + 1);
-        strcpy(link->channel2_state_str, element->channel2_state_str);
-    }
-    else
-    {
-        link->channel2_state_str = NULL;
-    }
+    link->channel2_state_str = element->channel2_state_str;
     // Channel 3 State
-    if(element->channel3_state_str != NULL)
-    {
-        len = strlen(element->channel3_state_str);
-        link->channel3_state_str = malloc(len + 1);
-        strcpy(link->channel3_state_str, element->channel3_state_str);
-    }
-    else
-    {
-        link->channel3_state_str = NULL;
-    }
+    link->channel3_state_str = element->channel3_state_str;
     // Channel 4 State
-    if(element->channel4_state_str != NULL)
-    {
-        len = strlen(element->channel4_state_str);
-        link->channel4_state_str = malloc(len + 1);
-        strcpy(link->channel4_state_str, element->channel4_state_str);
-    }
-    else
-    {
-        link->channel4_state_str = NULL;
-    }
+    link->channel4_state_str = element->channel4_state_str;
     // Set next in list to previous g_hrgbw_header (previous first node)
     link->next = g_hrgbw_head;	
     // Point g_hrgbw_header (first node) to current element (new first node)
@@ -255,33 +250,51 @@ static rgbwList_t* rgbwl_getFromOffset(int offset)
     return current;
 }
 
-// Delete list
-static void rgbwl_deleteList(void)
+// Mark every element as stale (configuration reload)
+static void rgbwl_setStale(void)
 {
     rgbwList_t* current;
-    rgbwList_t* next;
-    // Check all
-    current = g_hrgbw_head;
-    while(current != NULL) 
+    for(current = g_hrgbw_head; current != NULL; current = current->next) 
     {
-        //*******************************//
-        // Get next structure address    //
-        //*******************************//
-        next = current->next;
-        //*******************************//
-        // Free fields that are pointers //
-        //*******************************//
-        rgbwl_freeElementData(current);
-        //*******************************//
-        // Free structure itself         //
-        //*******************************//
-        free(current);
-        //*******************************//
-        // Get new current address       //
-        //*******************************//
-        current = next;
-        g_hrgbw_head = current;
-    }    
+        current->stale = true;
+    }
+}
+
+// Delete the elements that were not configured again
+static void rgbwl_deleteStale(void)
+{
+    rgbwList_t** link;
+    rgbwList_t* current;
+    link = &g_hrgbw_head;
+    while(*link != NULL) 
+    {
+        current = *link;
+        if(current->stale)
+        {
+            *link = current->next;
+            rgbwl_freeElementData(current);
+            free(current);
+        }
+        else
+        {
+            link = &current->next;
+        }
+    }
+}
+
+// Get a stale element of a module (same node, group and type)
+static rgbwList_t* rgbwl_getStale(int node, int group, bool isRGBW)
+{
+    rgbwList_t* current;
+    for(current = g_hrgbw_head; current != NULL; current = current->next) 
+    {
+        if(current->stale && (current->node == node) && 
+                (current->group == group) && (current->isRGBW == isRGBW))
+        {
+            break;
+        }
+    }
+    return current;
 }
 
 // Add elements to the List
@@ -291,8 +304,23 @@ static void rgbwl_addElementToList(int node, int group, bool isRGBW,
         char *channel4_state_str)
 {
     rgbwList_t element;
+    rgbwList_t* current;
     int i;
-    unsigned int len;
+    //-----------------------------
+    // Module already in the list: keep outputs and flags, update the topics
+    //-----------------------------
+    current = rgbwl_getStale(node, group, isRGBW);
+    if((current != NULL) && (current->isRGB == isRGB))
+    {
+        rgbwl_freeElementData(current);
+        current->rgb_state_str = topic_intern(rgb_state_str);
+        current->channel1_state_str = topic_intern(channel1_state_str);
+        current->channel2_state_str = topic_intern(channel2_state_str);
+        current->channel3_state_str = topic_intern(channel3_state_str);
+        current->channel4_state_str = topic_intern(channel4_state_str);
+        current->stale = false;
+        return;
+    }
     rgbwl_clearElementData(&element);
     element.group = group;
     element.node = node;
@@ -305,47 +333,20 @@ static void rgbwl_addElementToList(int node, int group, bool isRGBW,
     }
     element.ignore = false;
     //-----------------------------
-    // Copy strings
+    // Get the interned topics
     //-----------------------------
     // RGB State
-    if(rgb_state_str != NULL)
-    {
-        len = strlen(rgb_state_str);
-        element.rgb_state_str = malloc(len + 1);
-        strcpy(element.rgb_state_str, rgb_state_str);
-    }
+    element.rgb_state_str = topic_intern(rgb_state_str);
     // Channel 1 State
-    if(channel1_state_str != NULL)
-    {
-        len = strlen(channel1_state_str);
-        element.channel1_state_str = malloc(len + 1);
-        strcpy(element.channel1_state_str, channel1_state_str);
-    }
+    element.channel1_state_str = topic_intern(channel1_state_str);
     // Channel 2 State
-    if(channel2_state_str != NULL)
-    {
-        len = strlen(channel2_state_str);
-        element.channel2_state_str = malloc(len + 1);
-        strcpy(element.channel2_state_str, channel2_state_str);
-    }
+    element.channel2_state_str = topic_intern(channel2_state_str);
     // Channel 3 State
-    if(channel3_state_str != NULL)
-    {
-        len = strlen(channel3_state_str);
-        element.channel3_state_str = malloc(len + 1);
-        strcpy(element.channel3_state_str, channel3_state_str);
-    }
+    element.channel3_state_str = topic_intern(channel3_state_str);
     // Channel 4 State
-    if(channel4_state_str != NULL)
-    {
-        len = strlen(channel4_state_str);
-        element.channel4_state_str = malloc(len + 1);
-        strcpy(element.channel4_state_str, channel4_state_str);
-    }
+    element.channel4_state_str = topic_intern(channel4_state_str);
     // Add
     rgbwl_addToList(&element);
-    // Free temp data and then return
-    rgbwl_freeElementData(&element);
 }
 
 // Debug elements
@@ -353,59 +354,60 @@ static void rgbwl_addElementToList(int node, int group, bool isRGBW,
 static void rgbwl_printElementData(rgbwList_t* element)
 {    
     int i;
-    debug_print("rgbwl_printElementData:\n");
-    debug_print(" - element->node: %d\n", element->node);
-    debug_print(" - element->group: %d\n", element->group);
-    debug_print(" - element->isRGB: %d\n", element->isRGB);
-    debug_print(" - element->isRGBW: %d\n", element->isRGBW);
+    debug_verbose("rgbwl_printElementData:\n");
+    debug_verbose(" - element->node: %d\n", element->node);
+    debug_verbose(" - element->group: %d\n", element->group);
+    debug_verbose(" - element->isRGB: %d\n", element->isRGB);
+    debug_verbose(" - element->isRGBW: %d\n", element->isRGBW);
     if(element->rgb_state_str != NULL)
     {
-        debug_print(" - element->rgb_state_str: %s\n", element->rgb_state_str);
+        debug_verbose(" - element->rgb_state_str: %s\n", 
+                element->rgb_state_str);
     }
     else
     {
-        debug_print(" - element->rgb_state_str: NULL\n");
+        debug_verbose(" - element->rgb_state_str: NULL\n");
     }
     if(element->channel1_state_str != NULL)
     {
-        debug_print(" - element->channel1_state_str: %s\n", element->channel1_state_str);
+        debug_verbose(" - element->channel1_state_str: %s\n", element->channel1_state_str);
     }
     else
     {
-        debug_print(" - element->channel1_state_str: NULL\n");
+        debug_verbose(" - element->channel1_state_str: NULL\n");
     }
     if(element->channel2_state_str != NULL)
     {
-        debug_print(" - element->channel2_state_str: %s\n", element->channel2_state_str);
+        debug_verbose(" - element->channel2_state_str: %s\n", element->channel2_state_str);
     }
     else
     {
-        debug_print(" - element->channel2_state_str: NULL\n");
+        debug_verbose(" - element->channel2_state_str: NULL\n");
     }
     if(element->channel3_state_str != NULL)
     {
-        debug_print(" - element->channel3_state_str: %s\n", element->channel3_state_str);
+        debug_verbose(" - element->channel3_state_str: %s\n", element->channel3_state_str);
     }
     else
     {
-        debug_print(" - element->channel3_state_str: NULL\n");
+        debug_verbose(" - element->channel3_state_str: NULL\n");
     }
     if(element->channel4_state_str != NULL)
     {
-        debug_print(" - element->channel4_state_str: %s\n", element->channel4_state_str);
+        debug_verbose(" - element->channel4_state_str: %s\n", element->channel4_state_str);
     }
     else
     {
-        debug_print(" - element->channel4_state_str: NULL\n");
+        debug_verbose(" - element->channel4_state_str: NULL\n");
     }
     for(i = 0; i < RGBW_N_COLOURS; i++)
     {
-        debug_print(" - element->isColourUpdated[%d]: %d\n", i, 
+        debug_verbose(" - element->isColourUpdated[%d]: %d\n", i, 
                 element->isColourUpdated[i]);
     }
     for(i = 0; i < RGBW_N_COLOURS; i++)
     {
-        debug_print(" - element->colour[%d]: %d\n", i, element->colour[i]);
+        debug_verbose(" - element->colour[%d]: %d\n", i, element->colour[i]);
     }    
 }
 #endif
@@ -457,11 +459,11 @@ static void rgbw_addRGBWChannelToGateway(int node, int group, bool isRGBW,
     if(!valid)
     {
         #ifdef DEBUG_RGBW_ERRORS
-        debug_print("rgbw_addRGBWChannelToGateway - parameter error!\n");
-        debug_print("rgbw_addRGBWChannelToGateway - node:%d!\n", node);
-        debug_print("rgbw_addRGBWChannelToGateway - group:%d!\n", group);
-        debug_print("rgbw_addRGBWChannelToGateway - channel:%d!\n", channel);
-        debug_print("rgbw_addRGBWChannelToGateway - isRGBW:%d!\n", isRGBW);
+        debug_error("rgbw_addRGBWChannelToGateway - parameter error!\n");
+        debug_error("rgbw_addRGBWChannelToGateway - node:%d!\n", node);
+        debug_error("rgbw_addRGBWChannelToGateway - group:%d!\n", group);
+        debug_error("rgbw_addRGBWChannelToGateway - channel:%d!\n", channel);
+        debug_error("rgbw_addRGBWChannelToGateway - isRGBW:%d!\n", isRGBW);
         #endif
     }
     else
@@ -498,11 +500,12 @@ static void rgbw_addRGBWChannelToGateway(int node, int group, bool isRGBW,
         hd_check.data[2] = channel;        
         // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
         check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, &hd_mask, 
-            &hd_check, state_str, NULL, &hd_result);
+            &hd_check, state_str, NULL, &hd_result, 
+            &g_hrgbw_handler, &channel, sizeof(channel));
         if(check != EXIT_SUCCESS)
         {
             #ifdef DEBUG_RGBW_ERRORS
-            debug_print("rgbw_addRGBWChannelToGateway: Error "
+            debug_error("rgbw_addRGBWChannelToGateway: Error "
                     "adding to CAN2MQTT!\n");
             #endif
         }
@@ -531,11 +534,12 @@ static void rgbw_addRGBWChannelToGateway(int node, int group, bool isRGBW,
             hd_result.data[3] = group;        
             // Add to list CAN2MQTT: command_str, hd_result
             check = gateway_AddElementToList(GATEWAY_MQTT2CAN_LIST, &hd_mask, 
-                &hd_check, NULL, command_str, &hd_result);
+                &hd_check, NULL, command_str, &hd_result, 
+                &g_hrgbw_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_RGBW_ERRORS
-                debug_print("rgbw_addRGBWChannelToGateway: Error adding "
+                debug_error("rgbw_addRGBWChannelToGateway: Error adding "
                         "to MQTT2CAN!\n");
                 #endif
             }
@@ -547,8 +551,9 @@ static void rgbw_addRGBWChannelToGateway(int node, int group, bool isRGBW,
  * Set a payload based on the data received
  * 
  * \param   hd_received     (INPUT) pointer to HAPCAN message received
- * \param   hd_received     (INPUT) pointer to HAPCAN message received
- * \param   payload         (OUTPUT) payload to be filled
+ * \param   channel         (INPUT) channel of the matched gateway element
+ * \param   payload         (OUTPUT) payload buffer to be filled
+ * \param   size            (INPUT) size of the payload buffer
  * \param   payloadlen      (OUTPUT) payloadlen to be filled
  *                      
  * \return  HAPCAN_MQTT_RESPONSE: Payload set (OK)
@@ -557,12 +562,11 @@ static void rgbw_addRGBWChannelToGateway(int node, int group, bool isRGBW,
  *          
  */
 static int rgbw_getRGBWPayload(char *state_str, hapcanCANData *hd_received, 
-        void** payload, int *payloadlen)
+        int channel, char* payload, unsigned int size, int *payloadlen)
 {
     int ret = HAPCAN_RESPONSE_ERROR;
     int node;
     int group;
-    int channel;
     bool match;
     bool isRGBState;
     bool isChannel1State;
@@ -575,12 +579,10 @@ static int rgbw_getRGBWPayload(char *state_str, hapcanCANData *hd_received,
     int temp[RGBW_MASTER];
     bool test;
     int len;
-    char str[20]; // 255,255,255,255/0
     int n_colors;
-    // Get node, group and channel from received message
+    // Get node and group from received message (channel is from the gateway)
     node = hd_received->module;
     group = hd_received->group;
-    channel = hd_received->data[2];
     if(channel < 1 || channel > RGBW_N_COLOURS)
     {
         // Channel error
@@ -633,15 +635,11 @@ static int rgbw_getRGBWPayload(char *state_str, hapcanCANData *hd_received,
         else
         {
             // Check if state topic is for RGB status
-            isRGBState = aux_compareStrings(element.rgb_state_str, state_str);
-            isChannel1State = aux_compareStrings(element.channel1_state_str, 
-                state_str);
-            isChannel2State = aux_compareStrings(element.channel2_state_str, 
-                state_str);
-            isChannel3State = aux_compareStrings(element.channel3_state_str, 
-                state_str);
-            isChannel4State = aux_compareStrings(element.channel4_state_str, 
-                state_str);
+            isRGBState = (element.rgb_state_str == state_str);
+            isChannel1State = (element.channel1_state_str == state_str);
+            isChannel2State = (element.channel2_state_str == state_str);
+            isChannel3State = (element.channel3_state_str == state_str);
+            isChannel4State = (element.channel4_state_str == state_str);
             // Check if single channel
             if( (!element.isRGBW && !element.isRGB) || 
                 (!element.isRGBW && element.isRGB && !isRGBState) )
@@ -691,12 +689,9 @@ static int rgbw_getRGBWPayload(char *state_str, hapcanCANData *hd_received,
                         temp[0] = temp[0] * (element.colour[RGBW_MASTER] + 1);
                         temp[0] = temp[0] >> 8;
                     }                    
-                    // Add to temp string
-                    snprintf(str, 4, "%d", temp[0]);
-                    len = strlen(str);
-                    // Set payload and payloadlen
-                    *payload = malloc(len + 1);
-                    strcpy(*payload, str);
+                    // Set payload
+                    len = snprintf(payload, size, "%d", temp[0]);
+                    // Set payloadlen
                     *payloadlen = len;
                     ret = HAPCAN_MQTT_RESPONSE;
                 }
@@ -754,24 +749,18 @@ static int rgbw_getRGBWPayload(char *state_str, hapcanCANData *hd_received,
                     else if( n_colors == (RGBW_N_COLOURS - 1) )
                     {
                         // 255,255,255,255/0                        
-                        snprintf(str, 16, "%d,%d,%d,%d", temp[0], temp[1], 
+                        len = snprintf(payload, size, "%d,%d,%d,%d", temp[0], temp[1], 
                                 temp[2], temp[3]);
-                        len = strlen(str); 
-                        // Set payload and payloadlen
-                        *payload = malloc(len + 1);
-                        strcpy(*payload, str);
+                        // Set payloadlen
                         *payloadlen = len;
                         ret = HAPCAN_MQTT_RESPONSE;
                     }
                     else if( n_colors == (RGBW_N_COLOURS - 2) )
                     {
                         // 255,255,255/0
-                        snprintf(str, 16, "%d,%d,%d", temp[0], temp[1], 
+                        len = snprintf(payload, size, "%d,%d,%d", temp[0], temp[1], 
                                 temp[2]);
-                        len = strlen(str); 
-                        // Set payload and payloadlen
-                        *payload = malloc(len + 1);
-                        strcpy(*payload, str);
+                        // Set payloadlen
                         *payloadlen = len;
                         ret = HAPCAN_MQTT_RESPONSE;
                     }                    
@@ -834,7 +823,7 @@ static int rgbw_checkAndSendCAN(void)
                     if(g_lastSentCount >= HAPCAN_CAN_STATUS_SEND_RETRIES)
                     {                                        
                         #ifdef DEBUG_RGBW_ERRORS
-                        debug_print("INFO: rgbw_checkAndSendCAN: Module is not "
+                        debug_error("INFO: rgbw_checkAndSendCAN: Module is not "
                                 "responding - Node = %d, Group = %d!\n", 
                                 node, group);
                         #endif
@@ -908,12 +897,12 @@ void hrgbw_addToGateway(void)
     bool valid;
     bool configured[RGBW_N_COLOURS];
     //---------------------------------------------
-    // Delete and Add to list: PROTECTED
+    // Update list: PROTECTED
     //---------------------------------------------
     // LOCK LIST
     pthread_mutex_lock(&g_rgbw_mutex);
-    // Delete
-    rgbwl_deleteList();
+    // Modules not configured again are deleted at the end
+    rgbwl_setStale();
     // UNLOCK LIST
     pthread_mutex_unlock(&g_rgbw_mutex);
     // Add to list
@@ -967,7 +956,7 @@ void hrgbw_addToGateway(void)
                 #ifdef DEBUG_RGBW_ERRORS
                 if(!valid)
                 {
-                    debug_print("INFO: hrgbw_addToGateway: isRGBW check "
+                    debug_error("INFO: hrgbw_addToGateway: isRGBW check "
                             "Error - module %d - n_RGBWchannels %d - "
                             "n_RGBchannels %d!\n", i_module, n_RGBWchannels, 
                             n_RGBchannels);
@@ -983,7 +972,7 @@ void hrgbw_addToGateway(void)
                 #ifdef DEBUG_RGBW_ERRORS
                 if(!valid)
                 {
-                    debug_print("INFO: hrgbw_addToGateway: isRGB check "
+                    debug_error("INFO: hrgbw_addToGateway: isRGB check "
                             "Error - module %d!\n", i_module);
                 }
                 #endif
@@ -1012,7 +1001,7 @@ void hrgbw_addToGateway(void)
                 #ifdef DEBUG_RGBW_ERRORS
                 if(!valid)
                 {
-                    debug_print("INFO: hrgbw_addToGateway: single channels "
+                    debug_error("INFO: hrgbw_addToGateway: single channels "
                             "check Error - module %d - n_RGBWchannels %d - "
                             "n_RGBchannels %d!\n", i_module, n_RGBWchannels, 
                             n_RGBchannels);
@@ -1101,7 +1090,7 @@ void hrgbw_addToGateway(void)
                     #ifdef DEBUG_RGBW_ERRORS
                     if(!valid)
                     {
-                        debug_print("INFO: hrgbw_addToGateway: single channels "
+                        debug_error("INFO: hrgbw_addToGateway: single channels "
                                 "duplication / wrong colour Error - module %d "
                                 "- n_RGBWchannels %d - n_RGBchannels %d!\n", 
                                 i_module, n_RGBWchannels, n_RGBchannels);
@@ -1183,7 +1172,7 @@ void hrgbw_addToGateway(void)
                     #ifdef DEBUG_RGBW_ERRORS
                     if(!valid)
                     {
-                        debug_print("INFO: hrgb_addToGateway: RGBW channel "
+                        debug_error("INFO: hrgb_addToGateway: RGBW channel "
                                 "check Error - module %d!\n", i_module);
                     }
                     #endif
@@ -1348,20 +1337,86 @@ void hrgbw_addToGateway(void)
             command_str = NULL;
         }
     }    
+    //---------------------------------------------
+    // Delete modules removed from the configuration
+    //---------------------------------------------
+    // LOCK LIST
+    pthread_mutex_lock(&g_rgbw_mutex);
+    rgbwl_deleteStale();
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_rgbw_mutex);
+}
+
+/**
+ * Call a function for each module of the RGBW list
+ */
+void hrgbw_walkModules(hrgbwWalkFn fn, void *arg)
+{
+    rgbwList_t* current;
+    hrgbwModule module;
+    // LOCK LIST
+    pthread_mutex_lock(&g_rgbw_mutex);
+    for(current = g_hrgbw_head; current != NULL; current = current->next) 
+    {
+        module.node = current->node;
+        module.group = current->group;
+        module.isRGBW = current->isRGBW;
+        module.isRGB = current->isRGB;
+        module.state_str[0] = current->rgb_state_str;
+        module.state_str[1] = current->channel1_state_str;
+        module.state_str[2] = current->channel2_state_str;
+        module.state_str[3] = current->channel3_state_str;
+        module.state_str[4] = current->channel4_state_str;
+        fn(&module, arg);
+    }
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_rgbw_mutex);
+}
+
+/**
+ * Set the RGBW list from a module table
+ */
+void hrgbw_setModules(const hrgbwModule *modules, int n)
+{
+    int i;
+    // LOCK LIST
+    pthread_mutex_lock(&g_rgbw_mutex);
+    rgbwl_setStale();
+    for(i = 0; i < n; i++)
+    {
+        rgbwl_addElementToList(modules[i].node, modules[i].group, 
+                modules[i].isRGBW, modules[i].isRGB, 
+                (char *)modules[i].state_str[0],
+                (char *)modules[i].state_str[1],
+                (char *)modules[i].state_str[2],
+                (char *)modules[i].state_str[3],
+                (char *)modules[i].state_str[4]);
+    }
+    rgbwl_deleteStale();
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_rgbw_mutex);
 }
 
 /**
  * Set a payload based on the data received, and add it to the MQTT Pub Buffer.       
  */
 int hrgbw_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp)
+        const void *context, unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
-    void* payload = NULL;
+    char payload[HAPCAN_MQTT_PAYLOAD_MAX_LEN];
     int payloadlen;
+    const int *channel;
+    // Channel is the context registered with the gateway element
+    channel = (const int *)context;
+    if(channel == NULL)
+    {
+        return HAPCAN_RESPONSE_ERROR;
+    }
     // Set the payload
-    check = rgbw_getRGBWPayload(state_str, hd_received, &payload, &payloadlen);
+    check = rgbw_getRGBWPayload(state_str, hd_received, *channel, payload, 
+            sizeof(payload), &payloadlen);
     if(check == HAPCAN_MQTT_RESPONSE)
     {
         // Set MQTT Pub buffer
@@ -1371,8 +1426,6 @@ int hrgbw_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
                     timestamp);
         }
     }
-    // Free
-    free(payload);
     // Return
     return ret;
 }
@@ -1381,14 +1434,15 @@ int hrgbw_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
  * Set a HAPCAN message based on the payload received, and add it to the CAN 
  * write Buffer.    
  */
-int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload, 
-        int payloadlen, unsigned long long timestamp)
+int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, 
+        const void *context, void *payload, int payloadlen, 
+        unsigned long long timestamp)
 {
     int ret = HAPCAN_RESPONSE_ERROR;
     int channel;    
     long val;
-    char *str = NULL;    
-    json_object *obj = NULL;
+    char str[HAPCAN_MQTT_COMMAND_STR_LEN];
+    jsonFlatObject obj;
     bool valid = true;
     int temp;
     int colors[RGBW_N_COLOURS];
@@ -1421,9 +1475,7 @@ int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
     else
     {
         // Copy payload to str
-        str = malloc(payloadlen + 1);
-        memcpy(str, payload, payloadlen);
-        str[payloadlen] = 0;
+        aux_getPayloadString(payload, payloadlen, str, sizeof(str));
         // Set the frame as direct control
         hd_result->frametype = HAPCAN_DIRECT_CONTROL_FRAME_TYPE;
         if(!isRGBW && !isRGB)
@@ -1687,13 +1739,13 @@ int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
             else
             {
                 // Check for JSON - Get the JSON Object
-                jh_getObject(str, &obj);
+                check = jh_parseFlatObject(payload, payloadlen, &obj);
                 // Check if error parsing
-                if(obj != NULL)
+                if(check == JSON_OK)
                 {
                     valid = true;
                     // INSTR1
-                    check = jh_getObjectFieldAsInt(obj, "INSTR1", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR1", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1701,7 +1753,7 @@ int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
                         hd_result->data[0] = (uint8_t)temp;
                     }
                     // INSTR2
-                    check = jh_getObjectFieldAsInt(obj, "INSTR2", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR2", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1709,7 +1761,7 @@ int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
                         hd_result->data[1] = (uint8_t)temp;
                     }
                     // INSTR3
-                    check = jh_getObjectFieldAsInt(obj, "INSTR3", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR3", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1717,7 +1769,7 @@ int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
                         hd_result->data[4] = (uint8_t)temp;
                     }
                     // INSTR4
-                    check = jh_getObjectFieldAsInt(obj, "INSTR4", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR4", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1725,7 +1777,7 @@ int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
                         hd_result->data[5] = (uint8_t)temp;
                     }
                     // INSTR5
-                    check = jh_getObjectFieldAsInt(obj, "INSTR5", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR5", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1733,7 +1785,7 @@ int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
                         hd_result->data[6] = (uint8_t)temp;
                     }
                     // INSTR6
-                    check = jh_getObjectFieldAsInt(obj, "INSTR6", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR6", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -1751,9 +1803,6 @@ int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload,
     {
         ret = HAPCAN_RESPONSE_ERROR;
     }    
-    // Free
-    jh_freeObject(obj);
-    free(str);
     // Leave
     return ret;
 }
@@ -6,6 +6,13 @@
 //  1.00     | 19/Dec/2022 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Module handlers receive the per-channel context registered with the      //
+// gateway element                                                            //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add hrgbw_walkModules / hrgbw_setModules (configuration cache)           //
+//----------------------------------------------------------------------------//
 
 #ifndef HRGBW_H
 #define HRGBW_H
@@ -22,12 +29,28 @@ extern "C" {
 //----------------------------------------------------------------------------//
 // EXTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//    
-
+/* State topics of a module: RGB state, channel 1 to 4 */
+#define HRGBW_MODULE_TOPICS     5
     
 //----------------------------------------------------------------------------//
 // EXTERNAL TYPES
 //----------------------------------------------------------------------------//
+// Module of the RGBW list (configuration cache)
+typedef struct
+{
+    int node;
+    int group;
+    bool isRGBW;
+    bool isRGB;
+    const char *state_str[HRGBW_MODULE_TOPICS];    // NULL if not used
+} hrgbwModule;
 
+/**
+ * Function called for each module by hrgbw_walkModules
+ * \param   module  (INPUT) module data (valid only during the call)
+ * \param   arg     (INPUT) argument given to hrgbw_walkModules
+ */
+typedef void (*hrgbwWalkFn)(const hrgbwModule *module, void *arg);
     
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
@@ -38,10 +61,30 @@ extern "C" {
  */
 void hrgbw_addToGateway(void);
 
+/**
+ * Call a function for each module of the RGBW list (the list is locked during 
+ * the walk).
+ * 
+ * \param   fn      (INPUT) function called for each module
+ * \param   arg     (INPUT) argument passed to the function
+ */
+void hrgbw_walkModules(hrgbwWalkFn fn, void *arg);
+
+/**
+ * Set the RGBW list from a module table, instead of the configuration file 
+ * (the gateway elements are not added). Modules that were already in the list 
+ * keep their outputs and update flags.
+ * 
+ * \param   modules (INPUT) module table
+ * \param   n       (INPUT) number of modules
+ */
+void hrgbw_setModules(const hrgbwModule *modules, int n);
+
 /**
  * Set a payload based on the data received, and add it to the MQTT Pub Buffer.
  * \param   state_str       (INPUT) string with the MQTT State Topic
  * \param   hd_received     (INPUT) pointer to HAPCAN message received
+ * \param   context         (INPUT) context registered with the gateway element
  * \param   timestamp       (INPUT) timestamp of the CAN message
  *                      
  * \return  HAPCAN_NO_RESPONSE: No response was added to MQTT Pub Buffer
@@ -51,12 +94,13 @@ void hrgbw_addToGateway(void);
  *          
  */
 int hrgbw_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp);
+        const void *context, unsigned long long timestamp);
 
 /**
  * Set a HAPCAN message based on the payload received, and add it to the CAN 
  * write Buffer.
  * \param   hd_result   (INPUT) matched results from the gateway
+ * \param   context     (INPUT) context registered with the gateway element
  * \param   payload     (INPUT) received MQTT Payload
  * \param   payloadlen  (INPUT) received MQTT Payload Length
  * \param   timestamp   (INPUT) timestamp of the CAN message
@@ -67,8 +111,9 @@ int hrgbw_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
  *          HAPCAN_RESPONSE_ERROR: Other error
  *          
  */
-int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload, 
-        int payloadlen, unsigned long long timestamp);
+int hrgbw_setMQTT2CANResponse(hapcanCANData *hd_result, 
+        const void *context, void *payload, int payloadlen, 
+        unsigned long long timestamp);
 
 /**
  * To be called periodically to check and update the RGB modules status.
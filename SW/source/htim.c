@@ -6,6 +6,25 @@
 //  1.00     | 18/Jun/2023 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - CAN2MQTT payloads are written to a fixed size buffer                     //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - MQTT2CAN JSON commands are parsed with jh_parseFlatObject (no            //
+// allocation, no JSON lock)                                                  //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Register the module handlers with the gateway elements (called directly  //
+// on a match)                                                                //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_HAPCAN          //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_HAPCAN
 
 /*
 * Includes
@@ -47,6 +66,12 @@ enum TemperatureSensors
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
+// Handlers called by the gateway for the elements added by this module
+static const gatewayHandler g_htim_handler = 
+{
+    htim_setCAN2MQTTResponse,
+    htim_setMQTT2CANResponse
+};
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS
@@ -58,8 +83,8 @@ static void htiml_addThermostatModuleToGateway(int node, int group,
 static void htiml_addTErrorModuleToGateway(int node, int group, 
                 int channel, char *state_str);
 static void htiml_addIRModuleToGateway(int node, int group, char *command_str);
-static int htiml_getTempPayload(hapcanCANData *hd_received, void** payload, 
-        int *payloadlen);
+static int htiml_getTempPayload(hapcanCANData *hd_received, char* payload, 
+        unsigned int size, int *payloadlen);
 static int htiml_getTempHAPCANFrame(void *payload, int payloadlen, 
         hapcanCANData *hd_result);
 
@@ -97,7 +122,7 @@ static void htiml_addTemperatureModuleToGateway(int node, int group,
     if(!valid)
     {
         #ifdef DEBUG_TIM_ERRORS
-        debug_print("htiml_addTemperatureModuleToGateway: parameter error!\n");
+        debug_error("htiml_addTemperatureModuleToGateway: parameter error!\n");
         #endif
     }
     else
@@ -139,11 +164,12 @@ static void htiml_addTemperatureModuleToGateway(int node, int group,
             hd_check.data[2] = 0x17;
             // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
             check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, 
-                    &hd_mask, &hd_check, state_str, NULL, &hd_result);
+                    &hd_mask, &hd_check, state_str, NULL, &hd_result, 
+                    &g_htim_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_TIM_ERRORS
-                debug_print("htiml_addTemperatureModuleToGateway: Error adding "
+                debug_error("htiml_addTemperatureModuleToGateway: Error adding "
                         "to CAN2MQTT!\n");
                 #endif
             }
@@ -186,7 +212,7 @@ static void htiml_addThermostatModuleToGateway(int node, int group, int channel,
     if(!valid)
     {
         #ifdef DEBUG_TIM_ERRORS
-        debug_print("htiml_addThermostatModuleToGateway: parameter error!\n");
+        debug_error("htiml_addThermostatModuleToGateway: parameter error!\n");
         #endif
     }
     else
@@ -228,11 +254,12 @@ static void htiml_addThermostatModuleToGateway(int node, int group, int channel,
             hd_check.data[2] = 0x18;
             // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
             check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, &hd_mask, 
-                &hd_check, state_str, NULL, &hd_result);
+                &hd_check, state_str, NULL, &hd_result, 
+                &g_htim_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_TIM_ERRORS
-                debug_print("htiml_addThermostatModuleToGateway: Error adding "
+                debug_error("htiml_addThermostatModuleToGateway: Error adding "
                         "to CAN2MQTT!\n");
                 #endif
             }
@@ -266,11 +293,12 @@ static void htiml_addThermostatModuleToGateway(int node, int group, int channel,
             hd_result.data[5] = channel - 1;
             // Add to list CAN2MQTT: command_str, hd_result
             check = gateway_AddElementToList(GATEWAY_MQTT2CAN_LIST, &hd_mask, 
-                &hd_check, NULL, command_str, &hd_result);
+                &hd_check, NULL, command_str, &hd_result, 
+                &g_htim_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_TIM_ERRORS
-                debug_print("htiml_addThermostatModuleToGateway: Error adding "
+                debug_error("htiml_addThermostatModuleToGateway: Error adding "
                         "to MQTT2CAN!\n");
                 #endif
             }
@@ -312,7 +340,7 @@ static void htiml_addTErrorModuleToGateway(int node, int group, int channel,
     if(!valid)
     {
         #ifdef DEBUG_TIM_ERRORS
-        debug_print("htiml_addTErrorModuleToGateway: parameter error!\n");
+        debug_error("htiml_addTErrorModuleToGateway: parameter error!\n");
         #endif
     }
     else
@@ -354,11 +382,12 @@ static void htiml_addTErrorModuleToGateway(int node, int group, int channel,
             hd_check.data[2] = 0xF6;
             // Add to list CAN2MQTT: hd_mask, hd_check, state_topic
             check = gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, &hd_mask, 
-                &hd_check, state_str, NULL, &hd_result);
+                &hd_check, state_str, NULL, &hd_result, 
+                &g_htim_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_TIM_ERRORS
-                debug_print("htiml_addTErrorModuleToGateway: Error adding to "
+                debug_error("htiml_addTErrorModuleToGateway: Error adding to "
                         "CAN2MQTT!\n");
                 #endif
             }
@@ -397,7 +426,7 @@ static void htiml_addIRModuleToGateway(int node, int group, char *command_str)
     if(!valid)
     {
         #ifdef DEBUG_TIM_ERRORS
-        debug_print("htiml_addIRModuleToGateway: parameter error!\n");
+        debug_error("htiml_addIRModuleToGateway: parameter error!\n");
         #endif
     }
     else
@@ -443,11 +472,12 @@ static void htiml_addIRModuleToGateway(int node, int group, char *command_str)
             hd_result.data[3] = group;
             // Add to list CAN2MQTT: command_str, hd_result
             check = gateway_AddElementToList(GATEWAY_MQTT2CAN_LIST, &hd_mask, 
-                &hd_check, NULL, command_str, &hd_result);
+                &hd_check, NULL, command_str, &hd_result, 
+                &g_htim_handler, NULL, 0);
             if(check != EXIT_SUCCESS)
             {
                 #ifdef DEBUG_TIM_ERRORS
-                debug_print("htiml_addIRModuleToGateway: Error adding "
+                debug_error("htiml_addIRModuleToGateway: Error adding "
                         "to MQTT2CAN!\n");
                 #endif
             }
@@ -459,7 +489,8 @@ static void htiml_addIRModuleToGateway(int node, int group, char *command_str)
  * Set a payload based on the data received
  * 
  * \param   hd_received     (INPUT) pointer to HAPCAN message received
- * \param   payload         (OUTPUT) payload to be filled
+ * \param   payload         (OUTPUT) payload buffer to be filled
+ * \param   size            (INPUT) size of the payload buffer
  * \param   payloadlen      (OUTPUT) payloadlen to be filled
  *                      
  * \return  HAPCAN_MQTT_RESPONSE: Payload set (OK)
@@ -467,8 +498,8 @@ static void htiml_addIRModuleToGateway(int node, int group, char *command_str)
  *          HAPCAN_NO_RESPONSE: No response
  *          
  */
-static int htiml_getTempPayload(hapcanCANData *hd_received, void** payload, 
-        int *payloadlen)
+static int htiml_getTempPayload(hapcanCANData *hd_received, char* payload, 
+        unsigned int size, int *payloadlen)
 {
     // D2 is Type of Temperature message:
     //    - 0x17 – current temperature
@@ -476,9 +507,8 @@ static int htiml_getTempPayload(hapcanCANData *hd_received, void** payload,
     //    - 0xF6 – temperature error
     int ret = HAPCAN_MQTT_RESPONSE;
     int pair;
-    char *str;
     jsonFieldData j_arr[5];    
-    unsigned int len;
+    int len;
     int16_t i;
     double calc;
     switch(hd_received->data[2])
@@ -508,23 +538,17 @@ static int htiml_getTempPayload(hapcanCANData *hd_received, void** payload,
             j_arr[pair].value_type = JSON_TYPE_DOUBLE;
             j_arr[pair].double_value = calc;
             pair++;
-            jh_getStringFromFieldValuePairs(j_arr, pair, &str);
-            len = strlen(str);
-            if(len > 0)
+            len = jh_formatFieldValuePairs(j_arr, pair, payload, size);
+            if((len > 0) && (len < (int)size))
             {
-                *payload = malloc(len + 1);
-                strcpy(*payload, str);
                 ret = HAPCAN_MQTT_RESPONSE;
                 *payloadlen = len; 
             }
             else
             {
-                *payload = NULL;
                 *payloadlen = 0;
                 ret = HAPCAN_RESPONSE_ERROR;
             }
-            // free
-            free(str);
             break;
         //-------------------------------------------
         // Thermostat Frame
@@ -541,50 +565,41 @@ static int htiml_getTempPayload(hapcanCANData *hd_received, void** payload,
             {
                 j_arr[pair].field = "State";            
                 j_arr[pair].value_type = JSON_TYPE_STRING;
-                j_arr[pair].str_value = "OFF";
+                j_arr[pair].str_value = HAPCAN_PAYLOAD_OFF;
                 pair++;
             }
             else if(hd_received->data[7] == 0xFF)
             {
                 j_arr[pair].field = "State";            
                 j_arr[pair].value_type = JSON_TYPE_STRING;
-                j_arr[pair].str_value = "ON";
+                j_arr[pair].str_value = HAPCAN_PAYLOAD_ON;
                 pair++;
             }
-            jh_getStringFromFieldValuePairs(j_arr, pair, &str);
-            len = strlen(str);
-            if(len > 0)
+            len = jh_formatFieldValuePairs(j_arr, pair, payload, size);
+            if((len > 0) && (len < (int)size))
             {
-                *payload = malloc(len + 1);
-                strcpy(*payload, str);
                 ret = HAPCAN_MQTT_RESPONSE;
                 *payloadlen = len; 
             }
             else
             {
-                *payload = NULL;
                 *payloadlen = 0;
                 ret = HAPCAN_RESPONSE_ERROR;
             }
-            // free
-            free(str);
             break;        
         //-------------------------------------------
         // Temperature Sensor Error Frame
         //    - Integer (error)
         //-------------------------------------------
         case 0xF6:
-            len = snprintf(NULL, 0, "%d", hd_received->data[3]);
-            if(len > 0)
+            len = snprintf(payload, size, "%d", hd_received->data[3]);
+            if((len > 0) && (len < (int)size))
             {
-                *payload = malloc(len + 1);
-                snprintf(*payload, len + 1, "%d", hd_received->data[3]);
                 *payloadlen = len;
                 ret = HAPCAN_MQTT_RESPONSE;
             }
             else
             {
-                *payload = NULL;
                 *payloadlen = 0;
                 ret = HAPCAN_RESPONSE_ERROR;
             }
@@ -594,9 +609,10 @@ static int htiml_getTempPayload(hapcanCANData *hd_received, void** payload,
         //-------------------------------------------
         default:
             #ifdef DEBUG_TIM_ERRORS
-            debug_print("htiml_getTempPayload: Unknown Temperature "
+            debug_error("htiml_getTempPayload: Unknown Temperature "
                 "Frame Type!\n");
             #endif
+            ret = HAPCAN_NO_RESPONSE;
             break;
     }
     return ret;
@@ -629,8 +645,8 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
     int16_t i;
     double calc;
     int temp;
-    char *str = NULL;
-    json_object *obj = NULL;
+    char str[HAPCAN_MQTT_COMMAND_STR_LEN];
+    jsonFlatObject obj;
     // Check NULL or size 0
     if((payload == NULL) || (payloadlen <= 0))
     {
@@ -641,9 +657,7 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
         // set to false unless there is a payload match 
         valid = false;
         // payload does not end with 0 for a string - copy it here
-        str = malloc(payloadlen + 1);
-        memcpy(str, payload, payloadlen);
-        str[payloadlen] = 0;
+        aux_getPayloadString(payload, payloadlen, str, sizeof(str));
         // Check the result message D1 (previously set when added to gateway)
         switch(hd_result->data[1])
         {
@@ -703,12 +717,12 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
                 {
                     valid = false;
                     // Check for JSON - Get the JSON Object
-                    jh_getObject(str, &obj);                    
+                    check = jh_parseFlatObject(payload, payloadlen, &obj);
                     // Check if error parsing
-                    if(obj != NULL)
+                    if(check == JSON_OK)
                     {                        
                         // Setpoint
-                        check = jh_getObjectFieldAsDouble(obj, "Setpoint", 
+                        check = jh_getFlatFieldAsDouble(&obj, "Setpoint", 
                                 &calc);                        
                         valid = (check == JSON_OK) && (calc >= -55) && 
                                 (calc <= 125);                
@@ -727,7 +741,7 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
                         if(!valid)
                         {
                             // Increase
-                            check = jh_getObjectFieldAsDouble(obj, "Increase", 
+                            check = jh_getFlatFieldAsDouble(&obj, "Increase", 
                                     &calc);
                             valid = !valid && (check == JSON_OK) && (calc > 0) 
                                     && (calc <= 16);
@@ -750,7 +764,7 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
                         if(!valid)
                         {
                             // Decrease
-                            check = jh_getObjectFieldAsDouble(obj, "Decrease", 
+                            check = jh_getFlatFieldAsDouble(&obj, "Decrease", 
                                     &calc);
                             valid = !valid && (check == JSON_OK) && (calc > 0) 
                                     && (calc <= 16);
@@ -775,13 +789,13 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
                 break;
             case 0xC0:
                 // Check for JSON - Get the JSON Object
-                jh_getObject(str, &obj);
+                check = jh_parseFlatObject(payload, payloadlen, &obj);
                 // Check if error parsing
-                if(obj != NULL)
+                if(check == JSON_OK)
                 {
                     valid = true;
                     // INSTR1
-                    check = jh_getObjectFieldAsInt(obj, "INSTR1", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR1", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -789,7 +803,7 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
                         hd_result->data[0] = (uint8_t)temp;
                     }
                     // INSTR2
-                    check = jh_getObjectFieldAsInt(obj, "INSTR2", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR2", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -797,7 +811,7 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
                         hd_result->data[1] = (uint8_t)temp;
                     }
                     // INSTR3
-                    check = jh_getObjectFieldAsInt(obj, "INSTR3", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR3", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -805,7 +819,7 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
                         hd_result->data[4] = (uint8_t)temp;
                     }
                     // INSTR4
-                    check = jh_getObjectFieldAsInt(obj, "INSTR4", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR4", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -813,7 +827,7 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
                         hd_result->data[5] = (uint8_t)temp;
                     }
                     // INSTR5
-                    check = jh_getObjectFieldAsInt(obj, "INSTR5", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR5", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -821,7 +835,7 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
                         hd_result->data[6] = (uint8_t)temp;
                     }
                     // INSTR6
-                    check = jh_getObjectFieldAsInt(obj, "INSTR6", &temp);
+                    check = jh_getFlatFieldAsInt(&obj, "INSTR6", &temp);
                     valid = valid && (check == JSON_OK) && 
                             (temp >= 0) && (temp <= 255);
                     if( valid )
@@ -847,9 +861,6 @@ static int htiml_getTempHAPCANFrame(void *payload, int payloadlen,
         hd_result->frametype = HAPCAN_DIRECT_CONTROL_FRAME_TYPE;
         ret = HAPCAN_CAN_RESPONSE;
     }
-    // Free
-    jh_freeObject(obj);
-    free(str);
     // Leave
     return ret; 
 }
@@ -903,7 +914,7 @@ void htim_addToGateway(void)
             #ifdef DEBUG_TIM_ERRORS
             if(!valid)
             {
-                debug_print("htim_addToGateway: Basic Information Error!\n");
+                debug_error("htim_addToGateway: Basic Information Error!\n");
             }
             #endif
             if(valid)
@@ -923,7 +934,7 @@ void htim_addToGateway(void)
                     #ifdef DEBUG_TIM_ERRORS
                     if(!valid)
                     {
-                        debug_print("htim_addToGateway: Channel Information "
+                        debug_error("htim_addToGateway: Channel Information "
                             "Error!\n");
                     }
                     #endif
@@ -1012,14 +1023,15 @@ void htim_addToGateway(void)
  * Set a payload based on the data received, and add it to the MQTT Pub Buffer.       
  */
 int htim_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received, 
-        unsigned long long timestamp)
+        const void *context, unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
-    void* payload = NULL;
+    char payload[HAPCAN_MQTT_PAYLOAD_MAX_LEN];
     int payloadlen;
     // Set the payload
-    check = htiml_getTempPayload(hd_received, &payload, &payloadlen);
+    check = htiml_getTempPayload(hd_received, payload, sizeof(payload), 
+            &payloadlen);
     if(check == HAPCAN_MQTT_RESPONSE)
     {
         // Set MQTT Pub buffer
@@ -1029,8 +1041,6 @@ int htim_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
                     timestamp);
         }
     }
-    // Free
-    free(payload);
     // Return
     return ret;
 }
@@ -1039,8 +1049,9 @@ int htim_setCAN2MQTTResponse(char *state_str, hapcanCANData *hd_received,
  * Set a HAPCAN message based on the payload received, and add it to the CAN 
  * write Buffer.    
  */
-int htim_setMQTT2CANResponse(hapcanCANData *hd_result, void *payload, 
-        int payloadlen, unsigned long long timestamp)
+int htim_setMQTT2CANResponse(hapcanCANData *hd_result, 
+        const void *context, void *payload, int payloadlen, 
+        unsigned long long timestamp)
 {
     int ret = HAPCAN_NO_RESPONSE;
     int check;
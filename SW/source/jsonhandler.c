@@ -9,6 +9,37 @@
 //  1.01     | 24/Oct/2024 |                               | ALCP             //
 // - Add funtions jh_getJFieldIntObj and jh_getJArrayElementsObj              //
 //----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add jh_formatFieldValuePairs: lock-free and allocation-free JSON output  //
+// (byte-compatible with json-c PLAIN output)                                 //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add jh_parseFlatObject: lock-free and allocation-free parser for flat    //
+// JSON commands (json-c is only needed for the configuration file)           //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_CONFIG          //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Add jh_reloadConfigFile (new file parsed and checked before the swap)    //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Add jh_checkConfigFile: the module sections are checked at start-up and  //
+// on a reload (a reloaded file with errors is not used)                      //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - jh_readConfigFile / jh_reloadConfigFile parse the contents read by the   //
+// caller (the file is read once)                                             //
+//----------------------------------------------------------------------------//
+//  1.08     | 18/Oct/2026 |                               | ALCP             //
+// - Flat JSON: long integers are saturated, integers read as double are not  //
+// saturated to the int range                                                 //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_CONFIG
 
 /*
 * Includes
@@ -20,6 +51,8 @@
 #include <stdbool.h>
 #include <pthread.h>
 #include <errno.h>
+#include <math.h>
+#include <limits.h>
 #include "jsonhandler.h"
 #include "config.h"
 #include "debug.h"
@@ -27,17 +60,38 @@
 //----------------------------------------------------------------------------//
 // INTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
-
+// Size of the temporary buffer used to print a single number
+#define JH_NUMBER_STR_LEN   64
 
 //----------------------------------------------------------------------------//
 // INTERNAL TYPES
 //----------------------------------------------------------------------------//
+// Module section of the configuration file: array of modules with the 
+// mandatory fields read by the *_addToGateway functions
+typedef struct
+{
+    const char *section;
+    const char *boolField[2];   // Mandatory boolean fields (NULL: none)
+    const char *channels;       // Array of channels, each one with an integer
+                                // "channel" (NULL: not checked)
+    bool channelsRequired;      // false: array of channels is optional
+} jsonModuleSection;
 
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
 static pthread_mutex_t g_json_mutex = PTHREAD_MUTEX_INITIALIZER;
 static json_object *j_config;
+// Every module has the integer fields "node" and "group"
+static const jsonModuleSection g_moduleSections[] = 
+{
+    {"HAPCANRelays",    {NULL, NULL},           "relays",       true},
+    // Temperature modules are in the same section, without buttons
+    {"HAPCANButtons",   {NULL, NULL},           "buttons",      false},
+    {"HAPCANRGBs",      {"isRGB", NULL},        NULL,           false},
+    {"RGBWs",           {"isRGBW", "isRGB"},    NULL,           false},
+    {"TIMs",            {NULL, NULL},           "temperature",  true}
+};
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS
@@ -55,6 +109,22 @@ static int getObjectAndFieldObj(json_object *j_root, const char *level,
     json_object **data_obj, const char **data_field);
 static int getJArrayLengthObj(json_object *j_root, const char *level, 
     int levelIndex, const char *field, json_depth_t depth, int *value);
+static void appendChars(char *buf, unsigned int size, unsigned int *pos, 
+        const char *str, unsigned int len);
+static void appendEscapedString(char *buf, unsigned int size, 
+        unsigned int *pos, const char *str);
+static void appendDouble(char *buf, unsigned int size, unsigned int *pos, 
+        double value);
+static const char* skipWhitespace(const char *p, const char *end);
+static const char* scanString(const char *p, const char *end);
+static const char* scanNumber(const char *p, const char *end, bool *isInt);
+static const char* scanLiteral(const char *p, const char *end, 
+        const char *literal);
+static const char* skipNested(const char *p, const char *end);
+static const jsonFlatField* getFlatField(const jsonFlatObject *obj, 
+        const char *field);
+static bool checkModule(json_object *j_module, const jsonModuleSection *sec);
+static int checkConfigTree(json_object *j_root);
 
 /**
  * Get a boolean from a JSON object
@@ -593,27 +663,493 @@ static int getJArrayLengthObj(json_object *j_root, const char *level,
     return check;
 }
 
+/**
+ * Append characters to an output buffer. Characters that do not fit are not 
+ * written, but the position is always updated (snprintf-like behavior).
+ * 
+ * \param   buf     output buffer (OUTPUT)
+ * \param   size    output buffer size (INPUT)
+ * \param   pos     current position within the buffer (INPUT / OUTPUT)
+ * \param   str     characters to be appended (INPUT)
+ * \param   len     number of characters to be appended (INPUT)
+ **/
+static void appendChars(char *buf, unsigned int size, unsigned int *pos, 
+        const char *str, unsigned int len)
+{
+    unsigned int lui_index;
+    for(lui_index = 0; lui_index < len; lui_index++)
+    {
+        if((*pos + 1) < size)
+        {
+            buf[*pos] = str[lui_index];
+        }
+        (*pos)++;
+    }
+}
+
+/**
+ * Append a JSON string (with quotes) to an output buffer, escaping the same 
+ * characters as json-c does.
+ * 
+ * \param   buf     output buffer (OUTPUT)
+ * \param   size    output buffer size (INPUT)
+ * \param   pos     current position within the buffer (INPUT / OUTPUT)
+ * \param   str     string to be appended (INPUT)
+ **/
+static void appendEscapedString(char *buf, unsigned int size, 
+        unsigned int *pos, const char *str)
+{
+    static const char hex_chars[] = "0123456789abcdef";
+    char esc[6];
+    unsigned char c;
+    appendChars(buf, size, pos, "\"", 1);
+    while((str != NULL) && (*str != 0))
+    {
+        c = (unsigned char)(*str);
+        switch(c)
+        {
+            case '\b':
+                appendChars(buf, size, pos, "\\b", 2);
+                break;
+            case '\n':
+                appendChars(buf, size, pos, "\\n", 2);
+                break;
+            case '\r':
+                appendChars(buf, size, pos, "\\r", 2);
+                break;
+            case '\t':
+                appendChars(buf, size, pos, "\\t", 2);
+                break;
+            case '\f':
+                appendChars(buf, size, pos, "\\f", 2);
+                break;
+            case '"':
+                appendChars(buf, size, pos, "\\\"", 2);
+                break;
+            case '\\':
+                appendChars(buf, size, pos, "\\\\", 2);
+                break;
+            case '/':
+                appendChars(buf, size, pos, "\\/", 2);
+                break;
+            default:
+                if(c < ' ')
+                {
+                    esc[0] = '\\';
+                    esc[1] = 'u';
+                    esc[2] = '0';
+                    esc[3] = '0';
+                    esc[4] = hex_chars[c >> 4];
+                    esc[5] = hex_chars[c & 0x0F];
+                    appendChars(buf, size, pos, esc, 6);
+                }
+                else
+                {
+                    appendChars(buf, size, pos, str, 1);
+                }
+                break;
+        }
+        str++;
+    }
+    appendChars(buf, size, pos, "\"", 1);
+}
+
+/**
+ * Append a double to an output buffer, using the same format as json-c 
+ * ("%.17g", and ".0" added when the result looks like an integer).
+ * 
+ * \param   buf     output buffer (OUTPUT)
+ * \param   size    output buffer size (INPUT)
+ * \param   pos     current position within the buffer (INPUT / OUTPUT)
+ * \param   value   value to be appended (INPUT)
+ **/
+static void appendDouble(char *buf, unsigned int size, unsigned int *pos, 
+        double value)
+{
+    char str[JH_NUMBER_STR_LEN];
+    int len;
+    bool looks_numeric;
+    if(isnan(value))
+    {
+        len = snprintf(str, sizeof(str), "NaN");
+    }
+    else if(isinf(value))
+    {
+        if(value > 0)
+        {
+            len = snprintf(str, sizeof(str), "Infinity");
+        }
+        else
+        {
+            len = snprintf(str, sizeof(str), "-Infinity");
+        }
+    }
+    else
+    {
+        len = snprintf(str, sizeof(str), "%.17g", value);
+        if((len > 0) && (len < ((int)sizeof(str) - 2)))
+        {
+            looks_numeric = ((str[0] >= '0') && (str[0] <= '9')) || 
+                    ((len > 1) && (str[0] == '-') && 
+                    (str[1] >= '0') && (str[1] <= '9'));
+            if(looks_numeric && (strchr(str, '.') == NULL) && 
+                    (strchr(str, 'e') == NULL))
+            {
+                strcat(str, ".0");
+                len += 2;
+            }
+        }
+    }
+    if(len > 0)
+    {
+        appendChars(buf, size, pos, str, (unsigned int)len);
+    }
+}
+
+/**
+ * Skip JSON whitespace
+ * 
+ * \param   p       current position (INPUT)
+ * \param   end     end of the text (INPUT)
+ * 
+ * \return  first position that is not a whitespace
+ **/
+static const char* skipWhitespace(const char *p, const char *end)
+{
+    while((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\n') || 
+            (*p == '\r')))
+    {
+        p++;
+    }
+    return p;
+}
+
+/**
+ * Scan a JSON string
+ * 
+ * \param   p       position of the opening quote (INPUT)
+ * \param   end     end of the text (INPUT)
+ * 
+ * \return  position of the closing quote, or NULL if not found
+ **/
+static const char* scanString(const char *p, const char *end)
+{
+    p++;
+    while(p < end)
+    {
+        if(*p == '\\')
+        {
+            // Skip the escaped character
+            p++;
+        }
+        else if(*p == '"')
+        {
+            return p;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+/**
+ * Scan a JSON number: -?digits[.digits][(e|E)[+|-]digits]
+ * 
+ * \param   p       first character of the number (INPUT)
+ * \param   end     end of the text (INPUT)
+ * \param   isInt   true if there is no fraction or exponent (OUTPUT)
+ * 
+ * \return  position after the number, or NULL if not a valid number
+ **/
+static const char* scanNumber(const char *p, const char *end, bool *isInt)
+{
+    const char *start;
+    *isInt = true;
+    if((p < end) && (*p == '-'))
+    {
+        p++;
+    }
+    start = p;
+    while((p < end) && (*p >= '0') && (*p <= '9'))
+    {
+        p++;
+    }
+    if(p == start)
+    {
+        return NULL;
+    }
+    if((p < end) && (*p == '.'))
+    {
+        *isInt = false;
+        p++;
+        start = p;
+        while((p < end) && (*p >= '0') && (*p <= '9'))
+        {
+            p++;
+        }
+        if(p == start)
+        {
+            return NULL;
+        }
+    }
+    if((p < end) && ((*p == 'e') || (*p == 'E')))
+    {
+        *isInt = false;
+        p++;
+        if((p < end) && ((*p == '+') || (*p == '-')))
+        {
+            p++;
+        }
+        start = p;
+        while((p < end) && (*p >= '0') && (*p <= '9'))
+        {
+            p++;
+        }
+        if(p == start)
+        {
+            return NULL;
+        }
+    }
+    return p;
+}
+
+/**
+ * Scan a JSON literal (true, false, null)
+ * 
+ * \param   p       current position (INPUT)
+ * \param   end     end of the text (INPUT)
+ * \param   literal literal to be matched (INPUT)
+ * 
+ * \return  position after the literal, or NULL if it does not match
+ **/
+static const char* scanLiteral(const char *p, const char *end, 
+        const char *literal)
+{
+    unsigned int len = strlen(literal);
+    if(((unsigned int)(end - p) < len) || (memcmp(p, literal, len) != 0))
+    {
+        return NULL;
+    }
+    return p + len;
+}
+
+/**
+ * Skip a nested JSON object or array (values are not checked)
+ * 
+ * \param   p       position of the opening bracket (INPUT)
+ * \param   end     end of the text (INPUT)
+ * 
+ * \return  position after the closing bracket, or NULL if not found
+ **/
+static const char* skipNested(const char *p, const char *end)
+{
+    int depth = 0;
+    while(p < end)
+    {
+        if(*p == '"')
+        {
+            p = scanString(p, end);
+            if(p == NULL)
+            {
+                return NULL;
+            }
+        }
+        else if((*p == '{') || (*p == '['))
+        {
+            depth++;
+        }
+        else if((*p == '}') || (*p == ']'))
+        {
+            depth--;
+            if(depth == 0)
+            {
+                return p + 1;
+            }
+        }
+        p++;
+    }
+    return NULL;
+}
+
+/**
+ * Get a field from a flat JSON object. As for json-c, if a field is repeated 
+ * the last one is used.
+ * 
+ * \param   obj     parsed flat JSON object (INPUT)
+ * \param   field   field to be searched (INPUT)
+ * 
+ * \return  field found, or NULL
+ **/
+static const jsonFlatField* getFlatField(const jsonFlatObject *obj, 
+        const char *field)
+{
+    int i;
+    int len;
+    if((obj == NULL) || (field == NULL))
+    {
+        return NULL;
+    }
+    len = strlen(field);
+    for(i = obj->n_fields - 1; i >= 0; i--)
+    {
+        if((obj->fields[i].key_len == len) && 
+                (memcmp(obj->fields[i].key, field, len) == 0))
+        {
+            return &(obj->fields[i]);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Check the mandatory fields of a module (same as the *_addToGateway 
+ * functions)
+ * 
+ * \param   j_module    element of a module section (INPUT)
+ * \param   sec         module section (INPUT)
+ * 
+ * \return  true: valid
+ **/
+static bool checkModule(json_object *j_module, const jsonModuleSection *sec)
+{
+    json_object *j_channels;
+    json_object *j_channel;
+    size_t i;
+    int value;
+    bool flag;
+    bool valid;
+    if(json_object_get_type(j_module) != json_type_object)
+    {
+        return false;
+    }
+    valid = (getJFieldInt(j_module, "node", &value) == JSON_OK);
+    valid = valid && (getJFieldInt(j_module, "group", &value) == JSON_OK);
+    for(i = 0; i < 2; i++)
+    {
+        if(sec->boolField[i] != NULL)
+        {
+            valid = valid && (getJFieldBool(j_module, sec->boolField[i], 
+                    &flag) == JSON_OK);
+        }
+    }
+    if(!valid || (sec->channels == NULL))
+    {
+        return valid;
+    }
+    if(!json_object_object_get_ex(j_module, sec->channels, &j_channels))
+    {
+        return !sec->channelsRequired;
+    }
+    if(json_object_get_type(j_channels) != json_type_array)
+    {
+        return false;
+    }
+    for(i = 0; valid && (i < json_object_array_length(j_channels)); i++)
+    {
+        j_channel = json_object_array_get_idx(j_channels, i);
+        valid = (json_object_get_type(j_channel) == json_type_object) &&
+                (getJFieldInt(j_channel, "channel", &value) == JSON_OK);
+    }
+    return valid;
+}
+
+/**
+ * Check a configuration: JSON object with a "GeneralSettings" object, and 
+ * each module of the module sections (sections are optional)
+ * 
+ * \param   j_root      parsed configuration file (INPUT)
+ * 
+ * \return  JSON_OK             valid
+ *          JSON_ERROR_TYPE     not a valid configuration (errors printed)
+ **/
+static int checkConfigTree(json_object *j_root)
+{
+    json_object *j_settings;
+    json_object *j_section;
+    const jsonModuleSection *sec;
+    size_t n;
+    size_t i;
+    int errors;
+    if((json_object_get_type(j_root) != json_type_object) ||
+            !json_object_object_get_ex(j_root, CONFIG_GENERAL_SETTINGS_LEVEL, 
+            &j_settings) || 
+            (json_object_get_type(j_settings) != json_type_object))
+    {
+        #ifdef DEBUG_CONFIG_ERRORS
+        debug_error("jsonhandler: no %s object!\n", 
+                CONFIG_GENERAL_SETTINGS_LEVEL);
+        #endif
+        return JSON_ERROR_TYPE;
+    }
+    errors = 0;
+    n = sizeof(g_moduleSections) / sizeof(g_moduleSections[0]);
+    for(sec = g_moduleSections; sec < g_moduleSections + n; sec++)
+    {
+        if(!json_object_object_get_ex(j_root, sec->section, &j_section))
+        {
+            continue;
+        }
+        if(json_object_get_type(j_section) != json_type_array)
+        {
+            #ifdef DEBUG_CONFIG_ERRORS
+            debug_error("jsonhandler: %s is not an array!\n", sec->section);
+            #endif
+            errors++;
+            continue;
+        }
+        for(i = 0; i < json_object_array_length(j_section); i++)
+        {
+            if(!checkModule(json_object_array_get_idx(j_section, i), sec))
+            {
+                #ifdef DEBUG_CONFIG_ERRORS
+                debug_error("jsonhandler: %s - module %d: Module Information "
+                        "Error!\n", sec->section, (int)i);
+                #endif
+                errors++;
+            }
+        }
+    }
+    return (errors == 0) ? JSON_OK : JSON_ERROR_TYPE;
+}
+
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
-/* read config file */
-void jh_readConfigFile(void)
+/* parse config file */
+void jh_readConfigFile(const char *text)
 {
     // LOCK - Use of JSON is not thread protected
     pthread_mutex_lock(&g_json_mutex);
-    // Read from file
-    // Getting the type of value
-    j_config = json_object_from_file(JSON_CONFIG_FILE_PATH);
+    // Parse the contents of the file
+    j_config = (text != NULL) ? json_tokener_parse(text) : NULL;
     // UNLOCK - Use of JSON is not thread protected
     pthread_mutex_unlock(&g_json_mutex);
     #ifdef DEBUG_JSON_ERRORS
     if (!j_config)
     {
-        debug_print("jsonhandler: Error reading config file!\n");
+        debug_verbose("jsonhandler: Error reading config file!\n");
     }
     #endif
 }
 
+/* Check the configuration file in use */
+int jh_checkConfigFile(void)
+{
+    int ret;
+    // LOCK - Use of JSON is not thread protected
+    pthread_mutex_lock(&g_json_mutex);
+    if(j_config == NULL)
+    {
+        ret = JSON_ERROR_FILE;
+    }
+    else
+    {
+        ret = checkConfigTree(j_config);
+    }
+    // UNLOCK - Use of JSON is not thread protected
+    pthread_mutex_unlock(&g_json_mutex);
+    return ret;
+}
+
 /* Free memory from json object */
 void jh_freeConfigFile(void)
 {
@@ -625,6 +1161,36 @@ void jh_freeConfigFile(void)
     pthread_mutex_unlock(&g_json_mutex);
 }
 
+/* Read the configuration file again - swap only if valid */
+int jh_reloadConfigFile(const char *text)
+{
+    json_object *j_new;
+    json_object *j_old;
+    // Parse outside the lock: readers use the current file meanwhile
+    j_new = (text != NULL) ? json_tokener_parse(text) : NULL;
+    if(j_new == NULL)
+    {
+        #ifdef DEBUG_JSON_ERRORS
+        debug_verbose("jh_reloadConfigFile: Error reading config file!\n");
+        #endif
+        return JSON_ERROR_FILE;
+    }
+    // Same check as at start-up: the current file is kept if it fails
+    if(checkConfigTree(j_new) != JSON_OK)
+    {
+        json_object_put(j_new);
+        return JSON_ERROR_TYPE;
+    }
+    // LOCK - Use of JSON is not thread protected
+    pthread_mutex_lock(&g_json_mutex);
+    j_old = j_config;
+    j_config = j_new;
+    // UNLOCK - Use of JSON is not thread protected
+    pthread_mutex_unlock(&g_json_mutex);
+    json_object_put(j_old);
+    return JSON_OK;
+}
+
 /* Get a Bool*/
 int jh_getJFieldBool(const char *level, int levelIndex, const char *field, 
         int fieldIndex, const char *subField, bool *value)
@@ -646,8 +1212,8 @@ int jh_getJFieldBool(const char *level, int levelIndex, const char *field,
     #ifdef DEBUG_JSON_ERRORS
     if(check != JSON_OK)
     {
-        debug_print("Error - jh_getJFieldBool: %d - level = %s - field = %s\n", 
-                check, level, field);
+        debug_verbose("Error - jh_getJFieldBool: %d - level = %s - "
+                "field = %s\n", check, level, field);
     }    
     #endif    
     // Return
@@ -674,7 +1240,7 @@ int jh_getJFieldDouble(const char *level, int levelIndex, const char *field,
     #ifdef DEBUG_JSON_ERRORS
     if(check != JSON_OK)
     {
-        debug_print("Error - jh_getJFieldDouble: %d - level = %s - field = %s\n", 
+        debug_verbose("Error - jh_getJFieldDouble: %d - level = %s - field = %s\n", 
                 check, level, field);
     }    
     #endif    
@@ -702,8 +1268,8 @@ int jh_getJFieldInt(const char *level, int levelIndex, const char *field,
     #ifdef DEBUG_JSON_ERRORS
     if(check != JSON_OK)
     {
-        debug_print("Error - jh_getJFieldInt: %d - level = %s - field = %s\n", 
-                check, level, field);
+        debug_verbose("Error - jh_getJFieldInt: %d - level = %s - "
+                "field = %s\n", check, level, field);
     }    
     #endif    
     // Return
@@ -736,7 +1302,7 @@ int jh_getJFieldIntObj(const char *objStr, const char *level, int levelIndex,
     #ifdef DEBUG_JSON_ERRORS
     if(check != JSON_OK)
     {
-        debug_print("Error - jh_getJFieldIntObj: %d - level = %s - field = %s\n", 
+        debug_verbose("Error - jh_getJFieldIntObj: %d - level = %s - field = %s\n", 
                 check, level, field);
     }    
     #endif    
@@ -764,7 +1330,7 @@ int jh_getJFieldStringCopy(const char *level, int levelIndex, const char *field,
     #ifdef DEBUG_JSON_ERRORS
     if(check != JSON_OK)
     {
-        debug_print("Error - jh_getJFieldStringCopy: %d - level = %s - field = %s\n", 
+        debug_verbose("Error - jh_getJFieldStringCopy: %d - level = %s - field = %s\n", 
                 check, level, field);
     }    
     #endif    
@@ -788,7 +1354,7 @@ int jh_getJArrayElements(const char *level, int levelIndex, const char *field,
     #ifdef DEBUG_JSON_ERRORS
     if(check != JSON_OK)
     {
-        debug_print("Error - jh_getJArrayElements: %d - level = %s "
+        debug_verbose("Error - jh_getJArrayElements: %d - level = %s "
                 "levelIndex = %d - field = %s - depth = %d\n", 
                 check, level, levelIndex, field, depth);
     }    
@@ -819,7 +1385,7 @@ int jh_getJArrayElementsObj(const char *objStr, const char *level,
     #ifdef DEBUG_JSON_ERRORS
     if(check != JSON_OK)
     {
-        debug_print("Error - jh_getJArrayElementsObj: %d - level = %s "
+        debug_verbose("Error - jh_getJArrayElementsObj: %d - level = %s "
                 "levelIndex = %d - field = %s - depth = %d\n", 
                 check, level, levelIndex, field, depth);
     }    
@@ -849,12 +1415,12 @@ int jh_getJFieldStringArrayCopy(const char *level, const char *field,
     {
         if( (level != NULL) && (field != NULL) )
         {
-            debug_print("Error - jh_getJFieldStringArrayCopy: %d - level = %s - field = %s\n", 
+            debug_verbose("Error - jh_getJFieldStringArrayCopy: %d - level = %s - field = %s\n", 
                 check, level, field);
         }
         else
         {
-            debug_print("Error - jh_getJFieldStringArrayCopy: NULL input\n");
+            debug_verbose("Error - jh_getJFieldStringArrayCopy: NULL input\n");
         }
     }    
     #endif    
@@ -866,44 +1432,94 @@ int jh_getJFieldStringArrayCopy(const char *level, const char *field,
 void jh_getStringFromFieldValuePairs(jsonFieldData *a_data, int n_pairs, 
         char **str)
 {
-    json_object *obj;
-    unsigned int len;
-    // LOCK - Use of JSON is not thread protected
-    pthread_mutex_lock(&g_json_mutex);
-    obj = json_object_new_object();    
-    int i;    
+    int len;
+    // Get the length first, then fill the allocated string
+    len = jh_formatFieldValuePairs(a_data, n_pairs, NULL, 0);
+    if(len < 0)
+    {
+        *str = NULL;
+    }
+    else
+    {
+        *str = malloc(len + 1);
+        jh_formatFieldValuePairs(a_data, n_pairs, *str, len + 1);
+    }
+}
+
+/* Create JSON string from input data array into a caller provided buffer */
+int jh_formatFieldValuePairs(const jsonFieldData *a_data, int n_pairs, 
+        char *buf, unsigned int size)
+{
+    unsigned int pos = 0;
+    char str[JH_NUMBER_STR_LEN];
+    int len;
+    int i;
+    // Check parameters
+    if((n_pairs < 0) || ((n_pairs > 0) && (a_data == NULL)) || 
+            ((buf == NULL) && (size > 0)))
+    {
+        #ifdef DEBUG_JSON_ERRORS
+        debug_verbose("jh_formatFieldValuePairs: parameter error!\n");
+        #endif
+        return JSON_ERROR_OTHER;
+    }
+    appendChars(buf, size, &pos, "{", 1);
     for (i = 0; i < n_pairs; i++)
     {
+        if(i > 0)
+        {
+            appendChars(buf, size, &pos, ",", 1);
+        }
+        appendEscapedString(buf, size, &pos, a_data[i].field);
+        appendChars(buf, size, &pos, ":", 1);
         switch(a_data[i].value_type)        
         {
             case JSON_TYPE_BOOL:
-                json_object_object_add(obj, a_data[i].field, 
-                        json_object_new_boolean(a_data[i].b_value));
+                if(a_data[i].b_value)
+                {
+                    appendChars(buf, size, &pos, "true", 4);
+                }
+                else
+                {
+                    appendChars(buf, size, &pos, "false", 5);
+                }
                 break;
             case JSON_TYPE_INT:
-                json_object_object_add(obj, a_data[i].field, 
-                        json_object_new_int(a_data[i].int_value));
+                len = snprintf(str, sizeof(str), "%d", a_data[i].int_value);
+                appendChars(buf, size, &pos, str, (unsigned int)len);
                 break;
             case JSON_TYPE_DOUBLE:
-                json_object_object_add(obj, a_data[i].field, 
-                        json_object_new_double(a_data[i].double_value));
+                appendDouble(buf, size, &pos, a_data[i].double_value);
                 break;
             case JSON_TYPE_STRING:
-                json_object_object_add(obj, a_data[i].field, 
-                        json_object_new_string(a_data[i].str_value));
+                if(a_data[i].str_value == NULL)
+                {
+                    appendChars(buf, size, &pos, "null", 4);
+                }
+                else
+                {
+                    appendEscapedString(buf, size, &pos, a_data[i].str_value);
+                }
                 break;
             default:
+                appendChars(buf, size, &pos, "null", 4);
                 break;
         }
     }
-    // Copy to output
-    len = strlen(json_object_to_json_string_ext(obj, JSON_C_TO_STRING_PLAIN));
-    *str = malloc(len + 1);
-    strcpy(*str, json_object_to_json_string_ext(obj, JSON_C_TO_STRING_PLAIN));
-    // Free obj
-    json_object_put(obj); 
-    // UNLOCK - Use of JSON is not thread protected
-    pthread_mutex_unlock(&g_json_mutex);
+    appendChars(buf, size, &pos, "}", 1);
+    // Terminate the string
+    if(size > 0)
+    {
+        if(pos < size)
+        {
+            buf[pos] = 0;
+        }
+        else
+        {
+            buf[size - 1] = 0;
+        }
+    }
+    return (int)pos;
 }
 
 /**
@@ -985,3 +1601,210 @@ int jh_getObjectFieldAsStringCopy(json_object *obj, char *field, char **value)
     pthread_mutex_unlock(&g_json_mutex);
     return check;
 }
+
+/**
+ * Parse a flat JSON object
+ **/
+int jh_parseFlatObject(const void *str, int len, jsonFlatObject *obj)
+{
+    const char *p;
+    const char *end;
+    const char *q;
+    jsonFlatField *field;
+    bool isInt;
+    // Check parameters
+    if((str == NULL) || (len <= 0) || (obj == NULL))
+    {
+        return JSON_ERROR_OTHER;
+    }
+    obj->n_fields = 0;
+    p = (const char *)str;
+    end = p + len;
+    //--------------------------------------
+    // Opening bracket
+    //--------------------------------------
+    p = skipWhitespace(p, end);
+    if((p >= end) || (*p != '{'))
+    {
+        return JSON_ERROR_OTHER;
+    }
+    p = skipWhitespace(p + 1, end);
+    if((p < end) && (*p == '}'))
+    {
+        // Empty object
+        p = skipWhitespace(p + 1, end);
+        return (p == end) ? JSON_OK : JSON_ERROR_OTHER;
+    }
+    //--------------------------------------
+    // Field / Value pairs
+    //--------------------------------------
+    while(p < end)
+    {
+        if(obj->n_fields >= JSON_FLAT_MAX_FIELDS)
+        {
+            #ifdef DEBUG_JSON_ERRORS
+            debug_verbose("jh_parseFlatObject: too many fields!\n");
+            #endif
+            return JSON_ERROR_OTHER;
+        }
+        field = &(obj->fields[obj->n_fields]);
+        // Key
+        if(*p != '"')
+        {
+            return JSON_ERROR_OTHER;
+        }
+        q = scanString(p, end);
+        if(q == NULL)
+        {
+            return JSON_ERROR_OTHER;
+        }
+        field->key = p + 1;
+        field->key_len = q - (p + 1);
+        // Separator
+        p = skipWhitespace(q + 1, end);
+        if((p >= end) || (*p != ':'))
+        {
+            return JSON_ERROR_OTHER;
+        }
+        p = skipWhitespace(p + 1, end);
+        if(p >= end)
+        {
+            return JSON_ERROR_OTHER;
+        }
+        // Value
+        field->value = p;
+        switch(*p)
+        {
+            case '"':
+                q = scanString(p, end);
+                if(q != NULL)
+                {
+                    field->value = p + 1;
+                    q++;
+                }
+                field->value_type = JSON_TYPE_STRING;
+                break;
+            case 't':
+                q = scanLiteral(p, end, "true");
+                field->value_type = JSON_TYPE_BOOL;
+                break;
+            case 'f':
+                q = scanLiteral(p, end, "false");
+                field->value_type = JSON_TYPE_BOOL;
+                break;
+            case 'n':
+                q = scanLiteral(p, end, "null");
+                field->value_type = JSON_TYPE_NULL;
+                break;
+            case '{':
+            case '[':
+                q = skipNested(p, end);
+                field->value_type = JSON_TYPE_OTHER;
+                break;
+            default:
+                q = scanNumber(p, end, &isInt);
+                field->value_type = isInt ? JSON_TYPE_INT : JSON_TYPE_DOUBLE;
+                break;
+        }
+        if(q == NULL)
+        {
+            return JSON_ERROR_OTHER;
+        }
+        if(field->value_type == JSON_TYPE_STRING)
+        {
+            // Do not include the closing quote
+            field->value_len = (q - 1) - field->value;
+        }
+        else
+        {
+            field->value_len = q - field->value;
+        }
+        obj->n_fields++;
+        // Next field or closing bracket
+        p = skipWhitespace(q, end);
+        if(p >= end)
+        {
+            return JSON_ERROR_OTHER;
+        }
+        if(*p == '}')
+        {
+            // Only whitespaces are accepted after the object
+            p = skipWhitespace(p + 1, end);
+            return (p == end) ? JSON_OK : JSON_ERROR_OTHER;
+        }
+        if(*p != ',')
+        {
+            return JSON_ERROR_OTHER;
+        }
+        p = skipWhitespace(p + 1, end);
+    }
+    return JSON_ERROR_OTHER;
+}
+
+/**
+ * Get the Integer value of a flat JSON Object Field
+ **/
+int jh_getFlatFieldAsInt(const jsonFlatObject *obj, const char *field, 
+        int *value)
+{
+    const jsonFlatField *f;
+    char str[JH_NUMBER_STR_LEN];
+    long long temp;
+    f = getFlatField(obj, field);
+    if((f == NULL) || (f->value_type == JSON_TYPE_NULL))
+    {
+        return JSON_ERROR_OTHER;
+    }
+    if(f->value_type != JSON_TYPE_INT)
+    {
+        return JSON_ERROR_TYPE;
+    }
+    // Same as json-c: values out of the integer range are saturated
+    if(f->value_len >= JH_NUMBER_STR_LEN)
+    {
+        // Only digits (and sign): out of the long long range
+        temp = (f->value[0] == '-') ? LLONG_MIN : LLONG_MAX;
+    }
+    else
+    {
+        memcpy(str, f->value, f->value_len);
+        str[f->value_len] = 0;
+        temp = strtoll(str, NULL, 10);
+    }
+    if(temp > INT_MAX)
+    {
+        temp = INT_MAX;
+    }
+    else if(temp < INT_MIN)
+    {
+        temp = INT_MIN;
+    }
+    *value = (int)temp;
+    return JSON_OK;
+}
+
+/**
+ * Get the Double value of a flat JSON Object Field
+ **/
+int jh_getFlatFieldAsDouble(const jsonFlatObject *obj, const char *field, 
+        double *value)
+{
+    const jsonFlatField *f;
+    char str[JH_NUMBER_STR_LEN];
+    f = getFlatField(obj, field);
+    if((f == NULL) || (f->value_type == JSON_TYPE_NULL))
+    {
+        return JSON_ERROR_OTHER;
+    }
+    // Integers are not limited to the int range
+    if(((f->value_type != JSON_TYPE_DOUBLE) && 
+            (f->value_type != JSON_TYPE_INT)) || 
+            (f->value_len >= JH_NUMBER_STR_LEN))
+    {
+        return JSON_ERROR_TYPE;
+    }
+    memcpy(str, f->value, f->value_len);
+    str[f->value_len] = 0;
+    *value = strtod(str, NULL);
+    return JSON_OK;
+}
@@ -9,6 +9,24 @@
 //  1.01     | 24/Oct/2024 |                               | ALCP             //
 // - Add funtions jh_getJFieldIntObj and jh_getJArrayElementsObj              //
 //----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add jh_formatFieldValuePairs: lock-free and allocation-free JSON output  //
+// (byte-compatible with json-c PLAIN output)                                 //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add jh_parseFlatObject: lock-free and allocation-free parser for flat    //
+// JSON commands (json-c is only needed for the configuration file)           //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Add jh_reloadConfigFile: the new file replaces the current one only if   //
+// it is valid                                                                //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Add jh_checkConfigFile (also used by jh_reloadConfigFile)                //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - jh_readConfigFile / jh_reloadConfigFile take the contents of the file    //
+//----------------------------------------------------------------------------//
 
 #ifndef JSONHANDLER_H
 #define JSONHANDLER_H
@@ -48,7 +66,9 @@ typedef enum
     JSON_TYPE_BOOL = 0,
     JSON_TYPE_INT,
     JSON_TYPE_DOUBLE,
-    JSON_TYPE_STRING
+    JSON_TYPE_STRING,
+    JSON_TYPE_NULL,
+    JSON_TYPE_OTHER     // Object or array (not parsed within flat objects)
 }json_pairs_t;
 
 /* Field / Data pair */
@@ -62,19 +82,67 @@ typedef struct
     char *str_value;
 } jsonFieldData;
 
+/* Maximum number of fields of a flat JSON object */
+#define JSON_FLAT_MAX_FIELDS 16
+
+/* Field of a flat JSON object - key and value point to the parsed text (no 
+ * copy, no null terminator). For strings, the quotes are not included and 
+ * escape sequences are kept as received. */
+typedef struct
+{
+    const char *key;
+    int key_len;
+    const char *value;
+    int value_len;
+    json_pairs_t value_type;
+} jsonFlatField;
+
+/* Flat JSON object: {"field":value, ...} */
+typedef struct
+{
+    int n_fields;
+    jsonFlatField fields[JSON_FLAT_MAX_FIELDS];
+} jsonFlatObject;
+
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
 /**
- * Read the JSON configuration file
+ * Parse the JSON configuration file
+ * 
+ * \param   text    contents of the file (NULL if it could not be read)
  **/
-void jh_readConfigFile(void);
+void jh_readConfigFile(const char *text);
+
+/**
+ * Check the JSON configuration file in use: JSON object with a 
+ * "GeneralSettings" object, and the mandatory fields of each module of the 
+ * module sections ("HAPCANRelays", "HAPCANButtons", "HAPCANRGBs", "RGBWs", 
+ * "TIMs"). The errors are printed.
+ * 
+ * \return  JSON_OK: valid
+ *          JSON_ERROR_FILE: no file
+ *          JSON_ERROR_TYPE: file is not a valid configuration
+ **/
+int jh_checkConfigFile(void);
 
 /**
  * Free allocated memory of config file object
  **/
 void jh_freeConfigFile(void);
 
+/**
+ * Parse the JSON configuration file again. The new file is parsed and checked 
+ * (same check as jh_checkConfigFile) before it replaces the current one; if 
+ * it is not valid, the current one is kept.
+ * 
+ * \param   text    contents of the file (NULL if it could not be read)
+ * \return  JSON_OK: new file in use
+ *          JSON_ERROR_FILE: file could not be read / parsed
+ *          JSON_ERROR_TYPE: file is not a valid configuration
+ **/
+int jh_reloadConfigFile(const char *text);
+
 /**
  * Get a boolean from a JSON object
  * 
@@ -241,6 +309,28 @@ int jh_getJFieldStringArrayCopy(const char *level, const char *field,
 void jh_getStringFromFieldValuePairs(jsonFieldData *a_data, int n_pairs, 
         char **str);
 
+/**
+ * Write a JSON string based on Field / Value pairs of the input array into a 
+ * caller provided buffer. The output is the same as the json-c PLAIN output 
+ * (fields in the given order), but no memory is allocated and no lock is 
+ * taken, so it can be used for every received frame.
+ * 
+ * Like snprintf, the output is truncated (and always null terminated) when 
+ * it does not fit, and the full length is returned. Use buf = NULL and 
+ * size = 0 to get the needed length.
+ * 
+ * \param   a_data      array with all Field / values to be filled (INPUT)
+ * \param   n_pairs     number of field / value pairs (INPUT)
+ * \param   buf         buffer to be filled (OUTPUT)
+ * \param   size        size of buf, including the null terminator (INPUT)
+ * 
+ * \return  length of the JSON string (without the null terminator). If it is 
+ *              equal or bigger than size, the output was truncated.
+ *          JSON_ERROR_OTHER    Parameter error
+ **/
+int jh_formatFieldValuePairs(const jsonFieldData *a_data, int n_pairs, 
+        char *buf, unsigned int size);
+
 /**
  * Create a JSON Object from a tring
  * 
@@ -310,6 +400,50 @@ int jh_getObjectFieldAsInt(json_object *obj, char *field, int *value);
  **/
 int jh_getObjectFieldAsStringCopy(json_object *obj, char *field, char **value);
 
+/**
+ * Parse a flat JSON object (no nested objects or arrays are used) in a single 
+ * pass. No memory is allocated and no lock is taken: the fields point to the 
+ * input text, so it has to be kept while the object is used. The input does 
+ * not need to be null terminated.
+ * 
+ * \param   str         (INPUT) text to be parsed
+ * \param   len         (INPUT) length of the text
+ * \param   obj         (OUTPUT) parsed object
+ * 
+ * \return  JSON_OK             Object parsed
+ *          JSON_ERROR_OTHER    Not a JSON object, syntax error or more than 
+ *                                  JSON_FLAT_MAX_FIELDS fields
+ **/
+int jh_parseFlatObject(const void *str, int len, jsonFlatObject *obj);
+
+/**
+ * Get the Integer value of a flat JSON Object Field
+ * 
+ * \param   obj         (INPUT) parsed flat JSON Obj
+ * \param   field       (INPUT) field to be searched
+ * \param   value       (OUTPUT) value to be set
+ * 
+ * \return  JSON_OK             Value matches type and is not NULL
+ *          JSON_ERROR_TYPE     Type does not match
+ *          JSON_ERROR_OTHER    Nothing found / NULL Found
+ **/
+int jh_getFlatFieldAsInt(const jsonFlatObject *obj, const char *field, 
+        int *value);
+
+/**
+ * Get the Double value of a flat JSON Object Field (integers are accepted)
+ * 
+ * \param   obj         (INPUT) parsed flat JSON Obj
+ * \param   field       (INPUT) field to be searched
+ * \param   value       (OUTPUT) value to be set
+ * 
+ * \return  JSON_OK             Value matches type and is not NULL
+ *          JSON_ERROR_TYPE     Type does not match
+ *          JSON_ERROR_OTHER    Nothing found / NULL Found
+ **/
+int jh_getFlatFieldAsDouble(const jsonFlatObject *obj, const char *field, 
+        double *value);
+
 
 #ifdef __cplusplus
 }
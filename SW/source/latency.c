@@ -0,0 +1,353 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_MONITORING      //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add latency_handOver / latency_takeOver (message handled by another      //
+// thread)                                                                    //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Histograms are cumulative (exported metrics). The report uses a          //
+// separate window: counts since the last report and its own max              //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_MONITORING
+
+//----------------------------------------------------------------------------//
+// Includes
+//----------------------------------------------------------------------------//
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "latency.h"
+#include "debug.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+// Histogram buckets: bucket 0 is < 1us, bucket n is [2^(n-1), 2^n) us. The
+// last bucket holds everything above 2^(LATENCY_BUCKETS - 2) us (~18 min).
+#define LATENCY_BUCKETS     32
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Histogram - Updated only with atomic operations (no lock). Cumulative: 
+// the report window is the difference with the counts of the last report
+typedef struct
+{
+    unsigned long bucket[LATENCY_BUCKETS];
+    unsigned long long max;
+    unsigned long reported[LATENCY_BUCKETS];    // Report thread only
+    unsigned long long windowMax;               // Max since the last report
+} latencyHistogram_t;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+static latencyHistogram_t g_histogram[LATENCY_NUMBER_OF_PATHS]
+        [LATENCY_NUMBER_OF_STAGES];
+// Output of each path
+static const latencyOutput_t g_pathOutput[LATENCY_NUMBER_OF_PATHS] = {
+    LATENCY_OUTPUT_MQTT,    // LATENCY_PATH_CAN2MQTT
+    LATENCY_OUTPUT_CAN,     // LATENCY_PATH_MQTT2CAN
+    LATENCY_OUTPUT_CAN};    // LATENCY_PATH_SOCKET2CAN
+static const char* const g_pathName[LATENCY_NUMBER_OF_PATHS] = {
+    "CAN->MQTT", "MQTT->CAN", "Socket->CAN"};
+static const char* const g_stageName[LATENCY_NUMBER_OF_STAGES] = {
+    "input queue", "handler", "output queue", "output", "total"};
+// Message being handled by each thread (between dequeued and handled)
+static __thread int t_path = LATENCY_PATH_NONE;
+static __thread unsigned long long t_origin;
+static __thread unsigned long long t_dequeued;
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static int getBucket(unsigned long long us);
+static unsigned long long getBucketLimit(int bucket);
+static void updateMax(unsigned long long *max, unsigned long long us);
+static void addSample(int path, latencyStage_t stage,
+        unsigned long long start, unsigned long long now);
+static void getHistogramStats(const unsigned long *count,
+        unsigned long long max, latencyStats_t *stats);
+static void getWindowStats(int path, int stage, latencyStats_t *stats);
+
+// Histogram bucket of a value
+static int getBucket(unsigned long long us)
+{
+    int bucket;
+    if(us == 0)
+    {
+        return 0;
+    }
+    bucket = 64 - __builtin_clzll(us);
+    if(bucket >= LATENCY_BUCKETS)
+    {
+        bucket = LATENCY_BUCKETS - 1;
+    }
+    return bucket;
+}
+
+// Upper limit of a bucket (us)
+static unsigned long long getBucketLimit(int bucket)
+{
+    return 1ULL << bucket;
+}
+
+// Raise a max to a value
+static void updateMax(unsigned long long *max, unsigned long long us)
+{
+    unsigned long long current;
+    current = __atomic_load_n(max, __ATOMIC_RELAXED);
+    while((us > current) && !__atomic_compare_exchange_n(max, &current,
+            us, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+        // max was updated with the current value - try again
+    }
+}
+
+// Add a sample (now - start) to the histogram of a path stage
+static void addSample(int path, latencyStage_t stage,
+        unsigned long long start, unsigned long long now)
+{
+    unsigned long long us;
+    latencyHistogram_t* histogram;
+    if((path <= LATENCY_PATH_NONE) || (path >= LATENCY_NUMBER_OF_PATHS) ||
+            (start == 0))
+    {
+        return;
+    }
+    us = (now > start) ? (now - start) : 0;
+    histogram = &g_histogram[path][stage];
+    __atomic_fetch_add(&histogram->bucket[getBucket(us)], 1,
+            __ATOMIC_RELAXED);
+    updateMax(&histogram->max, us);
+    updateMax(&histogram->windowMax, us);
+}
+
+// Statistics of the counts of a histogram
+static void getHistogramStats(const unsigned long *count,
+        unsigned long long max, latencyStats_t *stats)
+{
+    int i;
+    unsigned long sum;
+    unsigned long rank50;
+    unsigned long rank99;
+    stats->count = 0;
+    stats->p50 = 0;
+    stats->p99 = 0;
+    stats->max = max;
+    for(i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        stats->count += count[i];
+    }
+    if(stats->count == 0)
+    {
+        return;
+    }
+    // Rank of the percentiles (1 to count)
+    rank50 = (stats->count + 1) / 2;
+    rank99 = stats->count - stats->count / 100;
+    sum = 0;
+    for(i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        sum += count[i];
+        if((stats->p50 == 0) && (sum >= rank50))
+        {
+            stats->p50 = getBucketLimit(i);
+        }
+        if(sum >= rank99)
+        {
+            stats->p99 = getBucketLimit(i);
+            break;
+        }
+    }
+    if(stats->p50 > stats->max)
+    {
+        stats->p50 = stats->max;
+    }
+    if(stats->p99 > stats->max)
+    {
+        stats->p99 = stats->max;
+    }
+}
+
+// Statistics of the report window of a stage (a new window is started)
+static void getWindowStats(int path, int stage, latencyStats_t *stats)
+{
+    int i;
+    unsigned long total;
+    unsigned long count[LATENCY_BUCKETS];
+    latencyHistogram_t* histogram;
+    histogram = &g_histogram[path][stage];
+    for(i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        total = __atomic_load_n(&histogram->bucket[i], __ATOMIC_RELAXED);
+        count[i] = total - histogram->reported[i];
+        histogram->reported[i] = total;
+    }
+    getHistogramStats(count, __atomic_exchange_n(&histogram->windowMax, 0,
+            __ATOMIC_RELAXED), stats);
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+// Monotonic time (us)
+unsigned long long latency_getTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// Message received - start of the path
+void latency_stampRx(latencyStamp_t *stamp, latencyPath_t path)
+{
+    stamp->origin = latency_getTime();
+    stamp->enqueued = stamp->origin;
+    stamp->path = path;
+}
+
+// Message added to an output queue
+void latency_stampTx(latencyStamp_t *stamp, latencyOutput_t output)
+{
+    stamp->enqueued = latency_getTime();
+    if((t_path > LATENCY_PATH_NONE) && (g_pathOutput[t_path] == output))
+    {
+        stamp->origin = t_origin;
+        stamp->path = t_path;
+    }
+    else
+    {
+        stamp->origin = stamp->enqueued;
+        stamp->path = LATENCY_PATH_NONE;
+    }
+}
+
+// Message read from an input queue
+void latency_dequeued(const latencyStamp_t *stamp)
+{
+    t_dequeued = latency_getTime();
+    t_path = stamp->path;
+    t_origin = stamp->origin;
+    addSample(stamp->path, LATENCY_STAGE_INPUT_QUEUE, stamp->enqueued,
+            t_dequeued);
+}
+
+// Message read from an input queue was handled
+void latency_handled(void)
+{
+    addSample(t_path, LATENCY_STAGE_HANDLER, t_dequeued, latency_getTime());
+    t_path = LATENCY_PATH_NONE;
+}
+
+// Message being handled is handed over to another thread
+void latency_handOver(latencyStamp_t *stamp)
+{
+    stamp->origin = t_origin;
+    stamp->enqueued = t_dequeued;
+    stamp->path = t_path;
+    t_path = LATENCY_PATH_NONE;
+}
+
+// Message handed over by another thread
+void latency_takeOver(const latencyStamp_t *stamp)
+{
+    t_path = stamp->path;
+    t_origin = stamp->origin;
+    t_dequeued = stamp->enqueued;
+}
+
+// Message read from an output queue
+unsigned long long latency_sendStart(const latencyStamp_t *stamp)
+{
+    unsigned long long now;
+    now = latency_getTime();
+    addSample(stamp->path, LATENCY_STAGE_OUTPUT_QUEUE, stamp->enqueued, now);
+    return now;
+}
+
+// Message sent / acknowledged
+void latency_sent(const latencyStamp_t *stamp, unsigned long long start)
+{
+    unsigned long long now;
+    now = latency_getTime();
+    addSample(stamp->path, LATENCY_STAGE_OUTPUT, start, now);
+    addSample(stamp->path, LATENCY_STAGE_TOTAL, stamp->origin, now);
+}
+
+// Statistics of a stage (cumulative)
+int latency_getStats(latencyPath_t path, latencyStage_t stage,
+        latencyStats_t *stats)
+{
+    int i;
+    unsigned long count[LATENCY_BUCKETS];
+    latencyHistogram_t* histogram;
+    if((path <= LATENCY_PATH_NONE) || (path >= LATENCY_NUMBER_OF_PATHS) ||
+            (stage < 0) || (stage >= LATENCY_NUMBER_OF_STAGES))
+    {
+        stats->count = 0;
+        stats->p50 = 0;
+        stats->p99 = 0;
+        stats->max = 0;
+        return EXIT_FAILURE;
+    }
+    histogram = &g_histogram[path][stage];
+    for(i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        count[i] = __atomic_load_n(&histogram->bucket[i], __ATOMIC_RELAXED);
+    }
+    getHistogramStats(count, __atomic_load_n(&histogram->max, 
+            __ATOMIC_RELAXED), stats);
+    return EXIT_SUCCESS;
+}
+
+// Start a new report window (the cumulative histograms are not cleared)
+void latency_reset(void)
+{
+    int path;
+    int stage;
+    latencyStats_t stats;
+    for(path = 0; path < LATENCY_NUMBER_OF_PATHS; path++)
+    {
+        for(stage = 0; stage < LATENCY_NUMBER_OF_STAGES; stage++)
+        {
+            getWindowStats(path, stage, &stats);
+        }
+    }
+}
+
+// Print the report window and start a new one
+void latency_report(void)
+{
+    int path;
+    int stage;
+    latencyStats_t stats;
+    for(path = 0; path < LATENCY_NUMBER_OF_PATHS; path++)
+    {
+        for(stage = 0; stage < LATENCY_NUMBER_OF_STAGES; stage++)
+        {
+            getWindowStats(path, stage, &stats);
+            #ifdef DEBUG_LATENCY
+            if(stats.count > 0)
+            {
+                debug_print("LATENCY %s - %s: n=%lu p50=%lluus p99=%lluus "
+                        "max=%lluus\n", g_pathName[path], g_stageName[stage],
+                        stats.count, stats.p50, stats.p99, stats.max);
+            }
+            #endif
+        }
+    }
+}
@@ -0,0 +1,187 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add latency_handOver / latency_takeOver (message handled by another      //
+// thread)                                                                    //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Statistics are cumulative. latency_reset / latency_report use a          //
+// separate report window                                                     //
+//----------------------------------------------------------------------------//
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+/* Default period of the latency report (seconds) - latencyReportPeriod */
+#define LATENCY_DEFAULT_REPORT_PERIOD   60
+
+//----------------------------------------------------------------------------//
+// EXTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Path of a message through the gateway (where it comes from / goes to)
+typedef enum
+{
+    LATENCY_PATH_NONE = -1,         // Not measured (e.g. periodic messages)
+    LATENCY_PATH_CAN2MQTT = 0,      // CAN read -> MQTT publish (broker ack)
+    LATENCY_PATH_MQTT2CAN,          // MQTT subscription -> CAN write
+    LATENCY_PATH_SOCKET2CAN,        // Socket server read -> CAN write
+    LATENCY_NUMBER_OF_PATHS
+} latencyPath_t;
+
+// Stages of a path
+typedef enum
+{
+    LATENCY_STAGE_INPUT_QUEUE = 0,  // received -> read from the input queue
+    LATENCY_STAGE_HANDLER,          // read from the input queue -> handled
+    LATENCY_STAGE_OUTPUT_QUEUE,     // added to the output queue -> read
+    LATENCY_STAGE_OUTPUT,           // read from the output queue -> sent / ack
+    LATENCY_STAGE_TOTAL,            // received -> sent / ack
+    LATENCY_NUMBER_OF_STAGES
+} latencyStage_t;
+
+// Output of a message
+typedef enum
+{
+    LATENCY_OUTPUT_MQTT = 0,
+    LATENCY_OUTPUT_CAN
+} latencyOutput_t;
+
+// Stamp stored with each message in a queue (monotonic clock, us)
+typedef struct
+{
+    unsigned long long origin;      // Message received (start of the path)
+    unsigned long long enqueued;    // Message added to the queue
+    int path;                       // latencyPath_t
+} latencyStamp_t;
+
+// Statistics of a stage (us). Percentiles are the upper limit of the
+// histogram bucket (power of 2), limited to max.
+typedef struct
+{
+    unsigned long count;
+    unsigned long long p50;
+    unsigned long long p99;
+    unsigned long long max;
+} latencyStats_t;
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Monotonic time in microseconds
+ *
+ * \return  time (us)
+ */
+unsigned long long latency_getTime(void);
+
+/**
+ * Stamp a message received from a bus / broker / client, before it is added
+ * to the input queue. This is the start of the path.
+ *
+ * \param   stamp   stamp to be filled (OUTPUT)
+ * \param   path    path of the message (INPUT)
+ */
+void latency_stampRx(latencyStamp_t *stamp, latencyPath_t path);
+
+/**
+ * Stamp a message before it is added to an output queue. The path is the path
+ * of the message being handled by this thread (see latency_dequeued), if the
+ * path ends on this output. If not, the message is not measured.
+ *
+ * \param   stamp   stamp to be filled (OUTPUT)
+ * \param   output  output of the queue (INPUT)
+ */
+void latency_stampTx(latencyStamp_t *stamp, latencyOutput_t output);
+
+/**
+ * A message was read from an input queue: records the input queue stage and
+ * sets the message as the one being handled by this thread, until
+ * latency_handled is called.
+ *
+ * \param   stamp   stamp of the message (INPUT)
+ */
+void latency_dequeued(const latencyStamp_t *stamp);
+
+/**
+ * The message read with latency_dequeued was handled: records the handler
+ * stage.
+ */
+void latency_handled(void);
+
+/**
+ * The message read with latency_dequeued is handed over to another thread
+ * (e.g. a worker queue): fills the stamp with the message being handled by
+ * this thread, which is not handling it any more. The handler stage is not
+ * recorded here - it ends when the other thread calls latency_handled.
+ *
+ * \param   stamp   stamp to be filled (OUTPUT)
+ */
+void latency_handOver(latencyStamp_t *stamp);
+
+/**
+ * A message handed over by another thread (see latency_handOver) is handled
+ * by this thread, until latency_handled is called. The handler stage includes
+ * the time the message waited for this thread.
+ *
+ * \param   stamp   stamp of the message (INPUT)
+ */
+void latency_takeOver(const latencyStamp_t *stamp);
+
+/**
+ * A message was read from an output queue: records the output queue stage.
+ *
+ * \param   stamp   stamp of the message (INPUT)
+ * \return  time (us) - start of the output stage (see latency_sent)
+ */
+unsigned long long latency_sendStart(const latencyStamp_t *stamp);
+
+/**
+ * A message was sent (CAN) or acknowledged by the broker (MQTT): records the
+ * output stage and the total of the path.
+ *
+ * \param   stamp   stamp of the message (INPUT)
+ * \param   start   value returned by latency_sendStart (INPUT)
+ */
+void latency_sent(const latencyStamp_t *stamp, unsigned long long start);
+
+/**
+ * Get the statistics of a stage since the start (cumulative: exported as 
+ * metrics, not cleared by latency_reset / latency_report).
+ *
+ * \param   path    path (INPUT)
+ * \param   stage   stage (INPUT)
+ * \param   stats   statistics (OUTPUT)
+ * \return  EXIT_SUCCESS / EXIT_FAILURE (invalid path or stage)
+ */
+int latency_getStats(latencyPath_t path, latencyStage_t stage,
+        latencyStats_t *stats);
+
+/**
+ * Start a new report window (see latency_report).
+ */
+void latency_reset(void);
+
+/**
+ * Print p50 / p99 / max of every stage with samples in the report window 
+ * (since the last report) and start a new window.
+ */
+void latency_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATENCY_H */
@@ -6,6 +6,13 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - stdout is buffered: debug messages are flushed by the debug module       //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Query of the bus trace: HMSG --trace <directory> [node] [group] [from]   //
+// [to] ("-" for any, times in ms since epoch)                                //
+//----------------------------------------------------------------------------//
 
 /*
 * Includes
@@ -15,11 +22,54 @@
 #include <string.h>
 #include "manager.h"
 #include "tests.h"
+#include "trace.h"
+
+/**
+ * Print the bus trace records of a node / group in a time range
+ * 
+ * \param   argc    number of arguments
+ * \param   argv    --trace <directory> [node] [group] [from] [to], "-" (or 
+ *                  no argument) for any node / group / time
+ * \return  EXIT_SUCCESS / EXIT_FAILURE
+ */
+static int traceQuery(int argc, char *argv[])
+{
+    long long value[4] = {TRACE_ANY, TRACE_ANY, TRACE_ANY_TIME, 
+            TRACE_ANY_TIME};
+    int li_index;
+    int found;
+    if(argc < 3)
+    {
+        printf("Usage: %s --trace <directory> [node] [group] [from] [to]\n", 
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    for(li_index = 0; (li_index < 4) && (li_index + 3 < argc); li_index++)
+    {
+        if(strcmp(argv[li_index + 3], "-") != 0)
+        {
+            value[li_index] = strtoll(argv[li_index + 3], NULL, 0);
+        }
+    }
+    found = trace_query(argv[2], (int)value[0], (int)value[1], 
+            (unsigned long long)value[2], (unsigned long long)value[3], 
+            trace_printRecord, stdout);
+    if(found < 0)
+    {
+        printf("Trace directory error: %s\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+    printf("%d records\n", found);
+    return EXIT_SUCCESS;
+}
 
 int main(int argc, char *argv[])
 {    
-    setbuf(stdout, NULL); // disable buffering on stdout: Needed for immediate debug
-    
+    // Query the bus trace (no gateway)
+    if((argc > 1) && (strcmp(argv[1], "--trace") == 0))
+    {
+        return traceQuery(argc, argv);
+    }
     // Init manager or perform module tests - see tests.h
     #ifdef TEST_RUN_MODULE_TESTS
     tests_Init();
@@ -19,37 +19,112 @@
 // - Perform initial status update for all configured modules when CAN and    //
 // MQTT are connected                                                         //
 //----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - MQTT SUB topic and payload are freed with mqttbuf_freeSubMsg             //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Queue sizes and overflow policies are applied again after a              //
+// configuration reload                                                       //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - Latency of the CAN->MQTT, MQTT->CAN and Socket->CAN handlers and         //
+// periodic latency report thread                                             //
+//----------------------------------------------------------------------------//
+//  1.08     | 18/Oct/2026 |                               | ALCP             //
+// - Metrics: periodic JSON message (MQTT) and Prometheus text endpoint       //
+//----------------------------------------------------------------------------//
+//  1.09     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_MANAGER         //
+// - Start the debug thread; log levels are read again on each reload         //
+//----------------------------------------------------------------------------//
+//  1.10     | 18/Oct/2026 |                               | ALCP             //
+// - Bus trace recorder opened / closed from the configuration (trace.h)      //
+//----------------------------------------------------------------------------//
+//  1.11     | 18/Oct/2026 |                               | ALCP             //
+// - One connection / read / write / buffers pipeline (threads) for each CAN  //
+// channel; received frames teach the channel of each node (canroute.h)       //
+//----------------------------------------------------------------------------//
+//  1.12     | 18/Oct/2026 |                               | ALCP             //
+// - Frames received are forwarded to other CAN channels by the bridge        //
+// routes (canbridge.h), read at start-up and on each reload                  //
+//----------------------------------------------------------------------------//
+//  1.13     | 18/Oct/2026 |                               | ALCP             //
+// - Raw frames waiting in a batch are published by the CAN buffers threads   //
+//----------------------------------------------------------------------------//
+//  1.14     | 18/Oct/2026 |                               | ALCP             //
+// - Configuration file watched with inotify (no 10 s polling); a file that   //
+// is not valid is not used                                                   //
+//----------------------------------------------------------------------------//
+//  1.15     | 18/Oct/2026 |                               | ALCP             //
+// - Configuration reload patches the gateway and module lists (only the      //
+// changed modules are added / removed, no full status update)                //
+//----------------------------------------------------------------------------//
+//  1.16     | 18/Oct/2026 |                               | ALCP             //
+// - Threads are created with the scheduling profile of the configuration     //
+// (CPU affinity, SCHED_FIFO priority, stack size, memory lock - threadprof.h)//
+//----------------------------------------------------------------------------//
+//  1.17     | 18/Oct/2026 |                               | ALCP             //
+// - Optional CAN->MQTT workers (hapcanpool.h): frames of different modules   //
+// are handled in parallel, the frames of a module in order                   //
+//----------------------------------------------------------------------------//
+//  1.18     | 18/Oct/2026 |                               | ALCP             //
+// - Trace writer thread (frames of the CAN threads written to the trace      //
+// files - trace_flush)                                                       //
+//----------------------------------------------------------------------------//
+//  1.19     | 18/Oct/2026 |                               | ALCP             //
+// - The metrics are published with an interned topic                         //
+//----------------------------------------------------------------------------//
+//  1.20     | 18/Oct/2026 |                               | ALCP             //
+// - Latency histograms are not cleared while the report is disabled          //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_MANAGER
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <pthread.h>
 #include "app.h"
 #include "auxiliary.h"
 #include "buffer.h"
+#include "canbridge.h"
 #include "canbuf.h"
+#include "canroute.h"
 #include "config.h"
 #include "debug.h"
 #include "errorhandler.h"
 #include "gateway.h"
 #include "hapcan.h"
+#include "hapcanfed.h"
 #include "hapcanconfig.h"
 #include "hapcanmqtt.h"
+#include "hapcanpool.h"
 #include "hapcanrgb.h"
 #include "hrgbw.h"
 #include "hapcansocket.h"
 #include "hapcansystem.h"
+#include "latency.h"
 #include "manager.h"
+#include "metrics.h"
+#include "metricsserver.h"
 #include "mqttbuf.h"
 #include "socketserverbuf.h"
+#include "threadprof.h"
+#include "topic.h"
+#include "trace.h"
 
 //----------------------------------------------------------------------------//
 // INTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
 #define NUMBER_OF_THREADS   14
-#define NUMBER_OF_BUFFERS   MQTT_NUMBER_OF_BUFFERS + SOCKETSERVER_NUMBER_OF_BUFFERS + CAN_NUMBER_OF_BUFFERS // Use SOCKETCAN_CHANNELS*CAN_NUMBER_OF_BUFFERS if more than one CAN channel is used
+#define NUMBER_OF_CAN_THREADS   4   // For each CAN channel
+#define NUMBER_OF_BUFFERS   MQTT_NUMBER_OF_BUFFERS + SOCKETSERVER_NUMBER_OF_BUFFERS + SOCKETCAN_CHANNELS*CAN_NUMBER_OF_BUFFERS
 #define INIT_RETRIES    5
 
 //----------------------------------------------------------------------------//
@@ -63,10 +138,10 @@ typedef void* (*vp_thread_t)( void *arg );
 void* managerHandleMQTTConn(void *arg);
 void* managerHandleMQTTSub(void *arg);
 void* managerHandleMQTTPub(void *arg);
-void* managerHandleCAN0Conn(void *arg);
-void* managerHandleCAN0Read(void *arg);
-void* managerHandleCAN0Write(void *arg);
-void* managerHandleCAN0Buffers(void *arg);
+void* managerHandleCANConn(void *arg);
+void* managerHandleCANRead(void *arg);
+void* managerHandleCANWrite(void *arg);
+void* managerHandleCANBuffers(void *arg);
 void* managerHandleSocketServerConn(void *arg);
 void* managerHandleSocketServerRead(void *arg);
 void* managerHandleSocketServerWrite(void *arg);
@@ -74,6 +149,10 @@ void* managerHandleSocketServerBuffers(void *arg);
 void* managerHandleHAPCANRTCEvents(void *arg);
 void* managerHandleHAPCANPeriodic(void *arg);
 void* managerHandleConfigFile(void *arg);
+void* managerHandleLatencyReport(void *arg);
+void* managerHandleMetricsPublish(void *arg);
+void* managerHandleMetricsServer(void *arg);
+void* managerHandleTraceWriter(void *arg);
 
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
@@ -83,22 +162,66 @@ vp_thread_t vp_thread[NUMBER_OF_THREADS] =
 {   managerHandleMQTTConn, 
     managerHandleMQTTSub, 
     managerHandleMQTTPub, 
-    managerHandleCAN0Conn,              // Manage Socket connection for CAN0
-    managerHandleCAN0Read,              // Fill the CAN0 Buffer IN (Read)
-    managerHandleCAN0Write,             // Fill the CAN0 Buffer OUT (Write)
-    managerHandleCAN0Buffers,           // Manage CAN0 Buffers
     managerHandleSocketServerConn,      // Manage Socket Client Connections
     managerHandleSocketServerRead,      // Fill the Socket Server Read Buffer
     managerHandleSocketServerWrite,     // Send from Socket Server Write Buffer
     managerHandleSocketServerBuffers,   // Manage Socket Server Buffers
     managerHandleHAPCANRTCEvents,       // Manage RTC messages
     managerHandleHAPCANPeriodic,        // Manage Periodic events (System)
-    managerHandleConfigFile};           // Handle Config File Updates
+    managerHandleConfigFile,            // Handle Config File Updates
+    managerHandleLatencyReport,         // Report latency histograms
+    managerHandleMetricsPublish,        // Publish metrics (MQTT)
+    managerHandleMetricsServer,         // Metrics endpoint (Prometheus)
+    managerHandleTraceWriter};          // Write the bus trace files
+// Names of the threads (section "ThreadProfiles")
+const char* c_threadName[NUMBER_OF_THREADS] = 
+{   "mqttConn",
+    "mqttSub",
+    "mqttPub",
+    "socketServerConn",
+    "socketServerRead",
+    "socketServerWrite",
+    "socketServerBuffers",
+    "rtc",
+    "periodic",
+    "config",
+    "latencyReport",
+    "metricsPublish",
+    "metricsServer",
+    "traceWriter"};
+// Threads of each CAN channel (argument: channel)
+pthread_t pt_canThreadID[SOCKETCAN_CHANNELS][NUMBER_OF_CAN_THREADS];
+vp_thread_t vp_canThread[NUMBER_OF_CAN_THREADS] = 
+{   managerHandleCANConn,               // Manage Socket connection
+    managerHandleCANRead,               // Fill the CAN Buffer IN (Read)
+    managerHandleCANWrite,              // Fill the CAN Buffer OUT (Write)
+    managerHandleCANBuffers};           // Manage CAN Buffers
+const char* c_canThreadName[NUMBER_OF_CAN_THREADS] = 
+{   "canConn",
+    "canRead",
+    "canWrite",
+    "canBuffers"};
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS - AUXILIARY
 //----------------------------------------------------------------------------//
+static bool isCANConnected(void);
 
+/* At least one CAN channel is connected */
+static bool isCANConnected(void)
+{
+    int channel;
+    stateCAN_t sc_state;
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
+    {
+        if( (canbuf_getState(channel, &sc_state) == EXIT_SUCCESS) && 
+                (sc_state == CAN_CONNECTED) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
 
 //----------------------------------------------------------------------------//
 // INTERNAL FUNCTIONS - THREADS
@@ -175,11 +298,11 @@ void* managerHandleMQTTSub(void *arg)
                     // Error is handled within the function
                     hapcan_handleMQTT2CAN(topic, payload, payloadlen, 
                             timestamp);
+                    latency_handled();
                 }
-                // FREE DATA
-                free(topic);
+                // FREE DATA (topic and payload)
+                mqttbuf_freeSubMsg(topic);
                 topic = NULL;
-                free(payload);
                 payload = NULL;                
             }            
             // 2ms delay after sending all messages while connected
@@ -229,10 +352,10 @@ void* managerHandleMQTTPub(void *arg)
     }
 }
 
-/* THREAD - Handle CAN0 Connection */
-void* managerHandleCAN0Conn(void *arg)
+/* THREAD - Handle CAN Connection (arg: channel) */
+void* managerHandleCANConn(void *arg)
 {
-    const int channel = 0;
+    const int channel = (int)(intptr_t)arg;
     int check;
     stateCAN_t sc_state;
     while(1)
@@ -251,10 +374,10 @@ void* managerHandleCAN0Conn(void *arg)
     }
 }
 
-/* THREAD - Handle CAN0 Reads */
-void* managerHandleCAN0Read(void *arg)
+/* THREAD - Handle CAN Reads (arg: channel) */
+void* managerHandleCANRead(void *arg)
 {
-    const int channel = 0;
+    const int channel = (int)(intptr_t)arg;
     int check;
     stateCAN_t sc_state;
     bool b_retry;
@@ -272,7 +395,8 @@ void* managerHandleCAN0Read(void *arg)
                     // Check with 5ms timeout
                     check = canbuf_receive(channel, 5000);
                     // Check and handle the error
-                    b_retry = !errorh_isError(ERROR_MODULE_CAN_RECEIVE, check);
+                    b_retry = !errorh_isCANError(channel, 
+                            ERROR_MODULE_CAN_RECEIVE, check);
                     // Stay in loop if a message was just read successfully
                     b_retry = b_retry && (check == CAN_RECEIVE_OK);                    
                 }
@@ -289,10 +413,10 @@ void* managerHandleCAN0Read(void *arg)
     }
 }
 
-/* THREAD - Handle CAN0 Writes */
-void* managerHandleCAN0Write(void *arg)
+/* THREAD - Handle CAN Writes (arg: channel) */
+void* managerHandleCANWrite(void *arg)
 {
-    const int channel = 0;
+    const int channel = (int)(intptr_t)arg;
     int check;
     stateCAN_t sc_state;
     bool b_retry;
@@ -311,7 +435,8 @@ void* managerHandleCAN0Write(void *arg)
                     // Send CAN Write Buffer message
                     check = canbuf_send(channel);
                     // Check and handle the error
-                    b_retry = !errorh_isError(ERROR_MODULE_CAN_SEND, check);
+                    b_retry = !errorh_isCANError(channel, 
+                            ERROR_MODULE_CAN_SEND, check);
                     // Stay in loop if a message was just sent successfully
                     b_retry = b_retry && (check == CAN_SEND_OK);
                 }
@@ -328,10 +453,10 @@ void* managerHandleCAN0Write(void *arg)
     }
 }
 
-/* THREAD - Handle CAN0 Buffers */
-void* managerHandleCAN0Buffers(void *arg)
+/* THREAD - Handle CAN Buffers (arg: channel) */
+void* managerHandleCANBuffers(void *arg)
 {
-    const int channel = 0;
+    const int channel = (int)(intptr_t)arg;
     int check;
     stateCAN_t sc_state;
     struct can_frame cf_Frame;
@@ -355,15 +480,21 @@ void* managerHandleCAN0Buffers(void *arg)
                     check = canbuf_getReadMsgFromBuffer(channel, &cf_Frame, 
                             &timestamp);
                     // Check and handle the error
-                    b_retry = !errorh_isError(ERROR_MODULE_CAN_RECEIVE, check);
+                    b_retry = !errorh_isCANError(channel, 
+                            ERROR_MODULE_CAN_RECEIVE, check);
                     // Stay in loop if a message was just read successfully
                     b_retry = b_retry && (check == CAN_RECEIVE_OK);                    
                     if(b_retry)
                     {
+                        //------------------------------------------
+                        // Forward to other channels (bridge routes)
+                        //------------------------------------------
+                        canbridge_forward(channel, &cf_Frame, timestamp);
                         //------------------------------------------
                         // Message is OK to be sent to the Socket
                         //------------------------------------------
                         hapcan_getHAPCANDataFromCAN(&cf_Frame, &hapcanData);
+                        canroute_learn(&hapcanData, channel);
                         hs_getSocketArrayFromHAPCAN(&hapcanData, data);
                         dataLen = HAPCAN_SOCKET_DATA_LEN;
                         check = socketserverbuf_setWriteMsgToBuffer(data, 
@@ -372,11 +503,19 @@ void* managerHandleCAN0Buffers(void *arg)
                         errorh_isError(ERROR_MODULE_SOCKETSERVER_SEND, check);
                         //-------------------------------------------------
                         // Process CAN Message and send MQTT response    
+                        // (by a worker of the module, if enabled)
                         //-------------------------------------------------
-                        // Error in handled within the function
-                        hapcan_handleCAN2MQTT(&hapcanData, timestamp);                        
+                        check = hpool_dispatch(&hapcanData, timestamp);
+                        if(check != EXIT_SUCCESS)
+                        {
+                            // Error is handled within the function
+                            hapcan_handleCAN2MQTT(&hapcanData, timestamp);
+                            latency_handled();
+                        }
                     }
                 }
+                // Raw frames batch waiting for too long
+                hfed_flush(aux_getmsSinceEpoch());
                 // 2ms loop after empty buffer
                 usleep(2000); 
             }
@@ -531,6 +670,7 @@ void* managerHandleSocketServerBuffers(void *arg)
                         // (PROGRAMMER) or a CAN Frame to Bus
                         // Error is handled within the function
                         hs_handleMsgFromSocket(data, dataLen, timestamp);
+                        latency_handled();
                     }
                 }
                 // 2ms delay after processing all messages while connected
@@ -550,7 +690,6 @@ void* managerHandleHAPCANRTCEvents(void *arg)
 {
     int check;
     bool enable;
-    stateCAN_t sc_state;
     hapcanCANData hapcanData;
     unsigned long long timestamp;
     int temp;
@@ -573,20 +712,16 @@ void* managerHandleHAPCANRTCEvents(void *arg)
             temp = aux_getLocalYear();
             if(temp > 100) // After year 2000
             {
-                /* STATE CHECK AND RE-INIT */
-                check = canbuf_getState(0, &sc_state);
-                if( check == EXIT_SUCCESS )
+                /* STATE CHECK - Sent to every channel */
+                if(isCANConnected())
                 {
-                    if(sc_state == CAN_CONNECTED)
-                    {
-                        // Get Timestamp
-                        timestamp = aux_getmsSinceEpoch();
-                        // FILL RTC MESSAGE
-                        hapcan_setHAPCANRTCMessage(&hapcanData);  
-                        // Send CAN FRame - Error is handled within the function
-                        hapcan_addToCANWriteBuffer(&hapcanData, timestamp, 
-                                true);                        
-                    }                    
+                    // Get Timestamp
+                    timestamp = aux_getmsSinceEpoch();
+                    // FILL RTC MESSAGE
+                    hapcan_setHAPCANRTCMessage(&hapcanData);  
+                    // Send CAN FRame - Error is handled within the function
+                    hapcan_addToCANWriteBuffer(&hapcanData, timestamp, 
+                            true);                        
                 }
             }
         }
@@ -599,7 +734,6 @@ void* managerHandleHAPCANPeriodic(void *arg)
 {
     int check;
     bool enable;
-    stateCAN_t sc_state;
     while(1)
     {
         // Check if this feature is enabled:
@@ -611,9 +745,7 @@ void* managerHandleHAPCANPeriodic(void *arg)
         if(enable)
         {
             /* STATE CHECK AND RE-INIT */
-            check = canbuf_getState(0, &sc_state);
-            if( (check == EXIT_SUCCESS) && (sc_state == CAN_CONNECTED) && 
-                (mqttbuf_getState() == MQTT_CONNECTED) )
+            if( isCANConnected() && (mqttbuf_getState() == MQTT_CONNECTED) )
             {                                    
                 //----------------------------------------------------------
                 // Check for messages to be sent to CAN Bus or 
@@ -641,14 +773,24 @@ void* managerHandleConfigFile(void *arg)
 {    
     bool reloadMQTT;
     bool reload_socket_server;
+    int channel;
     while(1)
     {
-        if(config_isNewConfigAvailable())
+        // Blocks until the file is written (inotify)
+        if(config_waitNewConfig())
         {
             #ifdef DEBUG_MANAGER_CONFIG_EVENTS
             debug_print("managerHandleConfigFile - New config available!\n");
             #endif
-            config_reload(&reloadMQTT, &reload_socket_server);
+            if(config_reload(&reloadMQTT, &reload_socket_server) != 
+                    EXIT_SUCCESS)
+            {
+                // Not valid: keep running with the current configuration
+                continue;
+            }
+            debug_updateLevels();
+            trace_update();
+            canbridge_init();
             // If configuration changed, close connections
             if(reloadMQTT)
             {
@@ -658,18 +800,130 @@ void* managerHandleConfigFile(void *arg)
             {
                 socketserverbuf_close(1);
             }
-            // For every new configuration file, reload the gateway
-            gateway_init();
+            // Queue sizes and policies (queued messages are kept)
+            for(channel = 0; channel < canbuf_getChannels(); channel++)
+            {
+                canbuf_updateQueues(channel);
+            }
+            mqttbuf_updateQueues();
+            socketserverbuf_updateQueues();
+            // For every new configuration file, update the gateway: only the 
+            // elements and modules that changed are added / removed
+            gateway_beginUpdate();
             hapcan_initGateway();
-            hsystem_init();
+            gateway_endUpdate();
+            hsystem_update();
             // Print Gateway
             #ifdef DEBUG_GATEWAY_LISTS
             gateway_printList(GATEWAY_MQTT2CAN_LIST);
             gateway_printList(GATEWAY_CAN2MQTT_LIST);
             #endif
         }
-        // Only check every 10 seconds
-        sleep(10);        
+    }
+}
+
+/* THREAD - Report latency histograms (p50 / p99 / max) */
+void* managerHandleLatencyReport(void *arg)
+{
+    int check;
+    int period;
+    bool enabled = false;
+    while(1)
+    {
+        // Period in seconds - 0 disables the report
+        check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0, 
+                "latencyReportPeriod", 0, NULL, &period);
+        if((check != EXIT_SUCCESS) || (period < 0))
+        {
+            period = LATENCY_DEFAULT_REPORT_PERIOD;
+        }
+        if(period > 0)
+        {
+            if(!enabled)
+            {
+                // Report enabled: the first window starts now
+                latency_reset();
+                enabled = true;
+            }
+            sleep(period);
+            latency_report();
+        }
+        else
+        {
+            // Check the configuration again after 10 seconds (the 
+            // histograms are cumulative - nothing to clear)
+            enabled = false;
+            sleep(10);
+        }
+    }
+}
+
+/* THREAD - Write the frames recorded by the CAN threads to the bus trace */
+void* managerHandleTraceWriter(void *arg)
+{
+    while(1)
+    {
+        trace_flush();
+        usleep(TRACE_FLUSH_PERIOD * 1000);
+    }
+}
+
+/* THREAD - Publish metrics (JSON) on "metricsTopic" */
+void* managerHandleMetricsPublish(void *arg)
+{
+    int check;
+    int period;
+    int len;
+    char *topic;
+    const char *itopic;
+    char *text;
+    while(1)
+    {
+        // Period in seconds
+        check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0, 
+                "metricsPeriod", 0, NULL, &period);
+        if((check != EXIT_SUCCESS) || (period <= 0))
+        {
+            period = METRICS_DEFAULT_PERIOD;
+        }
+        sleep(period);
+        // No topic disables the message
+        check = config_getString(CONFIG_GENERAL_SETTINGS_LEVEL, 0, 
+                "metricsTopic", 0, NULL, &topic);
+        if(check != EXIT_SUCCESS)
+        {
+            continue;
+        }
+        if(mqttbuf_getState() == MQTT_CONNECTED)
+        {
+            len = metrics_getText(METRICS_FORMAT_JSON, &text);
+            if(len > 0)
+            {
+                itopic = topic_intern(topic);
+                check = mqttbuf_setPubMsgToBuffer(itopic, text, len, 
+                        aux_getmsSinceEpoch());
+                topic_release(itopic);
+                errorh_isError(ERROR_MODULE_MQTT_PUB, check);
+                free(text);
+            }
+        }
+        free(topic);
+    }
+}
+
+/* THREAD - Metrics endpoint (Prometheus text format) on "metricsPort" */
+void* managerHandleMetricsServer(void *arg)
+{
+    int check;
+    while(1)
+    {
+        check = metricsserver_handle(1000);
+        if((check == METRICSSERVER_DISABLED) || 
+                (check == METRICSSERVER_ERROR))
+        {
+            // Check the configuration again after 10 seconds
+            sleep(10);
+        }
     }
 }
 
@@ -681,10 +935,13 @@ void managerInit(void)
 {    
     int li_index;
     int li_check;
+    int channel;
 
     /**************************************************************************
      * Build date
      *************************************************************************/
+    // Debug messages are printed by the debug thread from now on
+    debug_init();
     #ifdef DEBUG_VERSION
     debug_print("HMSG Start! Version = %s.%s\n", APP_SW_MAIN_VERSION, 
             APP_SW_SUB_VERSION);
@@ -694,6 +951,10 @@ void managerInit(void)
      * INIT CONFIG AND GATEWAY
      *************************************************************************/
     config_init();
+    debug_updateLevels();
+    tprof_init();
+    trace_update();
+    canbridge_init();
     gateway_init();
     hapcan_initGateway();
     hsystem_init();
@@ -706,12 +967,15 @@ void managerInit(void)
     /**************************************************************************
      * INIT BUFFERS
      *************************************************************************/        
-    for(li_index = 0; li_index < INIT_RETRIES; li_index++)
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
     {
-        li_check = canbuf_init(0);
-        if(li_check == EXIT_SUCCESS)
+        for(li_index = 0; li_index < INIT_RETRIES; li_index++)
         {
-            break;
+            li_check = canbuf_init(channel);
+            if(li_check == EXIT_SUCCESS)
+            {
+                break;
+            }
         }
     }
     for(li_index = 0; li_index < INIT_RETRIES; li_index++)
@@ -734,22 +998,46 @@ void managerInit(void)
     /**************************************************************************
      * INIT THREADS - CREATE AND JOIN
      *************************************************************************/    
+    // CAN->MQTT workers (used by the CAN buffers threads)
+    hpool_init();
     // Create Threads
     for(li_index = 0; li_index < NUMBER_OF_THREADS; li_index++)
     {
-        li_check = pthread_create(&pt_threadID[li_index], 
-                NULL, vp_thread[li_index], NULL);
+        li_check = tprof_create(&pt_threadID[li_index], 
+                c_threadName[li_index], TPROF_NO_CHANNEL, 
+                vp_thread[li_index], NULL);
         if(li_check)
         {
             /***************/
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_MANAGER_ERRORS
-            debug_print("MANAGER: THREAD CREATE ERROR!\n");
-            debug_print("- Thread Index = %d\n", li_index);
+            debug_error("MANAGER: THREAD CREATE ERROR!\n");
+            debug_error("- Thread Index = %d\n", li_index);
             #endif
         }
     }    
+    // Create the threads of each CAN channel
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
+    {
+        for(li_index = 0; li_index < NUMBER_OF_CAN_THREADS; li_index++)
+        {
+            li_check = tprof_create(&pt_canThreadID[channel][li_index], 
+                    c_canThreadName[li_index], channel, 
+                    vp_canThread[li_index], (void *)(intptr_t)channel);
+            if(li_check)
+            {
+                /***************/
+                /* FATAL ERROR */
+                /***************/
+                #ifdef DEBUG_MANAGER_ERRORS
+                debug_error("MANAGER: CAN THREAD CREATE ERROR!\n");
+                debug_error("- Channel = %d\n", channel);
+                debug_error("- Thread Index = %d\n", li_index);
+                #endif
+            }
+        }
+    }
     // Join Threads
     for(li_index = 0; li_index < NUMBER_OF_THREADS; li_index++)
     {
@@ -760,9 +1048,16 @@ void managerInit(void)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_MANAGER_ERRORS
-            debug_print("MANAGER: THREAD JOIN ERROR!\n");
-            debug_print("- Thread Index = %d\n", li_index);
+            debug_error("MANAGER: THREAD JOIN ERROR!\n");
+            debug_error("- Thread Index = %d\n", li_index);
             #endif
         }
     }
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
+    {
+        for(li_index = 0; li_index < NUMBER_OF_CAN_THREADS; li_index++)
+        {
+            pthread_join(pt_canThreadID[channel][li_index], NULL);
+        }
+    }
 }
@@ -0,0 +1,610 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_MONITORING      //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - CAN counters of the configured channels only (canbuf_getChannels)        //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Frames forwarded between CAN channels and echoes not forwarded           //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Raw frames batches published / received and frames not written           //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Queue depth of the CAN->MQTT workers (hapcanpool.h)                      //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_MONITORING
+
+//----------------------------------------------------------------------------//
+// Includes
+//----------------------------------------------------------------------------//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "auxiliary.h"
+#include "canbuf.h"
+#include "config.h"
+#include "debug.h"
+#include "errorhandler.h"
+#include "hapcanpool.h"
+#include "hapcansystem.h"
+#include "latency.h"
+#include "metrics.h"
+#include "mqttbuf.h"
+#include "socketserverbuf.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+// Initial size of the text (grows if needed)
+#define METRICS_TEXT_SIZE   4096
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Counters of one thread. Only the thread writes them, the readers add the
+// counters of all threads.
+typedef struct metricsBlock_t
+{
+    unsigned long counter[METRICS_NUMBER_OF_COUNTERS][METRICS_INDEXES];
+    bool inUse;     // false: the thread has ended - block can be reused
+    struct metricsBlock_t *next;
+} metricsBlock_t;
+
+// Text being built
+typedef struct
+{
+    char *text;
+    int len;
+    int size;
+    bool error;
+} metricsText_t;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+static pthread_mutex_t g_metrics_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t g_metrics_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_metrics_key;
+static metricsBlock_t* g_metrics_head = NULL;
+static __thread metricsBlock_t* t_block = NULL;
+// Last values for the rates of the JSON message
+static unsigned long long g_last_ms = 0;
+static unsigned long g_last_rx[SOCKETCAN_CHANNELS];
+static unsigned long g_last_tx[SOCKETCAN_CHANNELS];
+// Names
+static const char* const g_errorName[ERROR_NUMBER_OF_MODULES] = {
+    "canSend", "canReceive", "socketServerSend", "socketServerReceive",
+    "mqttPub", "mqttSub"};
+static const char* const g_gatewayName[] = {"can2mqtt", "mqtt2can"};
+static const char* const g_pathName[LATENCY_NUMBER_OF_PATHS] = {
+    "can2mqtt", "mqtt2can", "socket2can"};
+static const char* const g_stageName[LATENCY_NUMBER_OF_STAGES] = {
+    "inputQueue", "handler", "outputQueue", "output", "total"};
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static void initKey(void);
+static void releaseBlock(void *block);
+static metricsBlock_t* getBlock(void);
+static void textAppend(metricsText_t *t, const char *format, ...);
+static void getJSON(metricsText_t *t);
+static void getPrometheus(metricsText_t *t);
+
+// Key used to release the counters of a thread when it ends
+static void initKey(void)
+{
+    pthread_key_create(&g_metrics_key, releaseBlock);
+}
+
+// Thread ended: the counters are kept (sum), the block can be reused
+static void releaseBlock(void *block)
+{
+    // LOCK LIST
+    pthread_mutex_lock(&g_metrics_mutex);
+    ((metricsBlock_t*)block)->inUse = false;
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_metrics_mutex);
+}
+
+// Counters of the current thread - created when first used
+static metricsBlock_t* getBlock(void)
+{
+    metricsBlock_t* block;
+    if(t_block != NULL)
+    {
+        return t_block;
+    }
+    pthread_once(&g_metrics_once, initKey);
+    // LOCK LIST
+    pthread_mutex_lock(&g_metrics_mutex);
+    // Reuse the block of a thread that has ended
+    for(block = g_metrics_head; block != NULL; block = block->next)
+    {
+        if(!block->inUse)
+        {
+            break;
+        }
+    }
+    if(block == NULL)
+    {
+        block = calloc(1, sizeof(*block));
+        if(block != NULL)
+        {
+            block->next = g_metrics_head;
+            g_metrics_head = block;
+        }
+    }
+    if(block != NULL)
+    {
+        block->inUse = true;
+    }
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_metrics_mutex);
+    if(block != NULL)
+    {
+        pthread_setspecific(g_metrics_key, block);
+    }
+    t_block = block;
+    return block;
+}
+
+// Append to the text (printf format)
+static void textAppend(metricsText_t *t, const char *format, ...)
+{
+    va_list args;
+    int len;
+    char *text;
+    if(t->error)
+    {
+        return;
+    }
+    va_start(args, format);
+    len = vsnprintf(t->text + t->len, t->size - t->len, format, args);
+    va_end(args);
+    if((len >= 0) && (len >= (t->size - t->len)))
+    {
+        // Grow and write again
+        text = realloc(t->text, t->size + len + METRICS_TEXT_SIZE);
+        if(text == NULL)
+        {
+            t->error = true;
+            return;
+        }
+        t->text = text;
+        t->size = t->size + len + METRICS_TEXT_SIZE;
+        va_start(args, format);
+        len = vsnprintf(t->text + t->len, t->size - t->len, format, args);
+        va_end(args);
+    }
+    if(len < 0)
+    {
+        t->error = true;
+        return;
+    }
+    t->len += len;
+}
+
+// JSON message (MQTT)
+static void getJSON(metricsText_t *t)
+{
+    int channel;
+    int i;
+    int path;
+    int stage;
+    int node;
+    int group;
+    unsigned long read;
+    unsigned long write;
+    unsigned long dropRead;
+    unsigned long dropWrite;
+    unsigned long count;
+    unsigned long rx;
+    unsigned long tx;
+    unsigned long depth[HPOOL_MAX_WORKERS];
+    int workers;
+    unsigned long long now;
+    double seconds;
+    latencyStats_t stats;
+
+    now = aux_getmsSinceEpoch();
+    seconds = (g_last_ms > 0) ? ((now - g_last_ms) / 1000.0) : 0;
+    textAppend(t, "{\"timestamp\":%llu,\"can\":[", now);
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
+    {
+        rx = metrics_get(METRICS_CAN_RX_FRAMES, channel);
+        tx = metrics_get(METRICS_CAN_TX_FRAMES, channel);
+        canbuf_getQueueDepth(channel, &read, &write);
+        canbuf_getDropCount(channel, &dropRead, &dropWrite);
+        textAppend(t, "%s{\"channel\":%d,\"rxFrames\":%lu,\"txFrames\":%lu,"
+                "\"rxPerSecond\":%.1f,\"txPerSecond\":%.1f,"
+                "\"bridgedFrames\":%lu,\"bridgeLoops\":%lu,"
+                "\"readQueue\":{\"depth\":%lu,\"drops\":%lu},"
+                "\"writeQueue\":{\"depth\":%lu,\"drops\":%lu}}",
+                (channel > 0) ? "," : "", channel, rx, tx,
+                (seconds > 0) ? ((rx - g_last_rx[channel]) / seconds) : 0,
+                (seconds > 0) ? ((tx - g_last_tx[channel]) / seconds) : 0,
+                metrics_get(METRICS_CAN_BRIDGED_FRAMES, channel),
+                metrics_get(METRICS_CAN_BRIDGE_LOOPS, channel),
+                read, dropRead, write, dropWrite);
+        g_last_rx[channel] = rx;
+        g_last_tx[channel] = tx;
+    }
+    g_last_ms = now;
+    // MQTT
+    mqttbuf_getQueueDepth(&read, &write);
+    mqttbuf_getDropCount(&dropRead, &dropWrite);
+    count = metrics_get(METRICS_MQTT_TX_MESSAGES, 0);
+    textAppend(t, "],\"mqtt\":{\"rxMessages\":%lu,\"txMessages\":%lu,"
+            "\"publishRttAvgUs\":%lu,\"connectAttempts\":%lu,"
+            "\"connections\":%lu,\"connectionsLost\":%lu,"
+            "\"subQueue\":{\"depth\":%lu,\"drops\":%lu},"
+            "\"pubQueue\":{\"depth\":%lu,\"drops\":%lu}}",
+            metrics_get(METRICS_MQTT_RX_MESSAGES, 0), count,
+            (count > 0) ? (metrics_get(METRICS_MQTT_PUB_RTT_US, 0) / count) : 0,
+            metrics_get(METRICS_MQTT_CONNECT_ATTEMPTS, 0),
+            metrics_get(METRICS_MQTT_CONNECTIONS, 0),
+            metrics_get(METRICS_MQTT_CONNECTIONS_LOST, 0),
+            read, dropRead, write, dropWrite);
+    // Socket Server
+    socketserverbuf_getQueueDepth(&read, &write);
+    socketserverbuf_getDropCount(&dropRead, &dropWrite);
+    textAppend(t, ",\"socketServer\":{\"rxMessages\":%lu,\"txMessages\":%lu,"
+            "\"readQueue\":{\"depth\":%lu,\"drops\":%lu},"
+            "\"writeQueue\":{\"depth\":%lu,\"drops\":%lu}}",
+            metrics_get(METRICS_SOCKETSERVER_RX_MESSAGES, 0),
+            metrics_get(METRICS_SOCKETSERVER_TX_MESSAGES, 0),
+            read, dropRead, write, dropWrite);
+    // CAN->MQTT workers
+    workers = hpool_getQueueDepth(depth);
+    textAppend(t, ",\"can2mqttWorkers\":[");
+    for(i = 0; i < workers; i++)
+    {
+        textAppend(t, "%s{\"worker\":%d,\"queueDepth\":%lu}",
+                (i > 0) ? "," : "", i, depth[i]);
+    }
+    textAppend(t, "]");
+    // Error handler resets
+    textAppend(t, ",\"errorResets\":{");
+    for(i = 0; i < ERROR_NUMBER_OF_MODULES; i++)
+    {
+        textAppend(t, "%s\"%s\":%lu", (i > 0) ? "," : "", g_errorName[i],
+                metrics_get(METRICS_ERROR_RESETS, i));
+    }
+    // Gateway
+    textAppend(t, "},\"gateway\":{");
+    for(i = METRICS_GATEWAY_CAN2MQTT; i <= METRICS_GATEWAY_MQTT2CAN; i++)
+    {
+        textAppend(t, "%s\"%s\":{\"lookups\":%lu,\"matches\":%lu}",
+                (i > 0) ? "," : "", g_gatewayName[i],
+                metrics_get(METRICS_GATEWAY_LOOKUPS, i),
+                metrics_get(METRICS_GATEWAY_MATCHES, i));
+    }
+    // Raw frames batches
+    textAppend(t, "},\"federation\":{\"txBatches\":%lu,\"txFrames\":%lu,"
+            "\"rxBatches\":%lu,\"rxFrames\":%lu,\"duplicates\":%lu,"
+            "\"loops\":%lu",
+            metrics_get(METRICS_FEDERATION_BATCHES, METRICS_FEDERATION_TX),
+            metrics_get(METRICS_FEDERATION_FRAMES, METRICS_FEDERATION_TX),
+            metrics_get(METRICS_FEDERATION_BATCHES, METRICS_FEDERATION_RX),
+            metrics_get(METRICS_FEDERATION_FRAMES, METRICS_FEDERATION_RX),
+            metrics_get(METRICS_FEDERATION_DROPS, METRICS_FEDERATION_DUPLICATE),
+            metrics_get(METRICS_FEDERATION_DROPS, METRICS_FEDERATION_LOOP));
+    // Latency
+    textAppend(t, "},\"latency\":{");
+    for(path = 0; path < LATENCY_NUMBER_OF_PATHS; path++)
+    {
+        textAppend(t, "%s\"%s\":{", (path > 0) ? "," : "", g_pathName[path]);
+        for(stage = 0; stage < LATENCY_NUMBER_OF_STAGES; stage++)
+        {
+            latency_getStats(path, stage, &stats);
+            textAppend(t, "%s\"%s\":{\"count\":%lu,\"p50\":%llu,\"p99\":%llu,"
+                    "\"max\":%llu}", (stage > 0) ? "," : "",
+                    g_stageName[stage], stats.count, stats.p50, stats.p99,
+                    stats.max);
+        }
+        textAppend(t, "}");
+    }
+    // Modules not responding
+    textAppend(t, "},\"modulesNotResponding\":[");
+    i = 0;
+    while(hsystem_getNoResponseCount(i, &node, &group, &count) == EXIT_SUCCESS)
+    {
+        if(count > 0)
+        {
+            textAppend(t, "%s{\"node\":%d,\"group\":%d,\"count\":%lu}",
+                    (t->text[t->len - 1] == '[') ? "" : ",", node, group,
+                    count);
+        }
+        i++;
+    }
+    textAppend(t, "]}");
+}
+
+// Prometheus text format
+static void getPrometheus(metricsText_t *t)
+{
+    int channel;
+    int i;
+    int path;
+    int stage;
+    int node;
+    int group;
+    unsigned long read;
+    unsigned long write;
+    unsigned long dropRead;
+    unsigned long dropWrite;
+    unsigned long count;
+    unsigned long depth[HPOOL_MAX_WORKERS];
+    int workers;
+    latencyStats_t stats;
+
+    // CAN
+    textAppend(t, "# TYPE hmsg_can_rx_frames_total counter\n");
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
+    {
+        textAppend(t, "hmsg_can_rx_frames_total{channel=\"%d\"} %lu\n",
+                channel, metrics_get(METRICS_CAN_RX_FRAMES, channel));
+    }
+    textAppend(t, "# TYPE hmsg_can_tx_frames_total counter\n");
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
+    {
+        textAppend(t, "hmsg_can_tx_frames_total{channel=\"%d\"} %lu\n",
+                channel, metrics_get(METRICS_CAN_TX_FRAMES, channel));
+    }
+    textAppend(t, "# TYPE hmsg_can_bridged_frames_total counter\n");
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
+    {
+        textAppend(t, "hmsg_can_bridged_frames_total{channel=\"%d\"} %lu\n",
+                channel, metrics_get(METRICS_CAN_BRIDGED_FRAMES, channel));
+    }
+    textAppend(t, "# TYPE hmsg_can_bridge_loops_total counter\n");
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
+    {
+        textAppend(t, "hmsg_can_bridge_loops_total{channel=\"%d\"} %lu\n",
+                channel, metrics_get(METRICS_CAN_BRIDGE_LOOPS, channel));
+    }
+    // MQTT
+    textAppend(t, "# TYPE hmsg_mqtt_rx_messages_total counter\n"
+            "hmsg_mqtt_rx_messages_total %lu\n",
+            metrics_get(METRICS_MQTT_RX_MESSAGES, 0));
+    textAppend(t, "# TYPE hmsg_mqtt_tx_messages_total counter\n"
+            "hmsg_mqtt_tx_messages_total %lu\n",
+            metrics_get(METRICS_MQTT_TX_MESSAGES, 0));
+    textAppend(t, "# TYPE hmsg_mqtt_publish_rtt_microseconds summary\n"
+            "hmsg_mqtt_publish_rtt_microseconds_sum %lu\n"
+            "hmsg_mqtt_publish_rtt_microseconds_count %lu\n",
+            metrics_get(METRICS_MQTT_PUB_RTT_US, 0),
+            metrics_get(METRICS_MQTT_TX_MESSAGES, 0));
+    textAppend(t, "# TYPE hmsg_mqtt_connect_attempts_total counter\n"
+            "hmsg_mqtt_connect_attempts_total %lu\n",
+            metrics_get(METRICS_MQTT_CONNECT_ATTEMPTS, 0));
+    textAppend(t, "# TYPE hmsg_mqtt_connections_total counter\n"
+            "hmsg_mqtt_connections_total %lu\n",
+            metrics_get(METRICS_MQTT_CONNECTIONS, 0));
+    textAppend(t, "# TYPE hmsg_mqtt_connections_lost_total counter\n"
+            "hmsg_mqtt_connections_lost_total %lu\n",
+            metrics_get(METRICS_MQTT_CONNECTIONS_LOST, 0));
+    // Socket Server
+    textAppend(t, "# TYPE hmsg_socketserver_rx_messages_total counter\n"
+            "hmsg_socketserver_rx_messages_total %lu\n",
+            metrics_get(METRICS_SOCKETSERVER_RX_MESSAGES, 0));
+    textAppend(t, "# TYPE hmsg_socketserver_tx_messages_total counter\n"
+            "hmsg_socketserver_tx_messages_total %lu\n",
+            metrics_get(METRICS_SOCKETSERVER_TX_MESSAGES, 0));
+    // Queues
+    textAppend(t, "# TYPE hmsg_queue_depth gauge\n");
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
+    {
+        canbuf_getQueueDepth(channel, &read, &write);
+        textAppend(t, "hmsg_queue_depth{queue=\"%s\",channel=\"%d\"} %lu\n"
+                "hmsg_queue_depth{queue=\"%s\",channel=\"%d\"} %lu\n",
+                CONFIG_QUEUE_CAN_READ, channel, read,
+                CONFIG_QUEUE_CAN_WRITE, channel, write);
+    }
+    mqttbuf_getQueueDepth(&read, &write);
+    textAppend(t, "hmsg_queue_depth{queue=\"%s\"} %lu\n"
+            "hmsg_queue_depth{queue=\"%s\"} %lu\n",
+            CONFIG_QUEUE_MQTT_SUB, read, CONFIG_QUEUE_MQTT_PUB, write);
+    socketserverbuf_getQueueDepth(&read, &write);
+    textAppend(t, "hmsg_queue_depth{queue=\"%s\"} %lu\n"
+            "hmsg_queue_depth{queue=\"%s\"} %lu\n",
+            CONFIG_QUEUE_SOCKETSERVER_READ, read,
+            CONFIG_QUEUE_SOCKETSERVER_WRITE, write);
+    workers = hpool_getQueueDepth(depth);
+    for(i = 0; i < workers; i++)
+    {
+        textAppend(t, "hmsg_queue_depth{queue=\"%s\",worker=\"%d\"} %lu\n",
+                HPOOL_QUEUE_NAME, i, depth[i]);
+    }
+    textAppend(t, "# TYPE hmsg_queue_drops_total counter\n");
+    for(channel = 0; channel < canbuf_getChannels(); channel++)
+    {
+        canbuf_getDropCount(channel, &dropRead, &dropWrite);
+        textAppend(t, "hmsg_queue_drops_total{queue=\"%s\",channel=\"%d\"} "
+                "%lu\nhmsg_queue_drops_total{queue=\"%s\",channel=\"%d\"} "
+                "%lu\n", CONFIG_QUEUE_CAN_READ, channel, dropRead,
+                CONFIG_QUEUE_CAN_WRITE, channel, dropWrite);
+    }
+    mqttbuf_getDropCount(&dropRead, &dropWrite);
+    textAppend(t, "hmsg_queue_drops_total{queue=\"%s\"} %lu\n"
+            "hmsg_queue_drops_total{queue=\"%s\"} %lu\n",
+            CONFIG_QUEUE_MQTT_SUB, dropRead, CONFIG_QUEUE_MQTT_PUB, dropWrite);
+    socketserverbuf_getDropCount(&dropRead, &dropWrite);
+    textAppend(t, "hmsg_queue_drops_total{queue=\"%s\"} %lu\n"
+            "hmsg_queue_drops_total{queue=\"%s\"} %lu\n",
+            CONFIG_QUEUE_SOCKETSERVER_READ, dropRead,
+            CONFIG_QUEUE_SOCKETSERVER_WRITE, dropWrite);
+    // Error handler resets
+    textAppend(t, "# TYPE hmsg_error_resets_total counter\n");
+    for(i = 0; i < ERROR_NUMBER_OF_MODULES; i++)
+    {
+        textAppend(t, "hmsg_error_resets_total{module=\"%s\"} %lu\n",
+                g_errorName[i], metrics_get(METRICS_ERROR_RESETS, i));
+    }
+    // Gateway
+    textAppend(t, "# TYPE hmsg_gateway_lookups_total counter\n");
+    for(i = METRICS_GATEWAY_CAN2MQTT; i <= METRICS_GATEWAY_MQTT2CAN; i++)
+    {
+        textAppend(t, "hmsg_gateway_lookups_total{direction=\"%s\"} %lu\n",
+                g_gatewayName[i], metrics_get(METRICS_GATEWAY_LOOKUPS, i));
+    }
+    textAppend(t, "# TYPE hmsg_gateway_matches_total counter\n");
+    for(i = METRICS_GATEWAY_CAN2MQTT; i <= METRICS_GATEWAY_MQTT2CAN; i++)
+    {
+        textAppend(t, "hmsg_gateway_matches_total{direction=\"%s\"} %lu\n",
+                g_gatewayName[i], metrics_get(METRICS_GATEWAY_MATCHES, i));
+    }
+    // Raw frames batches
+    textAppend(t, "# TYPE hmsg_federation_batches_total counter\n"
+            "hmsg_federation_batches_total{direction=\"tx\"} %lu\n"
+            "hmsg_federation_batches_total{direction=\"rx\"} %lu\n",
+            metrics_get(METRICS_FEDERATION_BATCHES, METRICS_FEDERATION_TX),
+            metrics_get(METRICS_FEDERATION_BATCHES, METRICS_FEDERATION_RX));
+    textAppend(t, "# TYPE hmsg_federation_frames_total counter\n"
+            "hmsg_federation_frames_total{direction=\"tx\"} %lu\n"
+            "hmsg_federation_frames_total{direction=\"rx\"} %lu\n",
+            metrics_get(METRICS_FEDERATION_FRAMES, METRICS_FEDERATION_TX),
+            metrics_get(METRICS_FEDERATION_FRAMES, METRICS_FEDERATION_RX));
+    textAppend(t, "# TYPE hmsg_federation_drops_total counter\n"
+            "hmsg_federation_drops_total{reason=\"duplicate\"} %lu\n"
+            "hmsg_federation_drops_total{reason=\"loop\"} %lu\n",
+            metrics_get(METRICS_FEDERATION_DROPS, METRICS_FEDERATION_DUPLICATE),
+            metrics_get(METRICS_FEDERATION_DROPS, METRICS_FEDERATION_LOOP));
+    // Latency
+    textAppend(t, "# TYPE hmsg_latency_microseconds summary\n");
+    for(path = 0; path < LATENCY_NUMBER_OF_PATHS; path++)
+    {
+        for(stage = 0; stage < LATENCY_NUMBER_OF_STAGES; stage++)
+        {
+            latency_getStats(path, stage, &stats);
+            textAppend(t, "hmsg_latency_microseconds{path=\"%s\",stage=\"%s\","
+                    "quantile=\"0.5\"} %llu\n"
+                    "hmsg_latency_microseconds{path=\"%s\",stage=\"%s\","
+                    "quantile=\"0.99\"} %llu\n"
+                    "hmsg_latency_microseconds_count{path=\"%s\","
+                    "stage=\"%s\"} %lu\n",
+                    g_pathName[path], g_stageName[stage], stats.p50,
+                    g_pathName[path], g_stageName[stage], stats.p99,
+                    g_pathName[path], g_stageName[stage], stats.count);
+        }
+    }
+    textAppend(t, "# TYPE hmsg_latency_max_microseconds gauge\n");
+    for(path = 0; path < LATENCY_NUMBER_OF_PATHS; path++)
+    {
+        for(stage = 0; stage < LATENCY_NUMBER_OF_STAGES; stage++)
+        {
+            latency_getStats(path, stage, &stats);
+            textAppend(t, "hmsg_latency_max_microseconds{path=\"%s\","
+                    "stage=\"%s\"} %llu\n", g_pathName[path],
+                    g_stageName[stage], stats.max);
+        }
+    }
+    // Modules not responding
+    textAppend(t, "# TYPE hmsg_module_no_response_total counter\n");
+    i = 0;
+    while(hsystem_getNoResponseCount(i, &node, &group, &count) == EXIT_SUCCESS)
+    {
+        textAppend(t, "hmsg_module_no_response_total{node=\"%d\","
+                "group=\"%d\"} %lu\n", node, group, count);
+        i++;
+    }
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+// Add to a counter of the current thread
+void metrics_add(metricsCounter_t counter, int index, unsigned long value)
+{
+    metricsBlock_t* block;
+    unsigned long *p;
+    if((counter < 0) || (counter >= METRICS_NUMBER_OF_COUNTERS) ||
+            (index < 0) || (index >= METRICS_INDEXES))
+    {
+        return;
+    }
+    block = getBlock();
+    if(block == NULL)
+    {
+        return;
+    }
+    // Only this thread writes the counter: no read-modify-write lock needed
+    p = &block->counter[counter][index];
+    __atomic_store_n(p, __atomic_load_n(p, __ATOMIC_RELAXED) + value,
+            __ATOMIC_RELAXED);
+}
+
+// Sum of the counters of all threads
+unsigned long metrics_get(metricsCounter_t counter, int index)
+{
+    metricsBlock_t* block;
+    unsigned long sum;
+    if((counter < 0) || (counter >= METRICS_NUMBER_OF_COUNTERS) ||
+            (index < 0) || (index >= METRICS_INDEXES))
+    {
+        return 0;
+    }
+    sum = 0;
+    // LOCK LIST: blocks are only added to the list (never removed)
+    pthread_mutex_lock(&g_metrics_mutex);
+    block = g_metrics_head;
+    // UNLOCK LIST
+    pthread_mutex_unlock(&g_metrics_mutex);
+    for(; block != NULL; block = block->next)
+    {
+        sum += __atomic_load_n(&block->counter[counter][index],
+                __ATOMIC_RELAXED);
+    }
+    return sum;
+}
+
+// Metrics as text
+int metrics_getText(metricsFormat_t format, char **text)
+{
+    metricsText_t t;
+    *text = NULL;
+    t.len = 0;
+    t.size = METRICS_TEXT_SIZE;
+    t.error = false;
+    t.text = malloc(t.size);
+    if(t.text == NULL)
+    {
+        return -1;
+    }
+    t.text[0] = '\0';
+    if(format == METRICS_FORMAT_JSON)
+    {
+        getJSON(&t);
+    }
+    else
+    {
+        getPrometheus(&t);
+    }
+    if(t.error)
+    {
+        #ifdef DEBUG_METRICS_ERRORS
+        debug_error("metrics_getText ERROR: no memory!\n");
+        #endif
+        free(t.text);
+        return -1;
+    }
+    *text = t.text;
+    return t.len;
+}
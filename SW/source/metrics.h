@@ -0,0 +1,109 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add METRICS_CAN_BRIDGED_FRAMES and METRICS_CAN_BRIDGE_LOOPS              //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add the raw frames batches counters (METRICS_FEDERATION_*)               //
+//----------------------------------------------------------------------------//
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+/* Number of indexes of each counter (channel, module, direction...) */
+#define METRICS_INDEXES                 8
+/* Default period of the MQTT metrics message (seconds) - metricsPeriod */
+#define METRICS_DEFAULT_PERIOD          10
+/* Index of the gateway counters */
+#define METRICS_GATEWAY_CAN2MQTT        0
+#define METRICS_GATEWAY_MQTT2CAN        1
+/* Index of the raw frames batches counters */
+#define METRICS_FEDERATION_TX           0
+#define METRICS_FEDERATION_RX           1
+#define METRICS_FEDERATION_DUPLICATE    0
+#define METRICS_FEDERATION_LOOP         1
+
+//----------------------------------------------------------------------------//
+// EXTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Counters
+typedef enum
+{
+    METRICS_CAN_RX_FRAMES = 0,          // index: CAN channel
+    METRICS_CAN_TX_FRAMES,              // index: CAN channel
+    METRICS_CAN_BRIDGED_FRAMES,         // index: CAN channel (destination)
+    METRICS_CAN_BRIDGE_LOOPS,           // index: CAN channel (echo received)
+    METRICS_MQTT_RX_MESSAGES,
+    METRICS_MQTT_TX_MESSAGES,           // acknowledged by the broker
+    METRICS_MQTT_PUB_RTT_US,            // sum of publish -> ack times (us)
+    METRICS_MQTT_CONNECT_ATTEMPTS,
+    METRICS_MQTT_CONNECTIONS,
+    METRICS_MQTT_CONNECTIONS_LOST,
+    METRICS_SOCKETSERVER_RX_MESSAGES,
+    METRICS_SOCKETSERVER_TX_MESSAGES,
+    METRICS_ERROR_RESETS,               // index: errorh_module_t
+    METRICS_GATEWAY_LOOKUPS,            // index: METRICS_GATEWAY_*
+    METRICS_GATEWAY_MATCHES,            // index: METRICS_GATEWAY_*
+    METRICS_FEDERATION_BATCHES,         // index: METRICS_FEDERATION_TX / RX
+    METRICS_FEDERATION_FRAMES,          // index: METRICS_FEDERATION_TX / RX
+    METRICS_FEDERATION_DROPS,           // index: DUPLICATE / LOOP
+    METRICS_NUMBER_OF_COUNTERS
+} metricsCounter_t;
+
+// Text format
+typedef enum
+{
+    METRICS_FORMAT_JSON = 0,
+    METRICS_FORMAT_PROMETHEUS
+} metricsFormat_t;
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Add to a counter. Each thread has its own counters (no lock, no shared
+ * cache line): they are only added together when the metrics are read.
+ *
+ * \param   counter     (INPUT) counter
+ * \param   index       (INPUT) 0 to METRICS_INDEXES - 1 (channel, module...)
+ * \param   value       (INPUT) value to be added
+ */
+void metrics_add(metricsCounter_t counter, int index, unsigned long value);
+
+/**
+ * Get a counter (sum of all threads).
+ *
+ * \param   counter     (INPUT) counter
+ * \param   index       (INPUT) 0 to METRICS_INDEXES - 1
+ * \return  counter value
+ */
+unsigned long metrics_get(metricsCounter_t counter, int index);
+
+/**
+ * Get all metrics (counters, queue depths and drops, latency, modules not
+ * responding) as text.
+ *
+ * \param   format      (INPUT) METRICS_FORMAT_JSON / METRICS_FORMAT_PROMETHEUS
+ * \param   text        (OUTPUT) text - has to be freed after used
+ * \return  text length, -1 if error (no memory)
+ */
+int metrics_getText(metricsFormat_t format, char **text);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METRICS_H */
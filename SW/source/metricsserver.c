@@ -0,0 +1,286 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_MONITORING      //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Listener bound to the loopback address by default (config.json: add      //
+// field metricsBindAddress)                                                  //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_MONITORING
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <poll.h>
+#include "config.h"
+#include "debug.h"
+#include "metrics.h"
+#include "metricsserver.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+// Time to wait for the request of an accepted connection (ms)
+#define METRICSSERVER_REQUEST_TIMEOUT   1000
+// Request is read (and ignored) up to this size
+#define METRICSSERVER_REQUEST_SIZE      1024
+// HTTP header of the response
+#define METRICSSERVER_HEADER    "HTTP/1.0 200 OK\r\n" \
+        "Content-Type: text/plain; version=0.0.4\r\n" \
+        "Content-Length: %d\r\n" \
+        "Connection: close\r\n\r\n"
+
+//----------------------------------------------------------------------------//
+// GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+static int fdListener = -1;     // Listening socket descriptor
+static char *g_port = NULL;     // Port of the listening socket
+static char *g_address = NULL;  // Address of the listening socket (NULL:
+                                // loopback)
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static int get_listener_socket(const char *address, const char *port);
+static bool isSameString(const char *str1, const char *str2);
+static int send_all(int fd, const char *data, int dataLen);
+static void handle_request(int fd);
+
+// Return a listening socket (address NULL: loopback address)
+static int get_listener_socket(const char *address, const char *port)
+{
+    int fd = -1;
+    int yes = 1;        // For setsockopt() SO_REUSEADDR, below
+    int rv;
+    struct addrinfo hints, *ai, *p;
+
+    // Get us a socket and bind it
+    memset(&hints, 0, sizeof hints);
+    hints.ai_family = AF_UNSPEC;      // IPV4 or IPV6
+    hints.ai_socktype = SOCK_STREAM;  // TCP
+    hints.ai_flags = 0;               // No address: loopback (not passive)
+    if((rv = getaddrinfo(address, port, &hints, &ai)) != 0)
+    {
+        #ifdef DEBUG_METRICS_ERRORS
+        debug_error("Metrics Server ERROR: Listener Socket: %s\n",
+                gai_strerror(rv));
+        #endif
+        return -1;
+    }
+    // Check all Address Infos
+    for(p = ai; p != NULL; p = p->ai_next)
+    {
+        fd = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+        if (fd < 0)
+        {
+            // Go to the next Address Info
+            continue;
+        }
+        // Lose the pesky "address already in use" error message
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int)) == -1)
+        {
+            close(fd);
+            // Go to the next Address Info
+            continue;
+        }
+        if (bind(fd, p->ai_addr, p->ai_addrlen) < 0)
+        {
+            #ifdef DEBUG_METRICS_ERRORS
+            debug_error("Metrics Server ERROR: bind\n");
+            #endif
+            close(fd);
+            continue;
+        }
+        // Bind is OK: Leave
+        break;
+    }
+    // Free all Address Infos
+    freeaddrinfo(ai);
+    // Check if we have a valid Address Info
+    if (p == NULL)
+    {
+        return -1;
+    }
+    // Listen to up to 10 connection attempts
+    if (listen(fd, 10) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    // Return Listener file description
+    return fd;
+}
+
+// Compare two strings (NULL is accepted)
+static bool isSameString(const char *str1, const char *str2)
+{
+    if((str1 == NULL) || (str2 == NULL))
+    {
+        return (str1 == str2);
+    }
+    return (strcmp(str1, str2) == 0);
+}
+
+// Send all data - 0 on success, -1 on error
+static int send_all(int fd, const char *data, int dataLen)
+{
+    int i_WriteLength;
+    while(dataLen > 0)
+    {
+        // No SIGPIPE if the client has closed the connection
+        i_WriteLength = send(fd, data, dataLen, MSG_NOSIGNAL);
+        if(i_WriteLength <= 0)
+        {
+            return -1;
+        }
+        data += i_WriteLength;
+        dataLen -= i_WriteLength;
+    }
+    return 0;
+}
+
+// Read the request (any request gets the metrics) and send the response
+static void handle_request(int fd)
+{
+    struct pollfd pfds[1];
+    char request[METRICSSERVER_REQUEST_SIZE];
+    char header[sizeof(METRICSSERVER_HEADER) + 16];
+    char *text;
+    int len;
+    // Wait for the request
+    pfds[0].fd = fd;
+    pfds[0].events = POLLIN;
+    if(poll(pfds, 1, METRICSSERVER_REQUEST_TIMEOUT) <= 0)
+    {
+        return;
+    }
+    if(recv(fd, request, sizeof(request), 0) <= 0)
+    {
+        return;
+    }
+    // Response
+    len = metrics_getText(METRICS_FORMAT_PROMETHEUS, &text);
+    if(len < 0)
+    {
+        return;
+    }
+    snprintf(header, sizeof(header), METRICSSERVER_HEADER, len);
+    if(send_all(fd, header, strlen(header)) == 0)
+    {
+        send_all(fd, text, len);
+    }
+    free(text);
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/* Handle one request */
+int metricsserver_handle(int timeout)
+{
+    int i_Temp;
+    int check;
+    int fd;
+    char *port;
+    char *address;
+    struct pollfd pfds[1];
+
+    //*******************************//
+    // READ CONFIGURATION            //
+    //*******************************//
+    check = config_getString(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "metricsPort", 0, NULL, &port);
+    if(check != EXIT_SUCCESS)
+    {
+        metricsserver_close();
+        return METRICSSERVER_DISABLED;
+    }
+    // No address: loopback only
+    check = config_getString(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "metricsBindAddress", 0, NULL, &address);
+    if(check != EXIT_SUCCESS)
+    {
+        address = NULL;
+    }
+    // Open the listener again if the port or the address has changed
+    if((g_port == NULL) || (strcmp(port, g_port) != 0) ||
+            !isSameString(address, g_address))
+    {
+        metricsserver_close();
+        g_port = port;
+        g_address = address;
+    }
+    else
+    {
+        free(port);
+        free(address);
+    }
+    // Set up and get a listening socket
+    if (fdListener < 0)
+    {
+        fdListener = get_listener_socket(g_address, g_port);
+    }
+    if (fdListener < 0)
+    {
+        #ifdef DEBUG_METRICS_ERRORS
+        debug_error("Metrics Server ERROR: Listener error\n");
+        #endif
+        return METRICSSERVER_ERROR;
+    }
+    // Check if there is a connection to be accepted
+    pfds[0].fd = fdListener;
+    pfds[0].events = POLLIN;
+    i_Temp = poll(pfds, 1, timeout);
+    if(i_Temp == 0)
+    {
+        return METRICSSERVER_TIMEOUT;
+    }
+    else if(i_Temp < 0)
+    {
+        #ifdef DEBUG_METRICS_ERRORS
+        debug_error("Metrics Server ERROR: Poll Error!\n");
+        #endif
+        metricsserver_close();
+        return METRICSSERVER_ERROR;
+    }
+    // One request per connection
+    fd = accept(fdListener, NULL, NULL);
+    if (fd < 0)
+    {
+        return METRICSSERVER_ERROR;
+    }
+    handle_request(fd);
+    close(fd);
+    return METRICSSERVER_OK;
+}
+
+/* Close the listener */
+void metricsserver_close(void)
+{
+    if(fdListener >= 0)
+    {
+        close(fdListener);
+    }
+    fdListener = -1;
+    free(g_port);
+    g_port = NULL;
+    free(g_address);
+    g_address = NULL;
+}
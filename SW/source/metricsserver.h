@@ -0,0 +1,55 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Listener bound to metricsBindAddress (default: loopback)                 //
+//----------------------------------------------------------------------------//
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+#define METRICSSERVER_OK            0
+#define METRICSSERVER_ERROR         -1
+#define METRICSSERVER_TIMEOUT       -2
+#define METRICSSERVER_DISABLED      -3
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Handle one HTTP request (Prometheus text format) on "metricsPort". The
+ * listener is bound to "metricsBindAddress" (not configured: loopback address
+ * only). It is opened when needed and opened again if the port or the address
+ * is changed.
+ *
+ * \param   timeout     milliseconds to wait for a request, -1 equals no
+ *                      timeout
+ * \return  METRICSSERVER_OK            request handled
+ *          METRICSSERVER_TIMEOUT       no request
+ *          METRICSSERVER_DISABLED      no "metricsPort" configured
+ *          METRICSSERVER_ERROR         socket error
+ */
+int metricsserver_handle(int timeout);
+
+/**
+ * Close the listener
+ */
+void metricsserver_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METRICSSERVER_H */
@@ -13,6 +13,17 @@
 //  1.02     | 26/Oct/2024 |                               | ALCP             //
 // - Updtates to handle connecion lost events without destroying the client   //
 //----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Connections lost are counted (metrics)                                   //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_MQTT            //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_MQTT
 
 /*
 * Includes
@@ -25,6 +36,7 @@
 #include <MQTTClient.h>
 #include "auxiliary.h"
 #include "config.h"
+#include "metrics.h"
 #include "mqtt.h"
 #include "mqttbuf.h"
 #include "debug.h"
@@ -101,6 +113,7 @@ void mqtt_onConnLost(void *context, char *cause)
     debug_print("Connection lost!\n");
     debug_print("- Cause: %s\n", cause);
     #endif
+    metrics_add(METRICS_MQTT_CONNECTIONS_LOST, 0, 1);
     // Set state
     setMQTTStateLocked(MQTT_STATE_DISCONNECTED);
 }
@@ -113,8 +126,8 @@ void mqtt_onDelivered(void *context, MQTTClient_deliveryToken dt)
     int latency;
     timestamp = aux_getmsSinceEpoch();
     latency = timestamp - g_mqqt_latency;
-    debug_print("MQTT Confirmation Received. Latency = %d\n", latency);
-    debug_print("- Token: %d\n", dt);
+    debug_verbose("MQTT Confirmation Received. Latency = %d\n", latency);
+    debug_verbose("- Token: %d\n", dt);
     #endif
     // LOCK delivery token
     pthread_mutex_lock(&m_dt_mutex);
@@ -184,7 +197,7 @@ int mqtt_init(void)
                 free(clientID);
             }
             #if defined(DEBUG_MQTT_CONNECT)
-            debug_print("mqtt_init: Wrong Configuraion\n");
+            debug_verbose("mqtt_init: Wrong Configuraion\n");
             #endif
             return EXIT_FAILURE;
         }
@@ -240,7 +253,8 @@ int mqtt_init(void)
         if (check != MQTTCLIENT_SUCCESS) 
         {
             #if defined(DEBUG_MQTT_CONNECT)
-            debug_print("Failed to connect to MQTT Broker. Error: %d\n", check);
+            debug_verbose("Failed to connect to MQTT Broker. Error: %d\n", 
+                    check);
             #endif
             ret = EXIT_FAILURE;
             // Free Sub Topics - server and client ID are already free
@@ -264,7 +278,7 @@ int mqtt_init(void)
                 if(check != MQTTCLIENT_SUCCESS)
                 {                
                     #ifdef DEBUG_MQTT_CONNECT
-                    debug_print("Failed to connect subscribe to topic: %s\n", 
+                    debug_verbose("Failed to connect subscribe to topic: %s\n", 
                             sub_topics[i]);
                     #endif
                     ok = false;
@@ -297,7 +311,7 @@ int mqtt_init(void)
 void mqtt_close(void)
 {
     #ifdef DEBUG_MQTT_CONNECT
-    debug_print("MQTT Disconnect and Free!\n");
+    debug_verbose("MQTT Disconnect and Free!\n");
     #endif
     // LOCK: Protect in case more threads try to close client at the same time
     pthread_mutex_lock(&m_close_mutex);
@@ -338,9 +352,9 @@ void mqtt_publish(char* topic, void* payload, int payloadlen)
     MQTTClient_publishMessage(client, topic, &pubmsg, &lastdeliveredtoken);    
     #ifdef DEBUG_MQTT_SENT
     g_mqqt_latency = aux_getmsSinceEpoch();
-    debug_print("Message Sent!\n");
-    debug_print("- Topic: %s\n", topic);
-    debug_print("- Waiting for Token: %d\n", lastdeliveredtoken);
+    debug_verbose("Message Sent!\n");
+    debug_verbose("- Topic: %s\n", topic);
+    debug_verbose("- Waiting for Token: %d\n", lastdeliveredtoken);
     #endif     
 }
 
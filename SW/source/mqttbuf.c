@@ -6,33 +6,87 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - The publish topic buffer holds interned topics (a reference to the       //
+// shared copy) instead of a copy of each topic                               //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - One buffer of records (timestamp, topic and payload) per direction,      //
+// instead of three buffers that had to be kept in sync                       //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Records are handed over to/from the buffers (no copy on push / pop)      //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Overflow policy of each buffer from the configuration. An overflow is    //
+// handled by the buffer (counted as a drop), not reported as an error        //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Number of elements of each buffer from the configuration. Add            //
+// mqttbuf_updateQueues: resize the buffers and set the policies again after  //
+// a configuration reload (stored records are kept)                           //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - Latency of each message (monotonic stamp in the record). The publish     //
+// stage is measured up to the broker acknowledge                             //
+//----------------------------------------------------------------------------//
+//  1.07     | 18/Oct/2026 |                               | ALCP             //
+// - Add mqttbuf_getQueueDepth; messages, publish round trip times and        //
+// connection attempts are counted (metrics)                                  //
+//----------------------------------------------------------------------------//
+//  1.08     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_MQTT            //
+//----------------------------------------------------------------------------//
+//  1.09     | 18/Oct/2026 |                               | ALCP             //
+// - The publish topic is already interned (a reference is taken, no hash)    //
+//----------------------------------------------------------------------------//
+//  1.10     | 18/Oct/2026 |                               | ALCP             //
+// - The wait for a free position ("block" policy) is done by the push        //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_MQTT
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stddef.h>
 #include <stdbool.h>
 #include <unistd.h>
 #include <pthread.h>
 #include "auxiliary.h"
 #include "buffer.h"
+#include "config.h"
 #include "mqtt.h"
 #include "mqttbuf.h"
+#include "latency.h"
+#include "metrics.h"
 #include "debug.h"
+#include "topic.h"
 
 //----------------------------------------------------------------------------//
-// INTERNAL DEFINITIONS
+// INTERNAL TYPES
 //----------------------------------------------------------------------------//
-/* Buffer Offset */
-#define MQTT_PUB_BUFFER_OFFSET MQTT_PUB_TOPIC_BUFFER
-#define MQTT_SUB_BUFFER_OFFSET MQTT_SUB_TOPIC_BUFFER
+/* MQTT message record: timestamp, topic and payload in a single element of a 
+ * single buffer (one push / one pop per message) */
+typedef struct
+{
+    unsigned long long millisecondsSinceEpoch;
+    latencyStamp_t latency;
+    const char* topic;  // PUB: interned topic / SUB: NULL (topic is in data)
+    int topiclen;       // SUB: topic length in data (without '\0')
+    int payloadlen;
+    char data[];        // PUB: payload / SUB: topic + '\0' + payload
+} mqttRecord_t;
 
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
-static int mqttbufID[MQTT_NUMBER_OF_BUFFERS] = {-1, -1, -1, -1, -1, -1};
+static int mqttbufID[MQTT_NUMBER_OF_BUFFERS] = {-1, -1};
 volatile int lastSubError = MQTT_SUB_OK;
-static pthread_mutex_t sub_mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t pub_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t init_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t error_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 //----------------------------------------------------------------------------//
@@ -40,7 +94,10 @@ static pthread_mutex_t error_mutex = PTHREAD_MUTEX_INITIALIZER;
 //----------------------------------------------------------------------------//
 static void mqttbuf_setLastError(int error);
 static int mqttbuf_getLastError(void);
-static int mqttbuf_publish(void);
+static int mqttbuf_publish(latencyStamp_t *stamp, unsigned long long *start);
+static mqttRecord_t* mqttbuf_popRecord(int id);
+static void mqttbuf_freePubRecord(void *data);
+static void mqttbuf_configBuffers(void);
 
 /* Set Last Error set during subscription receive callback */
 static void mqttbuf_setLastError(int error)
@@ -67,201 +124,109 @@ static int mqttbuf_getLastError(void)
     return ret;
 }
 
-/** MQTT Publish Data from Buffer */
-static int mqttbuf_publish(void)
+/* Pop the next record from a MQTT buffer. The record has to be freed after 
+ * used. Returns NULL if the buffer is empty or the element is not a record. */
+static mqttRecord_t* mqttbuf_popRecord(int id)
 {
-    char* topic = NULL;
-    void* payload = NULL;
-    int payloadlen;
-    int li_index;
-    int li_check;
-    int li_return;
-    int li_temp;    
     unsigned int lui_size;
-    unsigned long long millisecondsSinceEpoch;    
-    unsigned int bufferSize[MQTT_NUMBER_OF_PUB_BUFFERS];
-    
-    /**************************************************************************
-     * CONSISTENCY CHECK
-     *************************************************************************/
-    // LOCK PUB BUFFERS: Protect data and timestamp buffers from being 
-    // read/written at different times
-    pthread_mutex_lock(&pub_mutex);
-    // Get every Publish buffer count
-    for(li_index = 0; li_index < MQTT_NUMBER_OF_PUB_BUFFERS; li_index++)
-    {        
-        bufferSize[li_index] = buffer_dataCount(mqttbufID[li_index + 
-                MQTT_PUB_BUFFER_OFFSET]);
-    }        
-    // Check if every write buffer is not empty
-    li_temp = 0;
-    for(li_index = 0; li_index < MQTT_NUMBER_OF_PUB_BUFFERS; li_index++)
-    {        
-        if( bufferSize[li_index] != 0 )
-        {
-            li_temp = 1;
-        }
-    }
-    if(li_temp == 0)
+    void* data;
+    // The record stored in the buffer is handed over (no copy)
+    if(buffer_popNoCopy(mqttbufID[id], &data, &lui_size) != BUFFER_OK)
     {
-        // No data to be sent - Unlock buffers and return now
-        // UNLOCK PUB BUFFERS
-        pthread_mutex_unlock(&pub_mutex);
-        return MQTT_PUB_NO_DATA;
-    }        
-    // Check if every Publish buffer has the same count of elements
-    for(li_index = 0; li_index < MQTT_NUMBER_OF_PUB_BUFFERS - 1; li_index++)
-    {        
-        if( bufferSize[li_index] != bufferSize[li_index + 1] )
-        {            
-            /***************/
-            /* FATAL ERROR */
-            /***************/
-            #if defined(DEBUG_MQTT_SENT) || defined(DEBUG_MQTT_ERRORS)
-            debug_print("MQTT: SEND Buffer ERROR!\n");
-            #endif
-            // Buffers out of sync - Unlock buffers and return now
-            // UNLOCK PUB BUFFERS
-            pthread_mutex_unlock(&pub_mutex);
-            return MQTT_PUB_BUFFER_ERROR;
-        }
-    }    
-    /**************************************************************************
-     * FILL DATA - topic, payload, payloadlen, millisecondsSinceEpoch
-     *************************************************************************/
-    li_return = MQTT_PUB_OK;
-    lui_size = buffer_popSize(mqttbufID[MQTT_PUB_TOPIC_BUFFER]);
-    if(lui_size > 0)
-    {
-        topic = malloc(lui_size);
-        li_check = buffer_pop(mqttbufID[MQTT_PUB_TOPIC_BUFFER], topic, lui_size);
-        if(li_check != BUFFER_OK)
-        {
-            /***************/
-            /* FATAL ERROR */
-            /***************/
-            #if defined(DEBUG_MQTT_SENT) || defined(DEBUG_MQTT_ERRORS)
-            debug_print("MQTT: SEND POP Buffer ERROR!\n");
-            debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_PUB_TOPIC_BUFFER]);
-            #endif
-            // Free data allocated
-            free(topic);
-            topic = NULL;
-            // Return
-            li_return = MQTT_PUB_BUFFER_ERROR;
-        }
+        return NULL;
     }
-    else
+    if(lui_size < sizeof(mqttRecord_t))
     {
         /***************/
         /* FATAL ERROR */
         /***************/
-        #if defined(DEBUG_MQTT_SENT) || defined(DEBUG_MQTT_ERRORS)
-        debug_print("MQTT: SEND POP Buffer ERROR - Data size 0!\n");
-        debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_PUB_TOPIC_BUFFER]);
+        #ifdef DEBUG_MQTT_ERRORS
+        debug_error("MQTT: POP Buffer ERROR - Not a record!\n");
+        debug_error("- Buffer ID: %d\n", mqttbufID[id]);
         #endif
-        // No allocated data to be Freed
-        // Return
-        li_return = MQTT_PUB_BUFFER_ERROR;
+        free(data);
+        return NULL;
     }
-    payloadlen = buffer_popSize(mqttbufID[MQTT_PUB_PAYLOAD_BUFFER]);
-    if(payloadlen > 0)
+    return (mqttRecord_t*)data;
+}
+
+/* Free a publish record (dropped or cleaned by the buffer): the topic is a 
+ * reference of an interned topic */
+static void mqttbuf_freePubRecord(void *data)
+{
+    mqttRecord_t* record = (mqttRecord_t*)data;
+    topic_release(record->topic);
+    free(record);
+}
+
+/**
+ * Create the buffers (if not created yet) or resize them, and set the overflow
+ * policy, from the configuration. init_mutex has to be locked.
+ */
+static void mqttbuf_configBuffers(void)
+{
+    int count;
+    unsigned int size;
+    bufferPolicySettings_t policy;
+    const char* queue[MQTT_NUMBER_OF_BUFFERS] = {CONFIG_QUEUE_MQTT_SUB, 
+            CONFIG_QUEUE_MQTT_PUB};
+    for(count = 0; count < MQTT_NUMBER_OF_BUFFERS; count++)
     {
-        payload = malloc(payloadlen);
-        li_check = buffer_pop(mqttbufID[MQTT_PUB_PAYLOAD_BUFFER], payload, 
-                payloadlen);
-        if(li_check != BUFFER_OK)
+        size = config_getQueueSize(queue[count], MQTT_BUFFER_SIZE);
+        if(mqttbufID[count] < 0)
         {
-            /***************/
-            /* FATAL ERROR */
-            /***************/
-            #if defined(DEBUG_MQTT_SENT) || defined(DEBUG_MQTT_ERRORS)
-            debug_print("MQTT: SEND POP Buffer ERROR!\n");
-            debug_print("- Buffer ID: %d\n", 
-                    mqttbufID[MQTT_PUB_PAYLOAD_BUFFER]);
-            #endif
-            // Free data allocated
-            free(topic);
-            free(payload);
-            topic = NULL;
-            payload = NULL;
-            // Return
-            li_return = MQTT_PUB_BUFFER_ERROR;
+            mqttbufID[count] = buffer_init(size);
         }
-    }
-    else
-    {
-        /***************/
-        /* FATAL ERROR */
-        /***************/
-        #if defined(DEBUG_MQTT_SENT) || defined(DEBUG_MQTT_ERRORS)
-        debug_print("MQTT: SEND POP Buffer ERROR - Data size 0!\n");
-        debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_PUB_PAYLOAD_BUFFER]);
-        #endif
-        // Free data allocated
-        free(topic);
-        topic = NULL;
-        // Return
-        li_return = MQTT_PUB_BUFFER_ERROR;
-    }
-    // Pop timestamp to keep buffers sync
-    lui_size = buffer_popSize(mqttbufID[MQTT_PUB_STAMP_BUFFER]);
-    if(lui_size > 0)
-    {
-        li_check = buffer_pop(mqttbufID[MQTT_PUB_STAMP_BUFFER], 
-                &millisecondsSinceEpoch, sizeof(millisecondsSinceEpoch));
-        if((li_check != BUFFER_OK) || 
-                (lui_size != sizeof(millisecondsSinceEpoch)))
+        else
         {
-            /***************/
-            /* FATAL ERROR */
-            /***************/
-            #if defined(DEBUG_MQTT_SENT) || defined(DEBUG_MQTT_ERRORS)
-            debug_print("MQTT: SEND POP Buffer ERROR!\n");
-            debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_PUB_STAMP_BUFFER]);
-            #endif
-            // Free data allocated
-            free(topic);
-            free(payload);
-            // Return
-            li_return = MQTT_PUB_BUFFER_ERROR;
+            buffer_resize(mqttbufID[count], size);
         }
+        config_getQueuePolicy(queue[count], size, &policy);
+        buffer_setPolicy(mqttbufID[count], &policy);
     }
-    else
+}
+
+/** MQTT Publish Data from Buffer - stamp and start (latency) are set when a 
+ * message is published */
+static int mqttbuf_publish(latencyStamp_t *stamp, unsigned long long *start)
+{
+    mqttRecord_t* record;
+    if(buffer_dataCount(mqttbufID[MQTT_PUB_BUFFER]) == 0)
+    {
+        // No data to be sent
+        return MQTT_PUB_NO_DATA;
+    }
+    record = mqttbuf_popRecord(MQTT_PUB_BUFFER);
+    if((record == NULL) || (record->topic == NULL) || 
+            (record->payloadlen <= 0))
     {
         /***************/
         /* FATAL ERROR */
         /***************/
         #if defined(DEBUG_MQTT_SENT) || defined(DEBUG_MQTT_ERRORS)
-        debug_print("MQTT: SEND POP Buffer ERROR - Data size 0!\n");
-        debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_PUB_STAMP_BUFFER]);
+        debug_print("MQTT: SEND POP Buffer ERROR!\n");
+        debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_PUB_BUFFER]);
         #endif
         // Free data allocated
-        free(topic);
-        free(payload);
-        topic = NULL;
-        payload = NULL;
+        if(record != NULL)
+        {
+            mqttbuf_freePubRecord(record);
+        }
         // Return
-        li_return = MQTT_PUB_BUFFER_ERROR;
+        return MQTT_PUB_BUFFER_ERROR;
     }
-    // UNLOCK BUFFERS:
-    pthread_mutex_unlock(&pub_mutex);    
-    // Check errors
-    if(li_return != MQTT_PUB_OK)
-    {
-        return li_return;
-    }    
     /**************************************************************************
      * PUBLISH
      *************************************************************************/
-    mqtt_publish(topic, payload, payloadlen);
+    *stamp = record->latency;
+    *start = latency_sendStart(stamp);
+    mqtt_publish((char *)record->topic, record->data, record->payloadlen);
     
     /**************************************************************************
      * FREE AND RETURN
      *************************************************************************/
-    // Free allocated memory
-    free(topic);
-    free(payload);    
+    // Free allocated memory (topic is an interned topic)
+    mqttbuf_freePubRecord(record);
     // Return
     return MQTT_PUB_OK; 
 }
@@ -292,20 +257,14 @@ int mqttbuf_init(void)
     int count;
     int check;
     
-    // Init buffers
-    // LOCK BUFFERS: Protect data and timestamp buffers from being read/written at different times
-    pthread_mutex_lock(&sub_mutex);
-    pthread_mutex_lock(&pub_mutex);
-    for(count = 0; count < MQTT_NUMBER_OF_BUFFERS; count++)
-    {
-        if(mqttbufID[count] < 0)
-        {
-            mqttbufID[count] = buffer_init(MQTT_BUFFER_SIZE);
-        }
-    }
+    // Init buffers - One buffer of records per direction
+    // LOCK BUFFERS: Protect in case more threads try to init at the same time
+    pthread_mutex_lock(&init_mutex);
+    mqttbuf_configBuffers();
+    // Publish records hold a reference of an interned topic
+    buffer_setFreeFunction(mqttbufID[MQTT_PUB_BUFFER], mqttbuf_freePubRecord);
     // UNLOCK BUFFERS:
-    pthread_mutex_unlock(&sub_mutex);
-    pthread_mutex_unlock(&pub_mutex);
+    pthread_mutex_unlock(&init_mutex);
     // Check buffers - All should have ID
     check = 0;
     for(count = 0; count < MQTT_NUMBER_OF_BUFFERS; count++)
@@ -313,8 +272,8 @@ int mqttbuf_init(void)
         if(mqttbufID[count] < 0)
         {
             #ifdef DEBUG_MQTT_ERRORS
-            debug_print("MQTT Init: - Buffer ERROR!\n");
-            debug_print("- Buffer: %d\n", count);
+            debug_error("MQTT Init: - Buffer ERROR!\n");
+            debug_error("- Buffer: %d\n", count);
             #endif
             check = 1;
         }
@@ -335,17 +294,19 @@ int mqttbuf_connect(void)
 {    
     int check;            
     // Connect to Broker
+    metrics_add(METRICS_MQTT_CONNECT_ATTEMPTS, 0, 1);
     check = mqtt_init();    
+    if(check == EXIT_SUCCESS)
+    {
+        metrics_add(METRICS_MQTT_CONNECTIONS, 0, 1);
+    }
     // Return
     return check;
 }
-
 /** MQTT Close connection: Close mqtt connection and/or re-inits buffers 
  * if needed */
 int mqttbuf_close(int close, int cleanBuffers)
 {
-    int li_index;
-    
     // Check if close connection
     if(close > 0)
     {
@@ -356,17 +317,9 @@ int mqttbuf_close(int close, int cleanBuffers)
     // Check if clean buffers
     if(cleanBuffers > 0)
     {
-        // clean all buffers
-        // LOCK BUFFERS: Protect data and timestamp buffers from being read/written at different times
-        pthread_mutex_lock(&sub_mutex);
-        pthread_mutex_lock(&pub_mutex);
-        for(li_index = MQTT_SUB_TOPIC_BUFFER; li_index < MQTT_NUMBER_OF_BUFFERS; li_index++)
-        {
-            buffer_clean(mqttbufID[li_index]);
-        }
-        // UNLOCK BUFFERS:
-        pthread_mutex_unlock(&sub_mutex);
-        pthread_mutex_unlock(&pub_mutex);
+        // clean all buffers (publish topics are released by the buffer)
+        buffer_clean(mqttbufID[MQTT_SUB_BUFFER]);
+        buffer_clean(mqttbufID[MQTT_PUB_BUFFER]);
     }
     
     // Return
@@ -374,62 +327,62 @@ int mqttbuf_close(int close, int cleanBuffers)
 }
 
 /** Set Publish buffer with data from parameters */
-int mqttbuf_setPubMsgToBuffer(char* topic, void* payload, int payloadlen, 
-        unsigned long long millisecondsSinceEpoch)
+int mqttbuf_setPubMsgToBuffer(const char* topic, void* payload, 
+        int payloadlen, unsigned long long millisecondsSinceEpoch)
 {
-    int li_index;
     int li_size;
-    int check[MQTT_NUMBER_OF_PUB_BUFFERS];
-    // Simply add data to Publish buffers
-    if(topic != NULL)
+    int check;
+    mqttRecord_t* record;
+    // Only add to buffer if connected and sizes are not 0
+    if( mqttbuf_getState() == MQTT_DISCONNECTED || topic == NULL ||
+            topic[0] == '\0' || payloadlen <= 0)
     {
-        li_size = strlen(topic);
+        return MQTT_PUB_NO_DATA;
     }
-    else
-    {
-        li_size = 0;
+    // Fill the record - The topic is a reference of the interned topic (no 
+    // search and no copy)
+    li_size = sizeof(*record) + payloadlen;
+    record = malloc(li_size);
+    record->millisecondsSinceEpoch = millisecondsSinceEpoch;
+    latency_stampTx(&record->latency, LATENCY_OUTPUT_MQTT);
+    record->topic = topic_acquire(topic);
+    record->topiclen = 0;
+    record->payloadlen = payloadlen;
+    memcpy(record->data, payload, payloadlen);
+    // The record is handed over to the buffer (no copy). It waits for a free 
+    // position if the overflow policy is "block"
+    check = buffer_pushNoCopy(mqttbufID[MQTT_PUB_BUFFER], record, li_size);
+    if(check == BUFFER_OVERFLOW)
+    {
+        // Overflow is handled by the buffer policy (a record was dropped)
+        #ifdef DEBUG_MQTT_ERRORS
+        debug_error("MQTT: PUB Buffer Overflow - Dropped: %lu\n", 
+                buffer_getDropCount(mqttbufID[MQTT_PUB_BUFFER]));
+        #endif
+        check = BUFFER_OK;
     }
-    // Only add to buffer if connected and sizes are not 0
-    if( mqttbuf_getState() == MQTT_DISCONNECTED || 
-            li_size == 0 || payloadlen == 0)
+    else if(check == BUFFER_WRONG_ID)
     {
-        return MQTT_PUB_NO_DATA;
+        // Record was not added to the buffer
+        mqttbuf_freePubRecord(record);
     }
-    li_index = 0;
-    // LOCK PUB BUFFERS: Protect data and timestamp buffers from being 
-    // read/written at different times
-    pthread_mutex_lock(&pub_mutex);
-    check[li_index] = buffer_push(mqttbufID[MQTT_PUB_TOPIC_BUFFER], 
-            topic, li_size + 1); // +1 to get the final '\0'
-    li_index++;
-    check[li_index] = buffer_push(mqttbufID[MQTT_PUB_PAYLOAD_BUFFER], 
-            payload, payloadlen);
-    li_index++;
-    check[li_index] = buffer_push(mqttbufID[MQTT_PUB_STAMP_BUFFER], 
-            &millisecondsSinceEpoch, sizeof(millisecondsSinceEpoch));    
-    // UNLOCK BUFFERS:
-    pthread_mutex_unlock(&pub_mutex);
     /* Check for critical errors */
-    for(li_index = 0; li_index < MQTT_NUMBER_OF_PUB_BUFFERS; li_index++)
+    if(check != BUFFER_OK)
     {
-        if( check[li_index] != BUFFER_OK )
-        {
-            /***************/
-            /* FATAL ERROR */
-            /***************/
-            #ifdef DEBUG_MQTT_ERRORS
-            debug_print("MQTT: PUB Buffer ERROR!\n");
-            debug_print("- Buffer ID: %d - Error = %d\n", li_index + 
-                    MQTT_PUB_TOPIC_BUFFER, check[li_index]);
-            #endif
-            return MQTT_PUB_BUFFER_ERROR;
-        }
+        /***************/
+        /* FATAL ERROR */
+        /***************/
+        #ifdef DEBUG_MQTT_ERRORS
+        debug_error("MQTT: PUB Buffer ERROR!\n");
+        debug_error("- Buffer ID: %d - Error = %d\n", 
+                mqttbufID[MQTT_PUB_BUFFER], check);
+        #endif
+        return MQTT_PUB_BUFFER_ERROR;
     }
     // Here all is good
     return MQTT_PUB_OK;
 }
 
-
 /* PUB messages from buffer */
 int mqttbuf_pubMsgFromBuffer(unsigned int retries, unsigned long timeout)
 {
@@ -437,9 +390,11 @@ int mqttbuf_pubMsgFromBuffer(unsigned int retries, unsigned long timeout)
     unsigned int lui_count;
     int m_State;
     bool keepInLoop;
+    latencyStamp_t stamp;
+    unsigned long long start;
     
     // Try to publish data from buffer    
-    li_check = mqttbuf_publish();
+    li_check = mqttbuf_publish(&stamp, &start);
     if(li_check == MQTT_PUB_OK)
     {
         li_check = MQTT_SEND_WAITING;
@@ -471,12 +426,15 @@ int mqttbuf_pubMsgFromBuffer(unsigned int retries, unsigned long timeout)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_MQTT_ERRORS
-            debug_print("mqttbuf_pubMsgFromBuffer: PUBLISH ERROR (TIMEOUT) - Tried %d times!\n", lui_count);
+            debug_error("mqttbuf_pubMsgFromBuffer: PUBLISH ERROR (TIMEOUT) - Tried %d times!\n", lui_count);
             #endif
             return MQTT_PUB_TIMEOUT_ERROR;
         }
         else
         {
+            latency_sent(&stamp, start);
+            metrics_add(METRICS_MQTT_TX_MESSAGES, 0, 1);
+            metrics_add(METRICS_MQTT_PUB_RTT_US, 0, latency_getTime() - start);
             return MQTT_PUB_OK;
         }
     }
@@ -485,192 +443,80 @@ int mqttbuf_pubMsgFromBuffer(unsigned int retries, unsigned long timeout)
         return li_check;
     }
 }
-
 /** Get Subscribed data from buffer */
 int mqttbuf_getSubMsgFromBuffer(char** topic, void** payload, int* payloadlen, 
         unsigned long long* millisecondsSinceEpoch)
 {
+    mqttRecord_t* record;
     *topic = NULL;
     *payload = NULL;
     *payloadlen = 0;
     *millisecondsSinceEpoch = 0;
-    int li_index;
-    int li_temp;
-    int li_return;
-    int li_check;
-    unsigned int lui_size;
-    unsigned int bufferSize[MQTT_NUMBER_OF_SUB_BUFFERS];
-    
-    /**************************************************************************
-     * CONSISTENCY CHECK
-     *************************************************************************/
-    // Get every Sub buffer count
-    // LOCK SUB BUFFERS: Protect data and timestamp buffers from being 
-    // read/written at different times
-    pthread_mutex_lock(&sub_mutex);
-    for(li_index = 0; li_index < MQTT_NUMBER_OF_SUB_BUFFERS; li_index++)
-    {        
-        bufferSize[li_index] = buffer_dataCount(mqttbufID[li_index + 
-                MQTT_SUB_BUFFER_OFFSET]);
-    }    
-    // Check if every write buffer is not empty
-    li_temp = 0;
-    for(li_index = 0; li_index < MQTT_NUMBER_OF_SUB_BUFFERS; li_index++)
-    {        
-        if( bufferSize[li_index] != 0 )
-        {
-            li_temp = 1;
-        }
-    }
-    if(li_temp == 0)
+    if(buffer_dataCount(mqttbufID[MQTT_SUB_BUFFER]) == 0)
     {
-        // No data to be sent - Unlock Buffers and return now
-        // UNLOCK SUB BUFFERS:
-        pthread_mutex_unlock(&sub_mutex);
+        // No data available
         return MQTT_SUB_NO_DATA;
-    }        
-    // Check if every buffer has the same count of elements
-    for(li_index = 0; li_index < MQTT_NUMBER_OF_SUB_BUFFERS - 1; li_index++)
-    {        
-        if( bufferSize[li_index] != bufferSize[li_index + 1] )
-        {            
-            /***************/
-            /* FATAL ERROR */
-            /***************/
-            #ifdef DEBUG_MQTT_ERRORS
-            debug_print("MQTT: SUB Buffer ERROR!\n");
-            #endif
-            // Buffers out of sync - Unlock Buffers and return now
-            // UNLOCK SUB BUFFERS:
-            pthread_mutex_unlock(&sub_mutex);
-            return MQTT_SUB_BUFFER_ERROR;
-        }
-    }    
-    
-    /**************************************************************************
-     * FILL DATA - topic, payload, payloadlen, millisecondsSinceEpoch
-     *************************************************************************/
-    li_return = MQTT_SUB_OK;
-    lui_size = buffer_popSize(mqttbufID[MQTT_SUB_TOPIC_BUFFER]);
-    if(lui_size > 0)
-    {
-        *topic = malloc(lui_size);
-        li_check = buffer_pop(mqttbufID[MQTT_SUB_TOPIC_BUFFER], *topic, 
-                lui_size);
-        if(li_check != BUFFER_OK)
-        {
-            /***************/
-            /* FATAL ERROR */
-            /***************/
-            #ifdef DEBUG_MQTT_ERRORS
-            debug_print("MQTT: Get SUB Buffer POP ERROR!\n");
-            debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_SUB_TOPIC_BUFFER]);
-            #endif
-            // Free data allocated
-            free(*topic);
-            *topic = NULL;
-            // Return
-            li_return = MQTT_SUB_BUFFER_ERROR;
-        }
-    }
-    else
-    {
-        /***************/
-        /* FATAL ERROR */
-        /***************/
-        #ifdef DEBUG_MQTT_ERRORS
-        debug_print("MQTT: Get SUB Buffer POP ERROR!\n");
-        debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_SUB_TOPIC_BUFFER]);
-        #endif
-        // No allocated data to be Freed
-        li_return = MQTT_SUB_BUFFER_ERROR;
-    }
-    *payloadlen = buffer_popSize(mqttbufID[MQTT_SUB_PAYLOAD_BUFFER]);
-    if(*payloadlen > 0)
-    {
-        *payload = malloc(*payloadlen);
-        li_check = buffer_pop(mqttbufID[MQTT_SUB_PAYLOAD_BUFFER], *payload, 
-                *payloadlen);
-        if(li_check != BUFFER_OK)
-        {
-            /***************/
-            /* FATAL ERROR */
-            /***************/
-            #ifdef DEBUG_MQTT_ERRORS
-            debug_print("MQTT: SEND POP Buffer ERROR!\n");
-            debug_print("- Buffer ID: %d\n", 
-                    mqttbufID[MQTT_SUB_PAYLOAD_BUFFER]);
-            #endif
-            // Free data allocated
-            free(*topic);
-            free(*payload);
-            *topic = NULL;
-            *payload = NULL;
-            // Return
-            li_return = MQTT_SUB_BUFFER_ERROR;
-        }
     }
-    else
+    record = mqttbuf_popRecord(MQTT_SUB_BUFFER);
+    if((record == NULL) || (record->topiclen <= 0) || 
+            (record->payloadlen <= 0))
     {
         /***************/
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_MQTT_ERRORS
-        debug_print("MQTT: SEND POP Buffer ERROR - Data size 0!\n");
-        debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_SUB_PAYLOAD_BUFFER]);
+        debug_error("MQTT: Get SUB Buffer POP ERROR!\n");
+        debug_error("- Buffer ID: %d\n", mqttbufID[MQTT_SUB_BUFFER]);
         #endif
         // Free data allocated
-        free(*topic);
-        *topic = NULL;
+        free(record);
         // Return
-        li_return = MQTT_SUB_BUFFER_ERROR;
-    }
-    // Pop timestamp to keep buffers sync
-    lui_size = buffer_popSize(mqttbufID[MQTT_SUB_STAMP_BUFFER]);
-    if(lui_size > 0)
-    {
-        li_check = buffer_pop(mqttbufID[MQTT_SUB_STAMP_BUFFER], 
-                millisecondsSinceEpoch, sizeof(*millisecondsSinceEpoch));
-        if((li_check != BUFFER_OK) || 
-                (lui_size != sizeof(*millisecondsSinceEpoch)))
-        {
-            /***************/
-            /* FATAL ERROR */
-            /***************/
-            #ifdef DEBUG_MQTT_ERRORS
-            debug_print("MQTT: SEND POP Buffer ERROR!\n");
-            debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_SUB_STAMP_BUFFER]);
-            #endif
-            // Free data allocated
-            free(*topic);
-            free(*payload);
-            *topic = NULL;
-            *payload = NULL;
-            // Return
-            li_return = MQTT_SUB_BUFFER_ERROR;
-        }
+        return MQTT_SUB_BUFFER_ERROR;
     }
-    else
+    /**************************************************************************
+     * FILL DATA - topic, payload, payloadlen, millisecondsSinceEpoch
+     *************************************************************************/
+    // Topic and payload point to the same record (freed with the topic)
+    *topic = record->data;
+    *payload = record->data + record->topiclen + 1;
+    *payloadlen = record->payloadlen;
+    *millisecondsSinceEpoch = record->millisecondsSinceEpoch;
+    latency_dequeued(&record->latency);
+    // return
+    return MQTT_SUB_OK;
+}
+
+/** Free the subscribed data read from buffer */
+void mqttbuf_freeSubMsg(char* topic)
+{
+    if(topic != NULL)
     {
-        /***************/
-        /* FATAL ERROR */
-        /***************/
-        #ifdef DEBUG_MQTT_ERRORS
-        debug_print("MQTT: SEND POP Buffer ERROR - Data size 0!\n");
-        debug_print("- Buffer ID: %d\n", mqttbufID[MQTT_SUB_STAMP_BUFFER]);
-        #endif
-        // Free data allocated
-        free(*topic);
-        free(*payload);
-        *topic = NULL;
-        *payload = NULL;
-        // Return
-        li_return = MQTT_SUB_BUFFER_ERROR;
+        free(topic - offsetof(mqttRecord_t, data));
     }
-    // UNLOCK BUFFERS:
-    pthread_mutex_unlock(&sub_mutex);    
-    // return
-    return li_return;
+}
+
+/** Resize the buffers and set the policies from the configuration */
+void mqttbuf_updateQueues(void)
+{
+    // LOCK BUFFERS
+    pthread_mutex_lock(&init_mutex);
+    mqttbuf_configBuffers();
+    // UNLOCK BUFFERS
+    pthread_mutex_unlock(&init_mutex);
+}
+
+/** Number of messages dropped by the buffers (overflow) */
+void mqttbuf_getDropCount(unsigned long *sub, unsigned long *pub)
+{
+    *sub = buffer_getDropCount(mqttbufID[MQTT_SUB_BUFFER]);
+    *pub = buffer_getDropCount(mqttbufID[MQTT_PUB_BUFFER]);
+}
+
+/** Number of messages in the buffers */
+void mqttbuf_getQueueDepth(unsigned long *sub, unsigned long *pub)
+{
+    *sub = buffer_dataCount(mqttbufID[MQTT_SUB_BUFFER]);
+    *pub = buffer_dataCount(mqttbufID[MQTT_PUB_BUFFER]);
 }
 
 /** Returns last error during MQTT subscription received message */
@@ -686,22 +532,24 @@ void mqttbuf_subCallback(char *topicName, int topicLen,
         MQTTClient_message *message)
 {
     unsigned long long millisecondsSinceEpoch;
-    int check[MQTT_NUMBER_OF_SUB_BUFFERS];
-    int li_index;
+    int check;
     int li_length;
+    int li_size;
+    mqttRecord_t* record;
     
     // Get Timestamp
     millisecondsSinceEpoch = aux_getmsSinceEpoch();
 
     #ifdef DEBUG_MQTT_RECEIVED
-    debug_print("Message Received! \n");
-    debug_print("- Topic: %s\n", topicName);
-    debug_print("- Message: %s\n", message->payload);
-    debug_print("- Topic Length: %d\n", topicLen);
-    debug_print("- Message Length: %d\n", message->payloadlen);
+    debug_verbose("Message Received! \n");
+    debug_verbose("- Topic: %s\n", topicName);
+    debug_verbose("- Message: %.*s\n", message->payloadlen, 
+            (char*)message->payload);
+    debug_verbose("- Topic Length: %d\n", topicLen);
+    debug_verbose("- Message Length: %d\n", message->payloadlen);
     #endif
 
-    /* Copy Message to Buffers */
+    /* Copy Message to Buffer */
     if(topicLen <= 0)
     {
         if(topicName != NULL)
@@ -721,37 +569,56 @@ void mqttbuf_subCallback(char *topicName, int topicLen,
     // Check if data is OK. If not, Ignore the message
     if((li_length > 0) && (message->payloadlen > 0))
     {
-        // LOCK BUFFERS: Protect data and timestamp buffers from being read/written at different times
-        pthread_mutex_lock(&sub_mutex);
-        check[MQTT_SUB_TOPIC_BUFFER] = buffer_push(mqttbufID[MQTT_SUB_TOPIC_BUFFER], topicName, li_length + 1); // +1 to get the final '\0'
-        check[MQTT_SUB_PAYLOAD_BUFFER] = buffer_push(mqttbufID[MQTT_SUB_PAYLOAD_BUFFER], message->payload, message->payloadlen);
-        check[MQTT_SUB_STAMP_BUFFER] = buffer_push(mqttbufID[MQTT_SUB_STAMP_BUFFER], &millisecondsSinceEpoch, sizeof(millisecondsSinceEpoch));
-        // UNLOCK BUFFERS:
-        pthread_mutex_unlock(&sub_mutex);
+        // Fill the record: topic + '\0' + payload
+        li_size = sizeof(*record) + li_length + 1 + message->payloadlen;
+        record = malloc(li_size);
+        record->millisecondsSinceEpoch = millisecondsSinceEpoch;
+        latency_stampRx(&record->latency, LATENCY_PATH_MQTT2CAN);
+        metrics_add(METRICS_MQTT_RX_MESSAGES, 0, 1);
+        record->topic = NULL;
+        record->topiclen = li_length;
+        record->payloadlen = message->payloadlen;
+        memcpy(record->data, topicName, li_length);
+        record->data[li_length] = '\0';
+        memcpy(record->data + li_length + 1, message->payload, 
+                message->payloadlen);
+        // The record is handed over to the buffer (no copy). It waits for a 
+        // free position if the overflow policy is "block"
+        check = buffer_pushNoCopy(mqttbufID[MQTT_SUB_BUFFER], record, li_size);
+        if(check == BUFFER_OVERFLOW)
+        {
+            // Overflow is handled by the buffer policy (a record was dropped)
+            #ifdef DEBUG_MQTT_ERRORS
+            debug_error("MQTT: RECEIVE Buffer Overflow - Dropped: %lu\n", 
+                    buffer_getDropCount(mqttbufID[MQTT_SUB_BUFFER]));
+            #endif
+            check = BUFFER_OK;
+        }
+        else if(check == BUFFER_WRONG_ID)
+        {
+            free(record);
+        }
         /* Check for critical errors */
-        for(li_index = 0; li_index < MQTT_NUMBER_OF_SUB_BUFFERS; li_index++)
+        if( check != BUFFER_OK )
         {
-            if( check[li_index] != BUFFER_OK )
-            {
-                /***************/
-                /* FATAL ERROR */
-                /***************/
-                #ifdef DEBUG_MQTT_ERRORS
-                debug_print("MQTT: RECEIVE Buffer ERROR!\n");
-                debug_print("- Buffer ID: %d\n", li_index);
-                #endif
-                // Set error and return
-                mqttbuf_setLastError(MQTT_SUB_BUFFER_ERROR);
-                return;
-            }
+            /***************/
+            /* FATAL ERROR */
+            /***************/
+            #ifdef DEBUG_MQTT_ERRORS
+            debug_error("MQTT: RECEIVE Buffer ERROR!\n");
+            debug_error("- Buffer ID: %d\n", mqttbufID[MQTT_SUB_BUFFER]);
+            #endif
+            // Set error and return
+            mqttbuf_setLastError(MQTT_SUB_BUFFER_ERROR);
+            return;
         }
     }
     else
     {
         #ifdef DEBUG_MQTT_ERRORS
-        debug_print("MQTT: RECEIVE Message ERROR!\n");
-        debug_print("- Topic Length: %d\n", li_length);
-        debug_print("- Message Length: %d\n", message->payloadlen);
+        debug_error("MQTT: RECEIVE Message ERROR!\n");
+        debug_error("- Topic Length: %d\n", li_length);
+        debug_error("- Message Length: %d\n", message->payloadlen);
         #endif
         // Set error and return
         mqttbuf_setLastError(MQTT_SUB_OTHER_ERROR);
@@ -6,6 +6,21 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - One buffer of records per direction; mqttbuf_freeSubMsg added            //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add mqttbuf_getDropCount (messages dropped by the overflow policy)       //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add mqttbuf_updateQueues (buffer sizes and policies after a reload)      //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Add mqttbuf_getQueueDepth (metrics)                                      //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - The publish topic is an interned topic (see topic.h)                     //
+//----------------------------------------------------------------------------//
 
 #ifndef MQTTBUF_H
 #define MQTTBUF_H
@@ -19,19 +34,13 @@ extern "C" {
 //----------------------------------------------------------------------------//
 // EXTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
-#define MQTT_BUFFER_SIZE    600
+#define MQTT_BUFFER_SIZE    600 // Default - mqttSub/mqttPubQueueSize
 enum
 {
-    MQTT_SUB_TOPIC_BUFFER = 0,
-    MQTT_SUB_PAYLOAD_BUFFER,
-    MQTT_SUB_STAMP_BUFFER,
-    MQTT_PUB_TOPIC_BUFFER,
-    MQTT_PUB_PAYLOAD_BUFFER,
-    MQTT_PUB_STAMP_BUFFER,
+    MQTT_SUB_BUFFER = 0,
+    MQTT_PUB_BUFFER,
     MQTT_NUMBER_OF_BUFFERS
 };
-#define MQTT_NUMBER_OF_SUB_BUFFERS (MQTT_SUB_STAMP_BUFFER - MQTT_SUB_TOPIC_BUFFER + 1)
-#define MQTT_NUMBER_OF_PUB_BUFFERS (MQTT_PUB_STAMP_BUFFER - MQTT_PUB_TOPIC_BUFFER + 1)
 
 // Send
 #define MQTT_PUB_OK                 1
@@ -89,7 +98,8 @@ int mqttbuf_close(int close, int cleanBuffers);
 /**
  * Set Publish buffer with data from parameters.
  * 
- * \param   topic
+ * \param   topic   interned topic (see topic_intern) - the record takes a
+ *                  reference of it (no search and no copy of the string)
  * \param   payload
  * \param   payloadlen
  * \param   millisecondsSinceEpoch
@@ -97,7 +107,7 @@ int mqttbuf_close(int close, int cleanBuffers);
  * \return  MQTT_PUB_OK             if data was set to buffer
  *          MQTT_PUB_BUFFER_ERROR   if no data was set due to buffer error
  */
-int mqttbuf_setPubMsgToBuffer(char* topic, void* payload, int payloadlen, unsigned long long millisecondsSinceEpoch);
+int mqttbuf_setPubMsgToBuffer(const char* topic, void* payload, int payloadlen, unsigned long long millisecondsSinceEpoch);
 
 /**
  * MQTT Publish Data from Buffer.
@@ -118,8 +128,9 @@ int mqttbuf_pubMsgFromBuffer(unsigned int retries, unsigned long timeout);
 /**
  * Get Subscribed data from buffer.
  * 
- * \param   topic                   Has to be freed after used: free(topic)
- * \param   payload                 Has to be freed after used: free(payload)
+ * \param   topic                   Has to be freed after used: 
+ *                                  mqttbuf_freeSubMsg(topic)
+ * \param   payload                 Same allocation as topic (not freed)
  * \param   payloadlen
  * \param   millisecondsSinceEpoch
  * 
@@ -130,6 +141,37 @@ int mqttbuf_pubMsgFromBuffer(unsigned int retries, unsigned long timeout);
  */
 int mqttbuf_getSubMsgFromBuffer(char** topic, void** payload, int* payloadlen, unsigned long long* millisecondsSinceEpoch);
 
+/**
+ * Free Subscribed data read from buffer (topic and payload).
+ * 
+ * \param   topic                   topic set by mqttbuf_getSubMsgFromBuffer
+ *                                  (NULL is accepted)
+ */
+void mqttbuf_freeSubMsg(char* topic);
+
+/**
+ * Number of messages dropped by the overflow policy of the buffers - 
+ * Monitoring.
+ * 
+ * \param   sub     messages dropped from the subscription buffer (OUTPUT)
+ * \param   pub     messages dropped from the publish buffer (OUTPUT)
+ */
+void mqttbuf_getDropCount(unsigned long *sub, unsigned long *pub);
+
+/**
+ * Number of messages in the buffers - Monitoring.
+ * 
+ * \param   sub     messages in the subscription buffer (OUTPUT)
+ * \param   pub     messages in the publish buffer (OUTPUT)
+ */
+void mqttbuf_getQueueDepth(unsigned long *sub, unsigned long *pub);
+
+/**
+ * Resize the buffers and set the overflow policies again from the 
+ * configuration. The messages stored in the buffers are kept.
+ */
+void mqttbuf_updateQueues(void);
+
 /**
  * Returns last error during mqtt subscription read. 
  * \return  MQTT_SUB_OK             if data was received
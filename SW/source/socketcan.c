@@ -6,6 +6,17 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_CAN             //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - socketcan_open: interface given by name (any number of channels)         //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_CAN
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -35,28 +46,23 @@
 // EXTERNAL FUNCTIONS
 //----------------------------------------------------------------------------//
 // Opens the connection to the CAN-bus
-int socketcan_open(int channel) 
+int socketcan_open(const char *interface) 
 {
     int fd;
     struct ifreq ifr;
     struct sockaddr_can addr;
     
-    // Check channel selected 
-    if(channel == 0)
-    {
-        strcpy(ifr.ifr_name, "can0");
-    }
-    else if(channel == 1)
-    {
-        strcpy(ifr.ifr_name, "can1");
-    }
-    else
+    // Check interface selected 
+    if((interface == NULL) || (interface[0] == 0) || 
+            (strlen(interface) >= sizeof(ifr.ifr_name)))
     {
         #if defined(DEBUG_SOCKETCAN_ERROR) || defined(DEBUG_SOCKETCAN_OPEN)
-        debug_print("SocketCAN: Invalid Channel: %d\n", channel);
+        debug_print("SocketCAN: Invalid Interface: %s\n", 
+                (interface == NULL) ? "" : interface);
         #endif 
         return -1;
     }
+    strcpy(ifr.ifr_name, interface);
     
     // Create the Socket
     fd = -1;
@@ -64,7 +70,7 @@ int socketcan_open(int channel)
     if(fd  == -1) 
     {
         #if defined(DEBUG_SOCKETCAN_ERROR) || defined(DEBUG_SOCKETCAN_OPEN)
-        debug_print("SocketCAN: Open Error - Socket Channel: %d\n", channel);
+        debug_print("SocketCAN: Open Error - Socket Interface: %s\n", interface);
         #endif  
         return fd;
     }
@@ -73,7 +79,7 @@ int socketcan_open(int channel)
     if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) 
     {
         #if defined(DEBUG_SOCKETCAN_ERROR) || defined(DEBUG_SOCKETCAN_OPEN)
-        debug_print("SocketCAN: Open Error - Socket Index not found - Channel: %d\n", channel);
+        debug_print("SocketCAN: Open Error - Socket Index not found - Interface: %s\n", interface);
         #endif
         // Close file and return
         close(fd);
@@ -91,7 +97,7 @@ int socketcan_open(int channel)
     if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) 
     {
         #if defined(DEBUG_SOCKETCAN_ERROR) || defined(DEBUG_SOCKETCAN_OPEN)
-        debug_print("SocketCAN: Bind Error - Channel: %d\n", channel);
+        debug_print("SocketCAN: Bind Error - Interface: %s\n", interface);
         #endif
         // Close file and return
         close(fd);
@@ -102,7 +108,7 @@ int socketcan_open(int channel)
     if (fcntl(fd, F_SETFL, O_NONBLOCK) < 0) 
     {
         #if defined(DEBUG_SOCKETCAN_ERROR) || defined(DEBUG_SOCKETCAN_OPEN)
-        debug_print("SocketCAN: Set to Non-Blocking Error - Channel: %d\n", channel);
+        debug_print("SocketCAN: Set to Non-Blocking Error - Interface: %s\n", interface);
         #endif
         // Close file and return
         close(fd);
@@ -111,7 +117,7 @@ int socketcan_open(int channel)
 
     // Return file descriptor
     #if defined(DEBUG_SOCKETCAN_OPEN) || defined(DEBUG_SOCKETCAN_OPENED)
-    debug_print("SocketCAN: Open Successful - Socket Channel: %d\n", channel);
+    debug_print("SocketCAN: Open Successful - Socket Interface: %s\n", interface);
     debug_print("SocketCAN: Open Successful - FD: %d\n", fd);
     #endif
     return fd;
@@ -130,7 +136,7 @@ void socketcan_close(int fd)
      * With shutdown, you will still be able to receive pending data the peer 
      * already sent */
     #ifdef DEBUG_SOCKETCAN_OPEN
-    debug_print("SocketCAN: Close - FD: %d\n", fd);
+    debug_verbose("SocketCAN: Close - FD: %d\n", fd);
     #endif
     close(fd);
 }
@@ -152,7 +158,7 @@ int socketcan_read(int fd, struct can_frame* pcf_Frame, int timeout)
     if(i_Temp > 0)
     {
         #ifdef DEBUG_SOCKETCAN_READ_FULL						
-        debug_print("SocketCAN: Read Poll OK!\n");
+        debug_verbose("SocketCAN: Read Poll OK!\n");
         #endif
         // Only set return to 0 in the end of the function - read could still have errors
         i_Return = SOCKETCAN_OTHER_ERROR;
@@ -160,9 +166,9 @@ int socketcan_read(int fd, struct can_frame* pcf_Frame, int timeout)
     else if(i_Temp == 0)
     {
         #ifdef DEBUG_SOCKETCAN_READ_FULL						
-        debug_print("SocketCAN: Read Poll Error (Timeout)!\n");
-        debug_print("- File: %d\n", fd);
-        debug_print("- Error: %d\n", i_Temp);
+        debug_verbose("SocketCAN: Read Poll Error (Timeout)!\n");
+        debug_verbose("- File: %d\n", fd);
+        debug_verbose("- Error: %d\n", i_Temp);
         #endif	
         i_Return = SOCKETCAN_TIMEOUT;	
     }
@@ -191,8 +197,8 @@ int socketcan_read(int fd, struct can_frame* pcf_Frame, int timeout)
     {        
         // Error, no bytes read
         #ifdef DEBUG_SOCKETCAN_READ_FULL						
-        debug_print("SocketCAN: No Bytes Read!\n");
-        debug_print("- File: %d\n", fd);
+        debug_verbose("SocketCAN: No Bytes Read!\n");
+        debug_verbose("- File: %d\n", fd);
         #endif
         // Return
         return i_Return;
@@ -222,7 +228,7 @@ int socketcan_read(int fd, struct can_frame* pcf_Frame, int timeout)
     
     // Debug Event
     #ifdef DEBUG_SOCKETCAN_READ_EVENTS
-    debug_print("SocketCAN Read: New Frame Read. FD = %d!\n", fd);
+    debug_verbose("SocketCAN Read: New Frame Read. FD = %d!\n", fd);
     #endif
     
     // At this point, read is OK!
@@ -262,7 +268,7 @@ int socketcan_write(int fd, struct can_frame* pcf_Frame)
     
     // At this point, write operation is finished OK!
     #ifdef DEBUG_SOCKETCAN_WRITE
-    debug_print("SocketCAN: Write OK!\n");
+    debug_verbose("SocketCAN: Write OK!\n");
     #endif
     return 0;
 }
\ No newline at end of file
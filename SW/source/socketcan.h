@@ -6,6 +6,9 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - socketcan_open: interface given by name (any number of channels)         //
+//----------------------------------------------------------------------------//
 
 #ifndef SOCKETCAN_H
 #define SOCKETCAN_H
@@ -38,10 +41,10 @@ extern "C" {
 /**
  * Opens the connection to the CAN-bus.
  *
- * \param channel       Channel 0: can0 / Channel 1: can1
+ * \param interface     CAN interface, e.g. "can0"
  * \return              file pointer on success, -1 on error
  */
-int socketcan_open(int channel);
+int socketcan_open(const char *interface);
 
 
 /** Closes the connection to the CAN-bus */
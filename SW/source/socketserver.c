@@ -6,6 +6,14 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_SOCKETSERVER    //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_SOCKETSERVER
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -172,7 +180,7 @@ int socketserver_open(int timeout)
         return SOCKETSERVER_ERROR;
     }
     #ifdef DEBUG_SOCKETSERVER_OPEN
-    debug_print("Socket Server Open: Listener fd = %d\n", fdListener);
+    debug_verbose("Socket Server Open: Listener fd = %d\n", fdListener);
     #endif
 
     pfds[0].fd = fdListener;
@@ -183,15 +191,15 @@ int socketserver_open(int timeout)
     if(i_Temp > 0)
     {
         #ifdef DEBUG_SOCKETSERVER_OPEN						
-        debug_print("SocketServer: Open Poll OK!\n");
+        debug_verbose("SocketServer: Open Poll OK!\n");
         #endif
     }
     else if(i_Temp == 0)
     {
         #ifdef DEBUG_SOCKETSERVER_OPEN						
-        debug_print("SocketServer: Open Poll Error (Timeout)!\n");
-        debug_print("- File: %d\n", fdListener);
-        debug_print("- Error: %d\n", i_Temp);
+        debug_verbose("SocketServer: Open Poll Error (Timeout)!\n");
+        debug_verbose("- File: %d\n", fdListener);
+        debug_verbose("- Error: %d\n", i_Temp);
         #endif	
         return SOCKETSERVER_TIMEOUT;	
     }
@@ -244,8 +252,8 @@ int socketserver_open(int timeout)
 void socketserver_close(void)
 {
     #ifdef DEBUG_SOCKETCAN_OPEN
-    debug_print("SocketCAN: Close - Listener FD: %d\n", fdListener);
-    debug_print("SocketCAN: Close - Accepted FD: %d\n", fdAccepted);
+    debug_verbose("SocketCAN: Close - Listener FD: %d\n", fdListener);
+    debug_verbose("SocketCAN: Close - Accepted FD: %d\n", fdAccepted);
     #endif
     close(fdListener);
     close(fdAccepted);
@@ -277,15 +285,15 @@ int socketserver_read(uint8_t* data, int* dataLen, int timeout)
     if(i_Temp > 0)
     {
         #ifdef DEBUG_SOCKETSERVER_READ_FULL						
-        debug_print("SocketCANServer: Read Poll OK!\n");
+        debug_verbose("SocketCANServer: Read Poll OK!\n");
         #endif
     }
     else if(i_Temp == 0)
     {
         #ifdef DEBUG_SOCKETSERVER_READ_FULL						
-        debug_print("SocketCANServer: Read Poll Error (Timeout)!\n");
-        debug_print("- File: %d\n", fdAccepted);
-        debug_print("- Error: %d\n", i_Temp);
+        debug_verbose("SocketCANServer: Read Poll Error (Timeout)!\n");
+        debug_verbose("- File: %d\n", fdAccepted);
+        debug_verbose("- Error: %d\n", i_Temp);
         #endif	
         return SOCKETSERVER_TIMEOUT;	
     }
@@ -314,8 +322,8 @@ int socketserver_read(uint8_t* data, int* dataLen, int timeout)
     {        
         // Error, no bytes read
         #ifdef DEBUG_SOCKETSERVER_READ_FULL						
-        debug_print("SocketCANServer: No Bytes Read!\n");
-        debug_print("- File: %d\n", fdAccepted);
+        debug_verbose("SocketCANServer: No Bytes Read!\n");
+        debug_verbose("- File: %d\n", fdAccepted);
         #endif
         // Return
         return SOCKETSERVER_OTHER_ERROR;
@@ -324,8 +332,8 @@ int socketserver_read(uint8_t* data, int* dataLen, int timeout)
     {        
         // Connection closed by client
         #ifdef DEBUG_SOCKETSERVER_READ_FULL						
-        debug_print("SocketCANServer: Connection closed by client!\n");
-        debug_print("- File: %d\n", fdAccepted);
+        debug_verbose("SocketCANServer: Connection closed by client!\n");
+        debug_verbose("- File: %d\n", fdAccepted);
         #endif
         // Return
         return SOCKETSERVER_CLOSED;
@@ -348,7 +356,7 @@ int socketserver_read(uint8_t* data, int* dataLen, int timeout)
     
     // Debug Event
     #ifdef DEBUG_SOCKETSERVER_READ_EVENTS
-    debug_print("SocketCANServer Read: New Frame Read (%d bytes received). FD = %d!\n", i_ReadLength, fdAccepted);
+    debug_verbose("SocketCANServer Read: New Frame Read (%d bytes received). FD = %d!\n", i_ReadLength, fdAccepted);
     #endif
     
     // At this point, read is OK!
@@ -387,7 +395,7 @@ int socketserver_write(uint8_t* data, int dataLen)
     
     // At this point, write operation is finished OK!
     #ifdef DEBUG_SOCKETSERVER_WRITE
-    debug_print("SocketCANServer: Write OK!\n");
+    debug_verbose("SocketCANServer: Write OK!\n");
     #endif
     return SOCKETSERVER_OK;
 }
\ No newline at end of file
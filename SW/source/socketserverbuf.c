@@ -6,6 +6,35 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Overflow policy of each buffer from the configuration. An overflow is    //
+// handled by the buffer (counted as a drop), not reported as an error        //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Number of elements of each buffer from the configuration. Add            //
+// socketserverbuf_updateQueues: resize the buffers and set the policies      //
+// again after a configuration reload (stored messages are kept)              //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Latency of each message read (monotonic stamp stored with the            //
+// timestamp)                                                                 //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Add socketserverbuf_getQueueDepth; messages received / sent are          //
+// counted (metrics)                                                          //
+//----------------------------------------------------------------------------//
+//  1.05     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_SOCKETSERVER    //
+//----------------------------------------------------------------------------//
+//  1.06     | 18/Oct/2026 |                               | ALCP             //
+// - The wait for a free position ("block" policy) is done under the lock of  //
+// the buffers: the position cannot be taken by another producer              //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_SOCKETSERVER
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -15,6 +44,9 @@
 #include "debug.h"
 #include "buffer.h"
 #include "auxiliary.h"
+#include "config.h"
+#include "latency.h"
+#include "metrics.h"
 #include "hapcan.h"
 #include "socketserver.h"
 #include "socketserverbuf.h"
@@ -26,6 +58,16 @@
 #define NUMBER_OF_SOCKETSERVER_WRITE_BUFFERS (SOCKETSERVER_WRITE_STAMP_BUFFER - SOCKETSERVER_WRITE_DATA_BUFFER + 1)
 #define NUMBER_OF_SOCKETSERVER_READ_BUFFERS  (SOCKETSERVER_READ_STAMP_BUFFER - SOCKETSERVER_READ_DATA_BUFFER + 1)
 
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+/* Element of the read timestamp buffer */
+typedef struct
+{
+    unsigned long long millisecondsSinceEpoch;
+    latencyStamp_t latency;
+} socketserverbufStamp_t;
+
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
@@ -40,6 +82,7 @@ static pthread_mutex_t ssb_write_mutex = PTHREAD_MUTEX_INITIALIZER;
 //----------------------------------------------------------------------------//
 static stateSocketServer_t getSSBStateLocked(void);
 static void setSSBStateLocked(stateSocketServer_t sState);
+static void socketserverbuf_configBuffers(void);
 
 static stateSocketServer_t getSSBStateLocked(void)
 {
@@ -65,6 +108,40 @@ static void setSSBStateLocked(stateSocketServer_t sState)
     // UNLOCK STATE:
     pthread_mutex_unlock(&ssb_state_mutex);
 }
+/**
+ * Create the buffers (if not created yet) or resize them, and set the overflow
+ * policy, from the configuration. Data and timestamp buffers of one direction
+ * get the same size and policy, so they drop the same messages.
+ */
+static void socketserverbuf_configBuffers(void)
+{
+    int count;
+    unsigned int size;
+    const char* queue;
+    bufferPolicySettings_t policy;
+    for(count = 0; count < SOCKETSERVER_NUMBER_OF_BUFFERS; count++)
+    {
+        if(count <= SOCKETSERVER_READ_STAMP_BUFFER)
+        {
+            queue = CONFIG_QUEUE_SOCKETSERVER_READ;
+        }
+        else
+        {
+            queue = CONFIG_QUEUE_SOCKETSERVER_WRITE;
+        }
+        size = config_getQueueSize(queue, SOCKETSERVER_BUFFER_SIZE);
+        if(socketserverbufID[count] < 0)
+        {
+            socketserverbufID[count] = buffer_init(size);
+        }
+        else
+        {
+            buffer_resize(socketserverbufID[count], size);
+        }
+        config_getQueuePolicy(queue, size, &policy);
+        buffer_setPolicy(socketserverbufID[count], &policy);
+    }
+}
 
 //----------------------------------------------------------------------------//
 // EXTERNAL FUNCTIONS
@@ -76,13 +153,7 @@ int socketserverbuf_init(void)
     int check;        
     
     // Init buffers
-    for(count = 0; count < SOCKETSERVER_NUMBER_OF_BUFFERS; count++)
-    {
-        if(socketserverbufID[count] < 0)
-        {
-            socketserverbufID[count] = buffer_init(SOCKETSERVER_BUFFER_SIZE);
-        }
-    }
+    socketserverbuf_configBuffers();
     // Check buffers - All should have ID
     check = 0;
     for(count = 0; count < SOCKETSERVER_NUMBER_OF_BUFFERS; count++)
@@ -90,8 +161,8 @@ int socketserverbuf_init(void)
         if(socketserverbufID[count] < 0)
         {
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: socketserverbuf_init Buffer Error!\n");
-            debug_print("- Buffer: %d\n", count);
+            debug_error("SOCKET SERVER: socketserverbuf_init Buffer Error!\n");
+            debug_error("- Buffer: %d\n", count);
             #endif
             check = 1;
         }
@@ -194,6 +265,37 @@ int socketserverbuf_getState(stateSocketServer_t* s_state)
     return EXIT_SUCCESS;        
 }
 
+/** Resize the buffers and set the policies from the configuration */
+void socketserverbuf_updateQueues(void)
+{
+    // LOCK READ and WRITE: data and timestamp buffers are changed together
+    pthread_mutex_lock(&ssb_read_mutex);
+    pthread_mutex_lock(&ssb_write_mutex);
+    socketserverbuf_configBuffers();
+    // UNLOCK WRITE and READ
+    pthread_mutex_unlock(&ssb_write_mutex);
+    pthread_mutex_unlock(&ssb_read_mutex);
+}
+
+/** Number of messages dropped by the buffers (overflow) */
+void socketserverbuf_getDropCount(unsigned long *read, unsigned long *write)
+{
+    // Data and timestamp buffers drop the same elements
+    *read = buffer_getDropCount(
+            socketserverbufID[SOCKETSERVER_READ_DATA_BUFFER]);
+    *write = buffer_getDropCount(
+            socketserverbufID[SOCKETSERVER_WRITE_DATA_BUFFER]);
+}
+
+/** Number of messages in the buffers */
+void socketserverbuf_getQueueDepth(unsigned long *read, unsigned long *write)
+{
+    *read = buffer_dataCount(
+            socketserverbufID[SOCKETSERVER_READ_DATA_BUFFER]);
+    *write = buffer_dataCount(
+            socketserverbufID[SOCKETSERVER_WRITE_DATA_BUFFER]);
+}
+
 /** Set Write buffer with data from parameters */
 int socketserverbuf_setWriteMsgToBuffer(uint8_t* data, int dataLen, 
         unsigned long long millisecondsSinceEpoch)
@@ -212,25 +314,40 @@ int socketserverbuf_setWriteMsgToBuffer(uint8_t* data, int dataLen,
     // LOCK WRITE BUFFERS: Protect data and timestamp buffers from being 
     // read/written at different times
     pthread_mutex_lock(&ssb_write_mutex);
-    check[li_index] = 
-            buffer_push(socketserverbufID[SOCKETSERVER_WRITE_DATA_BUFFER], 
-            data, dataLen);
-    li_index++;
-    check[li_index] = 
-            buffer_push(socketserverbufID[SOCKETSERVER_WRITE_STAMP_BUFFER], 
-            &millisecondsSinceEpoch, sizeof(millisecondsSinceEpoch));
+    // Wait for a free position (only if the overflow policy is "block"). The 
+    // lock is released while waiting - it is also needed to send.
+    if(buffer_waitNotFull(socketserverbufID[SOCKETSERVER_WRITE_DATA_BUFFER], 
+            &ssb_write_mutex) == BUFFER_ERROR)
+    {
+        // Still full: the data is dropped
+        check[li_index] = BUFFER_OVERFLOW;
+        li_index++;
+        check[li_index] = BUFFER_OVERFLOW;
+    }
+    else
+    {
+        check[li_index] = 
+                buffer_push(socketserverbufID[SOCKETSERVER_WRITE_DATA_BUFFER], 
+                data, dataLen);
+        li_index++;
+        check[li_index] = 
+                buffer_push(socketserverbufID[SOCKETSERVER_WRITE_STAMP_BUFFER], 
+                &millisecondsSinceEpoch, sizeof(millisecondsSinceEpoch));
+    }
     // UNLOCK BUFFERS:
     pthread_mutex_unlock(&ssb_write_mutex);
     /* Check for critical errors */
     for(li_index = 0; li_index < NUMBER_OF_SOCKETSERVER_WRITE_BUFFERS; li_index++)
     {
-        if( check[li_index] != BUFFER_OK )
+        // Overflow is handled by the buffer policy (data dropped)
+        if( (check[li_index] != BUFFER_OK) && 
+                (check[li_index] != BUFFER_OVERFLOW) )
         {
             /***************/
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: socketserverbuf_setWriteMsgToBuffer "
+            debug_error("SOCKET SERVER: socketserverbuf_setWriteMsgToBuffer "
                     "- Buffer Error!\n");
             #endif
             return SOCKETSERVER_SEND_BUFFER_ERROR;
@@ -295,7 +412,7 @@ int socketserverbuf_send(void)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("socketserverbuf_send: Write Buffer ERROR "
+            debug_error("socketserverbuf_send: Write Buffer ERROR "
                     "(pre-check)!\n");
             #endif
             // Buffers out of sync - unlock buffers and return now
@@ -323,9 +440,9 @@ int socketserverbuf_send(void)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("socketserverbuf_send: Write Buffer ERROR (pop)!\n");
-            debug_print("- Buffer ID: %d\n", li_position);
-            debug_print("- Data Size: %d\n", lui_size);
+            debug_error("socketserverbuf_send: Write Buffer ERROR (pop)!\n");
+            debug_error("- Buffer ID: %d\n", li_position);
+            debug_error("- Data Size: %d\n", lui_size);
             #endif
             li_return = SOCKETSERVER_SEND_BUFFER_ERROR;
         }
@@ -336,10 +453,10 @@ int socketserverbuf_send(void)
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-        debug_print("socketserverbuf_send: Write Buffer ERROR - "
+        debug_error("socketserverbuf_send: Write Buffer ERROR - "
                 "Data Size is incorrect!\n");
-        debug_print("- Buffer ID: %d\n", li_position);
-        debug_print("- Data Size: %d\n", lui_size);
+        debug_error("- Buffer ID: %d\n", li_position);
+        debug_error("- Data Size: %d\n", lui_size);
         #endif
         li_return = SOCKETSERVER_SEND_BUFFER_ERROR;
     }
@@ -354,10 +471,10 @@ int socketserverbuf_send(void)
                 (lui_size != sizeof(millisecondsSinceEpoch)))
         {
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("socketserverbuf_send: Write Buffer ERROR "
+            debug_error("socketserverbuf_send: Write Buffer ERROR "
                     "(pop timestamp)!\n");
-            debug_print("- Buffer ID: %d\n", li_position);
-            debug_print("- Data Size: %d\n", lui_size);
+            debug_error("- Buffer ID: %d\n", li_position);
+            debug_error("- Data Size: %d\n", lui_size);
             #endif
             li_return = SOCKETSERVER_SEND_BUFFER_ERROR;
         }
@@ -368,10 +485,10 @@ int socketserverbuf_send(void)
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-        debug_print("socketserverbuf_send: Write Buffer ERROR - "
+        debug_error("socketserverbuf_send: Write Buffer ERROR - "
                 "Data Size 0!\n");
-        debug_print("- Buffer ID: %d\n", li_position);
-        debug_print("- Data Size: %d\n", lui_size);
+        debug_error("- Buffer ID: %d\n", li_position);
+        debug_error("- Data Size: %d\n", lui_size);
         #endif
         li_return = SOCKETSERVER_SEND_BUFFER_ERROR;
     }
@@ -386,23 +503,24 @@ int socketserverbuf_send(void)
     *******************************************************************/
     // Send Data - At this point all buffers and data sizes are validated
     #ifdef DEBUG_SOCKETSERVERBUF_SEND
-    debug_printSocket("socketserverbuf_send: There is data to be sent:\n", 
+    debug_verboseSocket("socketserverbuf_send: There is data to be sent:\n", 
             data, dataLen);
     #endif
     li_temp = socketserver_write(data, dataLen);
     if(li_temp < 0)
     {
         #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-        debug_print("socketserverbuf_send: Socket Write ERROR!\n");
-        debug_print("- Error: %d\n", li_temp);
+        debug_error("socketserverbuf_send: Socket Write ERROR!\n");
+        debug_error("- Error: %d\n", li_temp);
         #endif
         return SOCKETSERVER_SEND_SOCKET_ERROR;
     }
     else
     {
         #ifdef DEBUG_SOCKETSERVERBUF_SEND
-        debug_print("socketserverbuf_send: Data sent!\n");
+        debug_verbose("socketserverbuf_send: Data sent!\n");
         #endif
+        metrics_add(METRICS_SOCKETSERVER_TX_MESSAGES, 0, 1);
         return SOCKETSERVER_SEND_OK;
     }
 }
@@ -417,6 +535,7 @@ int socketserverbuf_getReadMsgFromBuffer(uint8_t* data, int* dataLen,
     int li_temp;
     unsigned int lui_size;
     int li_return;
+    socketserverbufStamp_t stamp;
     
     /*************************************************************************
     * CONSISTENCY CHECK
@@ -459,7 +578,7 @@ int socketserverbuf_getReadMsgFromBuffer(uint8_t* data, int* dataLen,
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: Read Buffer ERROR!");
+            debug_error("SOCKET SERVER: Read Buffer ERROR!");
             #endif
             // Buffers out of sync: Unlock buffers and Return now
             // UNLOCK READ BUFFERS
@@ -486,9 +605,9 @@ int socketserverbuf_getReadMsgFromBuffer(uint8_t* data, int* dataLen,
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: Read Buffer ERROR!\n");
-            debug_print("- Buffer ID: %d\n", li_position);
-            debug_print("- Data Size: %d\n", lui_size);
+            debug_error("SOCKET SERVER: Read Buffer ERROR!\n");
+            debug_error("- Buffer ID: %d\n", li_position);
+            debug_error("- Data Size: %d\n", lui_size);
             #endif
             li_return = SOCKETSERVER_RECEIVE_BUFFER_ERROR;
         }
@@ -499,9 +618,9 @@ int socketserverbuf_getReadMsgFromBuffer(uint8_t* data, int* dataLen,
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-        debug_print("SOCKET SERVER: Read Buffer ERROR - Data Size is 0!\n");
-        debug_print("- Buffer ID: %d\n", li_position);
-        debug_print("- Data Size: %d\n", lui_size);
+        debug_error("SOCKET SERVER: Read Buffer ERROR - Data Size is 0!\n");
+        debug_error("- Buffer ID: %d\n", li_position);
+        debug_error("- Data Size: %d\n", lui_size);
         #endif
         li_return = SOCKETSERVER_RECEIVE_BUFFER_ERROR;
     }
@@ -510,15 +629,14 @@ int socketserverbuf_getReadMsgFromBuffer(uint8_t* data, int* dataLen,
     lui_size = buffer_popSize(socketserverbufID[li_position]);
     if(lui_size > 0)
     {
-        li_temp = buffer_pop(socketserverbufID[li_position], 
-                millisecondsSinceEpoch, sizeof(*millisecondsSinceEpoch));
-        if( (li_temp != BUFFER_OK) || 
-                (lui_size != sizeof(*millisecondsSinceEpoch)) )
+        li_temp = buffer_pop(socketserverbufID[li_position], &stamp, 
+                sizeof(stamp));
+        if( (li_temp != BUFFER_OK) || (lui_size != sizeof(stamp)) )
         {
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: Read Buffer ERROR!\n");
-            debug_print("- Buffer ID: %d\n", li_position);
-            debug_print("- Data Size: %d\n", lui_size);
+            debug_error("SOCKET SERVER: Read Buffer ERROR!\n");
+            debug_error("- Buffer ID: %d\n", li_position);
+            debug_error("- Data Size: %d\n", lui_size);
             #endif
             li_return = SOCKETSERVER_RECEIVE_BUFFER_ERROR;
         }
@@ -529,14 +647,19 @@ int socketserverbuf_getReadMsgFromBuffer(uint8_t* data, int* dataLen,
         /* FATAL ERROR */
         /***************/
         #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-        debug_print("SOCKET SERVER: Read Buffer ERROR - Data Size is 0!\n");
-        debug_print("- Buffer ID: %d\n", li_position);
-        debug_print("- Data Size: %d\n", lui_size);
+        debug_error("SOCKET SERVER: Read Buffer ERROR - Data Size is 0!\n");
+        debug_error("- Buffer ID: %d\n", li_position);
+        debug_error("- Data Size: %d\n", lui_size);
         #endif
         li_return = SOCKETSERVER_RECEIVE_BUFFER_ERROR;
     }
     // UNLOCK BUFFERS:
     pthread_mutex_unlock(&ssb_read_mutex);    
+    if(li_return == SOCKETSERVER_RECEIVE_OK)
+    {
+        *millisecondsSinceEpoch = stamp.millisecondsSinceEpoch;
+        latency_dequeued(&stamp.latency);
+    }
     // Return
     return li_return;
 }
@@ -544,7 +667,7 @@ int socketserverbuf_getReadMsgFromBuffer(uint8_t* data, int* dataLen,
 /* Socket Server read Data and fill Read Buffer */
 int socketserverbuf_receive(int timeout)
 {
-    unsigned long long millisecondsSinceEpoch;
+    socketserverbufStamp_t stamp;
     int socketReturn;
     uint8_t data[HAPCAN_SOCKET_DATA_LEN];
     int dataLen;
@@ -558,7 +681,9 @@ int socketserverbuf_receive(int timeout)
     {
         case SOCKETSERVER_OK:
             // Get Timestamp
-            millisecondsSinceEpoch = aux_getmsSinceEpoch();
+            stamp.millisecondsSinceEpoch = aux_getmsSinceEpoch();
+            latency_stampRx(&stamp.latency, LATENCY_PATH_SOCKET2CAN);
+            metrics_add(METRICS_SOCKETSERVER_RX_MESSAGES, 0, 1);
             break;
 
         case SOCKETSERVER_TIMEOUT:
@@ -570,7 +695,7 @@ int socketserverbuf_receive(int timeout)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: Socket Read - SOCKETSERVER_ERROR!\n");
+            debug_error("SOCKET SERVER: Socket Read - SOCKETSERVER_ERROR!\n");
             #endif
             return SOCKETSERVER_RECEIVE_SOCKET_ERROR;
             break;
@@ -580,7 +705,7 @@ int socketserverbuf_receive(int timeout)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: Socket Read - "
+            debug_error("SOCKET SERVER: Socket Read - "
                     "SOCKETSERVER_OTHER_ERROR!\n");
             #endif
             return SOCKETSERVER_RECEIVE_SOCKET_ERROR;
@@ -591,7 +716,7 @@ int socketserverbuf_receive(int timeout)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: Socket Read - SOCKETSERVER_CLOSED!\n");
+            debug_error("SOCKET SERVER: Socket Read - SOCKETSERVER_CLOSED!\n");
             #endif
             return SOCKETSERVER_RECEIVE_CLOSED_ERROR;
             break;
@@ -601,7 +726,7 @@ int socketserverbuf_receive(int timeout)
             /*    ERROR    */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: Socket Read - "
+            debug_error("SOCKET SERVER: Socket Read - "
                     "SOCKETSERVER_OVERFLOW!\n");
             #endif
             return SOCKETSERVER_RECEIVE_OVERFLOW;
@@ -612,7 +737,7 @@ int socketserverbuf_receive(int timeout)
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: Socket Read - NON-STANDARD ERROR!\n");
+            debug_error("SOCKET SERVER: Socket Read - NON-STANDARD ERROR!\n");
             #endif
             return SOCKETSERVER_RECEIVE_SOCKET_ERROR;
             break;
@@ -631,25 +756,40 @@ int socketserverbuf_receive(int timeout)
     // LOCK BUFFERS: Protect data and timestamp buffers from being 
     // read/written at different times
     pthread_mutex_lock(&ssb_read_mutex);
-    check[li_index] = buffer_push(socketserverbufID[li_position], data, 
-            dataLen);
-    li_position++;
-    li_index++;
-    check[li_index] = buffer_push(socketserverbufID[li_position], 
-            &millisecondsSinceEpoch, sizeof(millisecondsSinceEpoch));
+    // Wait for a free position (only if the overflow policy is "block"). The 
+    // lock is released while waiting - it is also needed to read.
+    if(buffer_waitNotFull(socketserverbufID[li_position], &ssb_read_mutex) == 
+            BUFFER_ERROR)
+    {
+        // Still full: the data is dropped
+        check[li_index] = BUFFER_OVERFLOW;
+        li_index++;
+        check[li_index] = BUFFER_OVERFLOW;
+    }
+    else
+    {
+        check[li_index] = buffer_push(socketserverbufID[li_position], data, 
+                dataLen);
+        li_position++;
+        li_index++;
+        check[li_index] = buffer_push(socketserverbufID[li_position], &stamp, 
+                sizeof(stamp));
+    }
     // UNLOCK BUFFERS:
     pthread_mutex_unlock(&ssb_read_mutex);    
     /* Check for critical errors */
     for(li_index = 0; li_index < NUMBER_OF_SOCKETSERVER_READ_BUFFERS; 
             li_index++)
     {
-        if( check[li_index] != BUFFER_OK )
+        // Overflow is handled by the buffer policy (data dropped)
+        if( (check[li_index] != BUFFER_OK) && 
+                (check[li_index] != BUFFER_OVERFLOW) )
         {
             /***************/
             /* FATAL ERROR */
             /***************/
             #ifdef DEBUG_SOCKETSERVERBUF_ERRORS
-            debug_print("SOCKET SERVER: Socket Read ERROR - Buffer ERROR!\n");
+            debug_error("SOCKET SERVER: Socket Read ERROR - Buffer ERROR!\n");
             #endif
             return SOCKETSERVER_RECEIVE_BUFFER_ERROR;
         }
@@ -6,6 +6,15 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add socketserverbuf_getDropCount (dropped by the overflow policy)        //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Add socketserverbuf_updateQueues (sizes and policies after a reload)     //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - Add socketserverbuf_getQueueDepth (metrics)                              //
+//----------------------------------------------------------------------------//
 
 #ifndef SOCKETSERVERBUF_H
 #define SOCKETSERVERBUF_H
@@ -19,7 +28,7 @@ extern "C" {
 //----------------------------------------------------------------------------//
 // EXTERNAL DEFINITIONS
 //----------------------------------------------------------------------------//
-#define SOCKETSERVER_BUFFER_SIZE    60
+#define SOCKETSERVER_BUFFER_SIZE    60  // Default - socketServer*QueueSize
 enum
 {
     SOCKETSERVER_READ_DATA_BUFFER = 0,
@@ -84,6 +93,27 @@ int socketserverbuf_close(int cleanBuffers);
  */
 int socketserverbuf_getState(stateSocketServer_t* s_state);
 
+/**
+ * Number of messages dropped by the overflow policy of the buffers - 
+ * Monitoring
+ * \param   read        messages dropped from the read buffer (OUTPUT)
+ * \param   write       messages dropped from the write buffer (OUTPUT)
+ */
+void socketserverbuf_getDropCount(unsigned long *read, unsigned long *write);
+
+/**
+ * Number of messages in the buffers - Monitoring
+ * \param   read        messages in the read buffer (OUTPUT)
+ * \param   write       messages in the write buffer (OUTPUT)
+ */
+void socketserverbuf_getQueueDepth(unsigned long *read, unsigned long *write);
+
+/**
+ * Resize the buffers and set the overflow policies again from the 
+ * configuration. The messages stored in the buffers are kept.
+ */
+void socketserverbuf_updateQueues(void);
+
 /**
  * Set Write buffer with data from parameters.
  * 
@@ -6,6 +6,20 @@
 //  1.00     | 10/Dec/2021 |                               | ALCP             //
 // - First version                                                            //
 //----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Buffer test: push / pop without copy (buffer_pushNoCopy/popNoCopy)       //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Buffer test: resize keeping the stored elements (buffer_resize)          //
+//----------------------------------------------------------------------------//
+//  1.03     | 18/Oct/2026 |                               | ALCP             //
+// - JSON output test (jh_formatFieldValuePairs): string escaping, doubles    //
+// and truncation of the output buffer                                        //
+//----------------------------------------------------------------------------//
+//  1.04     | 18/Oct/2026 |                               | ALCP             //
+// - Flat JSON parser test (jh_parseFlatObject): integer saturation, nested   //
+// and unexpected types, malformed input                                      //
+//----------------------------------------------------------------------------//
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -13,6 +27,8 @@
 #include <unistd.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include <math.h>
+#include <limits.h>
 #include "auxiliary.h"
 #include "buffer.h"
 #include "canbuf.h"
@@ -34,6 +50,8 @@
 //#define TEST_BUFFER
 //#define TEST_BASIC_STRING
 //#define TEST_MQTT_CONNECT
+//#define TEST_JSON_FORMAT
+//#define TEST_JSON_PARSE
 
 //----------------------------------------------------------------------------//
 // INTERNAL TYPES
@@ -130,6 +148,7 @@ static void test_Buffers(void)
     int i_Temp = 0;
     int i;
     int *p_i;
+    unsigned int lui_Size;
     char a[] = "abcd";
     char b[] = "efg";
     char c[] = "hi";
@@ -230,6 +249,47 @@ static void test_Buffers(void)
             pc = NULL;    
         }
     } 
+    debug_print("No Copy Test...\n");
+    // Test Push / Pop without copy (the element is handed over)
+    for( i = 0; i < 6; i++)
+    {
+        pc = strdup(d);
+        i_Temp = buffer_pushNoCopy(i_TestBuffer0, pc, sizeof(d));
+        debug_print("Push No Copy - Buffer: %d - Return: %d\n", 
+                i_TestBuffer0, i_Temp);
+    }
+    for( i = 0; i < 5; i++)
+    {
+        i_Temp = buffer_popNoCopy(i_TestBuffer0, (void**)&pc, &lui_Size);
+        debug_print("Pop No Copy - Buffer: %d - Data Length: %u - "
+                "Return = %d\n", i_TestBuffer0, lui_Size, i_Temp);
+        if(pc != NULL)
+        {
+            debug_print("Pop No Copy - Buffer: %d - Data: %s\n", 
+                    i_TestBuffer0, pc);
+            free(pc);
+            pc = NULL;
+        }
+    }
+    debug_print("Resize Test...\n");
+    // Test Resize - The stored elements are kept
+    buffer_clean(i_TestBuffer1);
+    for( i = 0; i < 3; i++)
+    {
+        i_Temp = buffer_push(i_TestBuffer1, &i, sizeof(i));
+    }
+    i_Temp = buffer_resize(i_TestBuffer1, 1);
+    debug_print("Resize to 1 - Buffer: %d - Count: %u - Return = %d\n", 
+            i_TestBuffer1, buffer_dataCount(i_TestBuffer1), i_Temp);
+    i_Temp = buffer_resize(i_TestBuffer1, 20);
+    debug_print("Resize to 20 - Buffer: %d - Count: %u - Return = %d\n", 
+            i_TestBuffer1, buffer_dataCount(i_TestBuffer1), i_Temp);
+    while(buffer_dataCount(i_TestBuffer1) > 0)
+    {
+        i_Temp = buffer_pop(i_TestBuffer1, &li_Test, sizeof(li_Test));
+        debug_print("Pop - Buffer: %d - Data: %d - Return = %d\n", 
+                i_TestBuffer1, li_Test, i_Temp);
+    }
     debug_print("Ending...:\n");
     buffer_clean(i_TestBuffer0);
     buffer_clean(i_TestBuffer1);
@@ -478,7 +538,7 @@ static void test_Config(void)
     unsigned int size = strlen(str_test);
     payload = malloc(size + 1);
     strcpy(payload, str_test);
-    debug_print("CONFIG Test - Payload = %s\n", payload);
+    debug_print("CONFIG Test - Payload = %s\n", (char *)payload);
     // free
     free(str_test);
     free(payload);
@@ -495,7 +555,7 @@ static void test_Config(void)
     size = strlen(str_test);
     payload = malloc(size + 1);
     strcpy(payload, str_test);
-    debug_print("CONFIG Test - Payload = %s\n", payload);
+    debug_print("CONFIG Test - Payload = %s\n", (char *)payload);
     // free
     free(str_test);
     free(payload);
@@ -573,6 +633,295 @@ static void test_Config(void)
 }
 #endif
 
+#ifdef TEST_JSON_FORMAT
+#define TEST_FORMAT_BUFFER_SIZE 256
+/* Format the pairs into a buffer of size bytes (buf is NULL if size is 0) and
+ * compare with the full expected output: the returned length is the full 
+ * length, and the buffer holds the part that fits (null terminated). */
+static bool checkFormat(const char *name, const jsonFieldData *a_data, 
+        int n_pairs, unsigned int size, const char *expected)
+{
+    char buf[TEST_FORMAT_BUFFER_SIZE];
+    int len;
+    unsigned int fit;
+    bool ok;
+    memset(buf, '#', sizeof(buf));
+    len = jh_formatFieldValuePairs(a_data, n_pairs, (size > 0) ? buf : NULL, 
+            size);
+    ok = (len == (int)strlen(expected));
+    if(size > 0)
+    {
+        fit = strlen(expected);
+        if(fit > size - 1)
+        {
+            fit = size - 1;
+        }
+        ok = ok && (strncmp(buf, expected, fit) == 0) && (buf[fit] == 0);
+        // Nothing written after the buffer
+        ok = ok && ((size >= sizeof(buf)) || (buf[size] == '#'));
+    }
+    debug_print("FORMAT Test - %s: %s (len = %d, size = %u, output = %s)\n", 
+            name, ok ? "OK" : "ERROR", len, size, (size > 0) ? buf : "-");
+    return ok;
+}
+
+static void test_JsonFormat(void)
+{
+    int errors = 0;
+    int len;
+    char buf[8];
+    jsonFieldData d[4];
+    //----------------------------------------------
+    // String escaping (same characters as json-c)
+    //----------------------------------------------
+    d[0] = (jsonFieldData){"S", JSON_TYPE_STRING, false, 0, 0.0, 
+            "a\"b\\c/d"};
+    errors += !checkFormat("Quotes, backslash, slash", d, 1, 
+            TEST_FORMAT_BUFFER_SIZE, "{\"S\":\"a\\\"b\\\\c\\/d\"}");
+    d[0].str_value = "\b\f\n\r\t";
+    errors += !checkFormat("Short escapes", d, 1, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"S\":\"\\b\\f\\n\\r\\t\"}");
+    d[0].str_value = "\x01\x1f\x7f";
+    errors += !checkFormat("Control characters", d, 1, 
+            TEST_FORMAT_BUFFER_SIZE, "{\"S\":\"\\u0001\\u001f\x7f\"}");
+    d[0].str_value = "Sala \xc3\xa9 \xe2\x82\xac";
+    errors += !checkFormat("Non-ASCII (UTF-8 kept)", d, 1, 
+            TEST_FORMAT_BUFFER_SIZE, "{\"S\":\"Sala \xc3\xa9 \xe2\x82\xac\"}");
+    d[0].str_value = "";
+    errors += !checkFormat("Empty string", d, 1, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"S\":\"\"}");
+    d[0].str_value = NULL;
+    errors += !checkFormat("NULL string", d, 1, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"S\":null}");
+    d[0].field = "k\"\n";
+    d[0].str_value = "v";
+    errors += !checkFormat("Escaped field", d, 1, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"k\\\"\\n\":\"v\"}");
+    //----------------------------------------------
+    // Numbers and other types
+    //----------------------------------------------
+    d[0] = (jsonFieldData){"D", JSON_TYPE_DOUBLE, false, 0, 2.5, NULL};
+    errors += !checkFormat("Double", d, 1, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"D\":2.5}");
+    d[0].double_value = 1.0;
+    errors += !checkFormat("Double integer", d, 1, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"D\":1.0}");
+    d[0].double_value = -3.0;
+    errors += !checkFormat("Double negative integer", d, 1, 
+            TEST_FORMAT_BUFFER_SIZE, "{\"D\":-3.0}");
+    d[0].double_value = 0.1;
+    errors += !checkFormat("Double %.17g", d, 1, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"D\":0.10000000000000001}");
+    d[0].double_value = 1e20;
+    errors += !checkFormat("Double exponent", d, 1, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"D\":1e+20}");
+    d[0].double_value = NAN;
+    errors += !checkFormat("Double NaN", d, 1, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"D\":NaN}");
+    d[0].double_value = -INFINITY;
+    errors += !checkFormat("Double -Infinity", d, 1, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"D\":-Infinity}");
+    d[0] = (jsonFieldData){"I", JSON_TYPE_INT, false, INT_MIN, 0.0, NULL};
+    d[1] = (jsonFieldData){"B", JSON_TYPE_BOOL, true, 0, 0.0, NULL};
+    d[2] = (jsonFieldData){"F", JSON_TYPE_BOOL, false, 0, 0.0, NULL};
+    d[3] = (jsonFieldData){"N", JSON_TYPE_NULL, false, 0, 0.0, NULL};
+    errors += !checkFormat("Int, bool, null", d, 4, TEST_FORMAT_BUFFER_SIZE, 
+            "{\"I\":-2147483648,\"B\":true,\"F\":false,\"N\":null}");
+    errors += !checkFormat("No pairs", d, 0, TEST_FORMAT_BUFFER_SIZE, "{}");
+    //----------------------------------------------
+    // Output buffer exhaustion (snprintf-like)
+    //----------------------------------------------
+    d[0] = (jsonFieldData){"S", JSON_TYPE_STRING, false, 0, 0.0, "a\"b"};
+    // {"S":"a\"b"} - 12 characters
+    errors += !checkFormat("Length only", d, 1, 0, "{\"S\":\"a\\\"b\"}");
+    errors += !checkFormat("Size 1", d, 1, 1, "{\"S\":\"a\\\"b\"}");
+    errors += !checkFormat("Cut in the escape", d, 1, 9, 
+            "{\"S\":\"a\\\"b\"}");
+    errors += !checkFormat("One byte short", d, 1, 12, 
+            "{\"S\":\"a\\\"b\"}");
+    errors += !checkFormat("Exact size", d, 1, 13, "{\"S\":\"a\\\"b\"}");
+    d[0] = (jsonFieldData){"D", JSON_TYPE_DOUBLE, false, 0, 0.1, NULL};
+    errors += !checkFormat("Cut in a double", d, 1, 10, 
+            "{\"D\":0.10000000000000001}");
+    //----------------------------------------------
+    // Parameter errors
+    //----------------------------------------------
+    len = jh_formatFieldValuePairs(d, -1, buf, sizeof(buf));
+    errors += (len != JSON_ERROR_OTHER);
+    len = jh_formatFieldValuePairs(NULL, 1, buf, sizeof(buf));
+    errors += (len != JSON_ERROR_OTHER);
+    len = jh_formatFieldValuePairs(d, 1, NULL, sizeof(buf));
+    errors += (len != JSON_ERROR_OTHER);
+    debug_print("FORMAT Test - End: %d errors\n", errors);
+}
+#endif
+
+#ifdef TEST_JSON_PARSE
+/* Parse a string (not null terminated: only strlen(str) characters are 
+ * given) and compare the result with the expected one */
+static bool checkParse(const char *name, const char *str, int expected, 
+        int n_fields, jsonFlatObject *obj)
+{
+    int check;
+    bool ok;
+    check = jh_parseFlatObject(str, (str != NULL) ? strlen(str) : 0, obj);
+    ok = (check == expected) && ((check != JSON_OK) || 
+            (obj->n_fields == n_fields));
+    debug_print("PARSE Test - %s: %s (check = %d)\n", name, 
+            ok ? "OK" : "ERROR", check);
+    return ok;
+}
+
+/* Get an integer field and compare with the expected result */
+static bool checkInt(const char *name, const jsonFlatObject *obj, 
+        const char *field, int expected, int value)
+{
+    int check;
+    int result = 0;
+    bool ok;
+    check = jh_getFlatFieldAsInt(obj, field, &result);
+    ok = (check == expected) && ((check != JSON_OK) || (result == value));
+    debug_print("PARSE Test - %s: %s (check = %d, value = %d)\n", name, 
+            ok ? "OK" : "ERROR", check, result);
+    return ok;
+}
+
+/* Get a double field and compare with the expected result */
+static bool checkDouble(const char *name, const jsonFlatObject *obj, 
+        const char *field, int expected, double value)
+{
+    int check;
+    double result = 0;
+    bool ok;
+    check = jh_getFlatFieldAsDouble(obj, field, &result);
+    ok = (check == expected) && ((check != JSON_OK) || (result == value));
+    debug_print("PARSE Test - %s: %s (check = %d, value = %g)\n", name, 
+            ok ? "OK" : "ERROR", check, result);
+    return ok;
+}
+
+static void test_JsonParse(void)
+{
+    // Malformed input: all of them return JSON_ERROR_OTHER
+    static const char* const c_malformed[] = 
+    {
+        "", "   ", "[1,2]", "\"a\"", "{", "}", "{\"a\"}", "{\"a\":}", 
+        "{\"a\":1", "{\"a\":1}}", "{\"a\":1}x", "{\"a\" 1}", "{a:1}", 
+        "{'a':1}", "{\"a:1}", "{\"a\":\"x}", "{\"a\":\"x\\\"}", 
+        "{\"a\":tru}", "{\"a\":truex}", "{\"a\":nul}", "{\"a\":1 2}", 
+        "{\"a\":-}", "{\"a\":1.}", "{\"a\":1e}", "{\"a\":1e+}", 
+        "{\"a\":.5}", "{\"a\":+1}", "{\"a\":0x10}", "{,}", 
+        "{\"a\":1,}", "{\"a\":1,,\"b\":2}", "{\"a\":1;\"b\":2}", 
+        "{\"a\":{\"b\":1}", "{\"a\":[1,2}", "{\"a\":[\"]\"}"
+    };
+    jsonFlatObject obj;
+    char str[256];
+    double d;
+    int errors = 0;
+    int check;
+    int i;
+    //----------------------------------------------
+    // Integer saturation and out of range values (same as json-c)
+    //----------------------------------------------
+    errors += !checkParse("Integers", "{\"max\":2147483647,"
+            "\"min\":-2147483648,\"over\":2147483648,"
+            "\"under\":-2147483649,\"big\":99999999999999999999999,"
+            "\"zero\":-0}", JSON_OK, 6, &obj);
+    errors += !checkInt("INT_MAX", &obj, "max", JSON_OK, INT_MAX);
+    errors += !checkInt("INT_MIN", &obj, "min", JSON_OK, INT_MIN);
+    errors += !checkInt("INT_MAX + 1 saturated", &obj, "over", JSON_OK, 
+            INT_MAX);
+    errors += !checkInt("INT_MIN - 1 saturated", &obj, "under", JSON_OK, 
+            INT_MIN);
+    errors += !checkInt("Out of long long range", &obj, "big", JSON_OK, 
+            INT_MAX);
+    errors += !checkInt("Negative zero", &obj, "zero", JSON_OK, 0);
+    errors += !checkDouble("INT_MAX + 1 as double", &obj, "over", JSON_OK, 
+            2147483648.0);
+    // Integer longer than the number buffer
+    str[0] = 0;
+    strcat(str, "{\"long\":-");
+    for(i = 0; i < 80; i++)
+    {
+        strcat(str, "9");
+    }
+    strcat(str, "}");
+    errors += !checkParse("Long integer", str, JSON_OK, 1, &obj);
+    errors += !checkInt("Long integer saturated", &obj, "long", JSON_OK, 
+            INT_MIN);
+    //----------------------------------------------
+    // Doubles
+    //----------------------------------------------
+    errors += !checkParse("Doubles", "{\"d\":-2.5e2,\"e\":1E-1,"
+            "\"f\":0.5}", JSON_OK, 3, &obj);
+    errors += !checkDouble("Double exponent", &obj, "d", JSON_OK, -250.0);
+    errors += !checkDouble("Double exponent E", &obj, "e", JSON_OK, 0.1);
+    errors += !checkInt("Double as integer", &obj, "f", JSON_ERROR_TYPE, 0);
+    //----------------------------------------------
+    // Nested and unexpected types
+    //----------------------------------------------
+    errors += !checkParse("Types", " {\"o\" : {\"x\":[1,{\"y\":\"}\"}]}, "
+            "\"a\":[[],[\"]\"]], \"s\":\"12\", \"e\":\"x\\\"y\", "
+            "\"t\":true, \"n\":null, \"i\":7}\r\n", JSON_OK, 7, &obj);
+    errors += !checkInt("Nested object", &obj, "o", JSON_ERROR_TYPE, 0);
+    errors += !checkInt("Nested array", &obj, "a", JSON_ERROR_TYPE, 0);
+    errors += !checkInt("String", &obj, "s", JSON_ERROR_TYPE, 0);
+    errors += !checkDouble("String as double", &obj, "s", JSON_ERROR_TYPE, 0);
+    errors += !checkInt("Bool", &obj, "t", JSON_ERROR_TYPE, 0);
+    errors += !checkInt("Null", &obj, "n", JSON_ERROR_OTHER, 0);
+    errors += !checkInt("Missing", &obj, "x", JSON_ERROR_OTHER, 0);
+    errors += !checkInt("After the nested values", &obj, "i", JSON_OK, 7);
+    // Escape sequences are kept, without the quotes
+    errors += ((obj.fields[3].value_len != 4) || 
+            (memcmp(obj.fields[3].value, "x\\\"y", 4) != 0));
+    // Repeated field: the last one is used
+    errors += !checkParse("Repeated", "{\"a\":1,\"a\":2}", JSON_OK, 2, 
+            &obj);
+    errors += !checkInt("Repeated field", &obj, "a", JSON_OK, 2);
+    errors += !checkParse("Empty object", " { } ", JSON_OK, 0, &obj);
+    //----------------------------------------------
+    // Number of fields
+    //----------------------------------------------
+    str[0] = 0;
+    strcat(str, "{");
+    for(i = 0; i <= JSON_FLAT_MAX_FIELDS; i++)
+    {
+        if(i == JSON_FLAT_MAX_FIELDS)
+        {
+            errors += !checkParse("Maximum fields", strcat(str, "}"), 
+                    JSON_OK, JSON_FLAT_MAX_FIELDS, &obj);
+            str[strlen(str) - 1] = 0;
+        }
+        snprintf(str + strlen(str), sizeof(str) - strlen(str), 
+                "%s\"D%d\":%d", (i > 0) ? "," : "", i, i);
+    }
+    errors += !checkParse("Too many fields", strcat(str, "}"), 
+            JSON_ERROR_OTHER, 0, &obj);
+    //----------------------------------------------
+    // Malformed input and parameters
+    //----------------------------------------------
+    for(i = 0; i < (int)(sizeof(c_malformed)/sizeof(c_malformed[0])); i++)
+    {
+        errors += !checkParse(c_malformed[i], c_malformed[i], 
+                JSON_ERROR_OTHER, 0, &obj);
+    }
+    // Only len characters are parsed (no null terminator needed)
+    check = jh_parseFlatObject("{\"a\":1}{\"b\"", 7, &obj);
+    errors += (check != JSON_OK) || (obj.n_fields != 1);
+    check = jh_parseFlatObject("{\"a\":12}", 7, &obj);
+    errors += (check != JSON_ERROR_OTHER);
+    check = jh_parseFlatObject(NULL, 7, &obj);
+    errors += (check != JSON_ERROR_OTHER);
+    check = jh_parseFlatObject("{}", -1, &obj);
+    errors += (check != JSON_ERROR_OTHER);
+    check = jh_parseFlatObject("{}", 2, NULL);
+    errors += (check != JSON_ERROR_OTHER);
+    check = jh_getFlatFieldAsDouble(NULL, "a", &d);
+    errors += (check != JSON_ERROR_OTHER);
+    debug_print("PARSE Test - End: %d errors\n", errors);
+}
+#endif
+
 //----------------------------------------------------------------------------//
 // INTERNAL GLOBAL VARIABLES
 //----------------------------------------------------------------------------//
@@ -601,4 +950,12 @@ void tests_Init(void)
     #ifdef TEST_MQTT_CONNECT
     test_mqtt_connect();
     #endif   
+
+    #ifdef TEST_JSON_FORMAT
+    test_JsonFormat();
+    #endif
+
+    #ifdef TEST_JSON_PARSE
+    test_JsonParse();
+    #endif
 }
\ No newline at end of file
@@ -0,0 +1,389 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Without permission for SCHED_FIFO, the thread keeps its CPUs and stack   //
+// (only the priority is not applied). Stacks have a guard page               //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_MANAGER
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/*
+* Includes
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "config.h"
+#include "debug.h"
+#include "jsonhandler.h"
+#include "threadprof.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+#define TPROF_SECTION           "ThreadProfiles"
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Profile of a thread (or of the threads of every CAN channel)
+typedef struct
+{
+    char name[TPROF_NAME_LEN];
+    int channel;            // TPROF_NO_CHANNEL: every channel
+    unsigned long cpuMask;  // 0: not set
+    int priority;           // 0: SCHED_OTHER
+} tprofProfile_t;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+static tprofProfile_t g_profiles[TPROF_MAX_PROFILES];
+static int g_nProfiles = 0;
+static size_t g_stackSize = 0;  // 0: default stack
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static void readProfiles(void);
+static const tprofProfile_t* getProfile(const char *name, int channel);
+static void* allocStack(size_t size);
+static void freeStack(void *stack, size_t size);
+static void setAttributes(pthread_attr_t *attr,
+        const tprofProfile_t *profile, void *stack, bool priority);
+static void report(pthread_t thread, const char *name, int channel);
+
+// Read section "ThreadProfiles"
+static void readProfiles(void)
+{
+    int i;
+    int n;
+    int check;
+    int value;
+    int max;
+    char *name = NULL;
+    tprofProfile_t *profile;
+    check = jh_getJArrayElements(TPROF_SECTION, 0, NULL, JSON_DEPTH_LEVEL, &n);
+    if(check != JSON_OK)
+    {
+        n = 0;
+    }
+    g_nProfiles = 0;
+    for(i = 0; (i < n) && (g_nProfiles < TPROF_MAX_PROFILES); i++)
+    {
+        profile = &g_profiles[g_nProfiles];
+        memset(profile, 0, sizeof(*profile));
+        check = jh_getJFieldStringCopy(TPROF_SECTION, i, "thread", 0, NULL,
+                &name);
+        if((check != JSON_OK) || (strlen(name) >= TPROF_NAME_LEN))
+        {
+            #ifdef DEBUG_MANAGER_ERRORS
+            debug_error("tprof_init: Profile %d - invalid thread!\n", i);
+            #endif
+            free(name);
+            name = NULL;
+            continue;
+        }
+        strcpy(profile->name, name);
+        free(name);
+        name = NULL;
+        // Channel (optional)
+        check = jh_getJFieldInt(TPROF_SECTION, i, "channel", 0, NULL, &value);
+        profile->channel = (check == JSON_OK) ? value : TPROF_NO_CHANNEL;
+        // CPUs (optional) - only CPUs that exist
+        check = jh_getJFieldInt(TPROF_SECTION, i, "cpuMask", 0, NULL, &value);
+        if(check == JSON_OK)
+        {
+            max = sysconf(_SC_NPROCESSORS_CONF);
+            if((value > 0) && ((max >= (int)(sizeof(int) * CHAR_BIT) - 1) ||
+                    (value < (1 << max))))
+            {
+                profile->cpuMask = value;
+            }
+            #ifdef DEBUG_MANAGER_ERRORS
+            else
+            {
+                debug_error("tprof_init: %s - invalid cpuMask %d (%d CPUs)!\n",
+                        profile->name, value, max);
+            }
+            #endif
+        }
+        // Priority (optional) - SCHED_FIFO range
+        check = jh_getJFieldInt(TPROF_SECTION, i, "priority", 0, NULL, &value);
+        if(check == JSON_OK)
+        {
+            if((value >= sched_get_priority_min(SCHED_FIFO)) &&
+                    (value <= sched_get_priority_max(SCHED_FIFO)))
+            {
+                profile->priority = value;
+            }
+            #ifdef DEBUG_MANAGER_ERRORS
+            else
+            {
+                debug_error("tprof_init: %s - invalid priority %d!\n",
+                        profile->name, value);
+            }
+            #endif
+        }
+        g_nProfiles++;
+    }
+}
+
+// Profile of a thread (a profile of the channel wins over one of every channel)
+static const tprofProfile_t* getProfile(const char *name, int channel)
+{
+    int i;
+    const tprofProfile_t *ret = NULL;
+    for(i = 0; i < g_nProfiles; i++)
+    {
+        if(strcmp(g_profiles[i].name, name) != 0)
+        {
+            continue;
+        }
+        if((channel != TPROF_NO_CHANNEL) && (g_profiles[i].channel == channel))
+        {
+            return &g_profiles[i];
+        }
+        if(g_profiles[i].channel == TPROF_NO_CHANNEL)
+        {
+            ret = &g_profiles[i];
+        }
+    }
+    return ret;
+}
+
+// Allocate a stack and touch it (no page faults when the thread uses it). 
+// A guard page below the stack stops an overflow (size: page multiple)
+static void* allocStack(size_t size)
+{
+    uint8_t *stack;
+    size_t page = sysconf(_SC_PAGESIZE);
+    stack = mmap(NULL, page + size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if(stack == MAP_FAILED)
+    {
+        return NULL;
+    }
+    if(mprotect(stack, page, PROT_NONE) != 0)
+    {
+        munmap(stack, page + size);
+        return NULL;
+    }
+    memset(stack + page, 0, size);
+    return stack + page;
+}
+
+// Free a stack not used by any thread (see allocStack)
+static void freeStack(void *stack, size_t size)
+{
+    size_t page = sysconf(_SC_PAGESIZE);
+    if(stack != NULL)
+    {
+        munmap((uint8_t *)stack - page, page + size);
+    }
+}
+
+// Attributes of a profile (priority: SCHED_FIFO is set)
+static void setAttributes(pthread_attr_t *attr,
+        const tprofProfile_t *profile, void *stack, bool priority)
+{
+    int cpu;
+    struct sched_param param;
+    cpu_set_t cpus;
+    pthread_attr_init(attr);
+    if(stack != NULL)
+    {
+        pthread_attr_setstack(attr, stack, g_stackSize);
+    }
+    if((profile != NULL) && (profile->cpuMask != 0))
+    {
+        CPU_ZERO(&cpus);
+        for(cpu = 0; cpu < (int)(sizeof(profile->cpuMask) * CHAR_BIT); cpu++)
+        {
+            if(profile->cpuMask & (1UL << cpu))
+            {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        pthread_attr_setaffinity_np(attr, sizeof(cpus), &cpus);
+    }
+    if(priority)
+    {
+        param.sched_priority = profile->priority;
+        pthread_attr_setinheritsched(attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(attr, SCHED_FIFO);
+        pthread_attr_setschedparam(attr, &param);
+    }
+}
+
+// Print the scheduling of a thread as it is running
+static void report(pthread_t thread, const char *name, int channel)
+{
+    #ifdef DEBUG_MANAGER_THREADS
+    int policy;
+    struct sched_param param;
+    cpu_set_t cpus;
+    unsigned long mask = 0;
+    int cpu;
+    if(pthread_getschedparam(thread, &policy, &param) != 0)
+    {
+        return;
+    }
+    CPU_ZERO(&cpus);
+    if(pthread_getaffinity_np(thread, sizeof(cpus), &cpus) == 0)
+    {
+        for(cpu = 0; cpu < (int)(sizeof(mask) * CHAR_BIT); cpu++)
+        {
+            if(CPU_ISSET(cpu, &cpus))
+            {
+                mask |= (1UL << cpu);
+            }
+        }
+    }
+    debug_print("tprof: %s (channel %d) - %s priority %d, CPUs 0x%lx\n",
+            name, channel, (policy == SCHED_FIFO) ? "SCHED_FIFO" : "SCHED_OTHER",
+            param.sched_priority, mask);
+    #endif
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+void tprof_init(void)
+{
+    int check;
+    int value;
+    bool lock;
+    size_t page;
+    //--------------------------------------
+    // Stack size (KB)
+    //--------------------------------------
+    g_stackSize = 0;
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0, "threadStackSize",
+            0, NULL, &value);
+    if((check == EXIT_SUCCESS) && (value > 0))
+    {
+        if((size_t)value * 1024 >= PTHREAD_STACK_MIN)
+        {
+            // Page multiple (guard page below the stack - see allocStack)
+            page = sysconf(_SC_PAGESIZE);
+            g_stackSize = ((size_t)value * 1024 + page - 1) / page * page;
+        }
+        #ifdef DEBUG_MANAGER_ERRORS
+        else
+        {
+            debug_error("tprof_init: threadStackSize %d KB is too small!\n",
+                    value);
+        }
+        #endif
+    }
+    //--------------------------------------
+    // Thread profiles
+    //--------------------------------------
+    readProfiles();
+    //--------------------------------------
+    // Lock memory (current and future: stacks, buffers)
+    //--------------------------------------
+    check = config_getBool(CONFIG_GENERAL_SETTINGS_LEVEL, 0, "lockMemory", 0,
+            NULL, &lock);
+    if((check == EXIT_SUCCESS) && lock)
+    {
+        if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            #ifdef DEBUG_MANAGER_ERRORS
+            debug_error("tprof_init: mlockall failed (permission / "
+                    "RLIMIT_MEMLOCK)!\n");
+            #endif
+        }
+        #ifdef DEBUG_MANAGER_THREADS
+        else
+        {
+            debug_print("tprof_init: memory locked\n");
+        }
+        #endif
+    }
+}
+
+int tprof_create(pthread_t *thread, const char *name, int channel,
+        void *(*fn)(void *), void *arg)
+{
+    int ret;
+    bool priority;
+    const tprofProfile_t *profile;
+    pthread_attr_t attr;
+    void *stack = NULL;
+    profile = getProfile(name, channel);
+    // Nothing to set: default attributes
+    if((profile == NULL) && (g_stackSize == 0))
+    {
+        return pthread_create(thread, NULL, fn, arg);
+    }
+    //--------------------------------------
+    // Attributes of the profile
+    //--------------------------------------
+    if(g_stackSize > 0)
+    {
+        stack = allocStack(g_stackSize);
+        #ifdef DEBUG_MANAGER_ERRORS
+        if(stack == NULL)
+        {
+            debug_error("tprof_create: %s (channel %d) - stack not "
+                    "allocated!\n", name, channel);
+        }
+        #endif
+    }
+    priority = (profile != NULL) && (profile->priority > 0);
+    setAttributes(&attr, profile, stack, priority);
+    ret = pthread_create(thread, &attr, fn, arg);
+    pthread_attr_destroy(&attr);
+    //--------------------------------------
+    // Not allowed (e.g. SCHED_FIFO without CAP_SYS_NICE): CPUs and stack 
+    // without the priority
+    //--------------------------------------
+    if((ret != 0) && priority)
+    {
+        #ifdef DEBUG_MANAGER_ERRORS
+        debug_error("tprof_create: %s (channel %d) - priority %d not applied "
+                "(error %d)!\n", name, channel, profile->priority, ret);
+        #endif
+        setAttributes(&attr, profile, stack, false);
+        ret = pthread_create(thread, &attr, fn, arg);
+        pthread_attr_destroy(&attr);
+    }
+    //--------------------------------------
+    // Still not created (e.g. CPUs not allowed): default attributes
+    //--------------------------------------
+    if(ret != 0)
+    {
+        #ifdef DEBUG_MANAGER_ERRORS
+        debug_error("tprof_create: %s (channel %d) - CPUs / stack not "
+                "applied (error %d)!\n", name, channel, ret);
+        #endif
+        // The stack was not used by any thread
+        freeStack(stack, g_stackSize);
+        return pthread_create(thread, NULL, fn, arg);
+    }
+    // The stack is used until the end of the process (threads are not ended)
+    report(*thread, name, channel);
+    return ret;
+}
@@ -0,0 +1,68 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - tprof_create: the priority is dropped first, then the other attributes   //
+//----------------------------------------------------------------------------//
+
+#ifndef THREADPROF_H
+#define THREADPROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <pthread.h>
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+/* Maximum number of profiles of section "ThreadProfiles" */
+#define TPROF_MAX_PROFILES      32
+/* Maximum length of a thread name */
+#define TPROF_NAME_LEN          32
+/* Thread not of a CAN channel */
+#define TPROF_NO_CHANNEL        -1
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Read the scheduling profile (read only at start-up - the threads are
+ * created once):
+ * - GeneralSettings "lockMemory": lock the memory of the process (mlockall)
+ * - GeneralSettings "threadStackSize": stack of each thread (KB), allocated
+ *   (with a guard page) and touched before the thread is created
+ * - Section "ThreadProfiles": "thread" (name), optional "cpuMask" (CPUs the
+ *   thread runs on, bit 0 is CPU 0) and optional "priority" (SCHED_FIFO)
+ * Invalid values are reported and not used.
+ */
+void tprof_init(void);
+
+/**
+ * Create a thread with its profile. If the thread cannot be created with its
+ * priority (e.g. no permission for SCHED_FIFO), it is created with its CPUs
+ * and stack only. If it still cannot be created, it is created with the
+ * default attributes. What is not applied is reported.
+ *
+ * \param   thread      (OUTPUT) thread ID
+ * \param   name        (INPUT) thread name (see "ThreadProfiles")
+ * \param   channel     (INPUT) CAN channel of the thread / TPROF_NO_CHANNEL
+ * \param   fn          (INPUT) thread function
+ * \param   arg         (INPUT) thread argument
+ *
+ * \return  result of pthread_create (0 if created)
+ */
+int tprof_create(pthread_t *thread, const char *name, int channel,
+        void *(*fn)(void *), void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THREADPROF_H */
@@ -0,0 +1,214 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Debug messages use the runtime log level of DEBUG_MODULE_GATEWAY         //
+//----------------------------------------------------------------------------//
+//  1.02     | 18/Oct/2026 |                               | ALCP             //
+// - Reference count is atomic: only insert / remove take the table lock      //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_GATEWAY
+
+//----------------------------------------------------------------------------//
+// Includes
+//----------------------------------------------------------------------------//
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "topic.h"
+#include "debug.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+// Number of hash table buckets (power of 2)
+#define TOPIC_HASH_SIZE     256
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Table element: the topic string is stored right after the header, so the
+// element can be found from the topic pointer
+typedef struct topicEntry
+{
+    struct topicEntry *next;
+    uint32_t hash;
+    int refcount;       // Atomic - the element is removed when it gets to 0
+    char str[];
+} topicEntry;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+static pthread_mutex_t g_topic_mutex = PTHREAD_MUTEX_INITIALIZER;
+static topicEntry* g_topic_table[TOPIC_HASH_SIZE];
+static int g_topic_count = 0;
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static uint32_t getHash(const char *str);
+static topicEntry* getEntry(const char *topic);
+static bool takeReference(topicEntry* entry);
+
+// FNV-1a hash of a string
+static uint32_t getHash(const char *str)
+{
+    uint32_t hash = 2166136261u;
+    while(*str != 0)
+    {
+        hash ^= (uint8_t)(*str);
+        hash *= 16777619u;
+        str++;
+    }
+    return hash;
+}
+
+// Get the table element of an interned topic
+static topicEntry* getEntry(const char *topic)
+{
+    return (topicEntry*)(topic - offsetof(topicEntry, str));
+}
+
+// Take a reference of an element found in the table - fails if the last
+// reference is being released (the element is going to be removed)
+static bool takeReference(topicEntry* entry)
+{
+    int refs;
+    refs = __atomic_load_n(&entry->refcount, __ATOMIC_RELAXED);
+    while(refs > 0)
+    {
+        if(__atomic_compare_exchange_n(&entry->refcount, &refs, refs + 1,
+                false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+// Get the interned copy of a topic
+const char* topic_intern(const char *str)
+{
+    topicEntry* current;
+    uint32_t hash;
+    size_t len;
+    if(str == NULL)
+    {
+        return NULL;
+    }
+    hash = getHash(str);
+    // LOCK TABLE
+    pthread_mutex_lock(&g_topic_mutex);
+    for(current = g_topic_table[hash & (TOPIC_HASH_SIZE - 1)]; current != NULL;
+            current = current->next)
+    {
+        // Same pointer (already interned) or same string - an element whose
+        // last reference is being released is skipped
+        if((current->hash == hash) &&
+                ((current->str == str) || (strcmp(current->str, str) == 0)) &&
+                takeReference(current))
+        {
+            break;
+        }
+    }
+    if(current == NULL)
+    {
+        // New topic
+        len = strlen(str);
+        current = malloc(sizeof(*current) + len + 1);
+        if(current == NULL)
+        {
+            // UNLOCK TABLE
+            pthread_mutex_unlock(&g_topic_mutex);
+            return NULL;
+        }
+        memcpy(current->str, str, len + 1);
+        current->hash = hash;
+        current->refcount = 1;
+        current->next = g_topic_table[hash & (TOPIC_HASH_SIZE - 1)];
+        g_topic_table[hash & (TOPIC_HASH_SIZE - 1)] = current;
+        g_topic_count++;
+    }
+    // UNLOCK TABLE
+    pthread_mutex_unlock(&g_topic_mutex);
+    return current->str;
+}
+
+// Take one more reference of an interned topic (the caller has one, so the
+// element is not removed - no lock)
+const char* topic_acquire(const char *topic)
+{
+    if(topic != NULL)
+    {
+        __atomic_add_fetch(&(getEntry(topic)->refcount), 1, __ATOMIC_RELAXED);
+    }
+    return topic;
+}
+
+// Release a reference of an interned topic
+void topic_release(const char *topic)
+{
+    topicEntry* entry;
+    topicEntry** link;
+    if(topic == NULL)
+    {
+        return;
+    }
+    entry = getEntry(topic);
+    if(__atomic_sub_fetch(&entry->refcount, 1, __ATOMIC_ACQ_REL) > 0)
+    {
+        return;
+    }
+    // Last reference - no other reference can be taken (see takeReference)
+    // LOCK TABLE
+    pthread_mutex_lock(&g_topic_mutex);
+    // Remove from the table
+    link = &(g_topic_table[entry->hash & (TOPIC_HASH_SIZE - 1)]);
+    while((*link != NULL) && (*link != entry))
+    {
+        link = &((*link)->next);
+    }
+    if(*link == entry)
+    {
+        *link = entry->next;
+        g_topic_count--;
+        free(entry);
+    }
+    #ifdef DEBUG_TOPIC_ERRORS
+    else
+    {
+        debug_error("topic_release ERROR: topic not interned!\n");
+    }
+    #endif
+    // UNLOCK TABLE
+    pthread_mutex_unlock(&g_topic_mutex);
+}
+
+// Number of topics in the table
+int topic_getCount(void)
+{
+    int ret;
+    // LOCK TABLE
+    pthread_mutex_lock(&g_topic_mutex);
+    ret = g_topic_count;
+    // UNLOCK TABLE
+    pthread_mutex_unlock(&g_topic_mutex);
+    return ret;
+}
@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Reference count is atomic: acquire / release do not take the table lock  //
+//----------------------------------------------------------------------------//
+
+#ifndef TOPIC_H
+#define TOPIC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+
+
+//----------------------------------------------------------------------------//
+// EXTERNAL TYPES
+//----------------------------------------------------------------------------//
+
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Get the interned (shared) copy of a topic. The topic is added to the table
+ * if it is not there yet. Each call takes a reference that has to be released
+ * with topic_release. Two interned topics are equal only if the pointers are
+ * equal. The string is hashed and the table is locked: intern a topic once
+ * (e.g. when the configuration is read) and pass the interned pointer on.
+ *
+ * \param   str     (INPUT) topic string (interned or not)
+ *
+ * \return  interned topic (read only), NULL if str is NULL or no memory
+ */
+const char* topic_intern(const char *str);
+
+/**
+ * Take one more reference of an interned topic (no search, no copy and no
+ * lock). The caller has to hold a reference of the topic.
+ *
+ * \param   topic   (INPUT) interned topic (NULL is accepted)
+ *
+ * \return  topic
+ */
+const char* topic_acquire(const char *topic);
+
+/**
+ * Release a reference of an interned topic. The table is locked only when
+ * the last reference is released (the topic is removed from the table).
+ *
+ * \param   topic   (INPUT) interned topic (NULL is accepted)
+ */
+void topic_release(const char *topic);
+
+/**
+ * Number of topics in the table - Debug
+ *
+ * \return  number of interned topics
+ */
+int topic_getCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TOPIC_H */
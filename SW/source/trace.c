@@ -0,0 +1,782 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Frames are added to a lock-free ring of each channel / direction; the    //
+// trace writer thread (trace_flush) copies them to the mapped file and       //
+// creates / maps the next file before it is needed                           //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// Module of the debug messages (see debug.h)
+//----------------------------------------------------------------------------//
+#define DEBUG_MODULE    DEBUG_MODULE_MONITORING
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "canbuf.h"
+#include "config.h"
+#include "debug.h"
+#include "hapcan.h"
+#include "trace.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+// Size of the file names
+#define TRACE_FILE_NAME_SIZE        512
+// Offsets within the file are aligned to 8 bytes
+#define TRACE_ALIGN(x)              (((x) + 7u) & ~7u)
+// Records of each ring (power of 2) - frames of a channel / direction waiting
+// for the writer (TRACE_FLUSH_PERIOD)
+#define TRACE_RING_RECORDS          4096
+#define TRACE_RING_MASK             (TRACE_RING_RECORDS - 1)
+#define TRACE_DIRECTIONS            2
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Ring of a channel / direction: one producer (CAN read or write thread of
+// the channel), one consumer (writer). No lock: head is written only by the
+// producer, tail only by the consumer.
+typedef struct
+{
+    traceRecord_t record[TRACE_RING_RECORDS];
+    unsigned int head;          // Next record to be written (producer)
+    unsigned int tail;          // Next record to be read (consumer)
+    unsigned long drops;        // Ring full (producer)
+} traceRing_t;
+
+// Mapped trace file
+typedef struct
+{
+    unsigned long sequence;
+    int fd;
+    uint8_t *map;
+    size_t mapSize;
+    traceFileHeader_t *header;
+    uint64_t *index;
+    uint8_t *bitmaps;
+    traceRecord_t *records;
+} traceFile_t;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+// Protect the files and the configuration (writer, update, close)
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Recorder enabled - read without the lock by trace_record
+static int g_enabled = 0;
+// Frames waiting for the writer
+static traceRing_t g_rings[SOCKETCAN_CHANNELS][TRACE_DIRECTIONS];
+static unsigned long g_drops = 0;   // Drops already reported (writer)
+// Configuration
+static char *g_directory = NULL;
+static int g_files = TRACE_DEFAULT_FILES;
+static unsigned int g_fileRecords = TRACE_DEFAULT_FILE_RECORDS;
+static bool g_moduleBitmap = true;
+// Sequence of the oldest file kept
+static unsigned long g_oldest = 0;
+// Current file and next file (created before the current one is full)
+static traceFile_t g_file = {0, -1, NULL, 0, NULL, NULL, NULL, NULL};
+static traceFile_t g_next = {0, -1, NULL, 0, NULL, NULL, NULL, NULL};
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static void getFileName(const char *directory, unsigned long sequence,
+        char *name);
+static int filterTraceFile(const struct dirent *entry);
+static int scanDirectory(const char *directory, unsigned long *oldest,
+        unsigned long *newest);
+static int openFile(traceFile_t *file, unsigned long sequence);
+static void closeFile(traceFile_t *file);
+static void discardFile(traceFile_t *file);
+static void removeOldFiles(void);
+static int nextFile(void);
+static void appendRecord(traceRecord_t *record);
+static void drainRings(void);
+static int queryFile(const char *name, int node, int group,
+        unsigned long long from, unsigned long long to,
+        traceCallback_t callback, void *context, int *stop);
+
+// Name of a trace file
+static void getFileName(const char *directory, unsigned long sequence,
+        char *name)
+{
+    snprintf(name, TRACE_FILE_NAME_SIZE, "%s/%s%010lu%s", directory,
+            TRACE_FILE_PREFIX, sequence, TRACE_FILE_SUFFIX);
+}
+
+// Filter of scandir: trace files only
+static int filterTraceFile(const struct dirent *entry)
+{
+    size_t len = strlen(entry->d_name);
+    size_t prefixLen = strlen(TRACE_FILE_PREFIX);
+    size_t suffixLen = strlen(TRACE_FILE_SUFFIX);
+    if(len <= prefixLen + suffixLen)
+    {
+        return 0;
+    }
+    if(strncmp(entry->d_name, TRACE_FILE_PREFIX, prefixLen) != 0)
+    {
+        return 0;
+    }
+    if(strcmp(entry->d_name + len - suffixLen, TRACE_FILE_SUFFIX) != 0)
+    {
+        return 0;
+    }
+    return 1;
+}
+
+// Sequence of the oldest and newest trace files - return number of files
+static int scanDirectory(const char *directory, unsigned long *oldest,
+        unsigned long *newest)
+{
+    struct dirent **entries;
+    unsigned long sequence;
+    int li_index;
+    int count;
+    count = scandir(directory, &entries, filterTraceFile, alphasort);
+    if(count < 0)
+    {
+        return 0;
+    }
+    for(li_index = 0; li_index < count; li_index++)
+    {
+        sequence = strtoul(entries[li_index]->d_name +
+                strlen(TRACE_FILE_PREFIX), NULL, 10);
+        if((li_index == 0) || (sequence < *oldest))
+        {
+            *oldest = sequence;
+        }
+        if((li_index == 0) || (sequence > *newest))
+        {
+            *newest = sequence;
+        }
+        free(entries[li_index]);
+    }
+    free(entries);
+    return count;
+}
+
+// Create and map a file (the memory is used when it is mapped if the memory
+// is locked - lockMemory)
+static int openFile(traceFile_t *file, unsigned long sequence)
+{
+    char name[TRACE_FILE_NAME_SIZE];
+    traceFileHeader_t header;
+    unsigned int blocks;
+
+    // Layout of the file
+    blocks = (g_fileRecords + TRACE_INDEX_INTERVAL - 1) / TRACE_INDEX_INTERVAL;
+    memset(&header, 0, sizeof(header));
+    header.magic = TRACE_FILE_MAGIC;
+    header.version = TRACE_FILE_VERSION;
+    header.recordSize = sizeof(traceRecord_t);
+    header.capacity = g_fileRecords;
+    header.indexOffset = TRACE_ALIGN(sizeof(traceFileHeader_t));
+    header.recordOffset = TRACE_ALIGN(header.indexOffset +
+            blocks * sizeof(uint64_t));
+    if(g_moduleBitmap)
+    {
+        header.flags = TRACE_FLAG_MODULE_BITMAP;
+        header.bitmapOffset = header.recordOffset;
+        header.recordOffset = TRACE_ALIGN(header.bitmapOffset +
+                blocks * TRACE_BITMAP_SIZE);
+    }
+    file->sequence = sequence;
+    file->mapSize = header.recordOffset +
+            (size_t)g_fileRecords * sizeof(traceRecord_t);
+    // Create the file (the unused part is not allocated) and map it
+    getFileName(g_directory, sequence, name);
+    file->fd = open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(file->fd < 0)
+    {
+        #ifdef DEBUG_TRACE_ERRORS
+        debug_error("trace: open error (%s): %s\n", name, strerror(errno));
+        #endif
+        return TRACE_ERROR;
+    }
+    if(ftruncate(file->fd, file->mapSize) != 0)
+    {
+        #ifdef DEBUG_TRACE_ERRORS
+        debug_error("trace: ftruncate error (%s): %s\n", name,
+                strerror(errno));
+        #endif
+        close(file->fd);
+        file->fd = -1;
+        unlink(name);
+        return TRACE_ERROR;
+    }
+    file->map = mmap(NULL, file->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+            file->fd, 0);
+    if(file->map == MAP_FAILED)
+    {
+        #ifdef DEBUG_TRACE_ERRORS
+        debug_error("trace: mmap error (%s): %s\n", name, strerror(errno));
+        #endif
+        file->map = NULL;
+        close(file->fd);
+        file->fd = -1;
+        unlink(name);
+        return TRACE_ERROR;
+    }
+    file->header = (traceFileHeader_t *)file->map;
+    memcpy(file->header, &header, sizeof(header));
+    file->index = (uint64_t *)(file->map + header.indexOffset);
+    file->bitmaps = g_moduleBitmap ? (file->map + header.bitmapOffset) : NULL;
+    file->records = (traceRecord_t *)(file->map + header.recordOffset);
+    return TRACE_OK;
+}
+
+// Unmap and close a file, cut to the records written
+static void closeFile(traceFile_t *file)
+{
+    size_t used;
+    if(file->map == NULL)
+    {
+        return;
+    }
+    used = file->header->recordOffset +
+            (size_t)file->header->count * sizeof(traceRecord_t);
+    munmap(file->map, file->mapSize);
+    if(ftruncate(file->fd, used) != 0)
+    {
+        #ifdef DEBUG_TRACE_ERRORS
+        debug_error("trace: ftruncate error: %s\n", strerror(errno));
+        #endif
+    }
+    close(file->fd);
+    file->fd = -1;
+    file->map = NULL;
+    file->header = NULL;
+    file->index = NULL;
+    file->bitmaps = NULL;
+    file->records = NULL;
+}
+
+// Unmap, close and remove a file that was not used (next file)
+static void discardFile(traceFile_t *file)
+{
+    char name[TRACE_FILE_NAME_SIZE];
+    if(file->map == NULL)
+    {
+        return;
+    }
+    closeFile(file);
+    getFileName(g_directory, file->sequence, name);
+    unlink(name);
+}
+
+// Keep "traceFiles" files (up to the current one)
+static void removeOldFiles(void)
+{
+    char name[TRACE_FILE_NAME_SIZE];
+    while(g_file.sequence - g_oldest + 1 > (unsigned long)g_files)
+    {
+        getFileName(g_directory, g_oldest, name);
+        unlink(name);
+        g_oldest++;
+    }
+}
+
+// Current file full: the next file (created by the writer) is used
+static int nextFile(void)
+{
+    closeFile(&g_file);
+    if(g_next.map == NULL)
+    {
+        // Not created yet (e.g. error on the last try)
+        if(openFile(&g_next, g_file.sequence + 1) != TRACE_OK)
+        {
+            return TRACE_ERROR;
+        }
+    }
+    g_file = g_next;
+    g_next.map = NULL;
+    g_next.fd = -1;
+    removeOldFiles();
+    return TRACE_OK;
+}
+
+// Copy a record to the current file - LOCKED BY THE CALLER
+static void appendRecord(traceRecord_t *record)
+{
+    uint32_t count;
+    // File full: next file
+    if(g_file.header->count >= g_file.header->capacity)
+    {
+        if(nextFile() != TRACE_OK)
+        {
+            __atomic_store_n(&g_enabled, 0, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+    count = g_file.header->count;
+    // Time never decreases within a file (binary search)
+    if((count > 0) && (record->millisecondsSinceEpoch <
+            g_file.header->lastMillisecondsSinceEpoch))
+    {
+        record->millisecondsSinceEpoch =
+                g_file.header->lastMillisecondsSinceEpoch;
+    }
+    memcpy(&g_file.records[count], record, sizeof(*record));
+    // Index and module bitmap of the block
+    if((count % TRACE_INDEX_INTERVAL) == 0)
+    {
+        g_file.index[count / TRACE_INDEX_INTERVAL] =
+                record->millisecondsSinceEpoch;
+    }
+    if(g_file.bitmaps != NULL)
+    {
+        g_file.bitmaps[(count / TRACE_INDEX_INTERVAL) * TRACE_BITMAP_SIZE +
+                (record->frame.module >> 3)] |=
+                (uint8_t)(1 << (record->frame.module & 7));
+    }
+    g_file.header->lastMillisecondsSinceEpoch = record->millisecondsSinceEpoch;
+    // Readers only use the records below count
+    __atomic_store_n(&g_file.header->count, count + 1, __ATOMIC_RELEASE);
+}
+
+// Copy the records of the rings to the file, oldest first - LOCKED BY THE
+// CALLER
+static void drainRings(void)
+{
+    int channel;
+    int direction;
+    unsigned int head[SOCKETCAN_CHANNELS][TRACE_DIRECTIONS];
+    unsigned long drops = 0;
+    traceRing_t *ring;
+    traceRing_t *oldest;
+    // Records written up to now (the producers keep adding after these)
+    for(channel = 0; channel < SOCKETCAN_CHANNELS; channel++)
+    {
+        for(direction = 0; direction < TRACE_DIRECTIONS; direction++)
+        {
+            ring = &g_rings[channel][direction];
+            head[channel][direction] = __atomic_load_n(&ring->head,
+                    __ATOMIC_ACQUIRE);
+            drops += __atomic_load_n(&ring->drops, __ATOMIC_RELAXED);
+        }
+    }
+    while(1)
+    {
+        oldest = NULL;
+        for(channel = 0; channel < SOCKETCAN_CHANNELS; channel++)
+        {
+            for(direction = 0; direction < TRACE_DIRECTIONS; direction++)
+            {
+                ring = &g_rings[channel][direction];
+                if(ring->tail == head[channel][direction])
+                {
+                    continue;
+                }
+                if((oldest == NULL) ||
+                        (ring->record[ring->tail & TRACE_RING_MASK].
+                        millisecondsSinceEpoch <
+                        oldest->record[oldest->tail & TRACE_RING_MASK].
+                        millisecondsSinceEpoch))
+                {
+                    oldest = ring;
+                }
+            }
+        }
+        if(oldest == NULL)
+        {
+            break;
+        }
+        if((g_file.map != NULL) &&
+                __atomic_load_n(&g_enabled, __ATOMIC_RELAXED))
+        {
+            appendRecord(&oldest->record[oldest->tail & TRACE_RING_MASK]);
+        }
+        // Position free for the producer
+        __atomic_store_n(&oldest->tail, oldest->tail + 1, __ATOMIC_RELEASE);
+    }
+    if(drops != g_drops)
+    {
+        #ifdef DEBUG_TRACE_ERRORS
+        debug_error("trace: %lu frames not recorded (ring full)\n",
+                drops - g_drops);
+        #endif
+        g_drops = drops;
+    }
+}
+
+// Query a file - return the number of records found
+static int queryFile(const char *name, int node, int group,
+        unsigned long long from, unsigned long long to,
+        traceCallback_t callback, void *context, int *stop)
+{
+    const traceFileHeader_t *header;
+    const traceRecord_t *records;
+    const uint64_t *index;
+    const uint8_t *bitmaps;
+    const uint8_t *map;
+    struct stat st;
+    unsigned long count;
+    unsigned long blocks;
+    unsigned long block;
+    unsigned long lo;
+    unsigned long hi;
+    unsigned long mid;
+    unsigned long li_index;
+    int found = 0;
+    int fd;
+
+    fd = open(name, O_RDONLY);
+    if(fd < 0)
+    {
+        return 0;
+    }
+    if((fstat(fd, &st) != 0) || (st.st_size < sizeof(traceFileHeader_t)))
+    {
+        close(fd);
+        return 0;
+    }
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        return 0;
+    }
+    header = (const traceFileHeader_t *)map;
+    // Check the file
+    if((header->magic != TRACE_FILE_MAGIC) ||
+            (header->version != TRACE_FILE_VERSION) ||
+            (header->recordSize != sizeof(traceRecord_t)) ||
+            (header->recordOffset > st.st_size))
+    {
+        munmap((void *)map, st.st_size);
+        return 0;
+    }
+    // Records written (the file may be written at the same time)
+    count = __atomic_load_n(&header->count, __ATOMIC_ACQUIRE);
+    if(count > (st.st_size - header->recordOffset) / sizeof(traceRecord_t))
+    {
+        count = (st.st_size - header->recordOffset) / sizeof(traceRecord_t);
+    }
+    records = (const traceRecord_t *)(map + header->recordOffset);
+    index = (const uint64_t *)(map + header->indexOffset);
+    bitmaps = NULL;
+    if(header->flags & TRACE_FLAG_MODULE_BITMAP)
+    {
+        bitmaps = map + header->bitmapOffset;
+    }
+    blocks = (count + TRACE_INDEX_INTERVAL - 1) / TRACE_INDEX_INTERVAL;
+    // Skip files out of the time range
+    if( (count == 0) ||
+        ((to != TRACE_ANY_TIME) &&
+            (records[0].millisecondsSinceEpoch > to)) ||
+        ((from != TRACE_ANY_TIME) &&
+            (records[count - 1].millisecondsSinceEpoch < from)) )
+    {
+        munmap((void *)map, st.st_size);
+        return 0;
+    }
+    //--------------------------------------------------------------------------
+    // First record: the block is found on the time index (last block starting
+    // before "from"), the record is found within the block
+    //--------------------------------------------------------------------------
+    li_index = 0;
+    if(from != TRACE_ANY_TIME)
+    {
+        lo = 0;
+        hi = blocks;
+        while(lo < hi)
+        {
+            mid = (lo + hi) / 2;
+            if(index[mid] < from)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        block = (lo > 0) ? (lo - 1) : 0;
+        lo = block * TRACE_INDEX_INTERVAL;
+        hi = lo + TRACE_INDEX_INTERVAL;
+        if(hi > count)
+        {
+            hi = count;
+        }
+        while(lo < hi)
+        {
+            mid = (lo + hi) / 2;
+            if(records[mid].millisecondsSinceEpoch < from)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        li_index = lo;
+    }
+    //--------------------------------------------------------------------------
+    // Records up to "to" - blocks without the node are skipped
+    //--------------------------------------------------------------------------
+    block = blocks;
+    while(li_index < count)
+    {
+        if((bitmaps != NULL) && (node != TRACE_ANY) &&
+                (li_index / TRACE_INDEX_INTERVAL != block))
+        {
+            block = li_index / TRACE_INDEX_INTERVAL;
+            if(!(bitmaps[block * TRACE_BITMAP_SIZE + (node >> 3)] &
+                    (1 << (node & 7))))
+            {
+                // Next block
+                block++;
+                if((block >= blocks) || ((to != TRACE_ANY_TIME) &&
+                        (index[block] > to)))
+                {
+                    break;
+                }
+                li_index = block * TRACE_INDEX_INTERVAL;
+                continue;
+            }
+        }
+        if((to != TRACE_ANY_TIME) &&
+                (records[li_index].millisecondsSinceEpoch > to))
+        {
+            break;
+        }
+        if( ((node == TRACE_ANY) || (records[li_index].frame.module == node)) &&
+            ((group == TRACE_ANY) || (records[li_index].frame.group == group)) )
+        {
+            found++;
+            if((callback != NULL) && callback(&records[li_index], context))
+            {
+                *stop = 1;
+                break;
+            }
+        }
+        li_index++;
+    }
+    munmap((void *)map, st.st_size);
+    return found;
+}
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/* Read the configuration and open / close the recorder */
+void trace_update(void)
+{
+    char *directory = NULL;
+    int files;
+    int fileRecords;
+    bool moduleBitmap;
+    unsigned long oldest;
+    unsigned long newest;
+    int check;
+
+    //*******************************//
+    // READ CONFIGURATION            //
+    //*******************************//
+    check = config_getString(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "traceDirectory", 0, NULL, &directory);
+    if(check != EXIT_SUCCESS)
+    {
+        directory = NULL;
+    }
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "traceFiles", 0, NULL, &files);
+    if((check != EXIT_SUCCESS) || (files <= 0))
+    {
+        files = TRACE_DEFAULT_FILES;
+    }
+    check = config_getInt(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "traceFileRecords", 0, NULL, &fileRecords);
+    if((check != EXIT_SUCCESS) || (fileRecords < TRACE_INDEX_INTERVAL))
+    {
+        fileRecords = TRACE_DEFAULT_FILE_RECORDS;
+    }
+    check = config_getBool(CONFIG_GENERAL_SETTINGS_LEVEL, 0,
+            "traceModuleBitmap", 0, NULL, &moduleBitmap);
+    if(check != EXIT_SUCCESS)
+    {
+        moduleBitmap = true;
+    }
+
+    //*******************************//
+    // OPEN / CLOSE THE RECORDER     //
+    //*******************************//
+    pthread_mutex_lock(&trace_mutex);
+    // Nothing changed
+    if( (g_file.map != NULL) && (directory != NULL) &&
+        (strcmp(directory, g_directory) == 0) && (files == g_files) &&
+        ((unsigned int)fileRecords == g_fileRecords) &&
+        (moduleBitmap == g_moduleBitmap) )
+    {
+        pthread_mutex_unlock(&trace_mutex);
+        free(directory);
+        return;
+    }
+    // Frames received up to now go to the current file
+    drainRings();
+    __atomic_store_n(&g_enabled, 0, __ATOMIC_RELAXED);
+    closeFile(&g_file);
+    discardFile(&g_next);
+    free(g_directory);
+    g_directory = directory;
+    g_files = files;
+    g_fileRecords = fileRecords;
+    g_moduleBitmap = moduleBitmap;
+    if(g_directory != NULL)
+    {
+        // A new file is started after the files already there
+        mkdir(g_directory, 0755);
+        if(scanDirectory(g_directory, &oldest, &newest) > 0)
+        {
+            g_oldest = oldest;
+            newest++;
+        }
+        else
+        {
+            g_oldest = 0;
+            newest = 0;
+        }
+        if(openFile(&g_file, newest) == TRACE_OK)
+        {
+            removeOldFiles();
+            __atomic_store_n(&g_enabled, 1, __ATOMIC_RELAXED);
+        }
+    }
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+/* Add a frame to the trace */
+void trace_record(int channel, int direction, struct can_frame *pcf_Frame,
+        unsigned long long millisecondsSinceEpoch)
+{
+    traceRing_t *ring;
+    traceRecord_t *record;
+    unsigned int head;
+
+    if(!__atomic_load_n(&g_enabled, __ATOMIC_RELAXED) ||
+            (channel < 0) || (channel >= SOCKETCAN_CHANNELS) ||
+            (direction < 0) || (direction >= TRACE_DIRECTIONS))
+    {
+        return;
+    }
+    ring = &g_rings[channel][direction];
+    head = ring->head;
+    // Ring full: the writer is late
+    if(head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >=
+            TRACE_RING_RECORDS)
+    {
+        __atomic_store_n(&ring->drops, ring->drops + 1, __ATOMIC_RELAXED);
+        return;
+    }
+    record = &ring->record[head & TRACE_RING_MASK];
+    record->millisecondsSinceEpoch = millisecondsSinceEpoch;
+    record->direction = (uint8_t)direction;
+    record->channel = (uint8_t)channel;
+    hapcan_getHAPCANDataFromCAN(pcf_Frame, &record->frame);
+    // Record ready for the writer
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/* Write the frames waiting in the rings and create the next file */
+void trace_flush(void)
+{
+    pthread_mutex_lock(&trace_mutex);
+    drainRings();
+    // Next file ready before the current one is full (no file system calls
+    // or page faults when the file changes)
+    if((g_file.map != NULL) && (g_next.map == NULL) &&
+            __atomic_load_n(&g_enabled, __ATOMIC_RELAXED))
+    {
+        openFile(&g_next, g_file.sequence + 1);
+    }
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+/* Close the recorder */
+void trace_close(void)
+{
+    pthread_mutex_lock(&trace_mutex);
+    drainRings();
+    __atomic_store_n(&g_enabled, 0, __ATOMIC_RELAXED);
+    closeFile(&g_file);
+    discardFile(&g_next);
+    free(g_directory);
+    g_directory = NULL;
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+/* Find the records of a node / group in a time range */
+int trace_query(const char *directory, int node, int group,
+        unsigned long long from, unsigned long long to,
+        traceCallback_t callback, void *context)
+{
+    char name[TRACE_FILE_NAME_SIZE];
+    struct dirent **entries;
+    int li_index;
+    int count;
+    int found = 0;
+    int stop = 0;
+
+    // Files in order (the sequence has a fixed number of digits)
+    count = scandir(directory, &entries, filterTraceFile, alphasort);
+    if(count < 0)
+    {
+        #ifdef DEBUG_TRACE_ERRORS
+        debug_error("trace: scandir error (%s): %s\n", directory,
+                strerror(errno));
+        #endif
+        return TRACE_ERROR;
+    }
+    for(li_index = 0; li_index < count; li_index++)
+    {
+        if(!stop)
+        {
+            snprintf(name, sizeof(name), "%s/%s", directory,
+                    entries[li_index]->d_name);
+            found += queryFile(name, node, group, from, to, callback,
+                    context, &stop);
+        }
+        free(entries[li_index]);
+    }
+    free(entries);
+    return found;
+}
+
+/* Print a record */
+int trace_printRecord(const traceRecord_t *record, void *context)
+{
+    FILE *out = (FILE *)context;
+    int li_index;
+    fprintf(out, "%llu %s %d 0x%03X %d %3d %3d",
+            (unsigned long long)record->millisecondsSinceEpoch,
+            (record->direction == TRACE_TX) ? "TX" : "RX", record->channel,
+            record->frame.frametype, record->frame.flags,
+            record->frame.module, record->frame.group);
+    for(li_index = 0; li_index < HAPCAN_DATA_LEN; li_index++)
+    {
+        fprintf(out, " %02X", record->frame.data[li_index]);
+    }
+    fprintf(out, "\n");
+    return 0;
+}
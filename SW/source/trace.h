@@ -0,0 +1,163 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Add trace_flush (trace writer thread); trace_record only adds the frame  //
+// to the ring of its channel / direction                                     //
+//----------------------------------------------------------------------------//
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+* Includes
+*/
+#include <stdint.h>
+#include <linux/can.h>
+#include "hapcan.h"
+
+//----------------------------------------------------------------------------//
+// EXTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+/* Return values */
+#define TRACE_OK                    0
+#define TRACE_ERROR                 -1
+/* Direction of a frame */
+#define TRACE_RX                    0
+#define TRACE_TX                    1
+/* Any node / group / time in a query */
+#define TRACE_ANY                   -1
+#define TRACE_ANY_TIME              0
+/* Defaults of the configuration */
+#define TRACE_DEFAULT_FILES         336
+#define TRACE_DEFAULT_FILE_RECORDS  65536
+/* Records of each entry of the time index (and of each module bitmap) */
+#define TRACE_INDEX_INTERVAL        256
+/* Period of the trace writer (ms) - see trace_flush */
+#define TRACE_FLUSH_PERIOD          10
+/* Trace file: "<traceDirectory>/trace_<sequence>.bin" */
+#define TRACE_FILE_PREFIX           "trace_"
+#define TRACE_FILE_SUFFIX           ".bin"
+#define TRACE_FILE_MAGIC            0x43524854  /* "THRC" */
+#define TRACE_FILE_VERSION          1
+
+//----------------------------------------------------------------------------//
+// EXTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Record of a frame (fixed size, the same in memory and in the file)
+typedef struct
+{
+    uint64_t millisecondsSinceEpoch;    // never decreases within a file
+    uint8_t direction;                  // TRACE_RX / TRACE_TX
+    uint8_t channel;                    // CAN channel
+    hapcanCANData frame;
+} traceRecord_t;
+
+// Header of a trace file. It is followed by the time index (uint64_t for
+// each TRACE_INDEX_INTERVAL records: time of the first record), the module
+// bitmaps (if TRACE_FLAG_MODULE_BITMAP: 256 bits for each TRACE_INDEX_INTERVAL
+// records, bit set if the module sent a frame) and the records.
+typedef struct
+{
+    uint32_t magic;                     // TRACE_FILE_MAGIC
+    uint16_t version;                   // TRACE_FILE_VERSION
+    uint16_t recordSize;                // sizeof(traceRecord_t)
+    uint32_t capacity;                  // number of records of the file
+    uint32_t flags;                     // TRACE_FLAG_*
+    uint32_t count;                     // records written
+    uint32_t indexOffset;               // offsets from the start of the file
+    uint32_t bitmapOffset;              // 0 if there are no module bitmaps
+    uint32_t recordOffset;
+    uint64_t lastMillisecondsSinceEpoch;
+} traceFileHeader_t;
+
+#define TRACE_FLAG_MODULE_BITMAP    0x00000001
+#define TRACE_BITMAP_SIZE           (256 / 8)
+
+/**
+ * Called for each record found by trace_query
+ *
+ * \param   record      (INPUT) record (in the mapped file)
+ * \param   context     (INPUT) context given to trace_query
+ * \return  0 to continue, other value to stop the query
+ */
+typedef int (*traceCallback_t)(const traceRecord_t *record, void *context);
+
+//----------------------------------------------------------------------------//
+// EXTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+/**
+ * Read the configuration ("traceDirectory", "traceFiles", "traceFileRecords",
+ * "traceModuleBitmap") and open / close the recorder. A new file is started
+ * when the configuration changes. No "traceDirectory" disables the recorder.
+ */
+void trace_update(void);
+
+/**
+ * Add a frame to the trace. The record is built in the ring of the channel /
+ * direction (one producer each: CAN read / write thread of the channel) -
+ * no lock and no system call. If the ring is full, the frame is not recorded
+ * (reported by trace_flush).
+ *
+ * \param   channel     (INPUT) CAN channel
+ * \param   direction   (INPUT) TRACE_RX / TRACE_TX
+ * \param   pcf_Frame   (INPUT) CAN frame
+ * \param   millisecondsSinceEpoch  (INPUT) time of the frame
+ */
+void trace_record(int channel, int direction, struct can_frame *pcf_Frame,
+        unsigned long long millisecondsSinceEpoch);
+
+/**
+ * Trace writer (called every TRACE_FLUSH_PERIOD ms by its thread): copies the
+ * frames of the rings to the mapped file, oldest first, and creates / maps the
+ * next file, so that changing files does not wait for the file system.
+ */
+void trace_flush(void);
+
+/**
+ * Close the recorder (the file is cut to the records written)
+ */
+void trace_close(void);
+
+/**
+ * Find the records of a node / group in a time range. Each file is mapped and
+ * the first record is found by binary search on the time index and on the
+ * records; blocks without the node are skipped using the module bitmaps.
+ *
+ * \param   directory   (INPUT) directory of the trace files
+ * \param   node        (INPUT) node (module) or TRACE_ANY
+ * \param   group       (INPUT) group or TRACE_ANY
+ * \param   from        (INPUT) first time (ms since epoch) or TRACE_ANY_TIME
+ * \param   to          (INPUT) last time (ms since epoch) or TRACE_ANY_TIME
+ * \param   callback    (INPUT) called for each record found
+ * \param   context     (INPUT) given to the callback
+ * \return  number of records found, TRACE_ERROR if the directory cannot be
+ *          read
+ */
+int trace_query(const char *directory, int node, int group,
+        unsigned long long from, unsigned long long to,
+        traceCallback_t callback, void *context);
+
+/**
+ * Print the records of a query (one line each)
+ *
+ * \param   record      (INPUT) record
+ * \param   context     (INPUT) FILE* to print to
+ * \return  0
+ */
+int trace_printRecord(const traceRecord_t *record, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_H */
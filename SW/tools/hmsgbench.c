@@ -0,0 +1,538 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Contended test: the push waits for a free position                       //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// HMSGBENCH - Microbenchmarks of the HMSG primitives ("make bench")
+//
+// One JSON object per line (e.g. to be compared between releases):
+// - buffer_push / buffer_pop: single thread and contended, by element size
+// - gateway_searchMQTTFromCAN / gateway_searchCANFromMQTT: hit and miss, from
+//   10 to 10000 entries
+// - aux_checkCAN2MQTTMatch, hs_getSocketArrayFromHAPCAN,
+//   hs_getHAPCANFromSocketArray
+// - module handlers (payload encode / decode) through the gateway, with the
+//   modules of ./config.json
+//----------------------------------------------------------------------------//
+
+/*
+* Includes
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include "../source/app.h"
+#include "../source/auxiliary.h"
+#include "../source/buffer.h"
+#include "../source/canbuf.h"
+#include "../source/config.h"
+#include "../source/debug.h"
+#include "../source/gateway.h"
+#include "../source/hapcan.h"
+#include "../source/hapcansocket.h"
+#include "../source/mqttbuf.h"
+#include "../source/socketserverbuf.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+// Time of each measurement (us) and iterations between time checks
+#define BENCH_TIME                  500000ULL
+#define BENCH_BATCH                 1000
+// Buffers: elements and threads (producers / consumers) of the contended test
+#define BENCH_BUFFER_ELEMENTS       1024
+#define BENCH_BUFFER_THREADS        2
+#define BENCH_BUFFER_CONTENDED_OPS  1000000
+// Gateway sizes
+#define BENCH_GATEWAY_SIZES         4
+#define BENCH_TOPIC_SIZE            64
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Function measured: "iterations" operations
+typedef void (*benchFunction_t)(void *context, long iterations);
+
+// Buffer test
+typedef struct
+{
+    int id;
+    unsigned int size;
+    long operations;            // contended: operations of each thread
+} benchBuffer_t;
+
+// Gateway test
+typedef struct
+{
+    int entries;
+    bool hit;
+    hapcanCANData *frames;
+    char (*topics)[BENCH_TOPIC_SIZE];
+} benchGateway_t;
+
+// Module handler test
+typedef struct
+{
+    const char *module;
+    hapcanCANData frame;        // CAN2MQTT
+    const char *topic;          // MQTT2CAN
+    const char *payload;
+} benchHandler_t;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+static const unsigned int c_bufferSizes[] = {8, 64, 256, 1024};
+static const int c_gatewaySizes[BENCH_GATEWAY_SIZES] = {10, 100, 1000, 10000};
+// Frames and commands of the modules of ./config.json (SW/config.json)
+static benchHandler_t g_handlers[] = {
+    {"relay", {HAPCAN_RELAY_FRAME_TYPE, 0, 1, 2,
+        {0xFF, 0xFF, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}},
+        "MyRootTopic/Command/Test1", "ON"},
+    {"relay_json", {HAPCAN_RELAY_FRAME_TYPE, 0, 1, 2,
+        {0xFF, 0xFF, 0x01, 0x00, 0xFF, 0xFF, 0xFF, 0xFF}},
+        "MyRootTopic/Command/Test1",
+        "{\"INSTR1\":1, \"INSTR3\":0, \"INSTR4\":255, \"INSTR5\":255, "
+        "\"INSTR6\":255}"},
+    {"button", {HAPCAN_BUTTON_FRAME_TYPE, 0, 1, 1,
+        {0xFF, 0xFF, 0x0E, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}},
+        "MyRootTopic/Command/LEDTest/set", "ON"},
+    {"temperature", {HAPCAN_TEMPERATURE_FRAME_TYPE, 0, 1, 1,
+        {0xFF, 0xFF, 0x11, 0x01, 0x58, 0x01, 0x50, 0x01}},
+        "MyRootTopic/Command/Thermostat1/set", "{\"Setpoint\":21.5}"},
+    {"rgb", {HAPCAN_RGB_FRAME_TYPE, 0, 1, 8,
+        {0xFF, 0xFF, 0x01, 0x80, 0xFF, 0xFF, 0xFF, 0xFF}},
+        "MyRootTopic/Command/PWM1/set", "128"},
+    {"rgbw", {HAPCAN_RGBW_FRAME_TYPE, 0, 4, 8,
+        {0xFF, 0xFF, 0x01, 0x80, 0xFF, 0xFF, 0xFF, 0xFF}},
+        "MyRootTopic/Command/RGBW1/set", "128"},
+    {"tim", {HAPCAN_MULTIPLE_TEMPERATURE_FRAME_TYPE, 0, 1, 4,
+        {0xFF, 0x00, 0x17, 0x01, 0x58, 0x01, 0x50, 0x01}},
+        "MyRootTopic/Command/TempSensor1ThermComm", "{\"Setpoint\":21.5}"}
+};
+// Contended buffer test
+static volatile int g_producersDone = 0;
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static unsigned long long getTime(void);
+static double benchRun(benchFunction_t function, void *context);
+static void benchBufferSingle(void *context, long iterations);
+static void* benchBufferProducer(void *arg);
+static void* benchBufferConsumer(void *arg);
+static double benchBufferContended(benchBuffer_t *buffer);
+static void benchBuffers(void);
+static void benchSearchMQTTFromCAN(void *context, long iterations);
+static void benchSearchCANFromMQTT(void *context, long iterations);
+static void benchGateway(void);
+static void benchCheckMatch(void *context, long iterations);
+static void benchToSocket(void *context, long iterations);
+static void benchFromSocket(void *context, long iterations);
+static void benchConversions(void);
+static void benchCAN2MQTTHandler(void *context, long iterations);
+static void benchMQTT2CANHandler(void *context, long iterations);
+static void benchHandlers(void);
+
+// Monotonic time (us)
+static unsigned long long getTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// Run a function in batches for BENCH_TIME - return operations per second
+static double benchRun(benchFunction_t function, void *context)
+{
+    unsigned long long start;
+    unsigned long long elapsed;
+    long operations = 0;
+    // Warm up
+    function(context, BENCH_BATCH);
+    start = getTime();
+    do
+    {
+        function(context, BENCH_BATCH);
+        operations += BENCH_BATCH;
+        elapsed = getTime() - start;
+    } while(elapsed < BENCH_TIME);
+    return (double)operations * 1000000.0 / elapsed;
+}
+
+//----------------------------------------------------------------------------//
+// BUFFERS
+//----------------------------------------------------------------------------//
+// Push and pop of an element (2 operations)
+static void benchBufferSingle(void *context, long iterations)
+{
+    benchBuffer_t *buffer = (benchBuffer_t *)context;
+    uint8_t data[1024];
+    unsigned int size;
+    long li_index;
+    for(li_index = 0; li_index < iterations / 2; li_index++)
+    {
+        buffer_push(buffer->id, data, buffer->size);
+        size = buffer_popSize(buffer->id);
+        if(size > 0)
+        {
+            buffer_pop(buffer->id, data, size);
+        }
+    }
+}
+
+// THREAD - Contended test: push (waits while the buffer is full)
+static void* benchBufferProducer(void *arg)
+{
+    benchBuffer_t *buffer = (benchBuffer_t *)arg;
+    uint8_t data[1024];
+    long li_index;
+    for(li_index = 0; li_index < buffer->operations; li_index++)
+    {
+        // The push waits for a free position (BUFFER_POLICY_BLOCK)
+        while(buffer_push(buffer->id, data, buffer->size) == BUFFER_OVERFLOW)
+        {
+            // Timeout: push the element again
+        }
+    }
+    return NULL;
+}
+
+// THREAD - Contended test: pop until the producers are done
+static void* benchBufferConsumer(void *arg)
+{
+    benchBuffer_t *buffer = (benchBuffer_t *)arg;
+    uint8_t data[1024];
+    unsigned int size;
+    while(1)
+    {
+        size = buffer_popSize(buffer->id);
+        if(size > 0)
+        {
+            buffer_pop(buffer->id, data, size);
+        }
+        else if(g_producersDone)
+        {
+            break;
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Contended test - return operations (push and pop) per second
+static double benchBufferContended(benchBuffer_t *buffer)
+{
+    pthread_t producers[BENCH_BUFFER_THREADS];
+    pthread_t consumers[BENCH_BUFFER_THREADS];
+    bufferPolicySettings_t policy = {BUFFER_POLICY_BLOCK, 1000, 0};
+    unsigned long long start;
+    unsigned long long elapsed;
+    int li_index;
+    buffer_setPolicy(buffer->id, &policy);
+    buffer->operations = BENCH_BUFFER_CONTENDED_OPS / BENCH_BUFFER_THREADS;
+    g_producersDone = 0;
+    start = getTime();
+    for(li_index = 0; li_index < BENCH_BUFFER_THREADS; li_index++)
+    {
+        pthread_create(&consumers[li_index], NULL, benchBufferConsumer, buffer);
+        pthread_create(&producers[li_index], NULL, benchBufferProducer, buffer);
+    }
+    for(li_index = 0; li_index < BENCH_BUFFER_THREADS; li_index++)
+    {
+        pthread_join(producers[li_index], NULL);
+    }
+    g_producersDone = 1;
+    for(li_index = 0; li_index < BENCH_BUFFER_THREADS; li_index++)
+    {
+        pthread_join(consumers[li_index], NULL);
+    }
+    elapsed = getTime() - start;
+    return 2.0 * BENCH_BUFFER_CONTENDED_OPS * 1000000.0 / elapsed;
+}
+
+// buffer_push / buffer_pop by element size
+static void benchBuffers(void)
+{
+    benchBuffer_t buffer;
+    bufferPolicySettings_t policy = {BUFFER_POLICY_DROP_OLDEST, 0, 0};
+    unsigned int li_index;
+    double ops;
+    for(li_index = 0; li_index < sizeof(c_bufferSizes) /
+            sizeof(c_bufferSizes[0]); li_index++)
+    {
+        buffer.id = buffer_init(BENCH_BUFFER_ELEMENTS);
+        if(buffer.id < 0)
+        {
+            printf("{\"bench\":\"buffer\",\"error\":\"buffer_init\"}\n");
+            return;
+        }
+        buffer.size = c_bufferSizes[li_index];
+        buffer_setPolicy(buffer.id, &policy);
+        ops = benchRun(benchBufferSingle, &buffer);
+        printf("{\"bench\":\"buffer_push_pop\",\"mode\":\"single\","
+                "\"threads\":1,\"size\":%u,\"ops_per_s\":%.0f}\n",
+                buffer.size, ops);
+        buffer_clean(buffer.id);
+        ops = benchBufferContended(&buffer);
+        printf("{\"bench\":\"buffer_push_pop\",\"mode\":\"contended\","
+                "\"threads\":%d,\"size\":%u,\"ops_per_s\":%.0f}\n",
+                2 * BENCH_BUFFER_THREADS, buffer.size, ops);
+        buffer_delete(buffer.id);
+    }
+}
+
+//----------------------------------------------------------------------------//
+// GATEWAY
+//----------------------------------------------------------------------------//
+// Search of a frame (first match), every entry in turn
+static void benchSearchMQTTFromCAN(void *context, long iterations)
+{
+    benchGateway_t *gw = (benchGateway_t *)context;
+    hapcanCANData hd;
+    long li_index;
+    for(li_index = 0; li_index < iterations; li_index++)
+    {
+        hd = gw->frames[li_index % gw->entries];
+        if(!gw->hit)
+        {
+            // Frame type not configured
+            hd.frametype = HAPCAN_BUTTON_FRAME_TYPE;
+        }
+        gateway_searchMQTTFromCAN(&hd, 0);
+    }
+}
+
+// Search of a topic (first match), every entry in turn
+static void benchSearchCANFromMQTT(void *context, long iterations)
+{
+    benchGateway_t *gw = (benchGateway_t *)context;
+    char miss[] = "bench/not/configured";
+    long li_index;
+    for(li_index = 0; li_index < iterations; li_index++)
+    {
+        if(gw->hit)
+        {
+            gateway_searchCANFromMQTT(gw->topics[li_index % gw->entries], 0);
+        }
+        else
+        {
+            gateway_searchCANFromMQTT(miss, 0);
+        }
+    }
+}
+
+// Lookups per second from 10 to 10000 entries
+static void benchGateway(void)
+{
+    benchGateway_t gw;
+    hapcanCANData hd_mask;
+    char state[BENCH_TOPIC_SIZE];
+    int i_size;
+    int li_index;
+    double ops;
+    gw.frames = malloc(sizeof(*gw.frames) *
+            c_gatewaySizes[BENCH_GATEWAY_SIZES - 1]);
+    gw.topics = malloc(sizeof(*gw.topics) *
+            c_gatewaySizes[BENCH_GATEWAY_SIZES - 1]);
+    if((gw.frames == NULL) || (gw.topics == NULL))
+    {
+        printf("{\"bench\":\"gateway\",\"error\":\"no memory\"}\n");
+        free(gw.frames);
+        free(gw.topics);
+        return;
+    }
+    // Mask: frame type, node, group, channel (as the relay module)
+    aux_clearHAPCANFrame(&hd_mask);
+    hd_mask.frametype = 0xFFFF;
+    hd_mask.module = 0xFF;
+    hd_mask.group = 0xFF;
+    hd_mask.data[2] = 0xFF;
+    for(i_size = 0; i_size < BENCH_GATEWAY_SIZES; i_size++)
+    {
+        gw.entries = c_gatewaySizes[i_size];
+        gateway_init();
+        for(li_index = 0; li_index < gw.entries; li_index++)
+        {
+            aux_clearHAPCANFrame(&gw.frames[li_index]);
+            gw.frames[li_index].frametype = HAPCAN_RELAY_FRAME_TYPE;
+            gw.frames[li_index].module = (li_index % 250) + 1;
+            gw.frames[li_index].group = ((li_index / 250) % 250) + 1;
+            gw.frames[li_index].data[2] = (li_index / 62500) + 1;
+            snprintf(state, sizeof(state), "bench/%d/state", li_index);
+            snprintf(gw.topics[li_index], BENCH_TOPIC_SIZE, "bench/%d/set",
+                    li_index);
+            gateway_AddElementToList(GATEWAY_CAN2MQTT_LIST, &hd_mask,
+                    &gw.frames[li_index], state, NULL, NULL, NULL, NULL, 0);
+            gateway_AddElementToList(GATEWAY_MQTT2CAN_LIST, NULL, NULL, NULL,
+                    gw.topics[li_index], &gw.frames[li_index], NULL, NULL, 0);
+        }
+        gw.hit = true;
+        ops = benchRun(benchSearchMQTTFromCAN, &gw);
+        printf("{\"bench\":\"gateway_searchMQTTFromCAN\",\"entries\":%d,"
+                "\"result\":\"hit\",\"ops_per_s\":%.0f}\n", gw.entries, ops);
+        gw.hit = false;
+        ops = benchRun(benchSearchMQTTFromCAN, &gw);
+        printf("{\"bench\":\"gateway_searchMQTTFromCAN\",\"entries\":%d,"
+                "\"result\":\"miss\",\"ops_per_s\":%.0f}\n", gw.entries, ops);
+        gw.hit = true;
+        ops = benchRun(benchSearchCANFromMQTT, &gw);
+        printf("{\"bench\":\"gateway_searchCANFromMQTT\",\"entries\":%d,"
+                "\"result\":\"hit\",\"ops_per_s\":%.0f}\n", gw.entries, ops);
+        gw.hit = false;
+        ops = benchRun(benchSearchCANFromMQTT, &gw);
+        printf("{\"bench\":\"gateway_searchCANFromMQTT\",\"entries\":%d,"
+                "\"result\":\"miss\",\"ops_per_s\":%.0f}\n", gw.entries, ops);
+    }
+    gateway_init();
+    free(gw.frames);
+    free(gw.topics);
+}
+
+//----------------------------------------------------------------------------//
+// MATCH AND CONVERSIONS
+//----------------------------------------------------------------------------//
+// Frame against a mask / check
+static void benchCheckMatch(void *context, long iterations)
+{
+    hapcanCANData *hd = (hapcanCANData *)context;
+    long li_index;
+    for(li_index = 0; li_index < iterations; li_index++)
+    {
+        aux_checkCAN2MQTTMatch(&hd[0], &hd[1], &hd[2]);
+    }
+}
+
+// HAPCAN frame to socket array
+static void benchToSocket(void *context, long iterations)
+{
+    uint8_t data[HAPCAN_SOCKET_DATA_LEN];
+    long li_index;
+    for(li_index = 0; li_index < iterations; li_index++)
+    {
+        hs_getSocketArrayFromHAPCAN((hapcanCANData *)context, data);
+    }
+}
+
+// Socket array to HAPCAN frame
+static void benchFromSocket(void *context, long iterations)
+{
+    hapcanCANData hd;
+    long li_index;
+    for(li_index = 0; li_index < iterations; li_index++)
+    {
+        hs_getHAPCANFromSocketArray((uint8_t *)context, &hd);
+    }
+}
+
+// aux_checkCAN2MQTTMatch, hs_getSocketArrayFromHAPCAN and back
+static void benchConversions(void)
+{
+    hapcanCANData hd[3];
+    uint8_t data[HAPCAN_SOCKET_DATA_LEN];
+    // Received frame, mask, check
+    hd[0] = g_handlers[0].frame;
+    aux_clearHAPCANFrame(&hd[1]);
+    hd[1].frametype = 0xFFFF;
+    hd[1].module = 0xFF;
+    hd[1].group = 0xFF;
+    hd[1].data[2] = 0xFF;
+    hd[2] = g_handlers[0].frame;
+    printf("{\"bench\":\"aux_checkCAN2MQTTMatch\",\"ops_per_s\":%.0f}\n",
+            benchRun(benchCheckMatch, hd));
+    printf("{\"bench\":\"hs_getSocketArrayFromHAPCAN\",\"ops_per_s\":%.0f}\n",
+            benchRun(benchToSocket, &hd[0]));
+    hs_getSocketArrayFromHAPCAN(&hd[0], data);
+    printf("{\"bench\":\"hs_getHAPCANFromSocketArray\",\"ops_per_s\":%.0f}\n",
+            benchRun(benchFromSocket, data));
+}
+
+//----------------------------------------------------------------------------//
+// MODULE HANDLERS
+//----------------------------------------------------------------------------//
+// CAN2MQTT: search and status payload (MQTT is not connected: the payload is
+// not queued)
+static void benchCAN2MQTTHandler(void *context, long iterations)
+{
+    benchHandler_t *handler = (benchHandler_t *)context;
+    hapcanCANData hd;
+    long li_index;
+    for(li_index = 0; li_index < iterations; li_index++)
+    {
+        hd = handler->frame;
+        gateway_handleCAN2MQTT(&hd, 0);
+    }
+}
+
+// MQTT2CAN: search, command payload decode and CAN frame queued
+static void benchMQTT2CANHandler(void *context, long iterations)
+{
+    benchHandler_t *handler = (benchHandler_t *)context;
+    char topic[BENCH_TOPIC_SIZE];
+    long li_index;
+    snprintf(topic, sizeof(topic), "%s", handler->topic);
+    for(li_index = 0; li_index < iterations; li_index++)
+    {
+        gateway_handleMQTT2CAN(topic, (void *)handler->payload,
+                strlen(handler->payload), 0);
+    }
+}
+
+// Payload encode / decode of each module (modules of ./config.json)
+static void benchHandlers(void)
+{
+    unsigned int li_index;
+    config_init();
+    gateway_init();
+    hapcan_initGateway();
+    // Queues of the handlers (drop the oldest element when full)
+    canbuf_init(0);
+    mqttbuf_init();
+    socketserverbuf_init();
+    for(li_index = 0; li_index < sizeof(g_handlers) / sizeof(g_handlers[0]);
+            li_index++)
+    {
+        printf("{\"bench\":\"handler_can2mqtt\",\"module\":\"%s\","
+                "\"ops_per_s\":%.0f}\n", g_handlers[li_index].module,
+                benchRun(benchCAN2MQTTHandler, &g_handlers[li_index]));
+        printf("{\"bench\":\"handler_mqtt2can\",\"module\":\"%s\","
+                "\"ops_per_s\":%.0f}\n", g_handlers[li_index].module,
+                benchRun(benchMQTT2CANHandler, &g_handlers[li_index]));
+    }
+}
+
+//----------------------------------------------------------------------------//
+// MAIN
+//----------------------------------------------------------------------------//
+int main(int argc, char *argv[])
+{
+    int li_index;
+    // Only errors are printed
+    for(li_index = 0; li_index < DEBUG_NUMBER_OF_MODULES; li_index++)
+    {
+        debug_setLevel(li_index, DEBUG_LEVEL_ERROR);
+    }
+    printf("{\"bench\":\"version\",\"version\":\"%s.%s\",\"build\":\"%s %s\"}\n",
+            APP_SW_MAIN_VERSION, APP_SW_SUB_VERSION, __DATE__, __TIME__);
+    benchBuffers();
+    benchConversions();
+    benchHandlers();
+    benchGateway();
+    return EXIT_SUCCESS;
+}
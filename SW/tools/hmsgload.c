@@ -0,0 +1,1034 @@
+//----------------------------------------------------------------------------//
+//                               OBJECT HISTORY                               //
+//----------------------------------------------------------------------------//
+//  REVISION |    DATE     |                               |      AUTHOR      //
+//----------------------------------------------------------------------------//
+//  1.00     | 18/Oct/2026 |                               | ALCP             //
+// - First version                                                            //
+//----------------------------------------------------------------------------//
+//  1.01     | 18/Oct/2026 |                               | ALCP             //
+// - Probe frames published by HMSG are decoded from the three raw encodings  //
+// (JSON, hex, binary) and from the federation batches                        //
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+// HMSGLOAD - Replay and load generation for HMSG on a (v)can interface
+//
+// - Probe frames (numbered) are sent at a fixed rate and received back through
+//   HMSG: CAN -> MQTT (raw frame published on rawHapcanPubTopic, in any
+//   rawHapcanEncoding or in a rawHapcanBatch batch) and MQTT ->
+//   CAN (raw frame published on a rawHapcanSubTopics topic). Throughput, loss
+//   and latency are measured for each direction.
+// - Modules of the HMSG configuration file (relays, buttons, temperature, RGB,
+//   RGBW, TIM) are emulated: status requests are answered with their status
+//   frames.
+// - Background traffic: status frames of the emulated modules at a fixed rate,
+//   or the frames received in a bus trace (trace.h) replayed with their
+//   original timing.
+//----------------------------------------------------------------------------//
+
+/*
+* Includes
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <poll.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <MQTTClient.h>
+#include <json-c/json.h>
+#include "../source/hapcan.h"
+#include "../source/hapcanfed.h"
+#include "../source/trace.h"
+
+//----------------------------------------------------------------------------//
+// INTERNAL DEFINITIONS
+//----------------------------------------------------------------------------//
+// Probe frames (application frame types not used by HAPCAN modules)
+#define LOAD_PROBE_CAN2MQTT_FRAME_TYPE  0x3F0
+#define LOAD_PROBE_MQTT2CAN_FRAME_TYPE  0x3F1
+#define LOAD_PROBE_MARKER               0xA5
+// Defaults
+#define LOAD_DEFAULT_INTERFACE          "can0"
+#define LOAD_DEFAULT_BROKER             "tcp://127.0.0.1:1883"
+#define LOAD_DEFAULT_CLIENT_ID          "HMSGLOAD"
+#define LOAD_DEFAULT_RATE               100
+#define LOAD_DEFAULT_DURATION           10
+#define LOAD_DEFAULT_DRAIN              2
+#define LOAD_DEFAULT_NODE               250
+#define LOAD_DEFAULT_GROUP              250
+// Emulated status frames
+#define LOAD_MAX_STATUS_FRAMES          4096
+// Size of the raw MQTT payload
+#define LOAD_RAW_PAYLOAD_SIZE           256
+
+//----------------------------------------------------------------------------//
+// INTERNAL TYPES
+//----------------------------------------------------------------------------//
+// Direction of the probe frames
+enum
+{
+    LOAD_CAN2MQTT = 0,
+    LOAD_MQTT2CAN,
+    LOAD_NUMBER_OF_DIRECTIONS
+};
+
+// Probe results of a direction
+typedef struct
+{
+    bool enabled;
+    unsigned long sent;
+    unsigned long received;
+    unsigned long duplicated;
+    unsigned long long *sentTime;   // us, by sequence number
+    unsigned long long *latency;    // us, by order of arrival
+    uint8_t *isReceived;            // by sequence number
+} loadProbe_t;
+
+// Options
+typedef struct
+{
+    const char *interface;
+    const char *broker;
+    const char *clientID;
+    const char *pubTopic;           // rawHapcanPubTopic of HMSG
+    const char *subTopic;           // one of rawHapcanSubTopics of HMSG
+    const char *configFile;         // modules to be emulated
+    const char *traceDirectory;     // background: trace replay
+    double speed;                   // trace replay speed (0: no pauses)
+    int rate;                       // probe frames per second
+    int backgroundRate;             // background: status frames per second
+    int duration;                   // seconds
+    int drain;                      // seconds to wait for the last frames
+    int node;                       // node / group of the probe frames
+    int group;
+} loadOptions_t;
+
+//----------------------------------------------------------------------------//
+// INTERNAL GLOBAL VARIABLES
+//----------------------------------------------------------------------------//
+static loadOptions_t g_options = {
+    LOAD_DEFAULT_INTERFACE, LOAD_DEFAULT_BROKER, LOAD_DEFAULT_CLIENT_ID, NULL,
+    NULL, NULL, NULL, 1.0, LOAD_DEFAULT_RATE, 0, LOAD_DEFAULT_DURATION,
+    LOAD_DEFAULT_DRAIN, LOAD_DEFAULT_NODE, LOAD_DEFAULT_GROUP};
+static loadProbe_t g_probe[LOAD_NUMBER_OF_DIRECTIONS];
+static pthread_mutex_t g_probe_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Status frames of the emulated modules
+static hapcanCANData g_status[LOAD_MAX_STATUS_FRAMES];
+static int g_nStatus = 0;
+static unsigned long g_statusRequests = 0;
+static unsigned long g_statusFrames = 0;
+static unsigned long g_backgroundFrames = 0;
+// CAN socket and MQTT client
+static int g_fd = -1;
+static MQTTClient g_client;
+// Threads stop when cleared
+static volatile int g_running = 1;
+static volatile int g_sending = 1;
+
+//----------------------------------------------------------------------------//
+// INTERNAL FUNCTIONS
+//----------------------------------------------------------------------------//
+static unsigned long long getTime(void);
+static void sleepUntil(unsigned long long time);
+static void getCANFromHAPCAN(const hapcanCANData *hd, struct can_frame *cf);
+static void getHAPCANFromCAN(const struct can_frame *cf, hapcanCANData *hd);
+static int writeFrame(const hapcanCANData *hd);
+static void addStatusFrame(int frametype, int node, int group, uint8_t d0,
+        uint8_t d1, uint8_t d2, uint8_t d3);
+static int getInt(json_object *obj, const char *field, int defaultValue);
+static void loadModules(const char *configFile);
+static void setProbe(int direction, unsigned long sequence, uint8_t *data);
+static void probeReceived(int direction, const uint8_t *data);
+static void checkProbe(const hapcanCANData *hd);
+static int getHexDigit(char c);
+static bool getFrameFromSocketArray(const uint8_t *data, hapcanCANData *hd);
+static bool getFrameFromRaw(const void *payload, int payloadlen,
+        hapcanCANData *hd);
+static void handleBatch(const uint8_t *data, int payloadlen);
+static int onMessage(void *context, char *topicName, int topicLen,
+        MQTTClient_message *message);
+static void onConnectionLost(void *context, char *cause);
+static void* canReader(void *arg);
+static void* statusLoad(void *arg);
+static void* traceReplay(void *arg);
+static int compareLatency(const void *a, const void *b);
+static void report(const char *name, loadProbe_t *probe);
+static void usage(const char *name);
+
+// Monotonic time (us)
+static unsigned long long getTime(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// Sleep until a monotonic time (us)
+static void sleepUntil(unsigned long long time)
+{
+    struct timespec ts;
+    ts.tv_sec = time / 1000000ULL;
+    ts.tv_nsec = (time % 1000000ULL) * 1000;
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0)
+    {
+        // Interrupted: sleep again
+    }
+}
+
+// CAN frame from HAPCAN frame (as hapcan_getCANDataFromHAPCAN)
+static void getCANFromHAPCAN(const hapcanCANData *hd, struct can_frame *cf)
+{
+    memset(cf, 0, sizeof(*cf));
+    cf->can_id = ((uint32_t)hd->frametype << 17) |
+            ((uint32_t)(hd->flags & 0x01) << 16) |
+            ((uint32_t)hd->module << 8) | hd->group;
+    cf->can_id |= CAN_EFF_FLAG;
+    cf->can_dlc = CAN_MAX_DLEN;
+    memcpy(cf->data, hd->data, HAPCAN_DATA_LEN);
+}
+
+// HAPCAN frame from CAN frame (as hapcan_getHAPCANDataFromCAN)
+static void getHAPCANFromCAN(const struct can_frame *cf, hapcanCANData *hd)
+{
+    uint32_t id = cf->can_id & CAN_EFF_MASK;
+    hd->frametype = (uint16_t)(id >> 17);
+    hd->flags = (uint8_t)((id >> 16) & 0x01);
+    hd->module = (uint8_t)(id >> 8);
+    hd->group = (uint8_t)id;
+    memcpy(hd->data, cf->data, HAPCAN_DATA_LEN);
+}
+
+// Write a HAPCAN frame to the CAN interface
+static int writeFrame(const hapcanCANData *hd)
+{
+    struct can_frame cf;
+    getCANFromHAPCAN(hd, &cf);
+    if(write(g_fd, &cf, sizeof(cf)) != sizeof(cf))
+    {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Add a status frame of an emulated module (response flag set)
+static void addStatusFrame(int frametype, int node, int group, uint8_t d0,
+        uint8_t d1, uint8_t d2, uint8_t d3)
+{
+    hapcanCANData *hd;
+    if(g_nStatus >= LOAD_MAX_STATUS_FRAMES)
+    {
+        return;
+    }
+    hd = &g_status[g_nStatus];
+    memset(hd->data, 0xFF, HAPCAN_DATA_LEN);
+    hd->frametype = frametype;
+    hd->flags = 0x01;
+    hd->module = node;
+    hd->group = group;
+    hd->data[0] = d0;
+    hd->data[1] = d1;
+    hd->data[2] = d2;
+    hd->data[3] = d3;
+    g_nStatus++;
+}
+
+// Integer field of a JSON object
+static int getInt(json_object *obj, const char *field, int defaultValue)
+{
+    json_object *value;
+    if(!json_object_object_get_ex(obj, field, &value))
+    {
+        return defaultValue;
+    }
+    return json_object_get_int(value);
+}
+
+// Status frames of the modules of the HMSG configuration file
+static void loadModules(const char *configFile)
+{
+    json_object *root;
+    json_object *section;
+    json_object *module;
+    json_object *channels;
+    json_object *channel;
+    hapcanCANData *hd;
+    size_t li_module;
+    size_t li_channel;
+    size_t n;
+    int node;
+    int group;
+    int ch;
+
+    root = json_object_from_file(configFile);
+    if(root == NULL)
+    {
+        printf("Configuration file error: %s\n", configFile);
+        return;
+    }
+    //--------------------------------------------------------------------------
+    // Relays: 0x302, D2 = channel, D3 = state
+    //--------------------------------------------------------------------------
+    if(json_object_object_get_ex(root, "HAPCANRelays", &section))
+    {
+        for(li_module = 0; li_module < json_object_array_length(section);
+                li_module++)
+        {
+            module = json_object_array_get_idx(section, li_module);
+            node = getInt(module, "node", 0);
+            group = getInt(module, "group", 0);
+            if(json_object_object_get_ex(module, "relays", &channels))
+            {
+                n = json_object_array_length(channels);
+                for(li_channel = 0; li_channel < n; li_channel++)
+                {
+                    channel = json_object_array_get_idx(channels, li_channel);
+                    ch = getInt(channel, "channel", 1);
+                    addStatusFrame(HAPCAN_RELAY_FRAME_TYPE, node, group, 0xFF,
+                            0xFF, ch, 0x00);
+                }
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    // Buttons: 0x301, D2 = channel, D3 = state. Temperature: 0x304, D2 = 0x11
+    //--------------------------------------------------------------------------
+    if(json_object_object_get_ex(root, "HAPCANButtons", &section))
+    {
+        for(li_module = 0; li_module < json_object_array_length(section);
+                li_module++)
+        {
+            module = json_object_array_get_idx(section, li_module);
+            node = getInt(module, "node", 0);
+            group = getInt(module, "group", 0);
+            if(json_object_object_get_ex(module, "buttons", &channels))
+            {
+                n = json_object_array_length(channels);
+                for(li_channel = 0; li_channel < n; li_channel++)
+                {
+                    channel = json_object_array_get_idx(channels, li_channel);
+                    ch = getInt(channel, "channel", 1);
+                    addStatusFrame(HAPCAN_BUTTON_FRAME_TYPE, node, group, 0xFF,
+                            0xFF, ch, 0x00);
+                }
+            }
+            if(json_object_object_get_ex(module, "temperature", &channel))
+            {
+                // 21.5 degrees, thermostat 21.0 degrees
+                addStatusFrame(HAPCAN_TEMPERATURE_FRAME_TYPE, node, group,
+                        0xFF, 0xFF, 0x11, 0x01);
+                hd = &g_status[g_nStatus - 1];
+                hd->data[4] = 0x58;
+                hd->data[5] = 0x01;
+                hd->data[6] = 0x50;
+                hd->data[7] = 0x01;
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    // RGB: 0x308, D2 = channel (1 to 4), D3 = value
+    //--------------------------------------------------------------------------
+    if(json_object_object_get_ex(root, "HAPCANRGBs", &section))
+    {
+        for(li_module = 0; li_module < json_object_array_length(section);
+                li_module++)
+        {
+            module = json_object_array_get_idx(section, li_module);
+            node = getInt(module, "node", 0);
+            group = getInt(module, "group", 0);
+            for(ch = 1; ch <= 4; ch++)
+            {
+                addStatusFrame(HAPCAN_RGB_FRAME_TYPE, node, group, 0xFF, 0xFF,
+                        ch, 0x00);
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    // RGBW: 0x318, D2 = channel (1 to 5), D3 = value
+    //--------------------------------------------------------------------------
+    if(json_object_object_get_ex(root, "RGBWs", &section))
+    {
+        for(li_module = 0; li_module < json_object_array_length(section);
+                li_module++)
+        {
+            module = json_object_array_get_idx(section, li_module);
+            node = getInt(module, "node", 0);
+            group = getInt(module, "group", 0);
+            for(ch = 1; ch <= 5; ch++)
+            {
+                addStatusFrame(HAPCAN_RGBW_FRAME_TYPE, node, group, 0xFF, 0xFF,
+                        ch, 0x00);
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    // TIM: 0x314, D1 = channel - 1, D2 = 0x17 (temperature)
+    //--------------------------------------------------------------------------
+    if(json_object_object_get_ex(root, "TIMs", &section))
+    {
+        for(li_module = 0; li_module < json_object_array_length(section);
+                li_module++)
+        {
+            module = json_object_array_get_idx(section, li_module);
+            node = getInt(module, "node", 0);
+            group = getInt(module, "group", 0);
+            if(json_object_object_get_ex(module, "temperature", &channels))
+            {
+                n = json_object_array_length(channels);
+                for(li_channel = 0; li_channel < n; li_channel++)
+                {
+                    channel = json_object_array_get_idx(channels, li_channel);
+                    ch = getInt(channel, "channel", 1);
+                    addStatusFrame(HAPCAN_MULTIPLE_TEMPERATURE_FRAME_TYPE,
+                            node, group, 0xFF, ch - 1, 0x17, 0x01);
+                    hd = &g_status[g_nStatus - 1];
+                    hd->data[4] = 0x58;
+                    hd->data[5] = 0x01;
+                    hd->data[6] = 0x50;
+                    hd->data[7] = 0x01;
+                }
+            }
+        }
+    }
+    json_object_put(root);
+}
+
+// Data of a probe frame: sequence (D0 to D3), direction and marker
+static void setProbe(int direction, unsigned long sequence, uint8_t *data)
+{
+    data[0] = (uint8_t)(sequence >> 24);
+    data[1] = (uint8_t)(sequence >> 16);
+    data[2] = (uint8_t)(sequence >> 8);
+    data[3] = (uint8_t)sequence;
+    data[4] = (uint8_t)direction;
+    data[5] = LOAD_PROBE_MARKER;
+    data[6] = LOAD_PROBE_MARKER;
+    data[7] = LOAD_PROBE_MARKER;
+}
+
+// Probe frame received: latency, duplicates
+static void probeReceived(int direction, const uint8_t *data)
+{
+    unsigned long long now = getTime();
+    unsigned long sequence;
+    loadProbe_t *probe = &g_probe[direction];
+    if((data[4] != direction) || (data[5] != LOAD_PROBE_MARKER))
+    {
+        return;
+    }
+    sequence = ((unsigned long)data[0] << 24) | ((unsigned long)data[1] << 16) |
+            ((unsigned long)data[2] << 8) | data[3];
+    pthread_mutex_lock(&g_probe_mutex);
+    if(sequence < probe->sent)
+    {
+        if(probe->isReceived[sequence])
+        {
+            probe->duplicated++;
+        }
+        else
+        {
+            probe->isReceived[sequence] = 1;
+            probe->latency[probe->received] = now - probe->sentTime[sequence];
+            probe->received++;
+        }
+    }
+    pthread_mutex_unlock(&g_probe_mutex);
+}
+
+// Raw frame published by HMSG: CAN -> MQTT probe
+static void checkProbe(const hapcanCANData *hd)
+{
+    if( (hd->frametype == LOAD_PROBE_CAN2MQTT_FRAME_TYPE) &&
+        (hd->module == g_options.node) && (hd->group == g_options.group) )
+    {
+        probeReceived(LOAD_CAN2MQTT, hd->data);
+    }
+}
+
+// Value of a hex digit - returns -1 if it is not a hex digit
+static int getHexDigit(char c)
+{
+    if((c >= '0') && (c <= '9'))
+    {
+        return c - '0';
+    }
+    if((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+    if((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+// HAPCAN frame from a socket format frame (as hs_getHAPCANFromSocketArray)
+static bool getFrameFromSocketArray(const uint8_t *data, hapcanCANData *hd)
+{
+    if((data[0] != 0xAA) || (data[HAPCAN_SOCKET_DATA_LEN - 1] != 0xA5))
+    {
+        return false;
+    }
+    hd->frametype = ((uint16_t)data[1] << 4) | (data[2] >> 4);
+    hd->flags = data[2] & 0x0F;
+    hd->module = data[3];
+    hd->group = data[4];
+    memcpy(hd->data, &data[5], HAPCAN_DATA_LEN);
+    return true;
+}
+
+// HAPCAN frame from a raw payload: JSON, hex string or binary
+// (rawHapcanEncoding)
+static bool getFrameFromRaw(const void *payload, int payloadlen,
+        hapcanCANData *hd)
+{
+    char str[LOAD_RAW_PAYLOAD_SIZE];
+    char field[4];
+    uint8_t data[HAPCAN_SOCKET_DATA_LEN];
+    const char *hex = payload;
+    json_object *root;
+    int li_index;
+    int hi;
+    int lo;
+    if(payloadlen == HAPCAN_SOCKET_DATA_LEN)
+    {
+        // Binary
+        return getFrameFromSocketArray(payload, hd);
+    }
+    if(payloadlen == 2*HAPCAN_SOCKET_DATA_LEN)
+    {
+        // Hex string
+        for(li_index = 0; li_index < HAPCAN_SOCKET_DATA_LEN; li_index++)
+        {
+            hi = getHexDigit(hex[2*li_index]);
+            lo = getHexDigit(hex[2*li_index + 1]);
+            if((hi < 0) || (lo < 0))
+            {
+                return false;
+            }
+            data[li_index] = (uint8_t)((hi << 4) | lo);
+        }
+        return getFrameFromSocketArray(data, hd);
+    }
+    // JSON
+    if(payloadlen >= (int)sizeof(str))
+    {
+        return false;
+    }
+    memcpy(str, payload, payloadlen);
+    str[payloadlen] = '\0';
+    root = json_tokener_parse(str);
+    if(root == NULL)
+    {
+        return false;
+    }
+    hd->frametype = getInt(root, "Frame", 0);
+    hd->flags = getInt(root, "Flags", 0);
+    hd->module = getInt(root, "Module", 0);
+    hd->group = getInt(root, "Group", 0);
+    for(li_index = 0; li_index < HAPCAN_DATA_LEN; li_index++)
+    {
+        snprintf(field, sizeof(field), "D%d", li_index);
+        hd->data[li_index] = (uint8_t)getInt(root, field, 0);
+    }
+    json_object_put(root);
+    return true;
+}
+
+// Frames of a batch (rawHapcanBatch, see hapcanfed.h)
+static void handleBatch(const uint8_t *data, int payloadlen)
+{
+    hapcanCANData hd;
+    const uint8_t *frame;
+    int li_index;
+    if((data[2] != HFED_VERSION) || (data[3] < 1) ||
+            (data[3] > HFED_MAX_FRAMES) ||
+            (payloadlen != HFED_HEADER_LEN + data[3]*HFED_FRAME_LEN))
+    {
+        return;
+    }
+    for(li_index = 0; li_index < data[3]; li_index++)
+    {
+        frame = &data[HFED_HEADER_LEN + li_index*HFED_FRAME_LEN];
+        hd.frametype = ((uint16_t)frame[0] << 4) | (frame[1] >> 4);
+        hd.flags = frame[1] & 0x0F;
+        hd.module = frame[2];
+        hd.group = frame[3];
+        memcpy(hd.data, &frame[4], HAPCAN_DATA_LEN);
+        checkProbe(&hd);
+    }
+}
+
+// MQTT message: raw frames published by HMSG (CAN -> MQTT probes)
+static int onMessage(void *context, char *topicName, int topicLen,
+        MQTTClient_message *message)
+{
+    hapcanCANData hd;
+    uint8_t *data = message->payload;
+    if((message->payloadlen >= HFED_HEADER_LEN) &&
+            (data[0] == HFED_MAGIC_0) && (data[1] == HFED_MAGIC_1))
+    {
+        handleBatch(data, message->payloadlen);
+    }
+    else if(getFrameFromRaw(message->payload, message->payloadlen, &hd))
+    {
+        checkProbe(&hd);
+    }
+    MQTTClient_freeMessage(&message);
+    MQTTClient_free(topicName);
+    return 1;
+}
+
+// MQTT connection lost
+static void onConnectionLost(void *context, char *cause)
+{
+    printf("MQTT connection lost\n");
+}
+
+// THREAD - CAN frames: status requests, MQTT -> CAN probes
+static void* canReader(void *arg)
+{
+    struct pollfd pfd;
+    struct can_frame cf;
+    hapcanCANData hd;
+    int li_index;
+    pfd.fd = g_fd;
+    pfd.events = POLLIN;
+    while(g_running)
+    {
+        if(poll(&pfd, 1, 100) <= 0)
+        {
+            continue;
+        }
+        if(read(g_fd, &cf, sizeof(cf)) != sizeof(cf))
+        {
+            continue;
+        }
+        getHAPCANFromCAN(&cf, &hd);
+        if( (hd.frametype == LOAD_PROBE_MQTT2CAN_FRAME_TYPE) &&
+            (hd.module == g_options.node) && (hd.group == g_options.group) )
+        {
+            probeReceived(LOAD_MQTT2CAN, hd.data);
+            continue;
+        }
+        // Status request: node (D2 = node, D3 = group) or group (D3 = group,
+        // 0 for all groups)
+        if(hd.frametype == HAPCAN_STATUS_REQUEST_GROUP_FRAME_TYPE)
+        {
+            hd.data[2] = 0;
+        }
+        else if(hd.frametype != HAPCAN_STATUS_REQUEST_NODE_FRAME_TYPE)
+        {
+            continue;
+        }
+        g_statusRequests++;
+        for(li_index = 0; li_index < g_nStatus; li_index++)
+        {
+            if( ((hd.data[2] == 0) ||
+                    (hd.data[2] == g_status[li_index].module)) &&
+                ((hd.data[3] == 0) ||
+                    (hd.data[3] == g_status[li_index].group)) )
+            {
+                if(writeFrame(&g_status[li_index]) == EXIT_SUCCESS)
+                {
+                    g_statusFrames++;
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+// THREAD - Background: status frames of the emulated modules
+static void* statusLoad(void *arg)
+{
+    unsigned long long next = getTime();
+    unsigned long long period = 1000000ULL / g_options.backgroundRate;
+    hapcanCANData hd;
+    int li_index = 0;
+    while(g_sending && (g_nStatus > 0))
+    {
+        hd = g_status[li_index];
+        // Sent by the module (not a response)
+        hd.flags = 0;
+        if(writeFrame(&hd) == EXIT_SUCCESS)
+        {
+            g_backgroundFrames++;
+        }
+        li_index = (li_index + 1) % g_nStatus;
+        next += period;
+        sleepUntil(next);
+    }
+    return NULL;
+}
+
+// THREAD - Background: frames received in a bus trace, with their timing
+static void* traceReplay(void *arg)
+{
+    struct dirent **entries;
+    const traceFileHeader_t *header;
+    const traceRecord_t *records;
+    const uint8_t *map;
+    struct stat st;
+    unsigned long long start = 0;
+    unsigned long long first = 0;
+    bool isFirst = true;
+    unsigned long li_record;
+    int li_file;
+    int count;
+    int fd;
+
+    // Files in order (the sequence has a fixed number of digits)
+    count = scandir(g_options.traceDirectory, &entries, NULL, alphasort);
+    if(count < 0)
+    {
+        printf("Trace directory error: %s\n", g_options.traceDirectory);
+        return NULL;
+    }
+    for(li_file = 0; li_file < count; li_file++)
+    {
+        char name[512];
+        if( (!g_sending) ||
+            (strncmp(entries[li_file]->d_name, TRACE_FILE_PREFIX,
+                strlen(TRACE_FILE_PREFIX)) != 0) )
+        {
+            free(entries[li_file]);
+            continue;
+        }
+        snprintf(name, sizeof(name), "%s/%s", g_options.traceDirectory,
+                entries[li_file]->d_name);
+        free(entries[li_file]);
+        fd = open(name, O_RDONLY);
+        if(fd < 0)
+        {
+            continue;
+        }
+        if((fstat(fd, &st) != 0) || (st.st_size < sizeof(*header)))
+        {
+            close(fd);
+            continue;
+        }
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if(map == MAP_FAILED)
+        {
+            continue;
+        }
+        header = (const traceFileHeader_t *)map;
+        if( (header->magic == TRACE_FILE_MAGIC) &&
+            (header->recordSize == sizeof(traceRecord_t)) &&
+            (header->recordOffset + (unsigned long long)header->count *
+                sizeof(traceRecord_t) <= (unsigned long long)st.st_size) )
+        {
+            records = (const traceRecord_t *)(map + header->recordOffset);
+            for(li_record = 0; g_sending && (li_record < header->count);
+                    li_record++)
+            {
+                // Frames sent by HMSG are not replayed
+                if(records[li_record].direction != TRACE_RX)
+                {
+                    continue;
+                }
+                if(isFirst)
+                {
+                    start = getTime();
+                    first = records[li_record].millisecondsSinceEpoch;
+                    isFirst = false;
+                }
+                if(g_options.speed > 0)
+                {
+                    sleepUntil(start + (unsigned long long)(1000.0 *
+                            (records[li_record].millisecondsSinceEpoch -
+                            first) / g_options.speed));
+                }
+                if(writeFrame(&records[li_record].frame) == EXIT_SUCCESS)
+                {
+                    g_backgroundFrames++;
+                }
+            }
+        }
+        munmap((void *)map, st.st_size);
+    }
+    free(entries);
+    return NULL;
+}
+
+// Compare latencies (qsort)
+static int compareLatency(const void *a, const void *b)
+{
+    unsigned long long la = *(const unsigned long long *)a;
+    unsigned long long lb = *(const unsigned long long *)b;
+    return (la > lb) - (la < lb);
+}
+
+// Print the results of a direction (one line, key=value)
+static void report(const char *name, loadProbe_t *probe)
+{
+    unsigned long long p50 = 0;
+    unsigned long long p99 = 0;
+    unsigned long long max = 0;
+    if(!probe->enabled)
+    {
+        return;
+    }
+    if(probe->received > 0)
+    {
+        qsort(probe->latency, probe->received, sizeof(*probe->latency),
+                compareLatency);
+        p50 = probe->latency[(probe->received - 1) * 50 / 100];
+        p99 = probe->latency[(probe->received - 1) * 99 / 100];
+        max = probe->latency[probe->received - 1];
+    }
+    printf("%s sent=%lu received=%lu lost=%lu duplicated=%lu "
+            "throughput=%.1f p50_us=%llu p99_us=%llu max_us=%llu\n", name,
+            probe->sent, probe->received, probe->sent - probe->received,
+            probe->duplicated, (double)probe->received / g_options.duration,
+            p50, p99, max);
+}
+
+// Usage
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n"
+        "  -i <interface>  CAN interface (default %s)\n"
+        "  -b <broker>     MQTT broker (default %s)\n"
+        "  -p <topic>      rawHapcanPubTopic of HMSG: CAN -> MQTT probes\n"
+        "  -s <topic>      topic of rawHapcanSubTopics of HMSG: MQTT -> CAN "
+        "probes\n"
+        "  -r <rate>       probe frames per second (default %d)\n"
+        "  -d <seconds>    duration (default %d)\n"
+        "  -w <seconds>    wait for the last frames (default %d)\n"
+        "  -n <node>       node of the probe frames (default %d)\n"
+        "  -g <group>      group of the probe frames (default %d)\n"
+        "  -c <file>       HMSG configuration file: modules to be emulated\n"
+        "  -l <rate>       background: status frames per second of the "
+        "emulated modules\n"
+        "  -t <directory>  background: replay the frames of a bus trace\n"
+        "  -x <speed>      trace replay speed (default 1.0, 0: no pauses)\n",
+        name, LOAD_DEFAULT_INTERFACE, LOAD_DEFAULT_BROKER, LOAD_DEFAULT_RATE,
+        LOAD_DEFAULT_DURATION, LOAD_DEFAULT_DRAIN, LOAD_DEFAULT_NODE,
+        LOAD_DEFAULT_GROUP);
+}
+
+//----------------------------------------------------------------------------//
+// MAIN
+//----------------------------------------------------------------------------//
+int main(int argc, char *argv[])
+{
+    MQTTClient_connectOptions conn_opts = MQTTClient_connectOptions_initializer;
+    MQTTClient_message pubmsg = MQTTClient_message_initializer;
+    MQTTClient_deliveryToken token;
+    struct sockaddr_can addr;
+    struct ifreq ifr;
+    pthread_t readerThread;
+    pthread_t backgroundThread;
+    bool isBackground = false;
+    hapcanCANData hd;
+    char payload[LOAD_RAW_PAYLOAD_SIZE];
+    unsigned long long next;
+    unsigned long long period;
+    unsigned long total;
+    unsigned long sequence;
+    int direction;
+    int opt;
+    int len;
+
+    //--------------------------------------------------------------------------
+    // Options
+    //--------------------------------------------------------------------------
+    while((opt = getopt(argc, argv, "i:b:p:s:r:d:w:n:g:c:l:t:x:h")) != -1)
+    {
+        switch(opt)
+        {
+            case 'i': g_options.interface = optarg; break;
+            case 'b': g_options.broker = optarg; break;
+            case 'p': g_options.pubTopic = optarg; break;
+            case 's': g_options.subTopic = optarg; break;
+            case 'r': g_options.rate = atoi(optarg); break;
+            case 'd': g_options.duration = atoi(optarg); break;
+            case 'w': g_options.drain = atoi(optarg); break;
+            case 'n': g_options.node = atoi(optarg); break;
+            case 'g': g_options.group = atoi(optarg); break;
+            case 'c': g_options.configFile = optarg; break;
+            case 'l': g_options.backgroundRate = atoi(optarg); break;
+            case 't': g_options.traceDirectory = optarg; break;
+            case 'x': g_options.speed = atof(optarg); break;
+            default: usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+    if((g_options.rate <= 0) || (g_options.duration <= 0))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    g_probe[LOAD_CAN2MQTT].enabled = (g_options.pubTopic != NULL);
+    g_probe[LOAD_MQTT2CAN].enabled = (g_options.subTopic != NULL);
+    total = (unsigned long)g_options.rate * g_options.duration;
+    for(direction = 0; direction < LOAD_NUMBER_OF_DIRECTIONS; direction++)
+    {
+        g_probe[direction].sentTime = calloc(total, sizeof(unsigned long long));
+        g_probe[direction].latency = calloc(total, sizeof(unsigned long long));
+        g_probe[direction].isReceived = calloc(total, sizeof(uint8_t));
+        if( (g_probe[direction].sentTime == NULL) ||
+            (g_probe[direction].latency == NULL) ||
+            (g_probe[direction].isReceived == NULL) )
+        {
+            printf("No memory\n");
+            return EXIT_FAILURE;
+        }
+    }
+    if(g_options.configFile != NULL)
+    {
+        loadModules(g_options.configFile);
+        printf("Emulated status frames: %d\n", g_nStatus);
+    }
+
+    //--------------------------------------------------------------------------
+    // CAN interface (e.g. "ip link add dev can0 type vcan")
+    //--------------------------------------------------------------------------
+    g_fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if(g_fd < 0)
+    {
+        printf("CAN socket error\n");
+        return EXIT_FAILURE;
+    }
+    snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", g_options.interface);
+    if(ioctl(g_fd, SIOCGIFINDEX, &ifr) < 0)
+    {
+        printf("CAN interface error: %s\n", g_options.interface);
+        return EXIT_FAILURE;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if(bind(g_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        printf("CAN bind error\n");
+        return EXIT_FAILURE;
+    }
+
+    //--------------------------------------------------------------------------
+    // MQTT client
+    //--------------------------------------------------------------------------
+    if(g_probe[LOAD_CAN2MQTT].enabled || g_probe[LOAD_MQTT2CAN].enabled)
+    {
+        MQTTClient_create(&g_client, g_options.broker, g_options.clientID,
+                MQTTCLIENT_PERSISTENCE_NONE, NULL);
+        MQTTClient_setCallbacks(g_client, NULL, onConnectionLost, onMessage,
+                NULL);
+        conn_opts.keepAliveInterval = 20;
+        conn_opts.cleansession = 1;
+        if(MQTTClient_connect(g_client, &conn_opts) != MQTTCLIENT_SUCCESS)
+        {
+            printf("MQTT connect error: %s\n", g_options.broker);
+            return EXIT_FAILURE;
+        }
+        if(g_probe[LOAD_CAN2MQTT].enabled)
+        {
+            MQTTClient_subscribe(g_client, g_options.pubTopic, 0);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Threads: CAN reader, background traffic
+    //--------------------------------------------------------------------------
+    pthread_create(&readerThread, NULL, canReader, NULL);
+    if(g_options.traceDirectory != NULL)
+    {
+        isBackground = (pthread_create(&backgroundThread, NULL, traceReplay,
+                NULL) == 0);
+    }
+    else if((g_options.backgroundRate > 0) && (g_nStatus > 0))
+    {
+        isBackground = (pthread_create(&backgroundThread, NULL, statusLoad,
+                NULL) == 0);
+    }
+
+    //--------------------------------------------------------------------------
+    // Probe frames at a fixed rate
+    //--------------------------------------------------------------------------
+    period = 1000000ULL / g_options.rate;
+    next = getTime();
+    for(sequence = 0; sequence < total; sequence++)
+    {
+        // CAN -> MQTT: frame written to the bus
+        if(g_probe[LOAD_CAN2MQTT].enabled)
+        {
+            hd.frametype = LOAD_PROBE_CAN2MQTT_FRAME_TYPE;
+            hd.flags = 0;
+            hd.module = g_options.node;
+            hd.group = g_options.group;
+            setProbe(LOAD_CAN2MQTT, sequence, hd.data);
+            pthread_mutex_lock(&g_probe_mutex);
+            g_probe[LOAD_CAN2MQTT].sentTime[sequence] = getTime();
+            g_probe[LOAD_CAN2MQTT].sent++;
+            pthread_mutex_unlock(&g_probe_mutex);
+            writeFrame(&hd);
+        }
+        // MQTT -> CAN: raw frame published
+        if(g_probe[LOAD_MQTT2CAN].enabled)
+        {
+            setProbe(LOAD_MQTT2CAN, sequence, hd.data);
+            len = snprintf(payload, sizeof(payload), "{\"Frame\":%d, "
+                    "\"Flags\":0, \"Module\":%d, \"Group\":%d, \"D0\":%d, "
+                    "\"D1\":%d, \"D2\":%d, \"D3\":%d, \"D4\":%d, \"D5\":%d, "
+                    "\"D6\":%d, \"D7\":%d}", LOAD_PROBE_MQTT2CAN_FRAME_TYPE,
+                    g_options.node, g_options.group, hd.data[0], hd.data[1],
+                    hd.data[2], hd.data[3], hd.data[4], hd.data[5], hd.data[6],
+                    hd.data[7]);
+            pubmsg.payload = payload;
+            pubmsg.payloadlen = len;
+            pubmsg.qos = 0;
+            pubmsg.retained = 0;
+            pthread_mutex_lock(&g_probe_mutex);
+            g_probe[LOAD_MQTT2CAN].sentTime[sequence] = getTime();
+            g_probe[LOAD_MQTT2CAN].sent++;
+            pthread_mutex_unlock(&g_probe_mutex);
+            MQTTClient_publishMessage(g_client, g_options.subTopic, &pubmsg,
+                    &token);
+        }
+        next += period;
+        sleepUntil(next);
+    }
+    g_sending = 0;
+    // Wait for the last frames
+    sleep(g_options.drain);
+    g_running = 0;
+    pthread_join(readerThread, NULL);
+    if(isBackground)
+    {
+        pthread_join(backgroundThread, NULL);
+    }
+
+    //--------------------------------------------------------------------------
+    // Results
+    //--------------------------------------------------------------------------
+    pthread_mutex_lock(&g_probe_mutex);
+    report("can2mqtt", &g_probe[LOAD_CAN2MQTT]);
+    report("mqtt2can", &g_probe[LOAD_MQTT2CAN]);
+    pthread_mutex_unlock(&g_probe_mutex);
+    printf("emulation status_requests=%lu status_frames=%lu "
+            "background_frames=%lu\n", g_statusRequests, g_statusFrames,
+            g_backgroundFrames);
+    if(g_probe[LOAD_CAN2MQTT].enabled || g_probe[LOAD_MQTT2CAN].enabled)
+    {
+        MQTTClient_disconnect(g_client, 100);
+        MQTTClient_destroy(&g_client);
+    }
+    close(g_fd);
+    return EXIT_SUCCESS;
+}